@@ -0,0 +1,16 @@
+function msd = importfile_msd(filename)
+%IMPORTFILE_MSD Import the MSD curve written by MeanSquaredDisplacementModifier
+%  MSD = IMPORTFILE_MSD(FILENAME) reads the file msd.dat and returns a table
+%  with one row per lag and variables lag, all, n_all, then the MSD and the
+%  number of displacements averaged for luminal, myoepithelial, luminal
+%  stem and myoepithelial stem cells.
+%
+%  Example:
+%  msd = importfile_msd("/Users/Priya/testoutput/TestMammaryOrganoid/results_from_time_0/msd.dat");
+%  loglog(msd.lag, msd.all);
+
+data = readmatrix(filename, 'FileType', 'text', 'Delimiter', '\t');
+msd = array2table(data, 'VariableNames', {'lag', 'all', 'n_all', ...
+    'luminal', 'n_luminal', 'myoepithelial', 'n_myoepithelial', ...
+    'luminal_stem', 'n_luminal_stem', 'myoepithelial_stem', 'n_myoepithelial_stem'});
+end
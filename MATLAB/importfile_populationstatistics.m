@@ -0,0 +1,20 @@
+function stats = importfile_populationstatistics(filename, dim)
+%IMPORTFILE_POPULATIONSTATISTICS Import the statistics written by PopulationStatisticsModifier
+%  STATS = IMPORTFILE_POPULATIONSTATISTICS(FILENAME, DIM) reads the file
+%  populationstatistics.dat of a DIM-dimensional simulation and returns a
+%  table with one row per output time.
+%
+%  Example:
+%  stats = importfile_populationstatistics("/Users/Priya/testoutput/TestMammaryOrganoid/results_from_time_0/populationstatistics.dat", 3);
+%  plot(stats.time, stats.radius_of_gyration);
+
+centroid = arrayfun(@(d) sprintf('centroid_%d', d), 1:dim, 'UniformOutput', false);
+names = [{'time', 'cells', 'luminal', 'myoepithelial', 'luminal_stem', 'myoepithelial_stem', 'no_type'}, ...
+    centroid, ...
+    {'radius_of_gyration', 'max_radius', 'percentile_radius', ...
+    'luminal_inner_radius', 'luminal_outer_radius', 'luminal_thickness', ...
+    'myoepithelial_inner_radius', 'myoepithelial_outer_radius', 'myoepithelial_thickness'}];
+
+data = readmatrix(filename, 'FileType', 'text', 'Delimiter', '\t');
+stats = array2table(data, 'VariableNames', names);
+end
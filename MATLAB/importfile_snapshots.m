@@ -0,0 +1,80 @@
+function snapshots = importfile_snapshots(filename)
+%IMPORTFILE_SNAPSHOTS Import data from a binary snapshot file
+%  SNAPSHOTS = IMPORTFILE_SNAPSHOTS(FILENAME) reads every snapshot from the
+%  file mammary_snapshots.bin written by MammarySnapshotWriter, and returns
+%  a struct array with fields time, id, type, b1, b4, position and velocity
+%  (one row per cell; velocity is empty if it was not written).
+%
+%  Cell types are 0 (luminal), 1 (myoepithelial), 2 (luminal stem cell),
+%  3 (myoepithelial stem cell) and 4 (none).
+%
+%  Delta-encoded snapshots are decoded. Compressed snapshot files are not
+%  supported; read those with MammarySnapshotReader instead.
+%
+%  Example:
+%  snapshots = importfile_snapshots("/Users/Priya/testoutput/TestMammaryOrganoid/results_from_time_0/mammary_snapshots.bin");
+
+fid = fopen(filename, 'r', 'native');
+if fid < 0
+    error('Could not open %s', filename);
+end
+cleaner = onCleanup(@() fclose(fid));
+
+magic = fread(fid, [1 4], '*char');
+if ~strcmp(magic, 'MSNP')
+    error('%s is not a mammary snapshot file', filename);
+end
+version = fread(fid, 1, 'uint32');
+dim = fread(fid, 1, 'uint32');
+if version >= 2 && fread(fid, 1, 'uint32') ~= 0
+    error('%s is compressed, which is not supported here', filename);
+end
+
+snapshots = struct('time', {}, 'id', {}, 'type', {}, 'b1', {}, 'b4', {}, 'position', {}, 'velocity', {});
+while true
+    time = fread(fid, 1, 'double');
+    if isempty(time)
+        break;
+    end
+    n = fread(fid, 1, 'uint32');
+    flags = fread(fid, 1, 'uint32');
+
+    s.time = time;
+    s.id = fread(fid, n, 'uint32');
+    s.type = fread(fid, n, 'uint8');
+    bits = fread(fid, n, 'uint8');
+    s.b1 = bitand(bits, 1) > 0;
+    s.b4 = bitand(bits, 2) > 0;
+    position = fread(fid, n*dim, 'double');
+    velocity = [];
+    if bitand(flags, 1)
+        velocity = fread(fid, n*dim, 'double');
+    end
+
+    % Stop at a snapshot left incomplete at the end of the file
+    if numel(position) < n*dim || (bitand(flags, 1) && numel(velocity) < n*dim)
+        break;
+    end
+    s.position = reshape(position, n, dim);
+    s.velocity = [];
+    if bitand(flags, 1)
+        s.velocity = reshape(velocity, n, dim);
+    end
+
+    % Undo the XOR of each coordinate's bits with those of the same cell in the previous snapshot
+    if bitand(flags, 2)
+        previous = snapshots(end);
+        [found, previous_row] = ismember(s.id, previous.id);
+        s.position(found, :) = undo_delta(s.position(found, :), previous.position(previous_row(found), :));
+        if ~isempty(s.velocity) && ~isempty(previous.velocity)
+            s.velocity(found, :) = undo_delta(s.velocity(found, :), previous.velocity(previous_row(found), :));
+        end
+    end
+    snapshots(end+1) = s; %#ok<AGROW>
+end
+end
+
+function x = undo_delta(x, previous)
+bits = bitxor(typecast(x(:), 'uint64'), typecast(previous(:), 'uint64'));
+x = reshape(typecast(bits, 'double'), size(x));
+end
@@ -0,0 +1,46 @@
+function data = importfile_trajectories(directory)
+%IMPORTFILE_TRAJECTORIES Import columns exported by MammaryTrajectoryTool
+%  DATA = IMPORTFILE_TRAJECTORIES(DIRECTORY) reads the raw column files
+%  written by "MammaryTrajectoryTool export file DIRECTORY", and returns a
+%  struct with fields time (one per snapshot), first_row (the first row of
+%  each snapshot, from 1), and snapshot, id, type, position and velocity
+%  (one row per cell per snapshot; velocity is empty if not recorded).
+%  Each file is read with a single call, so this is much faster than
+%  parsing location.dat or velocity.dat.
+%
+%  Example:
+%  data = importfile_trajectories("/Users/Priya/testoutput/TestMammaryOrganoid/results_from_time_0/columns");
+%  rows = data.id == 5;
+%  plot(data.time(data.snapshot(rows)), data.position(rows, 1));
+
+info = readlines(fullfile(directory, 'columns.txt'));
+values = containers.Map();
+for i = 1:numel(info)
+    parts = split(strtrim(info(i)));
+    if numel(parts) == 2
+        values(char(parts(1))) = str2double(parts(2));
+    end
+end
+dim = values('dimension');
+
+data.time = read_column(directory, 'times.f64', 'double');
+offsets = read_column(directory, 'snapshot_offsets.u64', 'uint64');
+data.first_row = double(offsets(1:end-1)) + 1;
+data.snapshot = double(read_column(directory, 'snapshots.u32', 'uint32')) + 1;
+data.id = read_column(directory, 'cell_ids.u32', 'uint32');
+data.type = read_column(directory, 'cell_types.u8', 'uint8');
+data.position = reshape(read_column(directory, 'positions.f64', 'double'), dim, [])';
+data.velocity = [];
+if values('velocities')
+    data.velocity = reshape(read_column(directory, 'velocities.f64', 'double'), dim, [])';
+end
+end
+
+function column = read_column(directory, name, type)
+fid = fopen(fullfile(directory, name), 'r', 'native');
+if fid < 0
+    error('Could not open %s', fullfile(directory, name));
+end
+cleaner = onCleanup(@() fclose(fid));
+column = fread(fid, Inf, ['*' type]);
+end
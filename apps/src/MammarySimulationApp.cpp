@@ -0,0 +1,179 @@
+/**
+ * @file
+ *
+ * Runs the simulation described by a scenario file (see MammaryScenario), so that a scenario
+ * can be changed without recompiling.
+ *
+ * Usage: MammarySimulationApp scenario.json [--seed N] [--output-directory DIR]
+ *                             [--replicates R [--processes P] [--merge FILE]...]
+ *        MammarySimulationApp --list
+ *
+ * --seed and --output-directory override the Seed and OutputDirectory of the scenario's
+ * simulation section. --list prints the types that may appear in each list of a scenario.
+ *
+ * --replicates runs an ensemble of R replicates through MammaryEnsembleRunner, at most P at
+ * a time (by default, one per processor), with seeds N, N+1, ... and outputs in
+ * DIR/replicate_000, DIR/replicate_001, ... The populationstatistics.dat of the replicates,
+ * and each FILE given by --merge, are merged into DIR/ensemble_<file>.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ExecutableSupport.hpp"
+#include "Exception.hpp"
+#include "PetscTools.hpp"
+#include "PetscException.hpp"
+
+#include "MammaryEnsembleRunner.hpp"
+#include "MammaryScenario.hpp"
+#include "MammaryScenarioFactory.hpp"
+
+/**
+ * Print the types registered in each list of a scenario.
+ */
+void PrintRegisteredTypes()
+{
+    MammaryScenarioFactory<3> factory;
+    const char* list_names[4] = {"Forces", "Killers", "Modifiers", "Writers"};
+    for (unsigned list=0; list<4; list++)
+    {
+        std::cout << list_names[list] << ":\n";
+        std::vector<std::string> types = factory.GetRegisteredTypes(list_names[list]);
+        for (unsigned i=0; i<types.size(); i++)
+        {
+            std::cout << "  " << types[i] << "\n";
+        }
+    }
+    std::cout << std::flush;
+}
+
+int main(int argc, char *argv[])
+{
+    ExecutableSupport::StandardStartup(&argc, &argv);
+
+    int exit_code = ExecutableSupport::EXIT_OK;
+
+    try
+    {
+        std::vector<std::string> arguments;
+        std::string seed;
+        std::string output_directory;
+        unsigned num_replicates = 0;
+        unsigned num_processes = 0;
+        std::vector<std::string> merged_files(1, "populationstatistics.dat");
+        bool list = false;
+        for (int i=1; i<argc; i++)
+        {
+            std::string argument(argv[i]);
+            if (argument == "--seed" && i+1 < argc)
+            {
+                seed = argv[++i];
+            }
+            else if (argument == "--output-directory" && i+1 < argc)
+            {
+                output_directory = argv[++i];
+            }
+            else if (argument == "--replicates" && i+1 < argc)
+            {
+                num_replicates = strtoul(argv[++i], NULL, 10);
+            }
+            else if (argument == "--processes" && i+1 < argc)
+            {
+                num_processes = strtoul(argv[++i], NULL, 10);
+            }
+            else if (argument == "--merge" && i+1 < argc)
+            {
+                merged_files.push_back(argv[++i]);
+            }
+            else if (argument == "--list")
+            {
+                list = true;
+            }
+            else
+            {
+                arguments.push_back(argument);
+            }
+        }
+
+        if (list && arguments.empty())
+        {
+            if (PetscTools::AmMaster())
+            {
+                PrintRegisteredTypes();
+            }
+        }
+        else if (arguments.size() != 1 || list)
+        {
+            ExecutableSupport::PrintError("Usage: MammarySimulationApp scenario.json [--seed N] [--output-directory DIR]\n"
+                                          "                            [--replicates R [--processes P] [--merge FILE]...]\n"
+                                          "       MammarySimulationApp --list", true);
+            exit_code = ExecutableSupport::EXIT_BAD_ARGUMENTS;
+        }
+        else if (num_replicates > 0)
+        {
+            // Read the scenario here only to report errors before any replicate starts
+            MammaryScenario scenario(arguments[0]);
+            const MammaryScenarioComponent& r_simulation = scenario.rGetSimulation();
+            MammaryEnsembleRunner runner(arguments[0],
+                                         output_directory.empty() ? r_simulation.GetString("OutputDirectory", "") : output_directory,
+                                         num_replicates);
+            runner.SetFirstSeed(seed.empty() ? r_simulation.GetUnsigned("Seed", 0) : strtoul(seed.c_str(), NULL, 10));
+            if (num_processes > 0)
+            {
+                runner.SetNumProcesses(num_processes);
+            }
+
+            unsigned num_failures = runner.Run();
+            for (unsigned i=0; i<merged_files.size(); i++)
+            {
+                if (runner.MergeStatistics(merged_files[i]) == 0)
+                {
+                    std::cout << "No replicate wrote " << merged_files[i] << std::endl;
+                }
+            }
+            if (num_failures > 0)
+            {
+                EXCEPTION(num_failures << " of " << num_replicates << " replicates failed");
+            }
+        }
+        else
+        {
+            MammaryScenario scenario(arguments[0]);
+            if (!seed.empty())
+            {
+                scenario.rGetSimulation().SetParameter("Seed", seed);
+            }
+            if (!output_directory.empty())
+            {
+                scenario.rGetSimulation().SetParameter("OutputDirectory", output_directory);
+            }
+
+            unsigned dimension = scenario.rGetSimulation().GetUnsigned("Dimension", 3);
+            switch (dimension)
+            {
+                case 1:
+                    MammaryScenarioFactory<1>().Run(scenario);
+                    break;
+                case 2:
+                    MammaryScenarioFactory<2>().Run(scenario);
+                    break;
+                case 3:
+                    MammaryScenarioFactory<3>().Run(scenario);
+                    break;
+                default:
+                    EXCEPTION("The Dimension of a scenario must be 1, 2 or 3");
+            }
+        }
+    }
+    catch (const Exception& e)
+    {
+        ExecutableSupport::PrintError(e.GetMessage());
+        exit_code = ExecutableSupport::EXIT_ERROR;
+    }
+
+    ExecutableSupport::FinalizePetsc();
+    return exit_code;
+}
@@ -0,0 +1,165 @@
+/**
+ * @file
+ *
+ * Command-line access to simulation output through MammaryTrajectoryIndex.
+ *
+ * Usage: MammaryTrajectoryTool command file [arguments] [--dim D] [--rebuild]
+ *
+ * where file is location.dat, velocity.dat or mammary_snapshots.bin (or an index file),
+ * and command is one of
+ *   index                  build (or update) the index and print a summary
+ *   snapshot time          print the cells of the last snapshot at or before the time, as CSV
+ *   trajectory cell_id     print the trajectory of a cell, as CSV
+ *   export directory       write the columns of the index as raw files in the directory
+ *
+ * --dim is needed only for velocity.dat; --rebuild rebuilds the index even if it is up to date.
+ */
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "ExecutableSupport.hpp"
+#include "Exception.hpp"
+#include "PetscTools.hpp"
+#include "PetscException.hpp"
+
+#include "MammaryTrajectoryIndex.hpp"
+
+/**
+ * Print a position or velocity as comma-separated values.
+ *
+ * @param pValues the values
+ * @param dimension the number of values
+ */
+void PrintVector(const double* pValues, unsigned dimension)
+{
+    for (unsigned d=0; d<dimension; d++)
+    {
+        std::cout << "," << pValues[d];
+    }
+}
+
+/**
+ * Print the header of CSV output.
+ *
+ * @param rFirstColumns the names of the columns before the position
+ * @param dimension the space dimension
+ * @param hasVelocities whether velocity columns follow the position
+ */
+void PrintHeader(const std::string& rFirstColumns, unsigned dimension, bool hasVelocities)
+{
+    const char* axes[3] = {"x", "y", "z"};
+    std::cout << rFirstColumns;
+    for (unsigned d=0; d<dimension; d++)
+    {
+        std::cout << "," << axes[d];
+    }
+    for (unsigned d=0; hasVelocities && d<dimension; d++)
+    {
+        std::cout << ",v" << axes[d];
+    }
+    std::cout << "\n";
+}
+
+int main(int argc, char *argv[])
+{
+    ExecutableSupport::StandardStartup(&argc, &argv);
+
+    int exit_code = ExecutableSupport::EXIT_OK;
+
+    try
+    {
+        std::vector<std::string> arguments;
+        unsigned dimension = 0;
+        bool rebuild = false;
+        for (int i=1; i<argc; i++)
+        {
+            std::string argument(argv[i]);
+            if (argument == "--dim" && i+1 < argc)
+            {
+                dimension = atoi(argv[++i]);
+            }
+            else if (argument == "--rebuild")
+            {
+                rebuild = true;
+            }
+            else
+            {
+                arguments.push_back(argument);
+            }
+        }
+
+        std::string command = arguments.empty() ? "" : arguments[0];
+        unsigned num_arguments_needed = (command == "index") ? 2 : 3;
+        if (arguments.size() != num_arguments_needed
+            || (command != "index" && command != "snapshot" && command != "trajectory" && command != "export"))
+        {
+            ExecutableSupport::PrintError("Usage: MammaryTrajectoryTool index|snapshot|trajectory|export file "
+                                          "[time|cell_id|directory] [--dim D] [--rebuild]", true);
+            exit_code = ExecutableSupport::EXIT_BAD_ARGUMENTS;
+        }
+        else if (PetscTools::AmMaster())
+        {
+            MammaryTrajectoryIndex index(arguments[1], dimension, rebuild);
+            unsigned dim = index.GetDimension();
+            std::cout.precision(17);
+
+            if (command == "index")
+            {
+                std::cout << MammaryTrajectoryIndex::GetIndexFileName(arguments[1]) << ": "
+                          << index.GetNumSnapshots() << " snapshots, "
+                          << index.GetNumCells() << " cells, "
+                          << index.GetNumRows() << " rows, dimension " << dim
+                          << (index.HasVelocities() ? ", with velocities" : "") << std::endl;
+            }
+            else if (command == "snapshot")
+            {
+                if (index.GetNumSnapshots() > 0)
+                {
+                    MammaryTrajectorySnapshotView snapshot = index.GetSnapshot(index.FindSnapshot(atof(arguments[2].c_str())));
+                    PrintHeader("time,cell_id,cell_type", dim, index.HasVelocities());
+                    for (uint64_t row=0; row<snapshot.GetNumCells(); row++)
+                    {
+                        std::cout << snapshot.GetTime() << "," << snapshot.GetCellId(row) << "," << unsigned(snapshot.GetCellType(row));
+                        PrintVector(snapshot.GetPosition(row), dim);
+                        if (index.HasVelocities())
+                        {
+                            PrintVector(snapshot.GetVelocity(row), dim);
+                        }
+                        std::cout << "\n";
+                    }
+                }
+            }
+            else if (command == "trajectory")
+            {
+                MammaryTrajectoryCellView trajectory = index.GetTrajectory(strtoul(arguments[2].c_str(), NULL, 10));
+                PrintHeader("time,cell_type", dim, index.HasVelocities());
+                for (uint64_t point=0; point<trajectory.GetNumPoints(); point++)
+                {
+                    std::cout << trajectory.GetTime(point) << "," << unsigned(trajectory.GetCellType(point));
+                    PrintVector(trajectory.GetPosition(point), dim);
+                    if (index.HasVelocities())
+                    {
+                        PrintVector(trajectory.GetVelocity(point), dim);
+                    }
+                    std::cout << "\n";
+                }
+            }
+            else
+            {
+                index.ExportColumns(arguments[2]);
+            }
+            std::cout << std::flush;
+        }
+    }
+    catch (const Exception& e)
+    {
+        ExecutableSupport::PrintError(e.GetMessage());
+        exit_code = ExecutableSupport::EXIT_ERROR;
+    }
+
+    ExecutableSupport::FinalizePetsc();
+    return exit_code;
+}
@@ -0,0 +1,263 @@
+#include "CellTrajectoryStoreReader.hpp"
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <sstream>
+#include "CellTrajectoryStoreModifier.hpp"
+#include "Exception.hpp"
+
+template<unsigned DIM>
+CellTrajectoryStoreReader<DIM>::CellTrajectoryStoreReader(const std::string& rFileName)
+{
+    mFile.open(rFileName.c_str(), std::ios::in | std::ios::binary);
+    if (!mFile.is_open())
+    {
+        EXCEPTION("Could not open cell trajectory store " + rFileName);
+    }
+
+    char magic[4];
+    uint32_t header[3] = {0, 0, 0};
+    mFile.read(magic, 4);
+    mFile.read(reinterpret_cast<char*>(header), sizeof(header));
+    if (mFile.fail() || memcmp(magic, CELL_TRAJECTORY_STORE_MAGIC, 4) != 0)
+    {
+        EXCEPTION(rFileName + " is not a cell trajectory store");
+    }
+    if (header[0] == 0 || header[0] > CELL_TRAJECTORY_STORE_FORMAT_VERSION)
+    {
+        EXCEPTION("Unsupported cell trajectory store format version in " + rFileName);
+    }
+    if (header[1] != DIM)
+    {
+        EXCEPTION("Cell trajectory store " + rFileName + " was written by a simulation of a different dimension");
+    }
+
+    // The footer locates the index
+    const uint64_t footer_size = 2*sizeof(uint64_t) + 4 + sizeof(uint32_t);
+    mFile.seekg(0, std::ios::end);
+    uint64_t file_size = static_cast<uint64_t>(mFile.tellg());
+    uint64_t index_offset = 0;
+    uint64_t num_cells = 0;
+    if (file_size >= 4 + sizeof(header) + footer_size)
+    {
+        mFile.seekg(file_size - footer_size);
+        mFile.read(reinterpret_cast<char*>(&index_offset), sizeof(uint64_t));
+        mFile.read(reinterpret_cast<char*>(&num_cells), sizeof(uint64_t));
+        mFile.read(magic, 4);
+    }
+    if (file_size < 4 + sizeof(header) + footer_size || mFile.fail()
+        || memcmp(magic, CELL_TRAJECTORY_INDEX_MAGIC, 4) != 0 || index_offset > file_size - footer_size)
+    {
+        EXCEPTION("Cell trajectory store " + rFileName + " has no index; the simulation writing it may not have finished");
+    }
+
+    mCellIds.resize(num_cells);
+    mParentIds.resize(num_cells);
+    mBirthTimes.resize(num_cells);
+    mBirthPositions.resize(num_cells*DIM);
+    mDeathTimes.resize(num_cells);
+    mNumSamples.resize(num_cells);
+    mChunkStarts.assign(1, 0);
+    mChunkStarts.reserve(num_cells + 1);
+
+    mFile.seekg(index_offset);
+    for (uint64_t i=0; i<num_cells; i++)
+    {
+        uint32_t ids[2];
+        uint32_t counts[2];
+        mFile.read(reinterpret_cast<char*>(ids), sizeof(ids));
+        mFile.read(reinterpret_cast<char*>(&mBirthTimes[i]), sizeof(double));
+        mFile.read(reinterpret_cast<char*>(&mBirthPositions[i*DIM]), DIM*sizeof(double));
+        mFile.read(reinterpret_cast<char*>(&mDeathTimes[i]), sizeof(double));
+        mFile.read(reinterpret_cast<char*>(counts), sizeof(counts));
+        if (mFile.fail())
+        {
+            EXCEPTION("The index of cell trajectory store " + rFileName + " is truncated");
+        }
+
+        mCellIds[i] = ids[0];
+        mParentIds[i] = ids[1];
+        mNumSamples[i] = counts[0];
+        mChunkOffsets.resize(mChunkOffsets.size() + counts[1]);
+        if (counts[1] > 0)
+        {
+            mFile.read(reinterpret_cast<char*>(&mChunkOffsets[mChunkStarts.back()]), counts[1]*sizeof(uint64_t));
+        }
+        mChunkStarts.push_back(mChunkOffsets.size());
+    }
+    if (mFile.fail())
+    {
+        EXCEPTION("The index of cell trajectory store " + rFileName + " is truncated");
+    }
+
+    // Build the family tree, as lists of children; cells are in order of ID, so each list is too
+    mChildStarts.assign(num_cells + 1, 0);
+    for (unsigned i=0; i<num_cells; i++)
+    {
+        if (mParentIds[i] != UINT_MAX && HasCell(mParentIds[i]))
+        {
+            mChildStarts[GetIndex(mParentIds[i]) + 1]++;
+        }
+    }
+    for (unsigned i=0; i<num_cells; i++)
+    {
+        mChildStarts[i+1] += mChildStarts[i];
+    }
+    mChildren.resize(mChildStarts.back());
+    std::vector<unsigned> num_children_placed(num_cells, 0);
+    for (unsigned i=0; i<num_cells; i++)
+    {
+        if (mParentIds[i] != UINT_MAX && HasCell(mParentIds[i]))
+        {
+            unsigned parent_index = GetIndex(mParentIds[i]);
+            mChildren[mChildStarts[parent_index] + num_children_placed[parent_index]++] = mCellIds[i];
+        }
+    }
+}
+
+template<unsigned DIM>
+unsigned CellTrajectoryStoreReader<DIM>::GetIndex(unsigned cellId) const
+{
+    std::vector<unsigned>::const_iterator iter = std::lower_bound(mCellIds.begin(), mCellIds.end(), cellId);
+    if (iter == mCellIds.end() || *iter != cellId)
+    {
+        std::stringstream message;
+        message << "Cell " << cellId << " is not in the cell trajectory store";
+        EXCEPTION(message.str());
+    }
+    return iter - mCellIds.begin();
+}
+
+template<unsigned DIM>
+unsigned CellTrajectoryStoreReader<DIM>::GetNumCells() const
+{
+    return mCellIds.size();
+}
+
+template<unsigned DIM>
+const std::vector<unsigned>& CellTrajectoryStoreReader<DIM>::rGetCellIds() const
+{
+    return mCellIds;
+}
+
+template<unsigned DIM>
+bool CellTrajectoryStoreReader<DIM>::HasCell(unsigned cellId) const
+{
+    return std::binary_search(mCellIds.begin(), mCellIds.end(), cellId);
+}
+
+template<unsigned DIM>
+unsigned CellTrajectoryStoreReader<DIM>::GetParentId(unsigned cellId) const
+{
+    return mParentIds[GetIndex(cellId)];
+}
+
+template<unsigned DIM>
+double CellTrajectoryStoreReader<DIM>::GetBirthTime(unsigned cellId) const
+{
+    return mBirthTimes[GetIndex(cellId)];
+}
+
+template<unsigned DIM>
+c_vector<double, DIM> CellTrajectoryStoreReader<DIM>::GetBirthPosition(unsigned cellId) const
+{
+    unsigned index = GetIndex(cellId);
+    c_vector<double, DIM> position;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        position[d] = mBirthPositions[index*DIM + d];
+    }
+    return position;
+}
+
+template<unsigned DIM>
+double CellTrajectoryStoreReader<DIM>::GetDeathTime(unsigned cellId) const
+{
+    return mDeathTimes[GetIndex(cellId)];
+}
+
+template<unsigned DIM>
+unsigned CellTrajectoryStoreReader<DIM>::GetNumSamples(unsigned cellId) const
+{
+    return mNumSamples[GetIndex(cellId)];
+}
+
+template<unsigned DIM>
+std::vector<unsigned> CellTrajectoryStoreReader<DIM>::GetChildren(unsigned cellId) const
+{
+    unsigned index = GetIndex(cellId);
+    return std::vector<unsigned>(mChildren.begin() + mChildStarts[index], mChildren.begin() + mChildStarts[index+1]);
+}
+
+template<unsigned DIM>
+std::vector<unsigned> CellTrajectoryStoreReader<DIM>::GetAncestors(unsigned cellId) const
+{
+    std::vector<unsigned> ancestors;
+    unsigned parent_id = GetParentId(cellId);
+    while (parent_id != UINT_MAX && HasCell(parent_id))
+    {
+        ancestors.push_back(parent_id);
+        parent_id = GetParentId(parent_id);
+    }
+    return ancestors;
+}
+
+template<unsigned DIM>
+std::vector<unsigned> CellTrajectoryStoreReader<DIM>::GetLineage(unsigned rootCellId) const
+{
+    std::vector<unsigned> lineage(1, mCellIds[GetIndex(rootCellId)]);
+    for (unsigned i=0; i<lineage.size(); i++)
+    {
+        unsigned index = GetIndex(lineage[i]);
+        lineage.insert(lineage.end(), mChildren.begin() + mChildStarts[index], mChildren.begin() + mChildStarts[index+1]);
+    }
+    return lineage;
+}
+
+template<unsigned DIM>
+void CellTrajectoryStoreReader<DIM>::ReadTrajectory(unsigned cellId,
+                                                    std::vector<double>& rTimes,
+                                                    std::vector<c_vector<double, DIM> >& rPositions)
+{
+    unsigned index = GetIndex(cellId);
+    rTimes.clear();
+    rPositions.clear();
+    rTimes.reserve(mNumSamples[index]);
+    rPositions.reserve(mNumSamples[index]);
+
+    std::vector<double> samples;
+    for (uint64_t chunk=mChunkStarts[index]; chunk<mChunkStarts[index+1]; chunk++)
+    {
+        uint32_t header[2] = {0, 0};
+        mFile.clear();
+        mFile.seekg(mChunkOffsets[chunk]);
+        mFile.read(reinterpret_cast<char*>(header), sizeof(header));
+        if (mFile.fail() || header[0] != cellId)
+        {
+            EXCEPTION("Corrupt chunk in cell trajectory store");
+        }
+
+        samples.resize(header[1]*(1+DIM));
+        mFile.read(reinterpret_cast<char*>(&samples[0]), samples.size()*sizeof(double));
+        if (mFile.fail())
+        {
+            EXCEPTION("Corrupt chunk in cell trajectory store");
+        }
+
+        for (unsigned sample=0; sample<header[1]; sample++)
+        {
+            rTimes.push_back(samples[sample*(1+DIM)]);
+            c_vector<double, DIM> position;
+            for (unsigned d=0; d<DIM; d++)
+            {
+                position[d] = samples[sample*(1+DIM) + 1 + d];
+            }
+            rPositions.push_back(position);
+        }
+    }
+}
+
+// Explicit instantiation
+template class CellTrajectoryStoreReader<1>;
+template class CellTrajectoryStoreReader<2>;
+template class CellTrajectoryStoreReader<3>;
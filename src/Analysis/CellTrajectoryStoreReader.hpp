@@ -0,0 +1,150 @@
+#ifndef CELLTRAJECTORYSTOREREADER_HPP_
+#define CELLTRAJECTORYSTOREREADER_HPP_
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/utility.hpp>
+
+#include "UblasVectorInclude.hpp"
+
+/**
+ * A reader for the cell trajectory stores written by CellTrajectoryStoreModifier.
+ *
+ * On construction only the index at the end of the file is read, giving the birth,
+ * death and chunk offsets of every cell, from which the family tree is built. A cell's
+ * trajectory is then read on demand by seeking to its chunks, so following one lineage
+ * (GetLineage() then ReadTrajectory() for each of its cells) reads that lineage's data
+ * alone. A store without an index (e.g. one left by a simulation that was killed) cannot
+ * be read.
+ */
+template<unsigned DIM>
+class CellTrajectoryStoreReader : boost::noncopyable
+{
+private:
+
+    /** The store file. */
+    std::ifstream mFile;
+
+    /** The ID of each cell, in ascending order. */
+    std::vector<unsigned> mCellIds;
+
+    /** The ID of each cell's parent (UINT_MAX if unknown). */
+    std::vector<unsigned> mParentIds;
+
+    /** The birth time of each cell. */
+    std::vector<double> mBirthTimes;
+
+    /** The birth position of each cell, DIM values per cell. */
+    std::vector<double> mBirthPositions;
+
+    /** The death time of each cell (DBL_MAX if it was alive at the end of the simulation). */
+    std::vector<double> mDeathTimes;
+
+    /** The number of samples of each cell. */
+    std::vector<unsigned> mNumSamples;
+
+    /** The chunk offsets of all cells; those of cell i are mChunkOffsets[mChunkStarts[i]] to mChunkOffsets[mChunkStarts[i+1]-1]. */
+    std::vector<uint64_t> mChunkOffsets;
+
+    /** The start of each cell's chunk offsets in mChunkOffsets, with one extra entry for the end. */
+    std::vector<uint64_t> mChunkStarts;
+
+    /** The children of all cells, by index; those of cell i are mChildren[mChildStarts[i]] to mChildren[mChildStarts[i+1]-1]. */
+    std::vector<unsigned> mChildren;
+
+    /** The start of each cell's children in mChildren, with one extra entry for the end. */
+    std::vector<unsigned> mChildStarts;
+
+    /**
+     * @param cellId the ID of a cell
+     * @return the index of the cell in the store (throws if there is no such cell)
+     */
+    unsigned GetIndex(unsigned cellId) const;
+
+public:
+
+    /**
+     * Constructor. Throws if the file cannot be opened, is not a complete cell trajectory
+     * store, or was written by a simulation of another dimension.
+     *
+     * @param rFileName the full path of the store (e.g. .../cell_trajectories.bin)
+     */
+    CellTrajectoryStoreReader(const std::string& rFileName);
+
+    /**
+     * @return the number of cells in the store
+     */
+    unsigned GetNumCells() const;
+
+    /**
+     * @return the IDs of the cells in the store, in ascending order
+     */
+    const std::vector<unsigned>& rGetCellIds() const;
+
+    /**
+     * @param cellId the ID of a cell
+     * @return whether the cell is in the store
+     */
+    bool HasCell(unsigned cellId) const;
+
+    /**
+     * @param cellId the ID of a cell
+     * @return the ID of the cell's parent (UINT_MAX if unknown)
+     */
+    unsigned GetParentId(unsigned cellId) const;
+
+    /**
+     * @param cellId the ID of a cell
+     * @return the cell's birth time
+     */
+    double GetBirthTime(unsigned cellId) const;
+
+    /**
+     * @param cellId the ID of a cell
+     * @return the cell's birth position
+     */
+    c_vector<double, DIM> GetBirthPosition(unsigned cellId) const;
+
+    /**
+     * @param cellId the ID of a cell
+     * @return the cell's death time (DBL_MAX if it was alive at the end of the simulation)
+     */
+    double GetDeathTime(unsigned cellId) const;
+
+    /**
+     * @param cellId the ID of a cell
+     * @return the number of samples of the cell's position
+     */
+    unsigned GetNumSamples(unsigned cellId) const;
+
+    /**
+     * @param cellId the ID of a cell
+     * @return the IDs of the cell's children, in ascending order
+     */
+    std::vector<unsigned> GetChildren(unsigned cellId) const;
+
+    /**
+     * @param cellId the ID of a cell
+     * @return the IDs of the cell's ancestors in the store, from its parent back
+     */
+    std::vector<unsigned> GetAncestors(unsigned cellId) const;
+
+    /**
+     * @param rootCellId the ID of a cell
+     * @return the IDs of the cell and all its descendants, generation by generation
+     */
+    std::vector<unsigned> GetLineage(unsigned rootCellId) const;
+
+    /**
+     * Read the trajectory of a cell from its chunks.
+     *
+     * @param cellId the ID of the cell
+     * @param rTimes filled in with the time of each sample
+     * @param rPositions filled in with the position at each sample
+     */
+    void ReadTrajectory(unsigned cellId, std::vector<double>& rTimes, std::vector<c_vector<double, DIM> >& rPositions);
+};
+
+#endif /*CELLTRAJECTORYSTOREREADER_HPP_*/
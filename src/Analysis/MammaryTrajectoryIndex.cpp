@@ -0,0 +1,631 @@
+#include "MammaryTrajectoryIndex.hpp"
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <sys/stat.h>
+
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammarySnapshotReader.hpp"
+#include "SnapshotCompressor.hpp"
+#include "Exception.hpp"
+
+/** The size of the header of an index file. */
+static const uint64_t MAMMARY_TRAJECTORY_HEADER_SIZE = 56;
+
+/** Bit of the flags of an index file set if velocities are recorded. */
+static const uint32_t MAMMARY_TRAJECTORY_HAS_VELOCITIES = 1u;
+
+/**
+ * @param offset an offset in an index file
+ * @return the offset rounded up to a multiple of 8 bytes
+ */
+static uint64_t AlignOffset(uint64_t offset)
+{
+    return (offset + 7) & ~static_cast<uint64_t>(7);
+}
+
+/**
+ * Write an array to an index file, followed by padding up to a multiple of 8 bytes.
+ *
+ * @param rFile the file
+ * @param pData the array
+ * @param size the size of the array in bytes
+ */
+static void WritePaddedArray(std::ofstream& rFile, const void* pData, uint64_t size)
+{
+    static const char padding[8] = {0, 0, 0, 0, 0, 0, 0, 0};
+    if (size > 0)
+    {
+        rFile.write(static_cast<const char*>(pData), size);
+    }
+    rFile.write(padding, AlignOffset(size) - size);
+}
+
+MammaryTrajectoryIndex::MammaryTrajectoryIndex(const std::string& rFileName, unsigned dimension, bool rebuild)
+    : mDimension(0),
+      mNumSnapshots(0),
+      mNumRows(0),
+      mNumCells(0)
+{
+    if (IsIndexFile(rFileName))
+    {
+        MapIndexFile(rFileName);
+        return;
+    }
+
+    struct stat source_status;
+    if (stat(rFileName.c_str(), &source_status) != 0)
+    {
+        EXCEPTION("Could not open " + rFileName);
+    }
+    uint64_t source_size = static_cast<uint64_t>(source_status.st_size);
+    int64_t source_modification_time = static_cast<int64_t>(source_status.st_mtime);
+
+    // Use the existing index if it was built from the output file as it is now
+    std::string index_file_name = GetIndexFileName(rFileName);
+    if (!rebuild && IsIndexFile(index_file_name))
+    {
+        MapIndexFile(index_file_name);
+
+        uint64_t indexed_size;
+        int64_t indexed_modification_time;
+        memcpy(&indexed_size, mpFile->GetData() + 40, sizeof(uint64_t));
+        memcpy(&indexed_modification_time, mpFile->GetData() + 48, sizeof(int64_t));
+        if (indexed_size == source_size
+            && indexed_modification_time == source_modification_time
+            && (dimension == 0 || dimension == mDimension))
+        {
+            return;
+        }
+        mpFile.reset();
+    }
+
+    Columns columns;
+    unsigned found_dimension = ReadOutputFile(rFileName, dimension, columns);
+    WriteIndexFile(index_file_name, found_dimension, columns, source_size, source_modification_time);
+    MapIndexFile(index_file_name);
+}
+
+std::string MammaryTrajectoryIndex::GetIndexFileName(const std::string& rFileName)
+{
+    return rFileName + ".mtraj";
+}
+
+bool MammaryTrajectoryIndex::IsIndexFile(const std::string& rFileName)
+{
+    std::ifstream file(rFileName.c_str(), std::ios::in | std::ios::binary);
+    char magic[4];
+    file.read(magic, 4);
+    return !file.fail() && memcmp(magic, MAMMARY_TRAJECTORY_FILE_MAGIC, 4) == 0;
+}
+
+uint64_t MammaryTrajectoryIndex::GetArrayOffsets(unsigned dimension, bool hasVelocities, uint64_t numSnapshots,
+                                                 uint64_t numRows, uint64_t numCells, uint64_t* pOffsets)
+{
+    uint64_t sizes[10] = {numSnapshots*sizeof(double),
+                          (numSnapshots + 1)*sizeof(uint64_t),
+                          numRows*sizeof(uint32_t),
+                          numRows*sizeof(uint32_t),
+                          numRows*sizeof(uint8_t),
+                          numRows*dimension*sizeof(double),
+                          hasVelocities ? numRows*dimension*sizeof(double) : 0,
+                          numCells*sizeof(uint32_t),
+                          (numCells + 1)*sizeof(uint64_t),
+                          numRows*sizeof(uint64_t)};
+
+    uint64_t offset = MAMMARY_TRAJECTORY_HEADER_SIZE;
+    for (unsigned i=0; i<10; i++)
+    {
+        pOffsets[i] = offset;
+        offset += AlignOffset(sizes[i]);
+    }
+    return offset;
+}
+
+unsigned MammaryTrajectoryIndex::ReadOutputFile(const std::string& rFileName, unsigned dimension, Columns& rColumns)
+{
+    MemoryMappedFile file(rFileName);
+    const char* p_data = file.GetData();
+    uint64_t size = file.GetSize();
+
+    // A binary snapshot file records its dimension in its header
+    if (size >= 12 && memcmp(p_data, MAMMARY_SNAPSHOT_FILE_MAGIC, 4) == 0)
+    {
+        uint32_t snapshot_dimension;
+        memcpy(&snapshot_dimension, p_data + 8, sizeof(uint32_t));
+        switch (snapshot_dimension)
+        {
+            case 1:
+                ReadSnapshotFile<1>(rFileName, rColumns);
+                break;
+            case 2:
+                ReadSnapshotFile<2>(rFileName, rColumns);
+                break;
+            case 3:
+                ReadSnapshotFile<3>(rFileName, rColumns);
+                break;
+            default:
+                EXCEPTION("Unsupported dimension in snapshot file " + rFileName);
+        }
+        if (dimension != 0 && dimension != snapshot_dimension)
+        {
+            EXCEPTION("Snapshot file " + rFileName + " was written by a simulation of a different dimension");
+        }
+        return snapshot_dimension;
+    }
+
+    // Text compressed by the writers is a sequence of frames, one per output time
+    CompressionType compression = NO_COMPRESSION;
+    if (size >= 2 && static_cast<unsigned char>(p_data[0]) == 0x1f && static_cast<unsigned char>(p_data[1]) == 0x8b)
+    {
+        compression = GZIP_COMPRESSION;
+    }
+    else if (size >= 4 && memcmp(p_data, "\x28\xb5\x2f\xfd", 4) == 0)
+    {
+        compression = ZSTD_COMPRESSION;
+    }
+
+    if (compression == NO_COMPRESSION)
+    {
+        return ParseText(p_data, p_data + size, dimension, rColumns);
+    }
+
+    if (!SnapshotCompressor::IsAvailable(compression))
+    {
+        EXCEPTION(rFileName + " is compressed in a way not supported by this build");
+    }
+    std::string text;
+    std::string frame;
+    uint64_t offset = 0;
+    while (offset < size)
+    {
+        // Stop at a frame left incomplete at the end of the file
+        uint64_t frame_size = SnapshotCompressor::DecompressFrame(compression, p_data + offset, size - offset, frame);
+        if (frame_size == 0)
+        {
+            break;
+        }
+        text += frame;
+        offset += frame_size;
+    }
+    return ParseText(text.data(), text.data() + text.size(), dimension, rColumns);
+}
+
+template<unsigned DIM>
+void MammaryTrajectoryIndex::ReadSnapshotFile(const std::string& rFileName, Columns& rColumns)
+{
+    MammarySnapshotReader<DIM> reader(rFileName);
+    MammaryPopulationSnapshot<DIM> snapshot;
+
+    // Velocities are kept only if every snapshot has them
+    bool has_velocities = true;
+    rColumns.mSnapshotOffsets.push_back(0);
+    for (unsigned index=0; index<reader.GetNumSnapshots(); index++)
+    {
+        reader.ReadSnapshot(index, snapshot);
+        rColumns.mTimes.push_back(snapshot.GetTime());
+        has_velocities = has_velocities && snapshot.HasVelocities();
+
+        for (unsigned i=0; i<snapshot.GetNumCells(); i++)
+        {
+            rColumns.mCellIds.push_back(snapshot.rGetCellIds()[i]);
+            rColumns.mCellTypes.push_back(snapshot.rGetCellTypes()[i]);
+            for (unsigned d=0; d<DIM; d++)
+            {
+                rColumns.mPositions.push_back(snapshot.GetPosition(i, d));
+                if (has_velocities)
+                {
+                    rColumns.mVelocities.push_back(snapshot.GetVelocity(i, d));
+                }
+            }
+        }
+        rColumns.mSnapshotOffsets.push_back(rColumns.mCellIds.size());
+    }
+
+    if (!has_velocities)
+    {
+        rColumns.mVelocities.clear();
+    }
+}
+
+bool MammaryTrajectoryIndex::NextToken(const char*& rPosition, const char* pLineEnd, const char*& rTokenBegin)
+{
+    while (rPosition < pLineEnd && (*rPosition == ' ' || *rPosition == '\t' || *rPosition == '\r'))
+    {
+        rPosition++;
+    }
+    if (rPosition == pLineEnd)
+    {
+        return false;
+    }
+    rTokenBegin = rPosition;
+    while (rPosition < pLineEnd && *rPosition != ' ' && *rPosition != '\t' && *rPosition != '\r')
+    {
+        rPosition++;
+    }
+    return true;
+}
+
+bool MammaryTrajectoryIndex::ParseNumber(const char* pBegin, const char* pEnd, double& rValue)
+{
+    // Copy the token, since the text need not be null-terminated
+    char buffer[64];
+    size_t length = pEnd - pBegin;
+    if (length == 0 || length >= sizeof(buffer))
+    {
+        return false;
+    }
+    memcpy(buffer, pBegin, length);
+    buffer[length] = '\0';
+
+    char* p_end;
+    rValue = strtod(buffer, &p_end);
+    return p_end == buffer + length;
+}
+
+unsigned MammaryTrajectoryIndex::ParseText(const char* pBegin, const char* pEnd, unsigned dimension, Columns& rColumns)
+{
+    bool format_known = false;
+    bool is_location_file = false;
+
+    rColumns.mSnapshotOffsets.push_back(0);
+    const char* p_line = pBegin;
+    while (p_line < pEnd)
+    {
+        const char* p_line_end = static_cast<const char*>(memchr(p_line, '\n', pEnd - p_line));
+        if (!p_line_end)
+        {
+            p_line_end = pEnd;
+        }
+
+        const char* p_position = p_line;
+        const char* p_token;
+        double time;
+        if (NextToken(p_position, p_line_end, p_token) && ParseNumber(p_token, p_position, time))
+        {
+            std::vector<const char*> tokens;
+            std::vector<const char*> token_ends;
+            while (NextToken(p_position, p_line_end, p_token))
+            {
+                tokens.push_back(p_token);
+                token_ends.push_back(p_position);
+            }
+
+            // Recognise the format, and if necessary the dimension, from the first cell
+            double value;
+            if (!format_known && !tokens.empty())
+            {
+                is_location_file = !ParseNumber(tokens[0], token_ends[0], value);
+                if (is_location_file && dimension == 0)
+                {
+                    unsigned num_numbers = 0;
+                    while (1 + num_numbers < tokens.size()
+                           && ParseNumber(tokens[1 + num_numbers], token_ends[1 + num_numbers], value))
+                    {
+                        num_numbers++;
+                    }
+                    dimension = num_numbers - 1;
+                }
+                if (dimension == 0 || dimension > 3)
+                {
+                    EXCEPTION("The space dimension must be given to index this output file");
+                }
+                format_known = true;
+            }
+
+            unsigned tokens_per_cell = is_location_file ? 2 + dimension : 1 + 2*dimension;
+            if (format_known && tokens.size() % tokens_per_cell != 0)
+            {
+                EXCEPTION("Unexpected number of values in output file line at time " + std::to_string(time));
+            }
+
+            for (unsigned first=0; first<tokens.size(); first+=tokens_per_cell)
+            {
+                unsigned next = first;
+                uint8_t cell_type = NO_MAMMARY_CELL_TYPE;
+                if (is_location_file)
+                {
+                    std::string type_name(tokens[next], token_ends[next]);
+                    if (type_name == "Luminal")
+                    {
+                        cell_type = LUMINAL_CELL;
+                    }
+                    else if (type_name == "Myoepithelial")
+                    {
+                        cell_type = MYOEPITHELIAL_CELL;
+                    }
+                    else if (type_name == "LSC")
+                    {
+                        cell_type = LUMINAL_STEM_CELL;
+                    }
+                    else if (type_name == "MSC")
+                    {
+                        cell_type = MYOEPITHELIAL_STEM_CELL;
+                    }
+                    next++;
+                }
+
+                double cell_id;
+                if (!ParseNumber(tokens[next], token_ends[next], cell_id))
+                {
+                    EXCEPTION("Could not read a cell ID from output file line at time " + std::to_string(time));
+                }
+                next++;
+                rColumns.mCellIds.push_back(static_cast<uint32_t>(cell_id));
+                rColumns.mCellTypes.push_back(cell_type);
+
+                for (unsigned i=0; i<(is_location_file ? 1u : 2u)*dimension; i++, next++)
+                {
+                    if (!ParseNumber(tokens[next], token_ends[next], value))
+                    {
+                        EXCEPTION("Could not read a number from output file line at time " + std::to_string(time));
+                    }
+                    if (i < dimension)
+                    {
+                        rColumns.mPositions.push_back(value);
+                    }
+                    else
+                    {
+                        rColumns.mVelocities.push_back(value);
+                    }
+                }
+            }
+
+            rColumns.mTimes.push_back(time);
+            rColumns.mSnapshotOffsets.push_back(rColumns.mCellIds.size());
+        }
+
+        p_line = p_line_end + 1;
+    }
+
+    if (!format_known && dimension == 0)
+    {
+        EXCEPTION("The space dimension must be given to index an output file with no cells");
+    }
+    return dimension;
+}
+
+void MammaryTrajectoryIndex::WriteIndexFile(const std::string& rFileName, unsigned dimension, const Columns& rColumns,
+                                            uint64_t sourceSize, int64_t sourceModificationTime)
+{
+    uint64_t num_snapshots = rColumns.mTimes.size();
+    uint64_t num_rows = rColumns.mCellIds.size();
+    bool has_velocities = !rColumns.mVelocities.empty();
+
+    std::vector<uint32_t> row_snapshots(num_rows);
+    for (uint64_t index=0; index<num_snapshots; index++)
+    {
+        std::fill(row_snapshots.begin() + rColumns.mSnapshotOffsets[index],
+                  row_snapshots.begin() + rColumns.mSnapshotOffsets[index + 1],
+                  static_cast<uint32_t>(index));
+    }
+
+    // Group the rows by cell; a stable sort keeps each cell's rows in time order
+    std::vector<uint64_t> cell_rows(num_rows);
+    for (uint64_t row=0; row<num_rows; row++)
+    {
+        cell_rows[row] = row;
+    }
+    const std::vector<uint32_t>& r_row_cell_ids = rColumns.mCellIds;
+    std::stable_sort(cell_rows.begin(), cell_rows.end(),
+                     [&r_row_cell_ids](uint64_t a, uint64_t b) { return r_row_cell_ids[a] < r_row_cell_ids[b]; });
+
+    std::vector<uint32_t> cell_ids;
+    std::vector<uint64_t> cell_offsets;
+    for (uint64_t i=0; i<num_rows; i++)
+    {
+        uint32_t cell_id = r_row_cell_ids[cell_rows[i]];
+        if (cell_ids.empty() || cell_ids.back() != cell_id)
+        {
+            cell_ids.push_back(cell_id);
+            cell_offsets.push_back(i);
+        }
+    }
+    cell_offsets.push_back(num_rows);
+    uint64_t num_cells = cell_ids.size();
+
+    std::string temporary_file_name = rFileName + ".tmp";
+    std::ofstream file(temporary_file_name.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+    if (!file.is_open())
+    {
+        EXCEPTION("Could not write the index file " + temporary_file_name);
+    }
+
+    uint32_t version = MAMMARY_TRAJECTORY_FORMAT_VERSION;
+    uint32_t dimension_32 = dimension;
+    uint32_t flags = has_velocities ? MAMMARY_TRAJECTORY_HAS_VELOCITIES : 0u;
+    file.write(MAMMARY_TRAJECTORY_FILE_MAGIC, 4);
+    file.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(&dimension_32), sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(&flags), sizeof(uint32_t));
+    file.write(reinterpret_cast<const char*>(&num_snapshots), sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(&num_rows), sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(&num_cells), sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(&sourceSize), sizeof(uint64_t));
+    file.write(reinterpret_cast<const char*>(&sourceModificationTime), sizeof(int64_t));
+
+    // The arrays are written in the order given by GetArrayOffsets()
+    WritePaddedArray(file, rColumns.mTimes.data(), num_snapshots*sizeof(double));
+    WritePaddedArray(file, rColumns.mSnapshotOffsets.data(), (num_snapshots + 1)*sizeof(uint64_t));
+    WritePaddedArray(file, row_snapshots.data(), num_rows*sizeof(uint32_t));
+    WritePaddedArray(file, rColumns.mCellIds.data(), num_rows*sizeof(uint32_t));
+    WritePaddedArray(file, rColumns.mCellTypes.data(), num_rows*sizeof(uint8_t));
+    WritePaddedArray(file, rColumns.mPositions.data(), num_rows*dimension*sizeof(double));
+    if (has_velocities)
+    {
+        WritePaddedArray(file, rColumns.mVelocities.data(), num_rows*dimension*sizeof(double));
+    }
+    WritePaddedArray(file, cell_ids.data(), num_cells*sizeof(uint32_t));
+    WritePaddedArray(file, cell_offsets.data(), (num_cells + 1)*sizeof(uint64_t));
+    WritePaddedArray(file, cell_rows.data(), num_rows*sizeof(uint64_t));
+
+    file.close();
+    if (file.fail() || std::rename(temporary_file_name.c_str(), rFileName.c_str()) != 0)
+    {
+        std::remove(temporary_file_name.c_str());
+        EXCEPTION("Could not write the index file " + rFileName);
+    }
+}
+
+void MammaryTrajectoryIndex::MapIndexFile(const std::string& rFileName)
+{
+    mpFile.reset(new MemoryMappedFile(rFileName));
+    const char* p_data = mpFile->GetData();
+    uint64_t size = mpFile->GetSize();
+    if (size < MAMMARY_TRAJECTORY_HEADER_SIZE || memcmp(p_data, MAMMARY_TRAJECTORY_FILE_MAGIC, 4) != 0)
+    {
+        EXCEPTION(rFileName + " is not a trajectory index file");
+    }
+
+    uint32_t version;
+    uint32_t dimension;
+    uint32_t flags;
+    memcpy(&version, p_data + 4, sizeof(uint32_t));
+    memcpy(&dimension, p_data + 8, sizeof(uint32_t));
+    memcpy(&flags, p_data + 12, sizeof(uint32_t));
+    memcpy(&mNumSnapshots, p_data + 16, sizeof(uint64_t));
+    memcpy(&mNumRows, p_data + 24, sizeof(uint64_t));
+    memcpy(&mNumCells, p_data + 32, sizeof(uint64_t));
+    if (version == 0 || version > MAMMARY_TRAJECTORY_FORMAT_VERSION)
+    {
+        EXCEPTION("Unsupported trajectory index file format version in " + rFileName);
+    }
+    mDimension = dimension;
+    bool has_velocities = (flags & MAMMARY_TRAJECTORY_HAS_VELOCITIES) != 0;
+
+    uint64_t offsets[10];
+    if (GetArrayOffsets(mDimension, has_velocities, mNumSnapshots, mNumRows, mNumCells, offsets) > size)
+    {
+        EXCEPTION("Trajectory index file " + rFileName + " is truncated");
+    }
+
+    // The mapping is page-aligned and each array starts on a multiple of 8 bytes, so the arrays can be used in place
+    mpTimes = reinterpret_cast<const double*>(p_data + offsets[0]);
+    mpSnapshotOffsets = reinterpret_cast<const uint64_t*>(p_data + offsets[1]);
+    mpRowSnapshots = reinterpret_cast<const uint32_t*>(p_data + offsets[2]);
+    mpRowCellIds = reinterpret_cast<const uint32_t*>(p_data + offsets[3]);
+    mpRowCellTypes = reinterpret_cast<const uint8_t*>(p_data + offsets[4]);
+    mpPositions = reinterpret_cast<const double*>(p_data + offsets[5]);
+    mpVelocities = has_velocities ? reinterpret_cast<const double*>(p_data + offsets[6]) : NULL;
+    mpCellIds = reinterpret_cast<const uint32_t*>(p_data + offsets[7]);
+    mpCellOffsets = reinterpret_cast<const uint64_t*>(p_data + offsets[8]);
+    mpCellRows = reinterpret_cast<const uint64_t*>(p_data + offsets[9]);
+}
+
+unsigned MammaryTrajectoryIndex::GetDimension() const
+{
+    return mDimension;
+}
+
+bool MammaryTrajectoryIndex::HasVelocities() const
+{
+    return mpVelocities != NULL;
+}
+
+uint64_t MammaryTrajectoryIndex::GetNumSnapshots() const
+{
+    return mNumSnapshots;
+}
+
+uint64_t MammaryTrajectoryIndex::GetNumRows() const
+{
+    return mNumRows;
+}
+
+uint64_t MammaryTrajectoryIndex::GetNumCells() const
+{
+    return mNumCells;
+}
+
+double MammaryTrajectoryIndex::GetTime(uint64_t index) const
+{
+    assert(index < mNumSnapshots);
+    return mpTimes[index];
+}
+
+uint64_t MammaryTrajectoryIndex::FindSnapshot(double time) const
+{
+    const double* p_after = std::upper_bound(mpTimes, mpTimes + mNumSnapshots, time);
+    return (p_after == mpTimes) ? 0 : (p_after - mpTimes) - 1;
+}
+
+MammaryTrajectorySnapshotView MammaryTrajectoryIndex::GetSnapshot(uint64_t index) const
+{
+    assert(index < mNumSnapshots);
+    uint64_t first_row = mpSnapshotOffsets[index];
+    return MammaryTrajectorySnapshotView(mpTimes[index],
+                                         mpSnapshotOffsets[index + 1] - first_row,
+                                         mDimension,
+                                         mpRowCellIds + first_row,
+                                         mpRowCellTypes + first_row,
+                                         mpPositions + first_row*mDimension,
+                                         mpVelocities ? mpVelocities + first_row*mDimension : NULL);
+}
+
+uint32_t MammaryTrajectoryIndex::GetCellId(uint64_t index) const
+{
+    assert(index < mNumCells);
+    return mpCellIds[index];
+}
+
+MammaryTrajectoryCellView MammaryTrajectoryIndex::GetTrajectory(uint32_t cellId) const
+{
+    const uint32_t* p_cell = std::lower_bound(mpCellIds, mpCellIds + mNumCells, cellId);
+    uint64_t num_points = 0;
+    const uint64_t* p_rows = mpCellRows;
+    if (p_cell != mpCellIds + mNumCells && *p_cell == cellId)
+    {
+        uint64_t cell_index = p_cell - mpCellIds;
+        p_rows = mpCellRows + mpCellOffsets[cell_index];
+        num_points = mpCellOffsets[cell_index + 1] - mpCellOffsets[cell_index];
+    }
+    return MammaryTrajectoryCellView(num_points, mDimension, p_rows, mpRowSnapshots, mpTimes,
+                                     mpRowCellTypes, mpPositions, mpVelocities);
+}
+
+void MammaryTrajectoryIndex::ExportColumns(const std::string& rDirectory) const
+{
+    struct Column
+    {
+        const char* mpName;
+        const void* mpData;
+        uint64_t mSize;
+    };
+    Column columns[7] = {{"times.f64", mpTimes, mNumSnapshots*sizeof(double)},
+                         {"snapshot_offsets.u64", mpSnapshotOffsets, (mNumSnapshots + 1)*sizeof(uint64_t)},
+                         {"snapshots.u32", mpRowSnapshots, mNumRows*sizeof(uint32_t)},
+                         {"cell_ids.u32", mpRowCellIds, mNumRows*sizeof(uint32_t)},
+                         {"cell_types.u8", mpRowCellTypes, mNumRows*sizeof(uint8_t)},
+                         {"positions.f64", mpPositions, mNumRows*mDimension*sizeof(double)},
+                         {"velocities.f64", mpVelocities, mpVelocities ? mNumRows*mDimension*sizeof(double) : 0}};
+
+    for (unsigned i=0; i<7; i++)
+    {
+        if (!columns[i].mpData)
+        {
+            continue;
+        }
+        std::string file_name = rDirectory + "/" + columns[i].mpName;
+        std::ofstream file(file_name.c_str(), std::ios::out | std::ios::trunc | std::ios::binary);
+        file.write(static_cast<const char*>(columns[i].mpData), columns[i].mSize);
+        file.close();
+        if (file.fail())
+        {
+            EXCEPTION("Could not write " + file_name);
+        }
+    }
+
+    std::string file_name = rDirectory + "/columns.txt";
+    std::ofstream file(file_name.c_str());
+    file << "dimension " << mDimension << "\n"
+         << "snapshots " << mNumSnapshots << "\n"
+         << "rows " << mNumRows << "\n"
+         << "velocities " << (mpVelocities ? 1 : 0) << "\n";
+    file.close();
+    if (file.fail())
+    {
+        EXCEPTION("Could not write " + file_name);
+    }
+}
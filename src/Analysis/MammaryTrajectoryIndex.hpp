@@ -0,0 +1,514 @@
+#ifndef MAMMARYTRAJECTORYINDEX_HPP_
+#define MAMMARYTRAJECTORYINDEX_HPP_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/scoped_ptr.hpp>
+#include <boost/utility.hpp>
+
+#include "MemoryMappedFile.hpp"
+
+/** The magic number at the start of a trajectory index file. */
+const char MAMMARY_TRAJECTORY_FILE_MAGIC[4] = {'M', 'T', 'R', 'J'};
+
+/** The version of the trajectory index file format written by this code. */
+const uint32_t MAMMARY_TRAJECTORY_FORMAT_VERSION = 1;
+
+/**
+ * A view of one snapshot of a MammaryTrajectoryIndex, pointing into the mapped index file.
+ * The cells of the snapshot are rows 0 to GetNumCells()-1 of the view.
+ */
+class MammaryTrajectorySnapshotView
+{
+private:
+
+    /** The time of the snapshot. */
+    double mTime;
+
+    /** The number of cells in the snapshot. */
+    uint64_t mNumCells;
+
+    /** The space dimension. */
+    unsigned mDimension;
+
+    /** The cell IDs. */
+    const uint32_t* mpCellIds;
+
+    /** The cell types (MammaryCellType values). */
+    const uint8_t* mpCellTypes;
+
+    /** The positions, mDimension per cell. */
+    const double* mpPositions;
+
+    /** The velocities, mDimension per cell (NULL if not recorded). */
+    const double* mpVelocities;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param time the time of the snapshot
+     * @param numCells the number of cells in the snapshot
+     * @param dimension the space dimension
+     * @param pCellIds the cell IDs
+     * @param pCellTypes the cell types
+     * @param pPositions the positions
+     * @param pVelocities the velocities (NULL if not recorded)
+     */
+    MammaryTrajectorySnapshotView(double time, uint64_t numCells, unsigned dimension,
+                                  const uint32_t* pCellIds, const uint8_t* pCellTypes,
+                                  const double* pPositions, const double* pVelocities)
+        : mTime(time), mNumCells(numCells), mDimension(dimension),
+          mpCellIds(pCellIds), mpCellTypes(pCellTypes), mpPositions(pPositions), mpVelocities(pVelocities)
+    {
+    }
+
+    /**
+     * @return the time of the snapshot
+     */
+    double GetTime() const
+    {
+        return mTime;
+    }
+
+    /**
+     * @return the number of cells in the snapshot
+     */
+    uint64_t GetNumCells() const
+    {
+        return mNumCells;
+    }
+
+    /**
+     * @param row a row of the snapshot
+     * @return the ID of the cell
+     */
+    uint32_t GetCellId(uint64_t row) const
+    {
+        return mpCellIds[row];
+    }
+
+    /**
+     * @param row a row of the snapshot
+     * @return the type of the cell
+     */
+    uint8_t GetCellType(uint64_t row) const
+    {
+        return mpCellTypes[row];
+    }
+
+    /**
+     * @param row a row of the snapshot
+     * @return the position of the cell (mDimension values)
+     */
+    const double* GetPosition(uint64_t row) const
+    {
+        return mpPositions + row*mDimension;
+    }
+
+    /**
+     * @param row a row of the snapshot
+     * @return the velocity of the cell (mDimension values), or NULL if not recorded
+     */
+    const double* GetVelocity(uint64_t row) const
+    {
+        return mpVelocities ? mpVelocities + row*mDimension : NULL;
+    }
+};
+
+/**
+ * A view of the trajectory of one cell of a MammaryTrajectoryIndex, pointing into the
+ * mapped index file. The points of the trajectory are in time order.
+ */
+class MammaryTrajectoryCellView
+{
+private:
+
+    /** The number of points in the trajectory. */
+    uint64_t mNumPoints;
+
+    /** The space dimension. */
+    unsigned mDimension;
+
+    /** The rows of the index holding the points of the trajectory. */
+    const uint64_t* mpRows;
+
+    /** The snapshot of each row of the index. */
+    const uint32_t* mpRowSnapshots;
+
+    /** The time of each snapshot. */
+    const double* mpTimes;
+
+    /** The cell type of each row of the index. */
+    const uint8_t* mpCellTypes;
+
+    /** The position of each row of the index. */
+    const double* mpPositions;
+
+    /** The velocity of each row of the index (NULL if not recorded). */
+    const double* mpVelocities;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param numPoints the number of points in the trajectory
+     * @param dimension the space dimension
+     * @param pRows the rows holding the points of the trajectory
+     * @param pRowSnapshots the snapshot of each row
+     * @param pTimes the time of each snapshot
+     * @param pCellTypes the cell type of each row
+     * @param pPositions the position of each row
+     * @param pVelocities the velocity of each row (NULL if not recorded)
+     */
+    MammaryTrajectoryCellView(uint64_t numPoints, unsigned dimension, const uint64_t* pRows,
+                              const uint32_t* pRowSnapshots, const double* pTimes, const uint8_t* pCellTypes,
+                              const double* pPositions, const double* pVelocities)
+        : mNumPoints(numPoints), mDimension(dimension), mpRows(pRows), mpRowSnapshots(pRowSnapshots),
+          mpTimes(pTimes), mpCellTypes(pCellTypes), mpPositions(pPositions), mpVelocities(pVelocities)
+    {
+    }
+
+    /**
+     * @return the number of points in the trajectory (0 if the cell was not found)
+     */
+    uint64_t GetNumPoints() const
+    {
+        return mNumPoints;
+    }
+
+    /**
+     * @param point a point of the trajectory
+     * @return the index of the snapshot at the point
+     */
+    uint32_t GetSnapshotIndex(uint64_t point) const
+    {
+        return mpRowSnapshots[mpRows[point]];
+    }
+
+    /**
+     * @param point a point of the trajectory
+     * @return the time at the point
+     */
+    double GetTime(uint64_t point) const
+    {
+        return mpTimes[GetSnapshotIndex(point)];
+    }
+
+    /**
+     * @param point a point of the trajectory
+     * @return the type of the cell at the point
+     */
+    uint8_t GetCellType(uint64_t point) const
+    {
+        return mpCellTypes[mpRows[point]];
+    }
+
+    /**
+     * @param point a point of the trajectory
+     * @return the position of the cell at the point (mDimension values)
+     */
+    const double* GetPosition(uint64_t point) const
+    {
+        return mpPositions + mpRows[point]*mDimension;
+    }
+
+    /**
+     * @param point a point of the trajectory
+     * @return the velocity of the cell at the point (mDimension values), or NULL if not recorded
+     */
+    const double* GetVelocity(uint64_t point) const
+    {
+        return mpVelocities ? mpVelocities + mpRows[point]*mDimension : NULL;
+    }
+};
+
+/**
+ * Random access to the output of a simulation by snapshot and by cell, without parsing it again.
+ *
+ * The first time an output file is opened, it is read once and converted into a columnar
+ * index file next to it (with the extension .mtraj appended), which is then memory mapped.
+ * Later openings map the index straight away, unless the output file has changed since
+ * (judged by its size and modification time). Snapshots and trajectories are returned as
+ * views into the mapping, so nothing is copied.
+ *
+ * The output files understood are
+ * - location.dat, written by CellLocationWriter (IDs, types and positions);
+ * - velocity.dat, written by CellVelocityWriter (IDs, positions and velocities);
+ * - mammary_snapshots.bin, written by MammarySnapshotWriter (IDs, types, positions and
+ *   velocities, if written);
+ * - an index file itself.
+ * Text output compressed by the writers (see SnapshotCompressor) is decompressed.
+ * results.viztypes holds no cell IDs, so cannot be indexed.
+ *
+ * The index file consists of a header
+ *
+ * ['MTRJ' (4 chars)] [format version (uint32)] [space dimension D (uint32)] [flags (uint32)]
+ * [number of snapshots S (uint64)] [number of rows R (uint64)] [number of distinct cells C (uint64)]
+ * [size of the output file (uint64)] [modification time of the output file (int64)]
+ *
+ * followed by these arrays, each starting on a multiple of 8 bytes:
+ *
+ * [times (S doubles)] [first row of each snapshot, and R (S+1 x uint64)]
+ * [snapshot of each row (R x uint32)] [cell ID of each row (R x uint32)] [cell type of each row (R x uint8)]
+ * [positions (R x D doubles)] [velocities (R x D doubles), if bit 0 of the flags is set]
+ * [distinct cell IDs, ascending (C x uint32)] [first entry of each cell in the next array, and R (C+1 x uint64)]
+ * [rows of each cell, in time order (R x uint64)]
+ *
+ * in native byte order. Each row is one cell in one snapshot; the rows of a snapshot are
+ * contiguous, and positions and velocities are stored cell by cell.
+ */
+class MammaryTrajectoryIndex : boost::noncopyable
+{
+private:
+
+    /**
+     * The columns of an index, as built in memory from an output file.
+     */
+    struct Columns
+    {
+        /** The time of each snapshot. */
+        std::vector<double> mTimes;
+
+        /** The first row of each snapshot, followed by the number of rows. */
+        std::vector<uint64_t> mSnapshotOffsets;
+
+        /** The cell ID of each row. */
+        std::vector<uint32_t> mCellIds;
+
+        /** The cell type of each row. */
+        std::vector<uint8_t> mCellTypes;
+
+        /** The position of each row. */
+        std::vector<double> mPositions;
+
+        /** The velocity of each row (empty if not recorded). */
+        std::vector<double> mVelocities;
+    };
+
+    /** The mapped index file. */
+    boost::scoped_ptr<MemoryMappedFile> mpFile;
+
+    /** The space dimension. */
+    unsigned mDimension;
+
+    /** The number of snapshots. */
+    uint64_t mNumSnapshots;
+
+    /** The number of rows (cells summed over snapshots). */
+    uint64_t mNumRows;
+
+    /** The number of distinct cells. */
+    uint64_t mNumCells;
+
+    /** The time of each snapshot. */
+    const double* mpTimes;
+
+    /** The first row of each snapshot, followed by mNumRows. */
+    const uint64_t* mpSnapshotOffsets;
+
+    /** The snapshot of each row. */
+    const uint32_t* mpRowSnapshots;
+
+    /** The cell ID of each row. */
+    const uint32_t* mpRowCellIds;
+
+    /** The cell type of each row. */
+    const uint8_t* mpRowCellTypes;
+
+    /** The position of each row. */
+    const double* mpPositions;
+
+    /** The velocity of each row (NULL if not recorded). */
+    const double* mpVelocities;
+
+    /** The distinct cell IDs, in ascending order. */
+    const uint32_t* mpCellIds;
+
+    /** The first entry of each cell in mpCellRows, followed by mNumRows. */
+    const uint64_t* mpCellOffsets;
+
+    /** The rows of each cell, in time order. */
+    const uint64_t* mpCellRows;
+
+    /**
+     * Read an output file into columns.
+     *
+     * @param rFileName the full path of the output file
+     * @param dimension the space dimension (0 to find it from the file, where possible)
+     * @param rColumns filled in with the columns
+     * @return the space dimension
+     */
+    static unsigned ReadOutputFile(const std::string& rFileName, unsigned dimension, Columns& rColumns);
+
+    /**
+     * Read a snapshot file written by MammarySnapshotWriter into columns.
+     *
+     * @param rFileName the full path of the snapshot file
+     * @param rColumns filled in with the columns
+     */
+    template<unsigned DIM>
+    static void ReadSnapshotFile(const std::string& rFileName, Columns& rColumns);
+
+    /**
+     * Parse the text written by CellLocationWriter or CellVelocityWriter into columns.
+     * The format is recognised from the first cell: a location file starts each cell
+     * with the name of its type.
+     *
+     * @param pBegin the start of the text
+     * @param pEnd the end of the text
+     * @param dimension the space dimension (0 to find it from a location file)
+     * @param rColumns filled in with the columns
+     * @return the space dimension
+     */
+    static unsigned ParseText(const char* pBegin, const char* pEnd, unsigned dimension, Columns& rColumns);
+
+    /**
+     * Find the next token (delimited by spaces or tabs) on a line.
+     *
+     * @param rPosition the position from which to search, moved past the token
+     * @param pLineEnd the end of the line
+     * @param rTokenBegin filled in with the start of the token
+     * @return whether a token was found
+     */
+    static bool NextToken(const char*& rPosition, const char* pLineEnd, const char*& rTokenBegin);
+
+    /**
+     * @param pBegin the start of a token
+     * @param pEnd the end of the token
+     * @param rValue filled in with the value of the token
+     * @return whether the whole token is a number
+     */
+    static bool ParseNumber(const char* pBegin, const char* pEnd, double& rValue);
+
+    /**
+     * Find where each array of an index file starts.
+     *
+     * @param dimension the space dimension
+     * @param hasVelocities whether velocities are recorded
+     * @param numSnapshots the number of snapshots
+     * @param numRows the number of rows
+     * @param numCells the number of distinct cells
+     * @param pOffsets filled in with the offsets of the ten arrays, in the order they are stored
+     *     (that of the velocities is the same as that of the next array if there are none)
+     * @return the size of the index file in bytes
+     */
+    static uint64_t GetArrayOffsets(unsigned dimension, bool hasVelocities, uint64_t numSnapshots,
+                                    uint64_t numRows, uint64_t numCells, uint64_t* pOffsets);
+
+    /**
+     * Write an index file. The file is written under a temporary name and then renamed,
+     * so that an interrupted build never leaves a partial index.
+     *
+     * @param rFileName the full path of the index file
+     * @param dimension the space dimension
+     * @param rColumns the columns
+     * @param sourceSize the size of the output file
+     * @param sourceModificationTime the modification time of the output file
+     */
+    static void WriteIndexFile(const std::string& rFileName, unsigned dimension, const Columns& rColumns,
+                               uint64_t sourceSize, int64_t sourceModificationTime);
+
+    /**
+     * Map an index file and set up the pointers to its arrays. Throws if it is not a valid index file.
+     *
+     * @param rFileName the full path of the index file
+     */
+    void MapIndexFile(const std::string& rFileName);
+
+    /**
+     * @param rFileName the full path of a file
+     * @return whether the file is an index file
+     */
+    static bool IsIndexFile(const std::string& rFileName);
+
+public:
+
+    /**
+     * Constructor. Builds the index of an output file if it does not yet exist or is out of
+     * date, and maps it.
+     *
+     * @param rFileName the full path of the output file, or of an index file
+     * @param dimension the space dimension; needed only for velocity.dat, and otherwise
+     *     found from the file (defaults to 0, i.e. found from the file)
+     * @param rebuild whether to rebuild the index even if it is up to date (defaults to false)
+     */
+    MammaryTrajectoryIndex(const std::string& rFileName, unsigned dimension=0, bool rebuild=false);
+
+    /**
+     * @param rFileName the full path of an output file
+     * @return the full path of its index file
+     */
+    static std::string GetIndexFileName(const std::string& rFileName);
+
+    /**
+     * @return the space dimension
+     */
+    unsigned GetDimension() const;
+
+    /**
+     * @return whether velocities are recorded
+     */
+    bool HasVelocities() const;
+
+    /**
+     * @return the number of snapshots
+     */
+    uint64_t GetNumSnapshots() const;
+
+    /**
+     * @return the number of rows (cells summed over snapshots)
+     */
+    uint64_t GetNumRows() const;
+
+    /**
+     * @return the number of distinct cells
+     */
+    uint64_t GetNumCells() const;
+
+    /**
+     * @param index the index of a snapshot
+     * @return the time of the snapshot
+     */
+    double GetTime(uint64_t index) const;
+
+    /**
+     * @param time a time
+     * @return the index of the last snapshot at or before the given time (or 0 if there is none)
+     */
+    uint64_t FindSnapshot(double time) const;
+
+    /**
+     * @param index the index of a snapshot
+     * @return a view of the snapshot
+     */
+    MammaryTrajectorySnapshotView GetSnapshot(uint64_t index) const;
+
+    /**
+     * @param index the index of a distinct cell, from 0 to GetNumCells()-1
+     * @return the ID of the cell (in ascending order of index)
+     */
+    uint32_t GetCellId(uint64_t index) const;
+
+    /**
+     * @param cellId the ID of a cell
+     * @return a view of the cell's trajectory, which has no points if the cell never appears
+     */
+    MammaryTrajectoryCellView GetTrajectory(uint32_t cellId) const;
+
+    /**
+     * Export the columns of the index as separate raw files in a directory, one per array
+     * (times.f64, snapshot_offsets.u64, snapshots.u32, cell_ids.u32, cell_types.u8,
+     * positions.f64 and, if recorded, velocities.f64), together with a text file
+     * (columns.txt) giving the dimension and the number of snapshots and rows. Each file
+     * can be read with a single call, e.g. fread in MATLAB.
+     *
+     * @param rDirectory the full path of an existing directory
+     */
+    void ExportColumns(const std::string& rDirectory) const;
+};
+
+#endif /*MAMMARYTRAJECTORYINDEX_HPP_*/
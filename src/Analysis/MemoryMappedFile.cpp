@@ -0,0 +1,58 @@
+#include "MemoryMappedFile.hpp"
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "Exception.hpp"
+
+MemoryMappedFile::MemoryMappedFile(const std::string& rFileName)
+    : mpData(NULL),
+      mSize(0)
+{
+    int fd = open(rFileName.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        EXCEPTION("Could not open " + rFileName);
+    }
+
+    struct stat file_status;
+    if (fstat(fd, &file_status) != 0)
+    {
+        close(fd);
+        EXCEPTION("Could not find the size of " + rFileName);
+    }
+    mSize = static_cast<uint64_t>(file_status.st_size);
+
+    // An empty file cannot be mapped, and needs no mapping
+    if (mSize > 0)
+    {
+        void* p_data = mmap(NULL, mSize, PROT_READ, MAP_SHARED, fd, 0);
+        if (p_data == MAP_FAILED)
+        {
+            close(fd);
+            EXCEPTION("Could not map " + rFileName + " into memory");
+        }
+        mpData = p_data;
+    }
+
+    // The mapping remains valid once the file is closed
+    close(fd);
+}
+
+MemoryMappedFile::~MemoryMappedFile()
+{
+    if (mpData)
+    {
+        munmap(mpData, mSize);
+    }
+}
+
+const char* MemoryMappedFile::GetData() const
+{
+    return static_cast<const char*>(mpData);
+}
+
+uint64_t MemoryMappedFile::GetSize() const
+{
+    return mSize;
+}
@@ -0,0 +1,48 @@
+#ifndef MEMORYMAPPEDFILE_HPP_
+#define MEMORYMAPPEDFILE_HPP_
+
+#include <string>
+#include <stdint.h>
+#include <boost/utility.hpp>
+
+/**
+ * A file mapped read-only into memory, so that its contents can be accessed in place
+ * without being read into buffers. Pages are loaded by the operating system as they are
+ * touched, and shared between processes mapping the same file.
+ */
+class MemoryMappedFile : boost::noncopyable
+{
+private:
+
+    /** The start of the mapping (NULL for an empty file). */
+    void* mpData;
+
+    /** The size of the file in bytes. */
+    uint64_t mSize;
+
+public:
+
+    /**
+     * Constructor. Throws if the file cannot be opened or mapped.
+     *
+     * @param rFileName the full path of the file
+     */
+    MemoryMappedFile(const std::string& rFileName);
+
+    /**
+     * Destructor, which unmaps the file.
+     */
+    ~MemoryMappedFile();
+
+    /**
+     * @return the contents of the file (NULL if it is empty)
+     */
+    const char* GetData() const;
+
+    /**
+     * @return the size of the file in bytes
+     */
+    uint64_t GetSize() const;
+};
+
+#endif /*MEMORYMAPPEDFILE_HPP_*/
@@ -0,0 +1,32 @@
+#ifndef ABSTRACTDIVISIONTIMEPROVIDER_HPP_
+#define ABSTRACTDIVISIONTIMEPROVIDER_HPP_
+
+/**
+ * Interface for cell-cycle models whose division time is fixed when the cell is
+ * born (or when it last divided), and so can be computed in advance rather than
+ * discovered by calling ReadyToDivide() on every time step.
+ *
+ * Models implementing this interface are handled by the event-driven division
+ * scheduler in MammaryOffLatticeSimulation; models with state-dependent timing
+ * (e.g. SubstrateDependentCellCycleModel) should not implement it, and are polled
+ * as usual.
+ */
+class AbstractDivisionTimeProvider
+{
+public:
+
+    /**
+     * Virtual destructor.
+     */
+    virtual ~AbstractDivisionTimeProvider()
+    {
+    }
+
+    /**
+     * @return the simulation time at which the cell will next be ready to divide,
+     * or DBL_MAX if it will never divide.
+     */
+    virtual double GetDivisionTime() const=0;
+};
+
+#endif /*ABSTRACTDIVISIONTIMEPROVIDER_HPP_*/
@@ -1,9 +1,11 @@
 #include "MammaryCellCycleModel.hpp"
+#include "ObjectPool.hpp"
 #include "DifferentiatedCellProliferativeType.hpp"
 #include "LuminalCellProperty.hpp"
 #include "MyoepithelialCellProperty.hpp"
 #include "LuminalStemCellProperty.hpp"
 #include "MyoepithelialStemCellProperty.hpp"
+#include "MammaryRandomStreams.hpp"
 
 MammaryCellCycleModel::MammaryCellCycleModel()
     : AbstractSimpleCellCycleModel(),
@@ -52,10 +54,18 @@ AbstractCellCycleModel* MammaryCellCycleModel::CreateCellCycleModel()
     return new MammaryCellCycleModel(*this);
 }
 
-void MammaryCellCycleModel::SetCellCycleDuration()
+void* MammaryCellCycleModel::operator new(std::size_t size)
+{
+    return ObjectPool<MammaryCellCycleModel>::Instance()->Allocate(size);
+}
+
+void MammaryCellCycleModel::operator delete(void* pModel, std::size_t size)
 {
-    RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+    ObjectPool<MammaryCellCycleModel>::Instance()->Deallocate(pModel, size);
+}
 
+void MammaryCellCycleModel::SetCellCycleDuration()
+{
     if (mpCell->HasCellProperty<LuminalCellProperty>()) // luminal cell is DifferentiatedCellProliferativeType
     {
         mCellCycleDuration = DBL_MAX;
@@ -66,8 +76,22 @@ void MammaryCellCycleModel::SetCellCycleDuration()
     }
     else
     {
-        mCellCycleDuration = mMinCellCycleDuration + (mMaxCellCycleDuration - mMinCellCycleDuration) * p_gen->ranf(); // U[MinCCD,MaxCCD]
+        // In reproducible mode, draw from the cell's own stream, keyed by the time step at which the cycle starts
+        MammaryRandomStreams* p_streams = MammaryRandomStreams::Instance();
+        double draw = p_streams->IsReproducible()
+                      ? p_streams->ranf(mpCell->GetCellId(), CELL_CYCLE_DURATION_EVENT, SimulationTime::Instance()->GetTimeStepsElapsed())
+                      : RandomNumberGenerator::Instance()->ranf();
+        mCellCycleDuration = mMinCellCycleDuration + (mMaxCellCycleDuration - mMinCellCycleDuration) * draw; // U[MinCCD,MaxCCD]
+    }
+}
+
+double MammaryCellCycleModel::GetDivisionTime() const
+{
+    if (mCellCycleDuration == DBL_MAX)
+    {
+        return DBL_MAX;
     }
+    return mBirthTime + mCellCycleDuration;
 }
 
 double MammaryCellCycleModel::GetMinCellCycleDuration()
@@ -2,6 +2,7 @@
 #define MAMMARYCELLCYCLEMODEL_HPP_
 
 #include "AbstractSimpleCellCycleModel.hpp"
+#include "AbstractDivisionTimeProvider.hpp"
 #include "RandomNumberGenerator.hpp"
 
 /**
@@ -11,8 +12,11 @@
  *
  * If the cell is differentiated, then the cell cycle duration is set to be infinite,
  * so that the cell will never divide.
+ *
+ * Since the duration is drawn once per cycle, the division time is known in advance
+ * and is exposed through AbstractDivisionTimeProvider for event-driven scheduling.
  */
-class MammaryCellCycleModel : public AbstractSimpleCellCycleModel
+class MammaryCellCycleModel : public AbstractSimpleCellCycleModel, public AbstractDivisionTimeProvider
 {
     friend class TestSimpleCellCycleModels;
 
@@ -74,7 +78,8 @@ public:
     MammaryCellCycleModel();
 
     /**
-     * Overridden SetCellCycleDuration() method to add stochastic cell cycle times
+     * Overridden SetCellCycleDuration() method to add stochastic cell cycle times.
+     * In the reproducible mode of MammaryRandomStreams, the duration is drawn from the cell's own stream.
      */
     void SetCellCycleDuration();
 
@@ -86,11 +91,35 @@ public:
      */
     AbstractCellCycleModel* CreateCellCycleModel();
 
+    /**
+     * Class-specific allocation function, so that models created on division are
+     * taken from an ObjectPool rather than the global heap.
+     *
+     * @param size the number of bytes required
+     * @return pointer to storage for the new model
+     */
+    static void* operator new(std::size_t size);
+
+    /**
+     * Class-specific deallocation function, returning storage to the ObjectPool.
+     *
+     * @param pModel the storage to release
+     * @param size the number of bytes originally requested
+     */
+    static void operator delete(void* pModel, std::size_t size);
+
     /**
      * Set the new cell's type after division.
      */
     void InitialiseDaughterCell();
 
+    /**
+     * Overridden GetDivisionTime() method.
+     *
+     * @return the birth time plus the cell cycle duration, or DBL_MAX if the cell never divides
+     */
+    double GetDivisionTime() const;
+
     /**
      * @return mMinCellCycleDuration
      */
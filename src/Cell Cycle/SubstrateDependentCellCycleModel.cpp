@@ -1,4 +1,6 @@
 #include "SubstrateDependentCellCycleModel.hpp"
+#include "ObjectPool.hpp"
+#include "CellDataColumns.hpp"
 #include "DifferentiatedCellProliferativeType.hpp"
 #include "LuminalCellProperty.hpp"
 #include "MyoepithelialCellProperty.hpp"
@@ -11,7 +13,8 @@ SubstrateDependentCellCycleModel::SubstrateDependentCellCycleModel()
       mQuiescentHeightFraction(DOUBLE_UNSET),
       mEquilibriumHeight(DOUBLE_UNSET),
       mCurrentQuiescentOnsetTime(SimulationTime::Instance()->GetTime()),
-      mCurrentQuiescentDuration(0.0)
+      mCurrentQuiescentDuration(0.0),
+      mHeightHandle(UNSIGNED_UNSET)
 {
 }
 
@@ -20,7 +23,8 @@ SubstrateDependentCellCycleModel::SubstrateDependentCellCycleModel(const Substra
       mQuiescentHeightFraction(rModel.mQuiescentHeightFraction),
       mEquilibriumHeight(rModel.mEquilibriumHeight),
       mCurrentQuiescentOnsetTime(rModel.mCurrentQuiescentOnsetTime),
-      mCurrentQuiescentDuration(rModel.mCurrentQuiescentDuration)
+      mCurrentQuiescentDuration(rModel.mCurrentQuiescentDuration),
+      mHeightHandle(rModel.mHeightHandle)
 {
     /*
      * Initialize only those member variables defined in this class.
@@ -45,8 +49,17 @@ void SubstrateDependentCellCycleModel::UpdateCellCyclePhase()
         EXCEPTION("The member variables mQuiescentHeightFraction and mEquilibriumHeight have not yet been set.");
     }
 
-    // Get cell Height
-    double cell_height = mpCell->GetCellData()->GetItem("height");
+    // Get cell height
+    boost::shared_ptr<CellDataColumns> p_columns = CellDataColumns::Get(mpCell->rGetCellPropertyCollection().GetCellPropertyRegistry());
+    if (mHeightHandle == UNSIGNED_UNSET)
+    {
+        mHeightHandle = p_columns->GetColumnHandle("height");
+    }
+    double cell_height = p_columns->GetValue(mHeightHandle, mpCell->GetCellId());
+    if (cell_height == DOUBLE_UNSET)
+    {
+        EXCEPTION("The height of cell " << mpCell->GetCellId() << " has not been set; is a CellHeightTrackingModifier being used?");
+    }
 
     if (mCurrentCellCyclePhase == G_ONE_PHASE)
     {
@@ -122,6 +135,16 @@ AbstractCellCycleModel* SubstrateDependentCellCycleModel::CreateCellCycleModel()
     return new SubstrateDependentCellCycleModel(*this);
 }
 
+void* SubstrateDependentCellCycleModel::operator new(std::size_t size)
+{
+    return ObjectPool<SubstrateDependentCellCycleModel>::Instance()->Allocate(size);
+}
+
+void SubstrateDependentCellCycleModel::operator delete(void* pModel, std::size_t size)
+{
+    ObjectPool<SubstrateDependentCellCycleModel>::Instance()->Deallocate(pModel, size);
+}
+
 void SubstrateDependentCellCycleModel::SetQuiescentHeightFraction(double quiescentHeightFraction)
 {
     mQuiescentHeightFraction = quiescentHeightFraction;
@@ -56,6 +56,13 @@ protected:
      */
     double mCurrentQuiescentDuration;
 
+    /**
+     * The handle of the "height" column in the CellDataColumns of the cell's population,
+     * resolved on first use. Daughters copy it, since they join the same population.
+     * Not archived, since it is resolved again after loading.
+     */
+    unsigned mHeightHandle;
+
     /**
      * Protected copy-constructor for use by CreateCellCycleModel.
      * The only way for external code to create a copy of a cell cycle model
@@ -80,6 +87,9 @@ public:
 
     /**
      * Overridden UpdateCellCyclePhase() method.
+     *
+     * Reads the cell height from the "height" column of the population's CellDataColumns,
+     * which must be populated by a CellHeightTrackingModifier.
      */
     void UpdateCellCyclePhase();
 
@@ -92,6 +102,23 @@ public:
      */
     AbstractCellCycleModel* CreateCellCycleModel();
 
+    /**
+     * Class-specific allocation function, so that models created on division are
+     * taken from an ObjectPool rather than the global heap.
+     *
+     * @param size the number of bytes required
+     * @return pointer to storage for the new model
+     */
+    static void* operator new(std::size_t size);
+
+    /**
+     * Class-specific deallocation function, returning storage to the ObjectPool.
+     *
+     * @param pModel the storage to release
+     * @param size the number of bytes originally requested
+     */
+    static void operator delete(void* pModel, std::size_t size);
+
     /**
      * Set the new cell's type after division.
      */
@@ -1,5 +1,7 @@
 #include "OrientedDivisionRule.hpp"
 #include "RandomNumberGenerator.hpp"
+#include "MammaryRandomStreams.hpp"
+#include "SimulationTime.hpp"
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 std::pair<c_vector<double, SPACE_DIM>, c_vector<double, SPACE_DIM> > OrientedDivisionRule<ELEMENT_DIM, SPACE_DIM>::CalculateCellDivisionVector(
@@ -12,6 +14,12 @@ std::pair<c_vector<double, SPACE_DIM>, c_vector<double, SPACE_DIM> > OrientedDiv
     // Make a random direction vector of the required length
     c_vector<double, SPACE_DIM> random_vector;
 
+    // In reproducible mode, draw from the parent cell's own stream, so the direction does not depend on the order of divisions
+    MammaryRandomStreams* p_streams = MammaryRandomStreams::Instance();
+    double draw = p_streams->IsReproducible()
+                  ? p_streams->ranf(pParentCell->GetCellId(), DIVISION_ORIENTATION_EVENT, SimulationTime::Instance()->GetTimeStepsElapsed())
+                  : RandomNumberGenerator::Instance()->ranf();
+
     /*
      * Pick a random direction and move the parent cell backwards by 0.5*separation
      * in that direction and return the position of the daughter cell 0.5*separation
@@ -21,14 +29,14 @@ std::pair<c_vector<double, SPACE_DIM>, c_vector<double, SPACE_DIM> > OrientedDiv
     {
         case 1:
         {
-            double random_direction = -1.0 + 2.0*(RandomNumberGenerator::Instance()->ranf() < 0.5);
+            double random_direction = -1.0 + 2.0*(draw < 0.5);
 
             random_vector(0) = 0.5*separation*random_direction;
             break;
         }
         case 2:
         {
-            double random_angle = 2.0*M_PI*RandomNumberGenerator::Instance()->ranf();
+            double random_angle = 2.0*M_PI*draw;
 
             random_vector(0) = 0.5*separation*cos(random_angle);
             random_vector(1) = 0.5*separation*sin(random_angle);
@@ -42,7 +50,7 @@ std::pair<c_vector<double, SPACE_DIM>, c_vector<double, SPACE_DIM> > OrientedDiv
              * [0, pi) respectively, since points picked in this way will be 'bunched' near
              * the poles. See #2230.
              */
-            double random_angle = 2.0*M_PI*RandomNumberGenerator::Instance()->ranf();
+            double random_angle = 2.0*M_PI*draw;
 
             random_vector(0) = 0.5*separation*cos(random_angle);
             random_vector(1) = 0.5*separation*sin(random_angle);
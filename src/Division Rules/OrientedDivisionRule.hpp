@@ -15,6 +15,9 @@ template<unsigned ELEMENT_DIM, unsigned SPACE_DIM> class AbstractCentreBasedDivi
  * AbstractCentreBasedCellPopulation::mMeinekeDivisionSeparation apart,
  * along a random axis. The midpoint between the two daughter cell
  * positions corresponds to the parent cell's position.
+ *
+ * In the reproducible mode of MammaryRandomStreams, the axis is drawn from the parent
+ * cell's own stream rather than from RandomNumberGenerator.
  */
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM>
 class OrientedDivisionRule : public AbstractCentreBasedDivisionRule<ELEMENT_DIM, SPACE_DIM>
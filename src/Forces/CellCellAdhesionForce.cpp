@@ -1,6 +1,9 @@
 #include "CellCellAdhesionForce.hpp"
 #include "LuminalCellProperty.hpp"
 #include "MyoepithelialCellProperty.hpp"
+#include "MammaryProfiler.hpp"
+#include "MammaryFixedOrderForceSum.hpp"
+#include "MammaryRandomStreams.hpp"
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 CellCellAdhesionForce<ELEMENT_DIM, SPACE_DIM>::CellCellAdhesionForce()
@@ -78,6 +81,20 @@ void CellCellAdhesionForce<ELEMENT_DIM, SPACE_DIM>::SetHeterotypicSpringConstant
     mHeterotypicSpringConstantMultiplier = heterotypicSpringConstantMultiplier;
 }
 
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void CellCellAdhesionForce<ELEMENT_DIM, SPACE_DIM>::AddForceContribution(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>& rCellPopulation)
+{
+    MAMMARY_PROFILE_SCOPE("step/positions/force/CellCellAdhesionForce");
+    if (MammaryRandomStreams::Instance()->IsReproducible())
+    {
+        MammaryFixedOrderForceSum<ELEMENT_DIM, SPACE_DIM>::AddForceContribution(*this, rCellPopulation);
+    }
+    else
+    {
+        GeneralisedLinearSpringForce<ELEMENT_DIM, SPACE_DIM>::AddForceContribution(rCellPopulation);
+    }
+}
+
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void CellCellAdhesionForce<ELEMENT_DIM, SPACE_DIM>::OutputForceParameters(out_stream& rParamsFile)
 {
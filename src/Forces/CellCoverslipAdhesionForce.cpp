@@ -5,6 +5,7 @@
 #include "LuminalStemCellProperty.hpp"
 #include "MyoepithelialStemCellProperty.hpp"
 #include "Debug.hpp"
+#include "MammaryProfiler.hpp"
 
 template<unsigned DIM>
 CellCoverslipAdhesionForce<DIM>::CellCoverslipAdhesionForce()
@@ -35,6 +36,8 @@ void CellCoverslipAdhesionForce<DIM>::SetEquilibriumLength(double equilibriumLen
 template<unsigned DIM>
 void CellCoverslipAdhesionForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
 {
+    MAMMARY_PROFILE_SCOPE("step/positions/force/CellCoverslipAdhesionForce");
+
     /* Inside the method, we loop over cells, and add a vector to each node associated with cells 
      * with the LuminalCellPorperty, which is proportional (with constant mStiffness) to the negative of the position. 
     */
@@ -2,6 +2,7 @@
 #include "NodeBasedCellPopulation.hpp"
 #include "CellLabel.hpp"
 #include "Debug.hpp"
+#include "MammaryProfiler.hpp"
 
 #include "LuminalCellProperty.hpp"
 #include "MyoepithelialCellProperty.hpp"
@@ -31,6 +32,8 @@ void CellECMAdhesionForce<DIM>::SetStiffness(double stiffness)
 template<unsigned DIM>
 void CellECMAdhesionForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
 {
+    MAMMARY_PROFILE_SCOPE("step/positions/force/CellECMAdhesionForce");
+
     /* Inside the method, we loop over cells, and add a vector to each node associated with cells 
      * with the LuminalCellPorperty, which is proportional (with constant mStiffness) to the negative of the position. 
     */
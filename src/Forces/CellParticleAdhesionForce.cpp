@@ -6,6 +6,7 @@
 #include "LuminalStemCellProperty.hpp"
 #include "MyoepithelialStemCellProperty.hpp"
 #include "Debug.hpp"
+#include "MammaryProfiler.hpp"
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 CellParticleAdhesionForce<ELEMENT_DIM, SPACE_DIM>::CellParticleAdhesionForce()
@@ -309,6 +310,8 @@ double CellParticleAdhesionForce<ELEMENT_DIM, SPACE_DIM>::VariableSpringConstant
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void CellParticleAdhesionForce<ELEMENT_DIM, SPACE_DIM>::AddForceContribution(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>& rCellPopulation)
 {
+  MAMMARY_PROFILE_SCOPE("step/positions/force/CellParticleAdhesionForce");
+
   AbstractCentreBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>* p_static_cast_cell_population = static_cast<AbstractCentreBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>*>(&rCellPopulation);
 
   std::vector< std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>* > >& r_node_pairs = p_static_cast_cell_population->rGetNodePairs();
@@ -5,6 +5,9 @@
 #include "MyoepithelialCellProperty.hpp"
 #include "CellLabel.hpp"
 #include "Debug.hpp"
+#include "MammaryProfiler.hpp"
+#include "MammaryFixedOrderForceSum.hpp"
+#include "MammaryRandomStreams.hpp"
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 DifferentialAdhesionLinearSpringForce<ELEMENT_DIM, SPACE_DIM>::DifferentialAdhesionLinearSpringForce()
@@ -82,6 +85,20 @@ void DifferentialAdhesionLinearSpringForce<ELEMENT_DIM, SPACE_DIM>::SetHeterotyp
     mHeterotypicSpringConstantMultiplier = heterotypicSpringConstantMultiplier;
 }
 
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void DifferentialAdhesionLinearSpringForce<ELEMENT_DIM, SPACE_DIM>::AddForceContribution(AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>& rCellPopulation)
+{
+    MAMMARY_PROFILE_SCOPE("step/positions/force/DifferentialAdhesionLinearSpringForce");
+    if (MammaryRandomStreams::Instance()->IsReproducible())
+    {
+        MammaryFixedOrderForceSum<ELEMENT_DIM, SPACE_DIM>::AddForceContribution(*this, rCellPopulation);
+    }
+    else
+    {
+        GeneralisedLinearSpringForce<ELEMENT_DIM, SPACE_DIM>::AddForceContribution(rCellPopulation);
+    }
+}
+
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void DifferentialAdhesionLinearSpringForce<ELEMENT_DIM, SPACE_DIM>::OutputForceParameters(out_stream& rParamsFile)
 {
@@ -2,6 +2,7 @@
 #include "NodeBasedCellPopulation.hpp"
 #include "CellLabel.hpp"
 #include "Debug.hpp"
+#include "MammaryProfiler.hpp"
 
 template<unsigned DIM>
 Force<DIM>::Force()
@@ -26,6 +27,8 @@ void Force<DIM>::SetStiffness(double stiffness)
 template<unsigned DIM>
 void Force<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
 {
+    MAMMARY_PROFILE_SCOPE("step/positions/force/Force");
+
     /* Inside the method, we loop over cells, and add a vector to each node associated with cells 
      * with the CellLabel, which is proportional (with constant mStiffness) to the negative of the position. 
     */
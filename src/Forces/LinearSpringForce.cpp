@@ -5,6 +5,9 @@
 #include "LuminalStemCellProperty.hpp"
 #include "MyoepithelialStemCellProperty.hpp"
 #include "Debug.hpp"
+#include "MammaryProfiler.hpp"
+#include "MammaryFixedOrderForceSum.hpp"
+#include "MammaryRandomStreams.hpp"
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 LinearSpringForce<ELEMENT_DIM,SPACE_DIM>::LinearSpringForce()
@@ -597,6 +600,20 @@ void LinearSpringForce<ELEMENT_DIM,SPACE_DIM>::SetMeinekeSpringGrowthDuration(do
     mMeinekeSpringGrowthDuration = springGrowthDuration;
 }
 
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void LinearSpringForce<ELEMENT_DIM,SPACE_DIM>::AddForceContribution(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation)
+{
+    MAMMARY_PROFILE_SCOPE("step/positions/force/LinearSpringForce");
+    if (MammaryRandomStreams::Instance()->IsReproducible())
+    {
+        MammaryFixedOrderForceSum<ELEMENT_DIM,SPACE_DIM>::AddForceContribution(*this, rCellPopulation);
+    }
+    else
+    {
+        AbstractTwoBodyInteractionForce<ELEMENT_DIM,SPACE_DIM>::AddForceContribution(rCellPopulation);
+    }
+}
+
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void LinearSpringForce<ELEMENT_DIM,SPACE_DIM>::OutputForceParameters(out_stream& rParamsFile)
 {
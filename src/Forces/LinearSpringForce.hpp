@@ -237,6 +237,14 @@ public:
       */
      void SetHeterotypicSpringConstantMultiplier(double heterotypicSpringConstantMultiplier);
 
+    /**
+     * Overridden AddForceContribution() method, which times the parent's method with MammaryProfiler,
+     * or sums the forces in fixed order (see MammaryFixedOrderForceSum) in reproducible mode.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void AddForceContribution(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation);
+
     /**
      * Overridden OutputForceParameters() method.
      *
@@ -0,0 +1,79 @@
+#include "MammaryFixedOrderForceSum.hpp"
+#include <algorithm>
+#include "AbstractCentreBasedCellPopulation.hpp"
+#include "Exception.hpp"
+#include "MammaryRandomStreams.hpp"
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+uint64_t MammaryFixedOrderForceSum<ELEMENT_DIM,SPACE_DIM>::GetKey(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation, unsigned nodeIndex)
+{
+    if (rCellPopulation.IsCellAttachedToLocationIndex(nodeIndex))
+    {
+        return rCellPopulation.GetCellUsingLocationIndex(nodeIndex)->GetCellId();
+    }
+    return MammaryRandomStreams::GetNodeStream(nodeIndex);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammaryFixedOrderForceSum<ELEMENT_DIM,SPACE_DIM>::AddForceContribution(AbstractTwoBodyInteractionForce<ELEMENT_DIM,SPACE_DIM>& rForce,
+                                                                            AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation)
+{
+    AbstractCentreBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>* p_population =
+        dynamic_cast<AbstractCentreBasedCellPopulation<ELEMENT_DIM,SPACE_DIM>*>(&rCellPopulation);
+    if (p_population == NULL)
+    {
+        EXCEPTION("Fixed-order force summation is only implemented for centre-based cell populations");
+    }
+
+    std::vector<std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>*> >& r_node_pairs = p_population->rGetNodePairs();
+
+    std::vector<Contribution> contributions(2*r_node_pairs.size());
+    for (unsigned i=0; i<r_node_pairs.size(); i++)
+    {
+        unsigned node_a_index = r_node_pairs[i].first->GetIndex();
+        unsigned node_b_index = r_node_pairs[i].second->GetIndex();
+        uint64_t key_a = GetKey(rCellPopulation, node_a_index);
+        uint64_t key_b = GetKey(rCellPopulation, node_b_index);
+        if (key_b < key_a)
+        {
+            std::swap(node_a_index, node_b_index);
+            std::swap(key_a, key_b);
+        }
+
+        Contribution& r_on_a = contributions[2*i];
+        r_on_a.mNodeIndex = node_a_index;
+        r_on_a.mNeighbourKey = key_b;
+        r_on_a.mForce = rForce.CalculateForceBetweenNodes(node_a_index, node_b_index, rCellPopulation);
+
+        Contribution& r_on_b = contributions[2*i + 1];
+        r_on_b.mNodeIndex = node_b_index;
+        r_on_b.mNeighbourKey = key_a;
+        r_on_b.mForce = -r_on_a.mForce;
+    }
+
+    std::sort(contributions.begin(), contributions.end());
+
+    // Sum the contributions to each node in order, and apply the total once
+    unsigned begin = 0;
+    while (begin < contributions.size())
+    {
+        unsigned node_index = contributions[begin].mNodeIndex;
+        c_vector<double, SPACE_DIM> total_force = zero_vector<double>(SPACE_DIM);
+        unsigned end = begin;
+        while (end < contributions.size() && contributions[end].mNodeIndex == node_index)
+        {
+            total_force += contributions[end].mForce;
+            end++;
+        }
+        rCellPopulation.GetNode(node_index)->AddAppliedForceContribution(total_force);
+        begin = end;
+    }
+}
+
+// Explicit instantiation
+template class MammaryFixedOrderForceSum<1,1>;
+template class MammaryFixedOrderForceSum<1,2>;
+template class MammaryFixedOrderForceSum<2,2>;
+template class MammaryFixedOrderForceSum<1,3>;
+template class MammaryFixedOrderForceSum<2,3>;
+template class MammaryFixedOrderForceSum<3,3>;
@@ -0,0 +1,67 @@
+#ifndef MAMMARYFIXEDORDERFORCESUM_HPP_
+#define MAMMARYFIXEDORDERFORCESUM_HPP_
+
+#include <vector>
+#include <stdint.h>
+#include "AbstractTwoBodyInteractionForce.hpp"
+
+/**
+ * Applies a two-body force to a centre-based cell population so that the force on each
+ * node does not depend on the order of the population's node pairs, for the reproducible
+ * mode of MammaryRandomStreams.
+ *
+ * AbstractTwoBodyInteractionForce::AddForceContribution() adds the force of each pair to
+ * both nodes as it goes, so the floating-point sum on a node follows the order of the
+ * pairs, which changes with the order of the nodes. Here, the force of each pair is
+ * computed once, with the node of the lower key first (its cell ID, or see
+ * MammaryRandomStreams::GetNodeStream() for a node without a cell), and the forces on
+ * each node are summed in order of the keys of its neighbours before being applied.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM=ELEMENT_DIM>
+class MammaryFixedOrderForceSum
+{
+private:
+
+    /** The force on a node from one of its neighbours. */
+    struct Contribution
+    {
+        /** The index of the node. */
+        unsigned mNodeIndex;
+
+        /** The key of the neighbour, which fixes the order of summation. */
+        uint64_t mNeighbourKey;
+
+        /** The force. */
+        c_vector<double, SPACE_DIM> mForce;
+
+        /**
+         * @param rOther another contribution
+         * @return whether this contribution is summed before the other
+         */
+        bool operator<(const Contribution& rOther) const
+        {
+            return (mNodeIndex < rOther.mNodeIndex)
+                   || (mNodeIndex == rOther.mNodeIndex && mNeighbourKey < rOther.mNeighbourKey);
+        }
+    };
+
+    /**
+     * @param rCellPopulation reference to the cell population
+     * @param nodeIndex the index of a node
+     * @return the key of the node
+     */
+    static uint64_t GetKey(AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation, unsigned nodeIndex);
+
+public:
+
+    /**
+     * Add the force between each pair of neighbouring nodes to both nodes, in fixed order.
+     *
+     * @param rForce the two-body force
+     * @param rCellPopulation reference to the cell population, which must be centre-based
+     */
+    static void AddForceContribution(AbstractTwoBodyInteractionForce<ELEMENT_DIM,SPACE_DIM>& rForce,
+                                     AbstractCellPopulation<ELEMENT_DIM,SPACE_DIM>& rCellPopulation);
+};
+
+#endif /*MAMMARYFIXEDORDERFORCESUM_HPP_*/
@@ -1,4 +1,6 @@
 #include "RandomMotionForce.hpp"
+#include "MammaryProfiler.hpp"
+#include "MammaryRandomStreams.hpp"
 
 template<unsigned DIM>
 RandomMotionForce<DIM>::RandomMotionForce()
@@ -28,13 +30,29 @@ double RandomMotionForce<DIM>::GetMovementParameter()
 template<unsigned DIM>
 void RandomMotionForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
 {
+    MAMMARY_PROFILE_SCOPE("step/positions/force/RandomMotionForce");
+
     double dt = SimulationTime::Instance()->GetTimeStep();
 
+    MammaryRandomStreams* p_streams = MammaryRandomStreams::Instance();
+    bool is_reproducible = p_streams->IsReproducible();
+    unsigned time_step = SimulationTime::Instance()->GetTimeStepsElapsed();
+
     // Iterate over the nodes
     for (typename AbstractMesh<DIM, DIM>::NodeIterator node_iter = rCellPopulation.rGetMesh().GetNodeIteratorBegin();
          node_iter != rCellPopulation.rGetMesh().GetNodeIteratorEnd();
          ++node_iter)
     {
+        // In reproducible mode, each node draws from the stream of its cell, so the draws do not depend on node order
+        uint64_t stream = 0;
+        if (is_reproducible)
+        {
+            unsigned node_index = node_iter->GetIndex();
+            stream = rCellPopulation.IsCellAttachedToLocationIndex(node_index)
+                     ? rCellPopulation.GetCellUsingLocationIndex(node_index)->GetCellId()
+                     : MammaryRandomStreams::GetNodeStream(node_index);
+        }
+
                 c_vector<double, DIM> force_contribution;
         for (unsigned i=0; i<DIM; i++)
         {
@@ -47,7 +65,9 @@ void RandomMotionForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& r
              *
              * where W is a standard normal random variable.
              */
-            double xi = RandomNumberGenerator::Instance()->StandardNormalRandomDeviate();
+            double xi = is_reproducible
+                        ? p_streams->StandardNormalRandomDeviate(stream, RANDOM_MOTION_EVENT, time_step, i)
+                        : RandomNumberGenerator::Instance()->StandardNormalRandomDeviate();
 
             force_contribution[i] = (sqrt(2.0*mMovementParameter*dt)/dt)*xi;
         }
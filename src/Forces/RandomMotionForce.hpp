@@ -10,6 +10,9 @@
 
 /**
  * A force class to model random cell movement.
+ *
+ * In the reproducible mode of MammaryRandomStreams, each node's displacement is drawn from
+ * the streams of its cell rather than from RandomNumberGenerator.
  */
 template<unsigned DIM>
 class RandomMotionForce : public AbstractForce<DIM>
@@ -0,0 +1,66 @@
+#include "SwitchableForce.hpp"
+
+template<unsigned DIM>
+SwitchableForce<DIM>::SwitchableForce(boost::shared_ptr<AbstractForce<DIM> > pForce)
+    : AbstractForce<DIM>(),
+      mpForce(pForce),
+      mIsActive(true)
+{
+    if (!mpForce)
+    {
+        EXCEPTION("A SwitchableForce must wrap a force");
+    }
+}
+
+template<unsigned DIM>
+SwitchableForce<DIM>::~SwitchableForce()
+{
+}
+
+template<unsigned DIM>
+boost::shared_ptr<AbstractForce<DIM> > SwitchableForce<DIM>::GetForce() const
+{
+    return mpForce;
+}
+
+template<unsigned DIM>
+bool SwitchableForce<DIM>::IsActive() const
+{
+    return mIsActive;
+}
+
+template<unsigned DIM>
+void SwitchableForce<DIM>::SetActive(bool isActive)
+{
+    mIsActive = isActive;
+}
+
+template<unsigned DIM>
+void SwitchableForce<DIM>::AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation)
+{
+    if (mIsActive)
+    {
+        mpForce->AddForceContribution(rCellPopulation);
+    }
+}
+
+template<unsigned DIM>
+void SwitchableForce<DIM>::OutputForceParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<IsActive>" << mIsActive << "</IsActive>\n";
+    *rParamsFile << "\t\t\t<WrappedForce>\n";
+    mpForce->OutputForceInfo(rParamsFile);
+    *rParamsFile << "\t\t\t</WrappedForce>\n";
+
+    // Call method on direct parent class
+    AbstractForce<DIM>::OutputForceParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class SwitchableForce<1>;
+template class SwitchableForce<2>;
+template class SwitchableForce<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(SwitchableForce)
@@ -0,0 +1,124 @@
+#ifndef SWITCHABLEFORCE_HPP_
+#define SWITCHABLEFORCE_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+
+#include "AbstractForce.hpp"
+
+/**
+ * A force which wraps another force and passes its contribution through only while
+ * it is active, so that the wrapped force can be switched on or off during a
+ * simulation (e.g. by a PerturbationSchedulerModifier).
+ */
+template<unsigned DIM>
+class SwitchableForce : public AbstractForce<DIM>
+{
+private:
+
+    /** The wrapped force. */
+    boost::shared_ptr<AbstractForce<DIM> > mpForce;
+
+    /** Whether the wrapped force is currently applied. Defaults to true. */
+    bool mIsActive;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractForce<DIM> >(*this);
+        archive & mIsActive;
+    }
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param pForce the force to wrap
+     */
+    SwitchableForce(boost::shared_ptr<AbstractForce<DIM> > pForce);
+
+    /**
+     * Destructor.
+     */
+    ~SwitchableForce();
+
+    /**
+     * @return mpForce
+     */
+    boost::shared_ptr<AbstractForce<DIM> > GetForce() const;
+
+    /**
+     * @return mIsActive
+     */
+    bool IsActive() const;
+
+    /**
+     * Set mIsActive.
+     *
+     * @param isActive whether the wrapped force is applied
+     */
+    void SetActive(bool isActive);
+
+    /**
+     * Overridden AddForceContribution() method.
+     *
+     * @param rCellPopulation reference to the tissue
+     */
+    void AddForceContribution(AbstractCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputForceParameters() method.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputForceParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(SwitchableForce)
+
+namespace boost
+{
+    namespace serialization
+    {
+        /**
+         * Serialize information required to construct a SwitchableForce.
+         */
+        template<class Archive, unsigned DIM>
+        inline void save_construct_data(
+            Archive & ar, const SwitchableForce<DIM> * t, const unsigned int file_version)
+        {
+            // Save data required to construct instance
+            const boost::shared_ptr<AbstractForce<DIM> > p_force = t->GetForce();
+            ar << p_force;
+        }
+
+        /**
+         * De-serialize constructor parameters and initialise a SwitchableForce.
+         */
+        template<class Archive, unsigned DIM>
+        inline void load_construct_data(
+            Archive & ar, SwitchableForce<DIM> * t, const unsigned int file_version)
+        {
+            // Retrieve data from archive required to construct new instance
+            boost::shared_ptr<AbstractForce<DIM> > p_force;
+            ar >> p_force;
+
+            // Invoke inplace constructor to initialise instance
+            ::new(t)SwitchableForce<DIM>(p_force);
+        }
+    }
+} // namespace ...
+
+#endif /*SWITCHABLEFORCE_HPP_*/
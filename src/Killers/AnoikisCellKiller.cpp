@@ -1,11 +1,22 @@
 #include "AnoikisCellKiller.hpp"
 #include "NodeBasedCellPopulation.hpp"
+#include "BoxRangeQuery.hpp"
+#include "CounterBasedRandomNumberGenerator.hpp"
+#include "MammaryRandomStreams.hpp"
 #include "Debug.hpp"
+#include "MammaryProfiler.hpp"
+
+#include <climits>
 
 template<unsigned DIM>
 AnoikisCellKiller<DIM>::AnoikisCellKiller(AbstractCellPopulation<DIM>* pCellPopulation, double probabilityOfDeathInAnHour)
 : AbstractCellKiller<DIM>(pCellPopulation),
-mProbabilityOfDeathInAnHour(probabilityOfDeathInAnHour)
+mProbabilityOfDeathInAnHour(probabilityOfDeathInAnHour),
+mDetachmentHeight(1.0),
+mSeed(0),
+mSeedIsSet(false),
+mCachedTimeStep(DOUBLE_UNSET),
+mDeathProbabilityThisTimestep(0.0)
 {   
     if ((mProbabilityOfDeathInAnHour<0) || (mProbabilityOfDeathInAnHour>1))
     {
@@ -19,36 +30,140 @@ double AnoikisCellKiller<DIM>::GetDeathProbabilityInAnHour() const
     return mProbabilityOfDeathInAnHour;
 }
 
+template<unsigned DIM>
+double AnoikisCellKiller<DIM>::GetDetachmentHeight() const
+{
+    return mDetachmentHeight;
+}
+
+template<unsigned DIM>
+void AnoikisCellKiller<DIM>::SetDetachmentHeight(double detachmentHeight)
+{
+    mDetachmentHeight = detachmentHeight;
+}
+
+template<unsigned DIM>
+unsigned AnoikisCellKiller<DIM>::GetSeed() const
+{
+    return mSeed;
+}
+
+template<unsigned DIM>
+void AnoikisCellKiller<DIM>::SetSeed(unsigned seed)
+{
+    mSeed = seed;
+    mSeedIsSet = true;
+}
+
+template<unsigned DIM>
+unsigned AnoikisCellKiller<DIM>::GetStreamSeed()
+{
+    if (!mSeedIsSet)
+    {
+        // Take the seed from RandomNumberGenerator, so that reseeding it changes which cells die
+        mSeed = RandomNumberGenerator::Instance()->randMod(UINT_MAX);
+        mSeedIsSet = true;
+    }
+    return mSeed;
+}
+
+template<unsigned DIM>
+double AnoikisCellKiller<DIM>::GetDeathProbabilityThisTimestep()
+{
+    double dt = SimulationTime::Instance()->GetTimeStep();
+    if (dt != mCachedTimeStep)
+    {
+        /*
+         * We assume a constant time step and that there are an integer number (n = 1/dt)
+         * of time steps per hour. We also assume that this method is called every time step
+         * and that the probabilities of dying at different times are independent.
+         *
+         * Let q=mProbabilityOfDeathInAnHour and p="probability of death in a given time step".
+         *
+         * Probability of not dying in an hour:
+         * (1-q) = (1-p)^n = (1-p)^(1/dt).
+         *
+         * Rearranging for p:
+         * p = 1 - (1-q)^dt.
+         */
+        mDeathProbabilityThisTimestep = 1.0 - pow((1.0 - mProbabilityOfDeathInAnHour), dt);
+        mCachedTimeStep = dt;
+    }
+    return mDeathProbabilityThisTimestep;
+}
+
 template<unsigned DIM>
 void AnoikisCellKiller<DIM>::CheckAndLabelSingleCellForApoptosis(CellPtr pCell)
 {
+    if (pCell->HasApoptosisBegun())
+    {
+        return;
+    }
+
     /*
-     * We assume a constant time step and that there are an integer number (n = 1/dt)
-     * of time steps per hour. We also assume that this method is called every time step
-     * and that the probabilities of dying at different times are independent.
-     *
-     * Let q=mProbabilityOfDeathInAnHour and p="probability of death in a given time step".
-     *
-     * Probability of not dying in an hour:
-     * (1-q) = (1-p)^n = (1-p)^(1/dt).
-     *
-     * Rearranging for p:
-     * p = 1 - (1-q)^dt.
+     * Each cell draws from its own stream, indexed by the time step, so the result does not depend
+     * on visiting order. In reproducible mode, the streams follow the seed of MammaryRandomStreams
+     * instead of RandomNumberGenerator.
      */
-    double death_prob_this_timestep = 1.0 - pow((1.0 - mProbabilityOfDeathInAnHour), SimulationTime::Instance()->GetTimeStep());
+    unsigned time_step = SimulationTime::Instance()->GetTimeStepsElapsed();
+    MammaryRandomStreams* p_streams = MammaryRandomStreams::Instance();
+    double draw = p_streams->IsReproducible()
+                  ? p_streams->ranf(pCell->GetCellId(), ANOIKIS_EVENT, time_step, mSeed)
+                  : CounterBasedRandomNumberGenerator::ranf(GetStreamSeed(), pCell->GetCellId(), time_step);
 
-    if (!pCell->HasApoptosisBegun() &&
-        RandomNumberGenerator::Instance()->ranf() < death_prob_this_timestep)
+    if (draw < GetDeathProbabilityThisTimestep())
     {
         pCell->StartApoptosis();
     }
 }
 
-
 template<unsigned DIM>
 void AnoikisCellKiller<DIM>::CheckAndLabelCellsForApoptosisOrDeath()
-{   
-    // Iterate over cell population
+{
+    MAMMARY_PROFILE_SCOPE("step/population_update/cell_removal/AnoikisCellKiller");
+
+    NodeBasedCellPopulation<DIM>* p_node_population = dynamic_cast<NodeBasedCellPopulation<DIM>*>(this->mpCellPopulation);
+    if (p_node_population)
+    {
+        NodesOnlyMesh<DIM>& r_mesh = p_node_population->rGetMesh();
+
+        /*
+         * Nodes were sorted into boxes when the population was last updated, and may have
+         * moved since, so pad the query region downwards by one box width.
+         */
+        c_vector<double, DIM> lower;
+        c_vector<double, DIM> upper;
+        for (unsigned i=0; i<DIM; i++)
+        {
+            lower[i] = -DBL_MAX;
+            upper[i] = DBL_MAX;
+        }
+        lower[DIM-1] = mDetachmentHeight - r_mesh.GetMaximumInteractionDistance();
+
+        std::vector<unsigned> box_indices;
+        if (BoxRangeQuery<DIM>::GetBoxesInRegion(r_mesh, lower, upper, box_indices))
+        {
+            DistributedBoxCollection<DIM>* p_box_collection = r_mesh.GetBoxCollection();
+            for (unsigned i=0; i<box_indices.size(); i++)
+            {
+                const std::set<Node<DIM>*>& r_nodes = p_box_collection->rGetBox(box_indices[i]).rGetNodesContained();
+                for (typename std::set<Node<DIM>*>::const_iterator node_iter = r_nodes.begin();
+                     node_iter != r_nodes.end();
+                     ++node_iter)
+                {
+                    unsigned node_index = (*node_iter)->GetIndex();
+                    if ((*node_iter)->rGetLocation()[DIM-1] > mDetachmentHeight &&
+                        p_node_population->IsCellAttachedToLocationIndex(node_index))
+                    {
+                        CheckAndLabelSingleCellForApoptosis(p_node_population->GetCellUsingLocationIndex(node_index));
+                    }
+                }
+            }
+            return;
+        }
+    }
+
+    // Otherwise, iterate over the whole cell population
     for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = this->mpCellPopulation->Begin();
     cell_iter != this->mpCellPopulation->End();
     ++cell_iter)
@@ -56,7 +171,7 @@ void AnoikisCellKiller<DIM>::CheckAndLabelCellsForApoptosisOrDeath()
         c_vector<double, DIM> location;
         location = this->mpCellPopulation->GetLocationOfCellCentre(*cell_iter);
 
-        if (location[DIM-1] > 1.0)
+        if (location[DIM-1] > mDetachmentHeight)
         {
             CheckAndLabelSingleCellForApoptosis(*cell_iter);
         }
@@ -67,6 +182,8 @@ template<unsigned DIM>
 void AnoikisCellKiller<DIM>::OutputCellKillerParameters(out_stream& rParamsFile)
 {
     *rParamsFile << "\t\t\t<ProbabilityOfDeathInAnHour>" << mProbabilityOfDeathInAnHour << "</ProbabilityOfDeathInAnHour>\n";
+    *rParamsFile << "\t\t\t<DetachmentHeight>" << mDetachmentHeight << "</DetachmentHeight>\n";
+    *rParamsFile << "\t\t\t<Seed>" << mSeed << "</Seed>\n";
     // No parameters to output, so just call method on direct parent class
     AbstractCellKiller<DIM>::OutputCellKillerParameters(rParamsFile);
 }
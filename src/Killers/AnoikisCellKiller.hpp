@@ -5,11 +5,25 @@
 #include "RandomNumberGenerator.hpp"
 
 #include "ChasteSerialization.hpp"
+#include "ChasteSerializationVersion.hpp"
 #include <boost/serialization/base_object.hpp>
 #include <boost/serialization/vector.hpp>
 
 /**
  * A cell killer that kills cells if they are outside the domain.
+ *
+ * Cells whose height (final coordinate) exceeds mDetachmentHeight are considered
+ * detached, and each undergoes apoptosis with a given probability per hour.
+ *
+ * For a NodeBasedCellPopulation, only the spatial boxes of the population's
+ * NodesOnlyMesh that may contain detached cells are visited, so the cost scales
+ * with the number of cells near or above the detachment height rather than with
+ * the population size. The per-time-step death probability is computed only when
+ * the time step changes, and each cell's draw comes from its own counter-based
+ * random stream, so results do not depend on the order in which cells are visited.
+ * Unless SetSeed() is called, the streams' seed is drawn from RandomNumberGenerator when
+ * first needed. In the reproducible mode of MammaryRandomStreams, these streams are keyed
+ * by its seed as well as mSeed, and RandomNumberGenerator is not used.
  */
 template<unsigned DIM>
 class AnoikisCellKiller : public AbstractCellKiller<DIM>
@@ -22,6 +36,42 @@ private:
       */
      double mProbabilityOfDeathInAnHour;
 
+    /**
+     * The height above which cells are considered detached. Defaults to 1.0.
+     */
+    double mDetachmentHeight;
+
+    /**
+     * The seed of the counter-based random streams used to decide cell death. Unless set by
+     * SetSeed(), drawn from RandomNumberGenerator when first needed (see GetStreamSeed()).
+     */
+    unsigned mSeed;
+
+    /**
+     * Whether mSeed has been set or drawn.
+     */
+    bool mSeedIsSet;
+
+    /**
+     * The time step for which mDeathProbabilityThisTimestep was computed.
+     */
+    double mCachedTimeStep;
+
+    /**
+     * The probability of death in a single time step of length mCachedTimeStep.
+     */
+    double mDeathProbabilityThisTimestep;
+
+    /**
+     * @return the probability of death in a single time step, recomputing it if the time step has changed
+     */
+    double GetDeathProbabilityThisTimestep();
+
+    /**
+     * @return mSeed, drawing it from RandomNumberGenerator if it has not yet been set
+     */
+    unsigned GetStreamSeed();
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
@@ -38,6 +88,14 @@ private:
         // Make sure the random number generator is also archived
         SerializableSingleton<RandomNumberGenerator>* p_rng_wrapper = RandomNumberGenerator::Instance()->GetSerializationWrapper();
         archive & p_rng_wrapper;
+
+        // Archives of version 0 predate these members, which then keep their default values
+        if (version > 0)
+        {
+            archive & mDetachmentHeight;
+            archive & mSeed;
+            archive & mSeedIsSet;
+        }
     }
 
 public:
@@ -53,6 +111,30 @@ public:
      */
     double GetDeathProbabilityInAnHour() const;
 
+    /**
+     * @return mDetachmentHeight.
+     */
+    double GetDetachmentHeight() const;
+
+    /**
+     * Set mDetachmentHeight.
+     *
+     * @param detachmentHeight the height above which cells are considered detached
+     */
+    void SetDetachmentHeight(double detachmentHeight);
+
+    /**
+     * @return mSeed (zero if it has been neither set nor drawn).
+     */
+    unsigned GetSeed() const;
+
+    /**
+     * Set mSeed.
+     *
+     * @param seed the seed of the random streams used to decide cell death
+     */
+    void SetSeed(unsigned seed);
+
     /**
      * Overridden method to test a given cell for apoptosis.
      *
@@ -61,7 +143,7 @@ public:
     void CheckAndLabelSingleCellForApoptosis(CellPtr pCell);
 
     /**
-     * Loops over cells and kills cells outside boundary.
+     * Loops over candidate cells and labels detached cells for apoptosis.
      */
     void CheckAndLabelCellsForApoptosisOrDeath();
 
@@ -113,4 +195,21 @@ namespace boost
     }
 } // namespace ...
 
+namespace boost
+{
+namespace serialization
+{
+/**
+ * Specify a version number for archives of AnoikisCellKiller, which has archived its
+ * detachment height and seed since version 1.
+ */
+template<unsigned DIM>
+struct version<AnoikisCellKiller<DIM> >
+{
+    ///Macro to set the version number of templated archive in known versions of Boost
+    CHASTE_VERSION_CONTENT(1);
+};
+} // namespace serialization
+} // namespace boost
+
 #endif /*ANOIKISCELLKILLER_HPP_*/
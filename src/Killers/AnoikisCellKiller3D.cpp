@@ -1,12 +1,21 @@
 #include "AnoikisCellKiller3D.hpp"
 #include "AbstractCentreBasedCellPopulation.hpp"
-#include "NodeBasedCellPopulationWithParticles.hpp"
 #include "NodeBasedCellPopulation.hpp"
+#include "MammaryCellPropertyHelper.hpp"
+#include "BoxRangeQuery.hpp"
+#include "MammaryProfiler.hpp"
+
+#include <algorithm>
 
 AnoikisCellKiller3D::AnoikisCellKiller3D(AbstractCellPopulation<3>* pCellPopulation, c_vector<double,3> centre, double radius)
     : AbstractCellKiller<3>(pCellPopulation),
       mCentre(centre),
-      mRadius(radius)
+      mRadius(radius),
+      mUseDynamicLumen(false),
+      mLumenUpdateInterval(1.0),
+      mLumenPercentile(0.1),
+      mLumenRadiusOffset(1.5),
+      mLastLumenUpdateTime(-DBL_MAX)
 {
 }
 
@@ -20,8 +29,184 @@ double AnoikisCellKiller3D::GetRadius() const
     return mRadius;
 }
 
+void AnoikisCellKiller3D::SetUseDynamicLumen(bool useDynamicLumen)
+{
+    mUseDynamicLumen = useDynamicLumen;
+}
+
+bool AnoikisCellKiller3D::GetUseDynamicLumen() const
+{
+    return mUseDynamicLumen;
+}
+
+void AnoikisCellKiller3D::SetLumenUpdateInterval(double lumenUpdateInterval)
+{
+    mLumenUpdateInterval = lumenUpdateInterval;
+}
+
+double AnoikisCellKiller3D::GetLumenUpdateInterval() const
+{
+    return mLumenUpdateInterval;
+}
+
+void AnoikisCellKiller3D::SetLumenPercentile(double lumenPercentile)
+{
+    if ((lumenPercentile < 0.0) || (lumenPercentile > 1.0))
+    {
+        EXCEPTION("The lumen percentile must be between zero and one");
+    }
+    mLumenPercentile = lumenPercentile;
+}
+
+double AnoikisCellKiller3D::GetLumenPercentile() const
+{
+    return mLumenPercentile;
+}
+
+void AnoikisCellKiller3D::SetLumenRadiusOffset(double lumenRadiusOffset)
+{
+    mLumenRadiusOffset = lumenRadiusOffset;
+}
+
+double AnoikisCellKiller3D::GetLumenRadiusOffset() const
+{
+    return mLumenRadiusOffset;
+}
+
+void AnoikisCellKiller3D::UpdateLumenEstimate()
+{
+    unsigned num_cells = this->mpCellPopulation->GetNumRealCells();
+    if (num_cells == 0)
+    {
+        return;
+    }
+
+    /*
+     * The centre of the lumen is taken to be the centroid of the organoid. Luminal cells may
+     * fill the lumen before it clears, so the shell is given by the myoepithelial cells of
+     * the basal layer or, if there are none, by the cells on the surface of the organoid,
+     * which have fewer neighbours than average.
+     */
+    c_vector<double,3> centroid = zero_vector<double>(3);
+    std::vector<c_vector<double,3> > locations;
+    std::vector<c_vector<double,3> > shell_locations;
+    std::vector<unsigned> num_neighbours;
+    locations.reserve(num_cells);
+    num_neighbours.reserve(num_cells);
+
+    for (AbstractCellPopulation<3>::Iterator cell_iter = this->mpCellPopulation->Begin();
+         cell_iter != this->mpCellPopulation->End();
+         ++cell_iter)
+    {
+        c_vector<double,3> location = this->mpCellPopulation->GetLocationOfCellCentre(*cell_iter);
+        centroid += location;
+        locations.push_back(location);
+
+        MammaryCellType cell_type = MammaryCellPropertyHelper::GetMammaryCellType(*cell_iter);
+        if (cell_type == MYOEPITHELIAL_CELL || cell_type == MYOEPITHELIAL_STEM_CELL)
+        {
+            shell_locations.push_back(location);
+        }
+        else if (shell_locations.empty())
+        {
+            unsigned location_index = this->mpCellPopulation->GetLocationIndexUsingCell(*cell_iter);
+            num_neighbours.push_back(this->mpCellPopulation->GetNeighbouringNodeIndices(location_index).size());
+        }
+    }
+    centroid /= (double)num_cells;
+
+    if (shell_locations.empty())
+    {
+        double mean_num_neighbours = 0.0;
+        for (unsigned i=0; i<num_neighbours.size(); i++)
+        {
+            mean_num_neighbours += num_neighbours[i];
+        }
+        mean_num_neighbours /= (double)num_neighbours.size();
+
+        for (unsigned i=0; i<num_neighbours.size(); i++)
+        {
+            if (num_neighbours[i] < mean_num_neighbours)
+            {
+                shell_locations.push_back(locations[i]);
+            }
+        }
+    }
+
+    if (shell_locations.empty())
+    {
+        // Every cell has as many neighbours as every other, so there is no shell to enclose a lumen
+        mCentre = centroid;
+        mRadius = 0.0;
+        return;
+    }
+
+    // The inner radius of the shell is a low percentile of the shell cells' distances from the centroid
+    std::vector<double> distances(shell_locations.size());
+    for (unsigned i=0; i<shell_locations.size(); i++)
+    {
+        distances[i] = norm_2(shell_locations[i] - centroid);
+    }
+    unsigned rank = (unsigned)(mLumenPercentile*(distances.size() - 1));
+    std::nth_element(distances.begin(), distances.begin() + rank, distances.end());
+
+    mCentre = centroid;
+    mRadius = std::max(0.0, distances[rank] - mLumenRadiusOffset);
+}
+
 void AnoikisCellKiller3D::CheckAndLabelCellsForApoptosisOrDeath()
 {
+    MAMMARY_PROFILE_SCOPE("step/population_update/cell_removal/AnoikisCellKiller3D");
+
+    if (mUseDynamicLumen)
+    {
+        double current_time = SimulationTime::Instance()->GetTime();
+        if (current_time - mLastLumenUpdateTime >= mLumenUpdateInterval)
+        {
+            UpdateLumenEstimate();
+            mLastLumenUpdateTime = current_time;
+        }
+    }
+
+    if (mRadius <= 0.0)
+    {
+        return;
+    }
+
+    NodeBasedCellPopulation<3>* p_node_population = dynamic_cast<NodeBasedCellPopulation<3>*>(this->mpCellPopulation);
+    if (p_node_population)
+    {
+        NodesOnlyMesh<3>& r_mesh = p_node_population->rGetMesh();
+
+        /*
+         * Nodes were sorted into boxes when the population was last updated, and may have
+         * moved since, so pad the query sphere by one box width.
+         */
+        std::vector<unsigned> box_indices;
+        double padded_radius = mRadius + r_mesh.GetMaximumInteractionDistance();
+        if (BoxRangeQuery<3>::GetBoxesInSphere(r_mesh, mCentre, padded_radius, box_indices))
+        {
+            DistributedBoxCollection<3>* p_box_collection = r_mesh.GetBoxCollection();
+            for (unsigned i=0; i<box_indices.size(); i++)
+            {
+                const std::set<Node<3>*>& r_nodes = p_box_collection->rGetBox(box_indices[i]).rGetNodesContained();
+                for (std::set<Node<3>*>::const_iterator node_iter = r_nodes.begin();
+                     node_iter != r_nodes.end();
+                     ++node_iter)
+                {
+                    unsigned node_index = (*node_iter)->GetIndex();
+                    if (norm_2((*node_iter)->rGetLocation() - mCentre) < mRadius &&
+                        p_node_population->IsCellAttachedToLocationIndex(node_index))
+                    {
+                        p_node_population->GetCellUsingLocationIndex(node_index)->Kill();
+                    }
+                }
+            }
+            return;
+        }
+    }
+
+    // Otherwise, check every cell
     for (AbstractCellPopulation<3>::Iterator cell_iter = this->mpCellPopulation->Begin();
          cell_iter != this->mpCellPopulation->End();
          ++cell_iter)
@@ -40,8 +225,12 @@ void AnoikisCellKiller3D::OutputCellKillerParameters(out_stream& rParamsFile)
 {
     *rParamsFile << "\t\t\t<xCentre>" << mCentre[0] << "</xCentre>\n";
     *rParamsFile << "\t\t\t<yCentre>" << mCentre[1] << "</yCentre>\n";
-    *rParamsFile << "\t\t\t<yCentre>" << mCentre[2] << "</zCentre>\n";
+    *rParamsFile << "\t\t\t<zCentre>" << mCentre[2] << "</zCentre>\n";
     *rParamsFile << "\t\t\t<mRadius>" << mRadius << "</mRadius>\n";
+    *rParamsFile << "\t\t\t<UseDynamicLumen>" << mUseDynamicLumen << "</UseDynamicLumen>\n";
+    *rParamsFile << "\t\t\t<LumenUpdateInterval>" << mLumenUpdateInterval << "</LumenUpdateInterval>\n";
+    *rParamsFile << "\t\t\t<LumenPercentile>" << mLumenPercentile << "</LumenPercentile>\n";
+    *rParamsFile << "\t\t\t<LumenRadiusOffset>" << mLumenRadiusOffset << "</LumenRadiusOffset>\n";
 
     // Call method on direct parent class
     AbstractCellKiller<3>::OutputCellKillerParameters(rParamsFile);
@@ -7,8 +7,19 @@
 #include <boost/serialization/base_object.hpp>
 
 /**
- *  Kills cells if they are outside a circle whose centre and radius can be
+ *  Kills cells if they are inside a sphere (the lumen) whose centre and radius can be
  *  passed in but are take default values.
+ *
+ *  For a NodeBasedCellPopulation, only the boxes of the population's NodesOnlyMesh
+ *  that overlap the sphere are visited, so the cost scales with the number of cells
+ *  in and around the lumen rather than with the population size.
+ *
+ *  Optionally, the lumen can be estimated from the organoid itself: its centre is
+ *  the centroid of the cells, and its radius is a low percentile of the distances of
+ *  the shell's cells from the centroid, less an offset. The shell is the myoepithelial
+ *  (basal) layer or, in an organoid without myoepithelial cells, the cells with fewer
+ *  neighbours than average, which lie on its surface. Luminal cells are not used, since
+ *  they fill the lumen until it clears. The estimate is refreshed at a given interval.
  */
 class AnoikisCellKiller3D : public AbstractCellKiller<3>
 {
@@ -20,6 +31,33 @@ private:
     /** Radius of death. */
     double mRadius;
 
+    /** Whether the lumen is estimated from the organoid rather than fixed. Defaults to false. */
+    bool mUseDynamicLumen;
+
+    /** The interval (in hours) between lumen estimates in dynamic mode. Defaults to 1.0. */
+    double mLumenUpdateInterval;
+
+    /**
+     * The percentile (between 0 and 1) of the distances of the shell's cells from the
+     * centroid used as the inner radius of the shell in dynamic mode. Defaults to 0.1.
+     */
+    double mLumenPercentile;
+
+    /**
+     * The distance subtracted from the inner radius of the shell to give the lumen radius
+     * in dynamic mode, so that the shell and the layer of luminal cells lining it are
+     * spared. Defaults to 1.5 (half a shell cell and one luminal cell).
+     */
+    double mLumenRadiusOffset;
+
+    /** The time at which the lumen was last estimated. */
+    double mLastLumenUpdateTime;
+
+    /**
+     * Estimate the lumen centre and radius from the current cell population.
+     */
+    void UpdateLumenEstimate();
+
     friend class boost::serialization::access;
     /**
      * Boost Serialization method for archiving/checkpointing.
@@ -32,6 +70,11 @@ private:
     void serialize(Archive & archive, const unsigned int version)
     {
         archive & boost::serialization::base_object<AbstractCellKiller<3> >(*this);
+        archive & mUseDynamicLumen;
+        archive & mLumenUpdateInterval;
+        archive & mLumenPercentile;
+        archive & mLumenRadiusOffset;
+        archive & mLastLumenUpdateTime;
     }
 
 public:
@@ -58,7 +101,55 @@ public:
     double GetRadius() const;
 
     /**
-     * Loop over cells and kills cells outside boundary.
+     * Set whether the lumen is estimated from the organoid.
+     *
+     * @param useDynamicLumen whether to estimate the lumen, rather than use the centre and radius passed to the constructor
+     */
+    void SetUseDynamicLumen(bool useDynamicLumen);
+
+    /**
+     * @return mUseDynamicLumen.
+     */
+    bool GetUseDynamicLumen() const;
+
+    /**
+     * Set mLumenUpdateInterval.
+     *
+     * @param lumenUpdateInterval the interval (in hours) between lumen estimates
+     */
+    void SetLumenUpdateInterval(double lumenUpdateInterval);
+
+    /**
+     * @return mLumenUpdateInterval.
+     */
+    double GetLumenUpdateInterval() const;
+
+    /**
+     * Set mLumenPercentile.
+     *
+     * @param lumenPercentile the percentile (between 0 and 1) giving the inner radius of the shell
+     */
+    void SetLumenPercentile(double lumenPercentile);
+
+    /**
+     * @return mLumenPercentile.
+     */
+    double GetLumenPercentile() const;
+
+    /**
+     * Set mLumenRadiusOffset.
+     *
+     * @param lumenRadiusOffset the distance subtracted from the inner radius of the shell
+     */
+    void SetLumenRadiusOffset(double lumenRadiusOffset);
+
+    /**
+     * @return mLumenRadiusOffset.
+     */
+    double GetLumenRadiusOffset() const;
+
+    /**
+     * Loop over cells in the lumen and kill them.
      */
     virtual void CheckAndLabelCellsForApoptosisOrDeath();
 
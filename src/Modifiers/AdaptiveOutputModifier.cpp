@@ -0,0 +1,263 @@
+#include "AdaptiveOutputModifier.hpp"
+#include <algorithm>
+#include <cmath>
+#include "MammaryCellPropertyHelper.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "Exception.hpp"
+#include "MammaryProfiler.hpp"
+
+template<unsigned DIM>
+AdaptiveOutputModifier<DIM>::AdaptiveOutputModifier()
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mCellCountChangeThreshold(1),
+      mDisplacementThreshold(0.0),
+      mPhenotypeChangeThreshold(1),
+      mMinOutputInterval(1),
+      mMaxOutputInterval(0),
+      mLastOutputTimeStep(0),
+      mLastNumCells(0),
+      mNumSnapshotsWritten(0)
+{
+}
+
+template<unsigned DIM>
+AdaptiveOutputModifier<DIM>::~AdaptiveOutputModifier()
+{
+}
+
+template<unsigned DIM>
+unsigned AdaptiveOutputModifier<DIM>::GetCellCountChangeThreshold() const
+{
+    return mCellCountChangeThreshold;
+}
+
+template<unsigned DIM>
+void AdaptiveOutputModifier<DIM>::SetCellCountChangeThreshold(unsigned cellCountChangeThreshold)
+{
+    mCellCountChangeThreshold = cellCountChangeThreshold;
+}
+
+template<unsigned DIM>
+double AdaptiveOutputModifier<DIM>::GetDisplacementThreshold() const
+{
+    return mDisplacementThreshold;
+}
+
+template<unsigned DIM>
+void AdaptiveOutputModifier<DIM>::SetDisplacementThreshold(double displacementThreshold)
+{
+    if (displacementThreshold < 0.0)
+    {
+        EXCEPTION("The displacement threshold must be non-negative");
+    }
+    mDisplacementThreshold = displacementThreshold;
+}
+
+template<unsigned DIM>
+unsigned AdaptiveOutputModifier<DIM>::GetPhenotypeChangeThreshold() const
+{
+    return mPhenotypeChangeThreshold;
+}
+
+template<unsigned DIM>
+void AdaptiveOutputModifier<DIM>::SetPhenotypeChangeThreshold(unsigned phenotypeChangeThreshold)
+{
+    mPhenotypeChangeThreshold = phenotypeChangeThreshold;
+}
+
+template<unsigned DIM>
+unsigned AdaptiveOutputModifier<DIM>::GetMinOutputInterval() const
+{
+    return mMinOutputInterval;
+}
+
+template<unsigned DIM>
+unsigned AdaptiveOutputModifier<DIM>::GetMaxOutputInterval() const
+{
+    return mMaxOutputInterval;
+}
+
+template<unsigned DIM>
+void AdaptiveOutputModifier<DIM>::SetOutputIntervals(unsigned minOutputInterval, unsigned maxOutputInterval)
+{
+    if (minOutputInterval == 0 || (maxOutputInterval != 0 && maxOutputInterval < minOutputInterval))
+    {
+        EXCEPTION("The minimum output interval must be at least 1 and no more than the maximum");
+    }
+    mMinOutputInterval = minOutputInterval;
+    mMaxOutputInterval = maxOutputInterval;
+}
+
+template<unsigned DIM>
+unsigned AdaptiveOutputModifier<DIM>::GetNumSnapshotsWritten() const
+{
+    return mNumSnapshotsWritten;
+}
+
+template<unsigned DIM>
+uint8_t AdaptiveOutputModifier<DIM>::GetPhenotype(CellPtr pCell)
+{
+    boost::shared_ptr<AbstractMammaryCellProperty> p_property = MammaryCellPropertyHelper::GetMammaryCellProperty(pCell);
+    uint8_t phenotype = MammaryCellPropertyHelper::GetMammaryCellType(p_property);
+    if (p_property)
+    {
+        phenotype |= (p_property->GetB1IntegrinExpression() ? 8u : 0u) | (p_property->GetB4IntegrinExpression() ? 16u : 0u);
+    }
+    return phenotype;
+}
+
+template<unsigned DIM>
+void AdaptiveOutputModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+    mOutputDirectory = outputDirectory;
+    OutputFileHandler output_file_handler(outputDirectory + "/", false);
+    mpOutputTimesFile = output_file_handler.OpenOutputFile("adaptive_output_times.dat");
+
+    mNumSnapshotsWritten = 0;
+    RecordState(rCellPopulation);
+}
+
+template<unsigned DIM>
+void AdaptiveOutputModifier<DIM>::RecordState(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    mLastOutputTimeStep = SimulationTime::Instance()->GetTimeStepsElapsed();
+    mLastNumCells = 0;
+    std::fill(mLastPositions.begin(), mLastPositions.end(), DOUBLE_UNSET);
+    std::fill(mLastPhenotypes.begin(), mLastPhenotypes.end(), UINT8_MAX);
+
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        unsigned cell_id = cell_iter->GetCellId();
+        if (cell_id >= mLastPhenotypes.size())
+        {
+            // Grow geometrically, as new cell IDs appear
+            unsigned new_size = std::max(2*static_cast<unsigned>(mLastPhenotypes.size()), cell_id + 1);
+            mLastPhenotypes.resize(new_size, UINT8_MAX);
+            mLastPositions.resize(new_size*DIM, DOUBLE_UNSET);
+        }
+
+        mLastPhenotypes[cell_id] = GetPhenotype(*cell_iter);
+        c_vector<double, DIM> location = rCellPopulation.GetLocationOfCellCentre(*cell_iter);
+        for (unsigned d=0; d<DIM; d++)
+        {
+            mLastPositions[cell_id*DIM + d] = location[d];
+        }
+        mLastNumCells++;
+    }
+}
+
+template<unsigned DIM>
+void AdaptiveOutputModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    MAMMARY_PROFILE_SCOPE("step/modifiers/AdaptiveOutputModifier");
+
+    SimulationTime* p_time = SimulationTime::Instance();
+    unsigned num_steps_since_output = p_time->GetTimeStepsElapsed() - mLastOutputTimeStep;
+    if (num_steps_since_output < mMinOutputInterval)
+    {
+        return;
+    }
+
+    // Compare the population with its state at the last snapshot
+    unsigned num_cells = 0;
+    unsigned num_births = 0;
+    unsigned num_phenotype_changes = 0;
+    double max_squared_displacement = 0.0;
+    bool check_cells = (mCellCountChangeThreshold > 0 || mPhenotypeChangeThreshold > 0 || mDisplacementThreshold > 0.0);
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         check_cells && cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        num_cells++;
+        unsigned cell_id = cell_iter->GetCellId();
+        if (cell_id >= mLastPhenotypes.size() || mLastPhenotypes[cell_id] == UINT8_MAX)
+        {
+            num_births++;
+            continue;
+        }
+
+        if (mPhenotypeChangeThreshold > 0 && GetPhenotype(*cell_iter) != mLastPhenotypes[cell_id])
+        {
+            num_phenotype_changes++;
+        }
+
+        if (mDisplacementThreshold > 0.0)
+        {
+            c_vector<double, DIM> location = rCellPopulation.GetLocationOfCellCentre(*cell_iter);
+            double squared_displacement = 0.0;
+            for (unsigned d=0; d<DIM; d++)
+            {
+                double displacement = location[d] - mLastPositions[cell_id*DIM + d];
+                squared_displacement += displacement*displacement;
+            }
+            max_squared_displacement = std::max(max_squared_displacement, squared_displacement);
+        }
+    }
+    unsigned num_removals = check_cells ? mLastNumCells + num_births - num_cells : 0;
+    double max_displacement = sqrt(max_squared_displacement);
+
+    std::string trigger;
+    if (mCellCountChangeThreshold > 0 && num_births + num_removals >= mCellCountChangeThreshold)
+    {
+        trigger = "count";
+    }
+    else if (mDisplacementThreshold > 0.0 && max_displacement >= mDisplacementThreshold)
+    {
+        trigger = "displacement";
+    }
+    else if (mPhenotypeChangeThreshold > 0 && num_phenotype_changes >= mPhenotypeChangeThreshold)
+    {
+        trigger = "phenotype";
+    }
+    else if (mMaxOutputInterval > 0 && num_steps_since_output >= mMaxOutputInterval)
+    {
+        trigger = "interval";
+    }
+
+    if (!trigger.empty())
+    {
+        rCellPopulation.WriteResultsToFiles(mOutputDirectory + "/");
+        mNumSnapshotsWritten++;
+
+        *mpOutputTimesFile << p_time->GetTime() << "\t" << trigger << "\t" << num_births << "\t" << num_removals
+                           << "\t" << max_displacement << "\t" << num_phenotype_changes << "\n";
+        mpOutputTimesFile->flush();
+
+        RecordState(rCellPopulation);
+    }
+}
+
+template<unsigned DIM>
+void AdaptiveOutputModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    if (mpOutputTimesFile)
+    {
+        mpOutputTimesFile->close();
+        mpOutputTimesFile.reset();
+    }
+}
+
+template<unsigned DIM>
+void AdaptiveOutputModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<CellCountChangeThreshold>" << mCellCountChangeThreshold << "</CellCountChangeThreshold>\n";
+    *rParamsFile << "\t\t\t<DisplacementThreshold>" << mDisplacementThreshold << "</DisplacementThreshold>\n";
+    *rParamsFile << "\t\t\t<PhenotypeChangeThreshold>" << mPhenotypeChangeThreshold << "</PhenotypeChangeThreshold>\n";
+    *rParamsFile << "\t\t\t<MinOutputInterval>" << mMinOutputInterval << "</MinOutputInterval>\n";
+    *rParamsFile << "\t\t\t<MaxOutputInterval>" << mMaxOutputInterval << "</MaxOutputInterval>\n";
+
+    // Call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class AdaptiveOutputModifier<1>;
+template class AdaptiveOutputModifier<2>;
+template class AdaptiveOutputModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(AdaptiveOutputModifier)
@@ -0,0 +1,221 @@
+#ifndef ADAPTIVEOUTPUTMODIFIER_HPP_
+#define ADAPTIVEOUTPUTMODIFIER_HPP_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+
+/**
+ * A modifier class which writes the population's output (that of all its cell and
+ * population writers) when something happens, rather than at a fixed interval.
+ *
+ * After each time step, a snapshot is written if any of the enabled triggers fires:
+ * - the number of cells born or removed since the last snapshot reaches mCellCountChangeThreshold;
+ * - some cell has moved at least mDisplacementThreshold since the last snapshot;
+ * - the number of cells whose mammary type or integrin expression has changed since the
+ *   last snapshot reaches mPhenotypeChangeThreshold;
+ * - mMaxOutputInterval time steps have passed since the last snapshot.
+ * No snapshot is written within mMinOutputInterval time steps of the last one. Each trigger
+ * is disabled by a threshold of 0. With no triggers other than the maximum interval, output
+ * is written at a fixed interval as usual.
+ *
+ * The simulation still writes its own output every SetSamplingTimestepMultiple() time
+ * steps, so the sampling multiple must be set to more than the number of time steps in
+ * the simulation (i.e. the sampling interval must exceed the end time), leaving the
+ * simulation to write only the initial state. Otherwise, at any time step where both
+ * write, WriteResultsToFiles() is called twice and the time step appears twice in the
+ * output. The time of each snapshot written by this modifier, and what triggered it
+ * (with the numbers of births and removals, the largest displacement and the number of
+ * phenotype changes since the last snapshot), are recorded in adaptive_output_times.dat.
+ */
+template<unsigned DIM>
+class AdaptiveOutputModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+private:
+
+    /** The number of births and removals that triggers a snapshot (0 to disable). Defaults to 1. */
+    unsigned mCellCountChangeThreshold;
+
+    /** The displacement of a cell that triggers a snapshot (0 to disable). Defaults to 0. */
+    double mDisplacementThreshold;
+
+    /** The number of phenotype changes that triggers a snapshot (0 to disable). Defaults to 1. */
+    unsigned mPhenotypeChangeThreshold;
+
+    /** The minimum number of time steps between snapshots. Defaults to 1. */
+    unsigned mMinOutputInterval;
+
+    /** The maximum number of time steps between snapshots (0 for no maximum). Defaults to 0. */
+    unsigned mMaxOutputInterval;
+
+    /** The directory to which the population's output is written. */
+    std::string mOutputDirectory;
+
+    /** The output file recording the time and trigger of each snapshot. */
+    out_stream mpOutputTimesFile;
+
+    /** The number of time steps elapsed at the last snapshot. */
+    unsigned mLastOutputTimeStep;
+
+    /** The number of cells at the last snapshot. */
+    unsigned mLastNumCells;
+
+    /** The position of each cell at the last snapshot, by cell ID (DOUBLE_UNSET for cells not then present). */
+    std::vector<double> mLastPositions;
+
+    /** The phenotype of each cell at the last snapshot, by cell ID (UINT8_MAX for cells not then present). */
+    std::vector<uint8_t> mLastPhenotypes;
+
+    /** The number of snapshots written by this modifier. */
+    unsigned mNumSnapshotsWritten;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mCellCountChangeThreshold;
+        archive & mDisplacementThreshold;
+        archive & mPhenotypeChangeThreshold;
+        archive & mMinOutputInterval;
+        archive & mMaxOutputInterval;
+    }
+
+    /**
+     * @param pCell a cell
+     * @return the cell's phenotype: its mammary type, with its integrin expression in bits 3 and 4
+     */
+    static uint8_t GetPhenotype(CellPtr pCell);
+
+    /**
+     * Record the state of the population at a snapshot.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void RecordState(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    AdaptiveOutputModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~AdaptiveOutputModifier();
+
+    /**
+     * @return mCellCountChangeThreshold
+     */
+    unsigned GetCellCountChangeThreshold() const;
+
+    /**
+     * Set mCellCountChangeThreshold.
+     *
+     * @param cellCountChangeThreshold the number of births and removals that triggers a snapshot (0 to disable)
+     */
+    void SetCellCountChangeThreshold(unsigned cellCountChangeThreshold);
+
+    /**
+     * @return mDisplacementThreshold
+     */
+    double GetDisplacementThreshold() const;
+
+    /**
+     * Set mDisplacementThreshold.
+     *
+     * @param displacementThreshold the displacement of a cell that triggers a snapshot (0 to disable)
+     */
+    void SetDisplacementThreshold(double displacementThreshold);
+
+    /**
+     * @return mPhenotypeChangeThreshold
+     */
+    unsigned GetPhenotypeChangeThreshold() const;
+
+    /**
+     * Set mPhenotypeChangeThreshold.
+     *
+     * @param phenotypeChangeThreshold the number of phenotype changes that triggers a snapshot (0 to disable)
+     */
+    void SetPhenotypeChangeThreshold(unsigned phenotypeChangeThreshold);
+
+    /**
+     * @return mMinOutputInterval
+     */
+    unsigned GetMinOutputInterval() const;
+
+    /**
+     * @return mMaxOutputInterval
+     */
+    unsigned GetMaxOutputInterval() const;
+
+    /**
+     * Set the minimum and maximum number of time steps between snapshots.
+     *
+     * @param minOutputInterval the minimum number of time steps between snapshots (at least 1)
+     * @param maxOutputInterval the maximum number of time steps between snapshots (0 for no maximum)
+     */
+    void SetOutputIntervals(unsigned minOutputInterval, unsigned maxOutputInterval);
+
+    /**
+     * @return the number of snapshots written by this modifier
+     */
+    unsigned GetNumSnapshotsWritten() const;
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Writes a snapshot if any trigger fires.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Records the initial state, which the simulation writes itself.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Closes adaptive_output_times.dat.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(AdaptiveOutputModifier)
+
+#endif /*ADAPTIVEOUTPUTMODIFIER_HPP_*/
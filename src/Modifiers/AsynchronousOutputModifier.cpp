@@ -0,0 +1,333 @@
+#include "AsynchronousOutputModifier.hpp"
+#include <chrono>
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "Exception.hpp"
+#include "MammaryProfiler.hpp"
+
+template<unsigned DIM>
+AsynchronousOutputModifier<DIM>::AsynchronousOutputModifier()
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mOutputTimestepMultiple(1),
+      mMaxQueuedSnapshots(2),
+      mStopRequested(false),
+      mWriterFailed(false),
+      mNumSnapshotsWritten(0),
+      mNumStalls(0),
+      mTotalStallTime(0.0)
+{
+}
+
+template<unsigned DIM>
+AsynchronousOutputModifier<DIM>::~AsynchronousOutputModifier()
+{
+    // Don't throw from the destructor; any error will already have been reported, or is lost with the simulation
+    try
+    {
+        StopWriterThread();
+    }
+    catch (Exception&)
+    {
+    }
+}
+
+template<unsigned DIM>
+void AsynchronousOutputModifier<DIM>::AddSnapshotFormat(boost::shared_ptr<AbstractSnapshotFormat<DIM> > pFormat)
+{
+    if (mWriterThread.joinable())
+    {
+        EXCEPTION("Snapshot formats cannot be added while the simulation is running");
+    }
+    mFormats.push_back(pFormat);
+}
+
+template<unsigned DIM>
+unsigned AsynchronousOutputModifier<DIM>::GetNumSnapshotFormats() const
+{
+    return mFormats.size();
+}
+
+template<unsigned DIM>
+unsigned AsynchronousOutputModifier<DIM>::GetOutputTimestepMultiple() const
+{
+    return mOutputTimestepMultiple;
+}
+
+template<unsigned DIM>
+void AsynchronousOutputModifier<DIM>::SetOutputTimestepMultiple(unsigned outputTimestepMultiple)
+{
+    assert(outputTimestepMultiple > 0);
+    mOutputTimestepMultiple = outputTimestepMultiple;
+}
+
+template<unsigned DIM>
+unsigned AsynchronousOutputModifier<DIM>::GetMaxQueuedSnapshots() const
+{
+    return mMaxQueuedSnapshots;
+}
+
+template<unsigned DIM>
+void AsynchronousOutputModifier<DIM>::SetMaxQueuedSnapshots(unsigned maxQueuedSnapshots)
+{
+    if (maxQueuedSnapshots == 0)
+    {
+        EXCEPTION("At least one snapshot must be allowed to wait to be written");
+    }
+    mMaxQueuedSnapshots = maxQueuedSnapshots;
+}
+
+template<unsigned DIM>
+unsigned AsynchronousOutputModifier<DIM>::GetNumSnapshotsWritten()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumSnapshotsWritten;
+}
+
+template<unsigned DIM>
+unsigned AsynchronousOutputModifier<DIM>::GetNumStalls()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mNumStalls;
+}
+
+template<unsigned DIM>
+double AsynchronousOutputModifier<DIM>::GetTotalStallTime()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    return mTotalStallTime;
+}
+
+template<unsigned DIM>
+std::size_t AsynchronousOutputModifier<DIM>::GetNumBufferBytes()
+{
+    std::lock_guard<std::mutex> lock(mMutex);
+    std::size_t num_bytes = 0;
+    for (unsigned i=0; i<mQueuedSnapshots.size(); i++)
+    {
+        num_bytes += sizeof(MammaryPopulationSnapshot<DIM>) + mQueuedSnapshots[i]->GetNumBytesReserved();
+    }
+    for (unsigned i=0; i<mFreeSnapshots.size(); i++)
+    {
+        num_bytes += sizeof(MammaryPopulationSnapshot<DIM>) + mFreeSnapshots[i]->GetNumBytesReserved();
+    }
+    return num_bytes;
+}
+
+template<unsigned DIM>
+void AsynchronousOutputModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+    // Any error of an earlier run has already been thrown from the Solve() that it stopped
+    try
+    {
+        StopWriterThread();
+    }
+    catch (Exception&)
+    {
+    }
+
+    OutputFileHandler output_file_handler(outputDirectory + "/", false);
+    mOutputStreams.clear();
+    for (unsigned i=0; i<mFormats.size(); i++)
+    {
+        std::ios_base::openmode mode = std::ios::out | std::ios::trunc;
+        if (mFormats[i]->IsBinary())
+        {
+            mode |= std::ios::binary;
+        }
+        mOutputStreams.push_back(output_file_handler.OpenOutputFile(mFormats[i]->rGetFileName(), mode));
+        mFormats[i]->WriteHeader(*mOutputStreams.back());
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopRequested = false;
+        mWriterFailed = false;
+        mWriterErrorMessage.clear();
+        mNumSnapshotsWritten = 0;
+        mNumStalls = 0;
+        mTotalStallTime = 0.0;
+    }
+    mWriterThread = std::thread(&AsynchronousOutputModifier<DIM>::WriteQueuedSnapshots, this);
+
+    // Write the initial state, as the synchronous writers do
+    QueueSnapshot(rCellPopulation);
+}
+
+template<unsigned DIM>
+void AsynchronousOutputModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    MAMMARY_PROFILE_SCOPE("step/modifiers/AsynchronousOutputModifier");
+
+    if (SimulationTime::Instance()->GetTimeStepsElapsed() % mOutputTimestepMultiple == 0)
+    {
+        QueueSnapshot(rCellPopulation);
+    }
+}
+
+template<unsigned DIM>
+void AsynchronousOutputModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    StopWriterThread();
+}
+
+template<unsigned DIM>
+void AsynchronousOutputModifier<DIM>::QueueSnapshot(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    if (mFormats.empty())
+    {
+        return;
+    }
+
+    // Take a free buffer, waiting for the writer thread if too many snapshots are already queued
+    boost::shared_ptr<MammaryPopulationSnapshot<DIM> > p_snapshot;
+    {
+        std::unique_lock<std::mutex> lock(mMutex);
+        ThrowIfWriterFailed();
+        if (mQueuedSnapshots.size() >= mMaxQueuedSnapshots)
+        {
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            while (mQueuedSnapshots.size() >= mMaxQueuedSnapshots && !mWriterFailed)
+            {
+                mSnapshotWrittenCondition.wait(lock);
+            }
+            mNumStalls++;
+            mTotalStallTime += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            ThrowIfWriterFailed();
+        }
+
+        if (mFreeSnapshots.empty())
+        {
+            p_snapshot.reset(new MammaryPopulationSnapshot<DIM>());
+        }
+        else
+        {
+            p_snapshot = mFreeSnapshots.back();
+            mFreeSnapshots.pop_back();
+        }
+    }
+
+    // The copy is made on this thread, without holding the lock, since it reads the population
+    p_snapshot->Capture(rCellPopulation);
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mQueuedSnapshots.push_back(p_snapshot);
+    }
+    mSnapshotQueuedCondition.notify_one();
+}
+
+template<unsigned DIM>
+void AsynchronousOutputModifier<DIM>::WriteQueuedSnapshots()
+{
+    while (true)
+    {
+        boost::shared_ptr<MammaryPopulationSnapshot<DIM> > p_snapshot;
+        {
+            std::unique_lock<std::mutex> lock(mMutex);
+            while (mQueuedSnapshots.empty() && !mStopRequested)
+            {
+                mSnapshotQueuedCondition.wait(lock);
+            }
+            if (mQueuedSnapshots.empty())
+            {
+                return;
+            }
+            p_snapshot = mQueuedSnapshots.front();
+        }
+
+        // Format and write the snapshot without holding the lock, so that the time loop can queue the next one
+        std::string error_message;
+        try
+        {
+            for (unsigned i=0; i<mFormats.size(); i++)
+            {
+                mFormats[i]->WriteSnapshot(*p_snapshot, *mOutputStreams[i]);
+            }
+        }
+        catch (Exception& e)
+        {
+            error_message = e.GetMessage();
+        }
+        catch (std::exception& e)
+        {
+            error_message = e.what();
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mMutex);
+            mQueuedSnapshots.pop_front();
+            mFreeSnapshots.push_back(p_snapshot);
+            if (error_message.empty())
+            {
+                mNumSnapshotsWritten++;
+            }
+            else
+            {
+                // Discard anything else queued, so that the time loop is never left waiting
+                mWriterFailed = true;
+                mWriterErrorMessage = error_message;
+                mQueuedSnapshots.clear();
+            }
+        }
+        mSnapshotWrittenCondition.notify_all();
+
+        if (!error_message.empty())
+        {
+            return;
+        }
+    }
+}
+
+template<unsigned DIM>
+void AsynchronousOutputModifier<DIM>::StopWriterThread()
+{
+    if (!mWriterThread.joinable())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mMutex);
+        mStopRequested = true;
+    }
+    mSnapshotQueuedCondition.notify_one();
+    mWriterThread.join();
+
+    for (unsigned i=0; i<mOutputStreams.size(); i++)
+    {
+        mOutputStreams[i]->close();
+    }
+    mOutputStreams.clear();
+
+    std::lock_guard<std::mutex> lock(mMutex);
+    ThrowIfWriterFailed();
+}
+
+template<unsigned DIM>
+void AsynchronousOutputModifier<DIM>::ThrowIfWriterFailed()
+{
+    // The failure is kept, since the writer thread has exited and nothing would empty the queue again
+    if (mWriterFailed)
+    {
+        EXCEPTION("Asynchronous output failed: " + mWriterErrorMessage);
+    }
+}
+
+template<unsigned DIM>
+void AsynchronousOutputModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<OutputTimestepMultiple>" << mOutputTimestepMultiple << "</OutputTimestepMultiple>\n";
+    *rParamsFile << "\t\t\t<MaxQueuedSnapshots>" << mMaxQueuedSnapshots << "</MaxQueuedSnapshots>\n";
+
+    // Call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class AsynchronousOutputModifier<1>;
+template class AsynchronousOutputModifier<2>;
+template class AsynchronousOutputModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(AsynchronousOutputModifier)
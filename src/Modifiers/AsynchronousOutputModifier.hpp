@@ -0,0 +1,244 @@
+#ifndef ASYNCHRONOUSOUTPUTMODIFIER_HPP_
+#define ASYNCHRONOUSOUTPUTMODIFIER_HPP_
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "AbstractSnapshotFormat.hpp"
+#include "MammaryPopulationSnapshot.hpp"
+
+/**
+ * A modifier class which writes population output on a background thread, in place of
+ * the synchronous cell writers (e.g. CellLocationWriter, CellVelocityWriter and
+ * MammaryCellTypeWriter, whose output is reproduced by LocationSnapshotFormat,
+ * VelocitySnapshotFormat and CellTypeSnapshotFormat).
+ *
+ * Every mOutputTimestepMultiple time steps, the state of the population is copied into a
+ * MammaryPopulationSnapshot, which is queued for a writer thread that formats it with each
+ * of the added snapshot formats and writes the results to file, while the simulation moves
+ * on. Snapshot buffers are recycled once written.
+ *
+ * At most mMaxQueuedSnapshots snapshots may be queued (including the one being written)
+ * at any time. If the writer thread falls this far behind, the time loop waits for it to
+ * catch up (back-pressure), so that memory use stays bounded. The default of 2 gives double buffering.
+ *
+ * Any error on the writer thread is rethrown as an exception on the simulation thread at
+ * the next output step, or at the end of Solve(), once all queued snapshots have been written.
+ * The writer thread stops at its first error, so every later output step throws too, until
+ * SetupSolve() starts a new one.
+ *
+ * The added formats are not archived, so must be added again after loading a simulation.
+ */
+template<unsigned DIM>
+class AsynchronousOutputModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+private:
+
+    /** The number of time steps between snapshots. Defaults to 1. */
+    unsigned mOutputTimestepMultiple;
+
+    /** The maximum number of snapshots queued, including the one being written. Defaults to 2. */
+    unsigned mMaxQueuedSnapshots;
+
+    /** The formats in which snapshots are written. */
+    std::vector<boost::shared_ptr<AbstractSnapshotFormat<DIM> > > mFormats;
+
+    /** The output file of each format. */
+    std::vector<out_stream> mOutputStreams;
+
+    /** The writer thread. */
+    std::thread mWriterThread;
+
+    /** Protects all members below, which are shared with the writer thread. */
+    std::mutex mMutex;
+
+    /** Signalled when a snapshot is queued, or the writer thread is asked to stop. */
+    std::condition_variable mSnapshotQueuedCondition;
+
+    /** Signalled when a snapshot has been written, or the writer thread fails. */
+    std::condition_variable mSnapshotWrittenCondition;
+
+    /** The snapshots waiting to be written, oldest first. */
+    std::deque<boost::shared_ptr<MammaryPopulationSnapshot<DIM> > > mQueuedSnapshots;
+
+    /** Snapshot buffers that have been written and may be reused. */
+    std::vector<boost::shared_ptr<MammaryPopulationSnapshot<DIM> > > mFreeSnapshots;
+
+    /** Whether the writer thread has been asked to stop once the queue is empty. */
+    bool mStopRequested;
+
+    /** Whether the writer thread has failed (and so stopped). Only reset by SetupSolve(). */
+    bool mWriterFailed;
+
+    /** The message of the error on the writer thread, if it has failed. */
+    std::string mWriterErrorMessage;
+
+    /** The number of snapshots written so far. */
+    unsigned mNumSnapshotsWritten;
+
+    /** The number of times the time loop has had to wait for the writer thread. */
+    unsigned mNumStalls;
+
+    /** The total time (in seconds) the time loop has spent waiting for the writer thread. */
+    double mTotalStallTime;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mOutputTimestepMultiple;
+        archive & mMaxQueuedSnapshots;
+    }
+
+    /**
+     * The main loop of the writer thread.
+     */
+    void WriteQueuedSnapshots();
+
+    /**
+     * Copy the state of the population into a snapshot and queue it for writing, first
+     * waiting for room in the queue if necessary.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void QueueSnapshot(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Wait for all queued snapshots to be written, stop the writer thread and close the
+     * output files. Does nothing if the writer thread is not running.
+     */
+    void StopWriterThread();
+
+    /**
+     * Throw an exception if the writer thread has failed. Must be called with mMutex locked.
+     */
+    void ThrowIfWriterFailed();
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    AsynchronousOutputModifier();
+
+    /**
+     * Destructor, which waits for any queued snapshots to be written.
+     */
+    virtual ~AsynchronousOutputModifier();
+
+    /**
+     * Add a format in which snapshots are written. Must be called before the simulation is run.
+     *
+     * @param pFormat the format
+     */
+    void AddSnapshotFormat(boost::shared_ptr<AbstractSnapshotFormat<DIM> > pFormat);
+
+    /**
+     * @return the number of formats in which snapshots are written
+     */
+    unsigned GetNumSnapshotFormats() const;
+
+    /**
+     * @return mOutputTimestepMultiple
+     */
+    unsigned GetOutputTimestepMultiple() const;
+
+    /**
+     * Set mOutputTimestepMultiple.
+     *
+     * @param outputTimestepMultiple the number of time steps between snapshots
+     */
+    void SetOutputTimestepMultiple(unsigned outputTimestepMultiple);
+
+    /**
+     * @return mMaxQueuedSnapshots
+     */
+    unsigned GetMaxQueuedSnapshots() const;
+
+    /**
+     * Set mMaxQueuedSnapshots.
+     *
+     * @param maxQueuedSnapshots the maximum number of snapshots queued, including the one being written (at least 1)
+     */
+    void SetMaxQueuedSnapshots(unsigned maxQueuedSnapshots);
+
+    /**
+     * @return the number of snapshots written so far
+     */
+    unsigned GetNumSnapshotsWritten();
+
+    /**
+     * @return the number of times the time loop has had to wait for the writer thread
+     */
+    unsigned GetNumStalls();
+
+    /**
+     * @return the total time (in seconds) the time loop has spent waiting for the writer thread
+     */
+    double GetTotalStallTime();
+
+    /**
+     * @return the number of bytes reserved by the snapshot buffers that are queued or free for reuse
+     */
+    std::size_t GetNumBufferBytes();
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Queues a snapshot every mOutputTimestepMultiple time steps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Opens the output file of each format, starts the writer thread and queues a snapshot
+     * of the initial state.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Waits for all queued snapshots to be written and closes the output files.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(AsynchronousOutputModifier)
+
+#endif /*ASYNCHRONOUSOUTPUTMODIFIER_HPP_*/
@@ -1,10 +1,12 @@
 #include "CellHeightTrackingModifier.hpp"
 #include "NodeBasedCellPopulation.hpp"
 #include "Debug.hpp"
+#include "MammaryProfiler.hpp"
 
 template<unsigned DIM>
 CellHeightTrackingModifier<DIM>::CellHeightTrackingModifier()
-    : AbstractCellBasedSimulationModifier<DIM>()
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mHeightHandle(UNSIGNED_UNSET)
 {
 }
 
@@ -16,14 +18,20 @@ CellHeightTrackingModifier<DIM>::~CellHeightTrackingModifier()
 template<unsigned DIM>
 void CellHeightTrackingModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
 {
+    MAMMARY_PROFILE_SCOPE("step/modifiers/CellHeightTrackingModifier");
+
     UpdateCellData(rCellPopulation);
 }
 
 template<unsigned DIM>
 void CellHeightTrackingModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
 {
+    // Resolve the column handle once, rather than looking up "height" by name every time step
+    mpCellDataColumns = CellDataColumns::Get(rCellPopulation.GetCellPropertyRegistry());
+    mHeightHandle = mpCellDataColumns->RegisterColumn("height");
+
     /*
-     * We must update CellData in SetupSolve(), otherwise it will not have been
+     * We must update the cell data in SetupSolve(), otherwise it will not have been
      * fully initialised by the time we enter the main time loop.
      */
     UpdateCellData(rCellPopulation);
@@ -32,19 +40,21 @@ void CellHeightTrackingModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>
 template<unsigned DIM>
 void CellHeightTrackingModifier<DIM>::UpdateCellData(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
 {
-    // Make sure the cell population is updated
+    /*
+     * Make sure the cell population is updated. Besides the heights read here, this rebuilds
+     * the boxes and neighbour lists after the move, which the killers read at the start of the
+     * next time step.
+     */
     rCellPopulation.Update();
 
-    // Iterate over cell population
+    assert(mHeightHandle != UNSIGNED_UNSET);
+
+    // Copy the height of each cell into the column (which grows geometrically as new cell IDs appear)
     for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
         cell_iter != rCellPopulation.End();
         ++cell_iter)
     {
-        // Get the height of this cell
-        double cell_height = rCellPopulation.GetLocationOfCellCentre(*cell_iter)[2];
-
-        // Store the cell's height in CellData
-        cell_iter->GetCellData()->SetItem("height", cell_height);
+        mpCellDataColumns->SetValue(mHeightHandle, cell_iter->GetCellId(), rCellPopulation.GetLocationOfCellCentre(*cell_iter)[DIM-1]);
     }
 }
 
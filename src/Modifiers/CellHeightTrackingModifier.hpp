@@ -5,15 +5,22 @@
 #include <boost/serialization/base_object.hpp>
 
 #include "AbstractCellBasedSimulationModifier.hpp"
+#include "CellDataColumns.hpp"
 
 /**
  * A modifier class which at each simulation time step calculates the cell height of each cell
- * and stores it in in the CellData property as "cell height". To be used in conjunction with
- * contact inhibition cell cycle models.
+ * and stores it in the "height" column of the population's CellDataColumns. To be used in
+ * conjunction with contact inhibition cell cycle models.
  */
 template<unsigned DIM>
 class CellHeightTrackingModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
 {
+    /** The cell data columns of the cell population, resolved in SetupSolve(). */
+    boost::shared_ptr<CellDataColumns> mpCellDataColumns;
+
+    /** The handle of the "height" column in mpCellDataColumns, resolved in SetupSolve(). */
+    unsigned mHeightHandle;
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
@@ -61,7 +68,7 @@ public:
     virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
 
     /**
-     * Helper method to compute the volume of each cell in the population and store these in the CellData.
+     * Helper method to compute the height of each cell in the population and store these in CellDataColumns.
      *
      * @param rCellPopulation reference to the cell population
      */
@@ -0,0 +1,255 @@
+#include "CellTrajectoryStoreModifier.hpp"
+#include <algorithm>
+#include <cfloat>
+#include "CellDataColumns.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "Exception.hpp"
+#include "MammaryProfiler.hpp"
+
+template<unsigned DIM>
+CellTrajectoryStoreModifier<DIM>::CellTrajectoryStoreModifier()
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mSamplingTimestepMultiple(1),
+      mChunkSize(32),
+      mNumBytesWritten(0)
+{
+}
+
+template<unsigned DIM>
+CellTrajectoryStoreModifier<DIM>::~CellTrajectoryStoreModifier()
+{
+}
+
+template<unsigned DIM>
+unsigned CellTrajectoryStoreModifier<DIM>::GetSamplingTimestepMultiple() const
+{
+    return mSamplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+void CellTrajectoryStoreModifier<DIM>::SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple)
+{
+    if (samplingTimestepMultiple == 0)
+    {
+        EXCEPTION("The sampling timestep multiple must be at least 1");
+    }
+    mSamplingTimestepMultiple = samplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+unsigned CellTrajectoryStoreModifier<DIM>::GetChunkSize() const
+{
+    return mChunkSize;
+}
+
+template<unsigned DIM>
+void CellTrajectoryStoreModifier<DIM>::SetChunkSize(unsigned chunkSize)
+{
+    if (chunkSize == 0)
+    {
+        EXCEPTION("The chunk size must be at least 1");
+    }
+    mChunkSize = chunkSize;
+}
+
+template<unsigned DIM>
+void CellTrajectoryStoreModifier<DIM>::Write(const void* pData, uint64_t size)
+{
+    mpOutputFile->write(reinterpret_cast<const char*>(pData), size);
+    mNumBytesWritten += size;
+}
+
+template<unsigned DIM>
+void CellTrajectoryStoreModifier<DIM>::WriteChunk(unsigned cellId, CellRecord& rRecord)
+{
+    uint32_t header[2] = {cellId, static_cast<uint32_t>(rRecord.mBuffer.size()/(1+DIM))};
+    rRecord.mChunkOffsets.push_back(mNumBytesWritten);
+    Write(header, sizeof(header));
+    Write(&rRecord.mBuffer[0], rRecord.mBuffer.size()*sizeof(double));
+
+    // Release the buffer's memory, which would otherwise be held for the rest of the cell's life
+    std::vector<double>().swap(rRecord.mBuffer);
+}
+
+template<unsigned DIM>
+void CellTrajectoryStoreModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+    // Without recorded parents every cell would be stored as a root, and lineage queries would silently find nothing
+    if (!CellDataColumns::Get(rCellPopulation.GetCellPropertyRegistry())->HasColumn("parent_id"))
+    {
+        EXCEPTION("CellTrajectoryStoreModifier needs the parent_id cell data column, which is written by MammaryOffLatticeSimulation");
+    }
+
+    OutputFileHandler output_file_handler(outputDirectory + "/", false);
+    mpOutputFile = output_file_handler.OpenOutputFile("cell_trajectories.bin", std::ios::out | std::ios::trunc | std::ios::binary);
+    mNumBytesWritten = 0;
+    mRecords.clear();
+    mLiveCellIds.clear();
+
+    uint32_t header[3] = {CELL_TRAJECTORY_STORE_FORMAT_VERSION, DIM, 0};
+    Write(CELL_TRAJECTORY_STORE_MAGIC, 4);
+    Write(header, sizeof(header));
+
+    UpdateRecords(rCellPopulation, true);
+}
+
+template<unsigned DIM>
+void CellTrajectoryStoreModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    MAMMARY_PROFILE_SCOPE("step/modifiers/CellTrajectoryStoreModifier");
+
+    UpdateRecords(rCellPopulation, SimulationTime::Instance()->GetTimeStepsElapsed() % mSamplingTimestepMultiple == 0);
+}
+
+template<unsigned DIM>
+void CellTrajectoryStoreModifier<DIM>::UpdateRecords(AbstractCellPopulation<DIM,DIM>& rCellPopulation, bool sample)
+{
+    SimulationTime* p_time = SimulationTime::Instance();
+    double time = p_time->GetTime();
+    unsigned time_step = p_time->GetTimeStepsElapsed();
+
+    boost::shared_ptr<CellDataColumns> p_columns = CellDataColumns::Get(rCellPopulation.GetCellPropertyRegistry());
+    unsigned parent_id_handle = p_columns->GetColumnHandle("parent_id");
+
+    std::vector<unsigned> live_cell_ids;
+    live_cell_ids.reserve(rCellPopulation.GetNumRealCells());
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        unsigned cell_id = cell_iter->GetCellId();
+        live_cell_ids.push_back(cell_id);
+        if (cell_id >= mRecords.size())
+        {
+            // Grow geometrically, as new cell IDs appear
+            CellRecord unused_record;
+            unused_record.mLastSeenTimeStep = UINT_MAX;
+            mRecords.resize(std::max(2*static_cast<unsigned>(mRecords.size()), cell_id + 1), unused_record);
+        }
+
+        CellRecord& r_record = mRecords[cell_id];
+        bool is_new = (r_record.mLastSeenTimeStep == UINT_MAX);
+        r_record.mLastSeenTimeStep = time_step;
+        if (!is_new && !sample)
+        {
+            continue;
+        }
+
+        c_vector<double, DIM> location = rCellPopulation.GetLocationOfCellCentre(*cell_iter);
+        if (is_new)
+        {
+            double parent_id = p_columns->GetValue(parent_id_handle, cell_id);
+            r_record.mParentId = (parent_id == DOUBLE_UNSET) ? UINT_MAX : static_cast<uint32_t>(parent_id);
+            r_record.mBirthTime = cell_iter->GetBirthTime();
+            for (unsigned d=0; d<DIM; d++)
+            {
+                r_record.mBirthPosition[d] = location[d];
+            }
+            r_record.mDeathTime = DBL_MAX;
+            r_record.mNumSamples = 0;
+        }
+
+        if (sample)
+        {
+            r_record.mBuffer.push_back(time);
+            for (unsigned d=0; d<DIM; d++)
+            {
+                r_record.mBuffer.push_back(location[d]);
+            }
+            r_record.mNumSamples++;
+            if (r_record.mBuffer.size() >= mChunkSize*(1+DIM))
+            {
+                WriteChunk(cell_id, r_record);
+            }
+        }
+    }
+
+    // Any cell alive at the last time step and not seen at this one has died or been removed
+    for (unsigned i=0; i<mLiveCellIds.size(); i++)
+    {
+        CellRecord& r_record = mRecords[mLiveCellIds[i]];
+        if (r_record.mLastSeenTimeStep != time_step)
+        {
+            r_record.mDeathTime = time;
+            if (!r_record.mBuffer.empty())
+            {
+                WriteChunk(mLiveCellIds[i], r_record);
+            }
+        }
+    }
+    mLiveCellIds.swap(live_cell_ids);
+}
+
+template<unsigned DIM>
+void CellTrajectoryStoreModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    if (!mpOutputFile)
+    {
+        return;
+    }
+
+    for (unsigned i=0; i<mLiveCellIds.size(); i++)
+    {
+        CellRecord& r_record = mRecords[mLiveCellIds[i]];
+        if (!r_record.mBuffer.empty())
+        {
+            WriteChunk(mLiveCellIds[i], r_record);
+        }
+    }
+
+    // Append the index, one entry per cell in ascending order of ID, then the footer that locates it
+    uint64_t index_offset = mNumBytesWritten;
+    uint64_t num_cells = 0;
+    for (unsigned cell_id=0; cell_id<mRecords.size(); cell_id++)
+    {
+        const CellRecord& r_record = mRecords[cell_id];
+        if (r_record.mLastSeenTimeStep == UINT_MAX)
+        {
+            continue;
+        }
+
+        uint32_t ids[2] = {cell_id, r_record.mParentId};
+        uint32_t counts[2] = {r_record.mNumSamples, static_cast<uint32_t>(r_record.mChunkOffsets.size())};
+        Write(ids, sizeof(ids));
+        Write(&r_record.mBirthTime, sizeof(double));
+        Write(r_record.mBirthPosition, DIM*sizeof(double));
+        Write(&r_record.mDeathTime, sizeof(double));
+        Write(counts, sizeof(counts));
+        if (!r_record.mChunkOffsets.empty())
+        {
+            Write(&r_record.mChunkOffsets[0], r_record.mChunkOffsets.size()*sizeof(uint64_t));
+        }
+        num_cells++;
+    }
+
+    uint32_t padding = 0;
+    Write(&index_offset, sizeof(uint64_t));
+    Write(&num_cells, sizeof(uint64_t));
+    Write(CELL_TRAJECTORY_INDEX_MAGIC, 4);
+    Write(&padding, sizeof(uint32_t));
+
+    mpOutputFile->close();
+    mpOutputFile.reset();
+    mRecords.clear();
+    mLiveCellIds.clear();
+}
+
+template<unsigned DIM>
+void CellTrajectoryStoreModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<SamplingTimestepMultiple>" << mSamplingTimestepMultiple << "</SamplingTimestepMultiple>\n";
+    *rParamsFile << "\t\t\t<ChunkSize>" << mChunkSize << "</ChunkSize>\n";
+
+    // Call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class CellTrajectoryStoreModifier<1>;
+template class CellTrajectoryStoreModifier<2>;
+template class CellTrajectoryStoreModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(CellTrajectoryStoreModifier)
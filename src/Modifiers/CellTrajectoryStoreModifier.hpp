@@ -0,0 +1,221 @@
+#ifndef CELLTRAJECTORYSTOREMODIFIER_HPP_
+#define CELLTRAJECTORYSTOREMODIFIER_HPP_
+
+#include <climits>
+#include <string>
+#include <vector>
+#include <stdint.h>
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+
+/** The magic number at the start of a cell trajectory store. */
+const char CELL_TRAJECTORY_STORE_MAGIC[4] = {'M', 'C', 'T', 'S'};
+
+/** The magic number at the end of a complete cell trajectory store, following its index. */
+const char CELL_TRAJECTORY_INDEX_MAGIC[4] = {'M', 'C', 'T', 'I'};
+
+/** The version of the cell trajectory store format written by this code. */
+const uint32_t CELL_TRAJECTORY_STORE_FORMAT_VERSION = 1;
+
+/**
+ * A modifier class which records the life of every cell to the file cell_trajectories.bin:
+ * its birth (parent ID, birth time and position), its position every
+ * mSamplingTimestepMultiple time steps, and its death (or removal). The file can be
+ * read with CellTrajectoryStoreReader.
+ *
+ * Each cell's sampled positions are buffered and appended to the file in chunks of
+ * mChunkSize samples (and when the cell dies), so the file is only ever appended to and
+ * at most mChunkSize samples are held in memory for each live cell. At
+ * the end of Solve() an index is appended, giving for each cell its birth and death and
+ * the offsets of its chunks, so that a reader can follow one lineage by reading that
+ * lineage's chunks alone. The file is laid out as
+ *
+ * ['MCTS' (4 chars)] [format version (uint32)] [space dimension D (uint32)] [0 (uint32)]
+ * chunks: [cell ID (uint32)] [number of samples n (uint32)] [n x (time, D coordinates) (doubles)]
+ * index, one entry per cell in ascending order of ID:
+ *     [cell ID (uint32)] [parent ID (uint32)] [birth time (double)] [birth position (D doubles)]
+ *     [death time (double)] [number of samples (uint32)] [number of chunks m (uint32)]
+ *     [chunk offsets (m x uint64)]
+ * [offset of the index (uint64)] [number of cells (uint64)] ['MCTI' (4 chars)] [0 (uint32)]
+ *
+ * in native byte order. Parents are read from the "parent_id" column of the population's
+ * CellDataColumns, which is written by MammaryOffLatticeSimulation, so SetupSolve() throws
+ * if there is no such column (e.g. under OffLatticeSimulation); the parent ID of the initial
+ * cells is UINT_MAX. The death time of a cell alive at the end of the simulation is DBL_MAX.
+ * Births and deaths are detected on every time step; the birth position is the cell's
+ * position at the end of the step in which it was born.
+ */
+template<unsigned DIM>
+class CellTrajectoryStoreModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+private:
+
+    /**
+     * What is recorded of one cell.
+     */
+    struct CellRecord
+    {
+        /** The ID of the cell's parent (UINT_MAX if unknown). */
+        uint32_t mParentId;
+
+        /** The time at which the cell was born. */
+        double mBirthTime;
+
+        /** The cell's position at birth. */
+        double mBirthPosition[DIM];
+
+        /** The time at which the cell died or was removed (DBL_MAX if it has not). */
+        double mDeathTime;
+
+        /** The total number of samples recorded. */
+        uint32_t mNumSamples;
+
+        /** The time step at which the cell was last seen (UINT_MAX if there is no such cell). */
+        unsigned mLastSeenTimeStep;
+
+        /** The offsets of the chunks written to file. */
+        std::vector<uint64_t> mChunkOffsets;
+
+        /** The samples not yet written to file (time followed by position, for each). */
+        std::vector<double> mBuffer;
+    };
+
+    /** The number of time steps between samples of the cell positions. Defaults to 1. */
+    unsigned mSamplingTimestepMultiple;
+
+    /** The number of samples in each chunk written to file. Defaults to 32. */
+    unsigned mChunkSize;
+
+    /** The record of every cell seen, indexed by cell ID. */
+    std::vector<CellRecord> mRecords;
+
+    /** The IDs of the cells alive at the last time step. */
+    std::vector<unsigned> mLiveCellIds;
+
+    /** The output file. */
+    out_stream mpOutputFile;
+
+    /** The number of bytes written to the output file. */
+    uint64_t mNumBytesWritten;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mSamplingTimestepMultiple;
+        archive & mChunkSize;
+    }
+
+    /**
+     * Record births and deaths, and sample the cell positions if due.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param sample whether to sample the cell positions
+     */
+    void UpdateRecords(AbstractCellPopulation<DIM,DIM>& rCellPopulation, bool sample);
+
+    /**
+     * Append a cell's buffered samples to the output file as a chunk.
+     *
+     * @param cellId the ID of the cell
+     * @param rRecord the cell's record
+     */
+    void WriteChunk(unsigned cellId, CellRecord& rRecord);
+
+    /**
+     * Write data to the output file.
+     *
+     * @param pData the data
+     * @param size the number of bytes of data
+     */
+    void Write(const void* pData, uint64_t size);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    CellTrajectoryStoreModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~CellTrajectoryStoreModifier();
+
+    /**
+     * @return mSamplingTimestepMultiple
+     */
+    unsigned GetSamplingTimestepMultiple() const;
+
+    /**
+     * Set mSamplingTimestepMultiple.
+     *
+     * @param samplingTimestepMultiple the number of time steps between samples
+     */
+    void SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple);
+
+    /**
+     * @return mChunkSize
+     */
+    unsigned GetChunkSize() const;
+
+    /**
+     * Set mChunkSize.
+     *
+     * @param chunkSize the number of samples in each chunk written to file (at least 1)
+     */
+    void SetChunkSize(unsigned chunkSize);
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Records births and deaths, and samples the cell positions every mSamplingTimestepMultiple time steps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Opens the output file and records the initial cells.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Writes the remaining samples and the index, and closes the output file.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(CellTrajectoryStoreModifier)
+
+#endif /*CELLTRAJECTORYSTOREMODIFIER_HPP_*/
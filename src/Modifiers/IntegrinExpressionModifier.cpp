@@ -6,6 +6,7 @@
 #include "LuminalStemCellProperty.hpp"
 #include "MyoepithelialStemCellProperty.hpp"
 #include "Debug.hpp"
+#include "MammaryProfiler.hpp"
 
 template<unsigned DIM>
 IntegrinExpressionModifier<DIM>::IntegrinExpressionModifier()
@@ -29,6 +30,8 @@ IntegrinExpressionModifier<DIM>::~IntegrinExpressionModifier()
 template<unsigned DIM>
 void IntegrinExpressionModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
 {
+    MAMMARY_PROFILE_SCOPE("step/modifiers/IntegrinExpressionModifier");
+
     UpdateCellData(rCellPopulation);
 }
 
@@ -67,124 +70,128 @@ void IntegrinExpressionModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>
 template<unsigned DIM>
 void IntegrinExpressionModifier<DIM>::UpdateCellData(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
 {
-    // Make sure the cell population is updated
-    rCellPopulation.Update();
+	/*
+	 * Once integrin expression has been modified there is nothing left to do, so return
+	 * before touching the cell population. The population does not need updating here,
+	 * since only cell properties are changed.
+	 */
+	if (mIntegrinExpressionModified)
+	{
+		return;
+	}
 
-	if (mIntegrinExpressionModified == false)
-	{	
-		if (SimulationTime::Instance()->GetTime() >= mIntegrinExpressionModificationTime)
+	if (SimulationTime::Instance()->GetTime() >= mIntegrinExpressionModificationTime)
+	{
+		// Iterate over cell population
+		for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+			cell_iter != rCellPopulation.End();
+			++cell_iter)
 		{
-			// Iterate over cell population
-			for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
-				cell_iter != rCellPopulation.End();
-				++cell_iter)
-			{
-				unsigned node_index = rCellPopulation.GetLocationIndexUsingCell(*cell_iter);
+			unsigned node_index = rCellPopulation.GetLocationIndexUsingCell(*cell_iter);
 
-				// Determine cell type
-       			CellPtr p_cell = rCellPopulation.GetCellUsingLocationIndex(node_index);
+			// Determine cell type
+       		CellPtr p_cell = rCellPopulation.GetCellUsingLocationIndex(node_index);
 
-				if (mLuminalCellsAffected == true)
+			if (mLuminalCellsAffected == true)
+			{
+				if (p_cell->HasCellProperty<LuminalCellProperty>())
 				{
-					if (p_cell->HasCellProperty<LuminalCellProperty>())
+					CellPropertyCollection collection = cell_iter->rGetCellPropertyCollection();
+            		CellPropertyCollection luminal_collection = collection.GetProperties<LuminalCellProperty>();
+            		boost::shared_ptr<LuminalCellProperty> p_luminal = boost::static_pointer_cast<LuminalCellProperty>(luminal_collection.GetProperty());
+
+					if (mB1GainOfFunction)
+					{
+						p_luminal->SetB1IntegrinExpression(true);
+					}
+					if (mB1LossOfFunction)
+					{
+						p_luminal->SetB1IntegrinExpression(false);
+					}
+					if (mB4GainOfFunction)
 					{
-						CellPropertyCollection collection = cell_iter->rGetCellPropertyCollection();
-            			CellPropertyCollection luminal_collection = collection.GetProperties<LuminalCellProperty>();
-            			boost::shared_ptr<LuminalCellProperty> p_luminal = boost::static_pointer_cast<LuminalCellProperty>(luminal_collection.GetProperty());
-
-						if (mB1GainOfFunction)
-						{
-							p_luminal->SetB1IntegrinExpression(true);
-						}
-						if (mB1LossOfFunction)
-						{
-							p_luminal->SetB1IntegrinExpression(false);
-						}
-						if (mB4GainOfFunction)
-						{
-							p_luminal->SetB4IntegrinExpression(true);
-						}
-						if (mB4LossOfFunction)
-						{
-							p_luminal->SetB4IntegrinExpression(false);
-						}
+						p_luminal->SetB4IntegrinExpression(true);
 					}
-					else if (p_cell->HasCellProperty<LuminalStemCellProperty>())
+					if (mB4LossOfFunction)
 					{
-						CellPropertyCollection collection = cell_iter->rGetCellPropertyCollection();
-            			CellPropertyCollection luminal_stem_collection = collection.GetProperties<LuminalStemCellProperty>();
-            			boost::shared_ptr<LuminalCellProperty> p_luminal_stem = boost::static_pointer_cast<LuminalCellProperty>(luminal_stem_collection.GetProperty());
-
-						if (mB1GainOfFunction)
-						{
-							p_luminal_stem->SetB1IntegrinExpression(true);
-						}
-						if (mB1LossOfFunction)
-						{
-							p_luminal_stem->SetB1IntegrinExpression(false);
-						}
-						if (mB4GainOfFunction)
-						{
-							p_luminal_stem->SetB4IntegrinExpression(true);
-						}
-						if (mB4LossOfFunction)
-						{
-							p_luminal_stem->SetB4IntegrinExpression(false);
-						}
+						p_luminal->SetB4IntegrinExpression(false);
 					}
 				}
-				if (mMyoepithelialCellsAffected == true)
+				else if (p_cell->HasCellProperty<LuminalStemCellProperty>())
 				{
-					if (p_cell->HasCellProperty<MyoepithelialCellProperty>())
+					CellPropertyCollection collection = cell_iter->rGetCellPropertyCollection();
+            		CellPropertyCollection luminal_stem_collection = collection.GetProperties<LuminalStemCellProperty>();
+            		boost::shared_ptr<LuminalCellProperty> p_luminal_stem = boost::static_pointer_cast<LuminalCellProperty>(luminal_stem_collection.GetProperty());
+
+					if (mB1GainOfFunction)
+					{
+						p_luminal_stem->SetB1IntegrinExpression(true);
+					}
+					if (mB1LossOfFunction)
+					{
+						p_luminal_stem->SetB1IntegrinExpression(false);
+					}
+					if (mB4GainOfFunction)
 					{
-						CellPropertyCollection collection = cell_iter->rGetCellPropertyCollection();
-            			CellPropertyCollection myo_collection = collection.GetProperties<MyoepithelialCellProperty>();
-						boost::shared_ptr<MyoepithelialCellProperty> p_myo = boost::static_pointer_cast<MyoepithelialCellProperty>(myo_collection.GetProperty());
-						
-						if (mB1GainOfFunction)
-						{
-							p_myo->SetB1IntegrinExpression(true);
-						}
-						if (mB1LossOfFunction)
-						{
-							p_myo->SetB1IntegrinExpression(false);
-						}
-						if (mB4GainOfFunction)
-						{
-							p_myo->SetB4IntegrinExpression(true);
-						}
-						if (mB4LossOfFunction)
-						{
-							p_myo->SetB4IntegrinExpression(false);
-						}
+						p_luminal_stem->SetB4IntegrinExpression(true);
+					}
+					if (mB4LossOfFunction)
+					{
+						p_luminal_stem->SetB4IntegrinExpression(false);
 					}
 				}
-				else if (p_cell->HasCellProperty<MyoepithelialStemCellProperty>())
+			}
+			if (mMyoepithelialCellsAffected == true)
+			{
+				if (p_cell->HasCellProperty<MyoepithelialCellProperty>())
 				{
 					CellPropertyCollection collection = cell_iter->rGetCellPropertyCollection();
-					CellPropertyCollection myo_stem_collection = collection.GetProperties<MyoepithelialStemCellProperty>();
-					boost::shared_ptr<MyoepithelialStemCellProperty> p_myo_stem = boost::static_pointer_cast<MyoepithelialStemCellProperty>(myo_stem_collection.GetProperty());
-
+            		CellPropertyCollection myo_collection = collection.GetProperties<MyoepithelialCellProperty>();
+					boost::shared_ptr<MyoepithelialCellProperty> p_myo = boost::static_pointer_cast<MyoepithelialCellProperty>(myo_collection.GetProperty());
+					
 					if (mB1GainOfFunction)
 					{
-						p_myo_stem->SetB1IntegrinExpression(true);
+						p_myo->SetB1IntegrinExpression(true);
 					}
 					if (mB1LossOfFunction)
 					{
-						p_myo_stem->SetB1IntegrinExpression(false);
+						p_myo->SetB1IntegrinExpression(false);
 					}
 					if (mB4GainOfFunction)
 					{
-						p_myo_stem->SetB4IntegrinExpression(true);
+						p_myo->SetB4IntegrinExpression(true);
 					}
 					if (mB4LossOfFunction)
 					{
-						p_myo_stem->SetB4IntegrinExpression(false);
+						p_myo->SetB4IntegrinExpression(false);
 					}
 				}
-			}		
-			mIntegrinExpressionModified = true;
-		}
+			}
+			else if (p_cell->HasCellProperty<MyoepithelialStemCellProperty>())
+			{
+				CellPropertyCollection collection = cell_iter->rGetCellPropertyCollection();
+				CellPropertyCollection myo_stem_collection = collection.GetProperties<MyoepithelialStemCellProperty>();
+				boost::shared_ptr<MyoepithelialStemCellProperty> p_myo_stem = boost::static_pointer_cast<MyoepithelialStemCellProperty>(myo_stem_collection.GetProperty());
+
+				if (mB1GainOfFunction)
+				{
+					p_myo_stem->SetB1IntegrinExpression(true);
+				}
+				if (mB1LossOfFunction)
+				{
+					p_myo_stem->SetB1IntegrinExpression(false);
+				}
+				if (mB4GainOfFunction)
+				{
+					p_myo_stem->SetB4IntegrinExpression(true);
+				}
+				if (mB4LossOfFunction)
+				{
+					p_myo_stem->SetB4IntegrinExpression(false);
+				}
+			}
+		}		
+		mIntegrinExpressionModified = true;
 	}
 }
 
@@ -10,6 +10,9 @@
  * A modifier class which at each simulation time step checks whether a certain time has elapsed, 
  * and as soon as it has, alters the integrin expression of one or more mammary cell types 
  * present in a simulation.
+ *
+ * For several events per run, or events targeting a region or a fraction of cells, see
+ * PerturbationSchedulerModifier.
  */
 template<unsigned DIM>
 class IntegrinExpressionModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
@@ -0,0 +1,352 @@
+#include "MeanSquaredDisplacementModifier.hpp"
+#include <cmath>
+#include "CellDataColumns.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "Exception.hpp"
+#include "MammaryProfiler.hpp"
+
+template<unsigned DIM>
+MeanSquaredDisplacementModifier<DIM>::MeanSquaredDisplacementModifier()
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mSamplingTimestepMultiple(1),
+      mNumPointsPerLevel(16),
+      mAveragingFactor(2),
+      mNumLevels(12),
+      mDaughtersInheritHistory(true),
+      mNumSamples(0),
+      mSamplingInterval(0.0)
+{
+}
+
+template<unsigned DIM>
+MeanSquaredDisplacementModifier<DIM>::~MeanSquaredDisplacementModifier()
+{
+}
+
+template<unsigned DIM>
+unsigned MeanSquaredDisplacementModifier<DIM>::GetSamplingTimestepMultiple() const
+{
+    return mSamplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+void MeanSquaredDisplacementModifier<DIM>::SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple)
+{
+    assert(samplingTimestepMultiple > 0);
+    mSamplingTimestepMultiple = samplingTimestepMultiple;
+}
+
+template<unsigned DIM>
+unsigned MeanSquaredDisplacementModifier<DIM>::GetNumPointsPerLevel() const
+{
+    return mNumPointsPerLevel;
+}
+
+template<unsigned DIM>
+unsigned MeanSquaredDisplacementModifier<DIM>::GetAveragingFactor() const
+{
+    return mAveragingFactor;
+}
+
+template<unsigned DIM>
+unsigned MeanSquaredDisplacementModifier<DIM>::GetNumLevels() const
+{
+    return mNumLevels;
+}
+
+template<unsigned DIM>
+void MeanSquaredDisplacementModifier<DIM>::SetCorrelatorShape(unsigned numPointsPerLevel, unsigned averagingFactor, unsigned numLevels)
+{
+    if (averagingFactor < 2 || numPointsPerLevel < averagingFactor || numPointsPerLevel % averagingFactor != 0)
+    {
+        EXCEPTION("The number of points per level must be a multiple of the averaging factor, which must be at least 2");
+    }
+    if (numLevels == 0)
+    {
+        EXCEPTION("The correlator must have at least one level");
+    }
+    mNumPointsPerLevel = numPointsPerLevel;
+    mAveragingFactor = averagingFactor;
+    mNumLevels = numLevels;
+}
+
+template<unsigned DIM>
+bool MeanSquaredDisplacementModifier<DIM>::GetDaughtersInheritHistory() const
+{
+    return mDaughtersInheritHistory;
+}
+
+template<unsigned DIM>
+void MeanSquaredDisplacementModifier<DIM>::SetDaughtersInheritHistory(bool daughtersInheritHistory)
+{
+    mDaughtersInheritHistory = daughtersInheritHistory;
+}
+
+template<unsigned DIM>
+void MeanSquaredDisplacementModifier<DIM>::GetLags(std::vector<double>& rLags) const
+{
+    // Level 0 covers lags 1 to p-1 samples; level l>0 covers lags p/m to p-1 in units of m^l samples
+    rLags.clear();
+    double level_interval = mSamplingInterval;
+    for (unsigned level=0; level<mNumLevels; level++)
+    {
+        unsigned first_point = (level == 0) ? 1 : mNumPointsPerLevel/mAveragingFactor;
+        for (unsigned j=first_point; j<mNumPointsPerLevel; j++)
+        {
+            rLags.push_back(j*level_interval);
+        }
+        level_interval *= mAveragingFactor;
+    }
+}
+
+template<unsigned DIM>
+void MeanSquaredDisplacementModifier<DIM>::GetMeanSquaredDisplacements(unsigned cellType,
+                                                                      std::vector<double>& rMeanSquaredDisplacements,
+                                                                      std::vector<double>& rCounts) const
+{
+    assert(cellType <= NO_MAMMARY_CELL_TYPE + 1);
+    rMeanSquaredDisplacements.clear();
+    rCounts.clear();
+    if (mSums.empty())
+    {
+        return;
+    }
+
+    for (unsigned level=0; level<mNumLevels; level++)
+    {
+        unsigned first_point = (level == 0) ? 1 : mNumPointsPerLevel/mAveragingFactor;
+        for (unsigned j=first_point; j<mNumPointsPerLevel; j++)
+        {
+            unsigned index = level*mNumPointsPerLevel + j;
+            double sum = 0.0;
+            double count = 0.0;
+            for (unsigned type=0; type<=NO_MAMMARY_CELL_TYPE; type++)
+            {
+                if (cellType == type || cellType == NO_MAMMARY_CELL_TYPE + 1)
+                {
+                    sum += mSums[type][index];
+                    count += mCounts[type][index];
+                }
+            }
+            rMeanSquaredDisplacements.push_back(count > 0.0 ? sum/count : 0.0);
+            rCounts.push_back(count);
+        }
+    }
+}
+
+template<unsigned DIM>
+void MeanSquaredDisplacementModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+    mOutputDirectory = outputDirectory;
+    mSamplingInterval = SimulationTime::Instance()->GetTimeStep()*mSamplingTimestepMultiple;
+
+    mCellHistories.clear();
+    mSums.assign(NO_MAMMARY_CELL_TYPE + 1, std::vector<double>(mNumLevels*mNumPointsPerLevel, 0.0));
+    mCounts.assign(NO_MAMMARY_CELL_TYPE + 1, std::vector<double>(mNumLevels*mNumPointsPerLevel, 0.0));
+    mNumSamples = 0;
+
+    Sample(rCellPopulation);
+}
+
+template<unsigned DIM>
+void MeanSquaredDisplacementModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    MAMMARY_PROFILE_SCOPE("step/modifiers/MeanSquaredDisplacementModifier");
+
+    if (SimulationTime::Instance()->GetTimeStepsElapsed() % mSamplingTimestepMultiple == 0)
+    {
+        Sample(rCellPopulation);
+    }
+}
+
+template<unsigned DIM>
+void MeanSquaredDisplacementModifier<DIM>::Sample(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    // Parents are only recorded by MammaryOffLatticeSimulation; otherwise every new cell starts a history of its own
+    boost::shared_ptr<CellDataColumns> p_columns = CellDataColumns::Get(rCellPopulation.GetCellPropertyRegistry());
+    bool has_parents = mDaughtersInheritHistory && p_columns->HasColumn("parent_id");
+    unsigned parent_id_handle = has_parents ? p_columns->GetColumnHandle("parent_id") : UNSIGNED_UNSET;
+
+    /*
+     * Start a history for each new cell before any positions are added, so that a daughter
+     * copies its parent's history as it was at the last sample.
+     */
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        unsigned cell_id = cell_iter->GetCellId();
+        if (mCellHistories.find(cell_id) != mCellHistories.end())
+        {
+            continue;
+        }
+
+        typename std::map<unsigned, CellHistory>::iterator parent_iter = mCellHistories.end();
+        if (has_parents)
+        {
+            double parent_id = p_columns->GetValue(parent_id_handle, cell_id);
+            if (parent_id != DOUBLE_UNSET)
+            {
+                parent_iter = mCellHistories.find(static_cast<unsigned>(parent_id));
+            }
+        }
+
+        if (parent_iter != mCellHistories.end())
+        {
+            mCellHistories[cell_id] = parent_iter->second;
+        }
+        else
+        {
+            CellHistory& r_history = mCellHistories[cell_id];
+            r_history.mValues.assign(mNumLevels*mNumPointsPerLevel*DIM, 0.0);
+            r_history.mHeads.assign(mNumLevels, 0);
+            r_history.mNumValues.assign(mNumLevels, 0);
+            r_history.mAccumulators.assign(mNumLevels*DIM, 0.0);
+            r_history.mNumAccumulated.assign(mNumLevels, 0);
+        }
+    }
+
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        CellHistory& r_history = mCellHistories[cell_iter->GetCellId()];
+        r_history.mLastSample = mNumSamples;
+
+        c_vector<double, DIM> location = rCellPopulation.GetLocationOfCellCentre(*cell_iter);
+        double value[DIM];
+        for (unsigned d=0; d<DIM; d++)
+        {
+            value[d] = location[d];
+        }
+        AddValue(r_history, 0, value, MammaryCellPropertyHelper::GetMammaryCellType(*cell_iter));
+    }
+
+    // Forget cells that have died or been removed
+    for (typename std::map<unsigned, CellHistory>::iterator it = mCellHistories.begin(); it != mCellHistories.end(); )
+    {
+        if (it->second.mLastSample != mNumSamples)
+        {
+            mCellHistories.erase(it++);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    mNumSamples++;
+}
+
+template<unsigned DIM>
+void MeanSquaredDisplacementModifier<DIM>::AddValue(CellHistory& rHistory, unsigned level, const double* pValue, unsigned cellType)
+{
+    // Store the value as the newest at this level, overwriting the oldest once the level is full
+    unsigned head = (rHistory.mHeads[level] + mNumPointsPerLevel - 1) % mNumPointsPerLevel;
+    rHistory.mHeads[level] = head;
+    if (rHistory.mNumValues[level] < mNumPointsPerLevel)
+    {
+        rHistory.mNumValues[level]++;
+    }
+    double* p_level_values = &rHistory.mValues[level*mNumPointsPerLevel*DIM];
+    for (unsigned d=0; d<DIM; d++)
+    {
+        p_level_values[head*DIM + d] = pValue[d];
+    }
+
+    // The shorter lags at higher levels are already covered by the level below
+    unsigned first_point = (level == 0) ? 1 : mNumPointsPerLevel/mAveragingFactor;
+    std::vector<double>& r_sums = mSums[cellType];
+    std::vector<double>& r_counts = mCounts[cellType];
+    for (unsigned j=first_point; j<rHistory.mNumValues[level]; j++)
+    {
+        const double* p_earlier = &p_level_values[((head + j) % mNumPointsPerLevel)*DIM];
+        double squared_displacement = 0.0;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            double displacement = pValue[d] - p_earlier[d];
+            squared_displacement += displacement*displacement;
+        }
+        r_sums[level*mNumPointsPerLevel + j] += squared_displacement;
+        r_counts[level*mNumPointsPerLevel + j] += 1.0;
+    }
+
+    // Pass the average of every mAveragingFactor values up to the next level
+    double* p_accumulator = &rHistory.mAccumulators[level*DIM];
+    for (unsigned d=0; d<DIM; d++)
+    {
+        p_accumulator[d] += pValue[d];
+    }
+    if (++rHistory.mNumAccumulated[level] == mAveragingFactor)
+    {
+        double average[DIM];
+        for (unsigned d=0; d<DIM; d++)
+        {
+            average[d] = p_accumulator[d]/mAveragingFactor;
+            p_accumulator[d] = 0.0;
+        }
+        rHistory.mNumAccumulated[level] = 0;
+
+        if (level + 1 < mNumLevels)
+        {
+            AddValue(rHistory, level + 1, average, cellType);
+        }
+    }
+}
+
+template<unsigned DIM>
+void MeanSquaredDisplacementModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    std::vector<double> lags;
+    GetLags(lags);
+
+    std::vector<std::vector<double> > msds(NO_MAMMARY_CELL_TYPE + 1);
+    std::vector<std::vector<double> > counts(NO_MAMMARY_CELL_TYPE + 1);
+    GetMeanSquaredDisplacements(NO_MAMMARY_CELL_TYPE + 1, msds[NO_MAMMARY_CELL_TYPE], counts[NO_MAMMARY_CELL_TYPE]);
+    for (unsigned type=0; type<NO_MAMMARY_CELL_TYPE; type++)
+    {
+        GetMeanSquaredDisplacements(type, msds[type], counts[type]);
+    }
+
+    OutputFileHandler output_file_handler(mOutputDirectory + "/", false);
+    out_stream p_file = output_file_handler.OpenOutputFile("msd.dat");
+
+    // Lags that no cell has lived long enough to reach are left out
+    for (unsigned i=0; i<lags.size(); i++)
+    {
+        if (counts[NO_MAMMARY_CELL_TYPE][i] == 0.0)
+        {
+            continue;
+        }
+        *p_file << lags[i] << "\t" << msds[NO_MAMMARY_CELL_TYPE][i] << "\t" << counts[NO_MAMMARY_CELL_TYPE][i];
+        for (unsigned type=0; type<NO_MAMMARY_CELL_TYPE; type++)
+        {
+            *p_file << "\t" << msds[type][i] << "\t" << counts[type][i];
+        }
+        *p_file << "\n";
+    }
+    p_file->close();
+}
+
+template<unsigned DIM>
+void MeanSquaredDisplacementModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<SamplingTimestepMultiple>" << mSamplingTimestepMultiple << "</SamplingTimestepMultiple>\n";
+    *rParamsFile << "\t\t\t<NumPointsPerLevel>" << mNumPointsPerLevel << "</NumPointsPerLevel>\n";
+    *rParamsFile << "\t\t\t<AveragingFactor>" << mAveragingFactor << "</AveragingFactor>\n";
+    *rParamsFile << "\t\t\t<NumLevels>" << mNumLevels << "</NumLevels>\n";
+    *rParamsFile << "\t\t\t<DaughtersInheritHistory>" << mDaughtersInheritHistory << "</DaughtersInheritHistory>\n";
+
+    // Call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class MeanSquaredDisplacementModifier<1>;
+template class MeanSquaredDisplacementModifier<2>;
+template class MeanSquaredDisplacementModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(MeanSquaredDisplacementModifier)
@@ -0,0 +1,261 @@
+#ifndef MEANSQUAREDDISPLACEMENTMODIFIER_HPP_
+#define MEANSQUAREDDISPLACEMENTMODIFIER_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "MammaryCellPropertyHelper.hpp"
+
+/**
+ * A modifier class which accumulates the mean squared displacement (MSD) of cells as a
+ * function of lag time during the simulation, for all cells and for each mammary cell
+ * type, and writes only the resulting curve to file (msd.dat) at the end of Solve(). This
+ * replaces writing every cell's trajectory with CellVelocityWriter and post-processing it
+ * with MSD.m.
+ *
+ * Positions are sampled every mSamplingTimestepMultiple time steps and fed to a
+ * multiple-tau correlator for each cell: level 0 keeps the last mNumPointsPerLevel
+ * samples, and each further level keeps the last mNumPointsPerLevel averages of
+ * mAveragingFactor consecutive values from the level below. Each new value is compared
+ * with every value held at its level, so lags from one sample interval up to
+ * mNumPointsPerLevel * mAveragingFactor^(mNumLevels-1) intervals are covered, on a
+ * roughly logarithmic grid, at a cost per sample independent of the length of the run.
+ * (As usual for this method, lags beyond the first level are taken between averaged
+ * positions.)
+ *
+ * Each cell's history is keyed by its ID. When a cell divides in a
+ * MammaryOffLatticeSimulation, its daughter is given a copy of the parent's history (if
+ * mDaughtersInheritHistory), so that lineages are followed across divisions; the
+ * simulation records each daughter's parent in the "parent_id" column of the
+ * population's CellDataColumns. Otherwise, daughters start a history of their own. Each
+ * displacement is attributed to the cell's type at the later time.
+ *
+ * The cell histories are not archived, so accumulation starts again after loading a simulation.
+ */
+template<unsigned DIM>
+class MeanSquaredDisplacementModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+private:
+
+    /**
+     * The correlator state of one cell.
+     */
+    struct CellHistory
+    {
+        /** The values held at each level (mNumLevels x mNumPointsPerLevel x DIM), newest first from mHeads. */
+        std::vector<double> mValues;
+
+        /** The position of the newest value at each level. */
+        std::vector<unsigned> mHeads;
+
+        /** The number of values held at each level. */
+        std::vector<unsigned> mNumValues;
+
+        /** The sum of the values waiting to be averaged into the next level, at each level (mNumLevels x DIM). */
+        std::vector<double> mAccumulators;
+
+        /** The number of values waiting to be averaged into the next level, at each level. */
+        std::vector<unsigned> mNumAccumulated;
+
+        /** The index of the last sample at which the cell was seen. */
+        unsigned mLastSample;
+    };
+
+    /** The number of time steps between samples. Defaults to 1. */
+    unsigned mSamplingTimestepMultiple;
+
+    /** The number of values held at each level of the correlator. Defaults to 16. */
+    unsigned mNumPointsPerLevel;
+
+    /** The number of values averaged into each value of the next level. Defaults to 2. */
+    unsigned mAveragingFactor;
+
+    /** The number of levels of the correlator. Defaults to 12. */
+    unsigned mNumLevels;
+
+    /** Whether a daughter cell continues its parent's history. Defaults to true. */
+    bool mDaughtersInheritHistory;
+
+    /** The history of each cell, by cell ID. */
+    std::map<unsigned, CellHistory> mCellHistories;
+
+    /** The sum of squared displacements at each level and point of the correlator, for each mammary cell type. */
+    std::vector<std::vector<double> > mSums;
+
+    /** The number of displacements at each level and point of the correlator, for each mammary cell type. */
+    std::vector<std::vector<double> > mCounts;
+
+    /** The number of samples taken so far. */
+    unsigned mNumSamples;
+
+    /** The time between samples. */
+    double mSamplingInterval;
+
+    /** The output directory, relative to where Chaste output is stored. */
+    std::string mOutputDirectory;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mSamplingTimestepMultiple;
+        archive & mNumPointsPerLevel;
+        archive & mAveragingFactor;
+        archive & mNumLevels;
+        archive & mDaughtersInheritHistory;
+    }
+
+    /**
+     * Add a value to one level of a cell's correlator, accumulating the squared
+     * displacements from the values already held there, and pass averages up to the next level.
+     *
+     * @param rHistory the cell's history
+     * @param level the level
+     * @param pValue the value (DIM doubles)
+     * @param cellType the cell's mammary cell type
+     */
+    void AddValue(CellHistory& rHistory, unsigned level, const double* pValue, unsigned cellType);
+
+    /**
+     * Sample the positions of all cells.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void Sample(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    MeanSquaredDisplacementModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~MeanSquaredDisplacementModifier();
+
+    /**
+     * @return mSamplingTimestepMultiple
+     */
+    unsigned GetSamplingTimestepMultiple() const;
+
+    /**
+     * Set mSamplingTimestepMultiple.
+     *
+     * @param samplingTimestepMultiple the number of time steps between samples
+     */
+    void SetSamplingTimestepMultiple(unsigned samplingTimestepMultiple);
+
+    /**
+     * @return mNumPointsPerLevel
+     */
+    unsigned GetNumPointsPerLevel() const;
+
+    /**
+     * @return mAveragingFactor
+     */
+    unsigned GetAveragingFactor() const;
+
+    /**
+     * @return mNumLevels
+     */
+    unsigned GetNumLevels() const;
+
+    /**
+     * Set the shape of the correlator. The number of points per level must be a multiple
+     * of the averaging factor.
+     *
+     * @param numPointsPerLevel the number of values held at each level
+     * @param averagingFactor the number of values averaged into each value of the next level
+     * @param numLevels the number of levels
+     */
+    void SetCorrelatorShape(unsigned numPointsPerLevel, unsigned averagingFactor, unsigned numLevels);
+
+    /**
+     * @return mDaughtersInheritHistory
+     */
+    bool GetDaughtersInheritHistory() const;
+
+    /**
+     * Set mDaughtersInheritHistory.
+     *
+     * @param daughtersInheritHistory whether a daughter cell continues its parent's history
+     */
+    void SetDaughtersInheritHistory(bool daughtersInheritHistory);
+
+    /**
+     * Get the lags at which the MSD is accumulated.
+     *
+     * @param rLags filled in with the lags, in increasing order
+     */
+    void GetLags(std::vector<double>& rLags) const;
+
+    /**
+     * Get the MSD curve.
+     *
+     * @param cellType a mammary cell type, or NO_MAMMARY_CELL_TYPE + 1 for all cells
+     * @param rMeanSquaredDisplacements filled in with the MSD at each lag (0 where there are no samples)
+     * @param rCounts filled in with the number of displacements averaged at each lag
+     */
+    void GetMeanSquaredDisplacements(unsigned cellType,
+                                     std::vector<double>& rMeanSquaredDisplacements,
+                                     std::vector<double>& rCounts) const;
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Samples the cell positions every mSamplingTimestepMultiple time steps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Clears the accumulated curve and samples the initial positions.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Writes the MSD curve to msd.dat, one line per lag of the form
+     * [lag] [MSD of all cells] [number of displacements] followed by the MSD and number
+     * of displacements for luminal, myoepithelial, luminal stem and myoepithelial stem cells.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(MeanSquaredDisplacementModifier)
+
+#endif /*MEANSQUAREDDISPLACEMENTMODIFIER_HPP_*/
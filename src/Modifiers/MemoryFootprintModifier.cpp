@@ -0,0 +1,142 @@
+#include "MemoryFootprintModifier.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "MammaryAllocationCounter.hpp"
+#include "MammaryProfiler.hpp"
+
+template<unsigned DIM>
+MemoryFootprintModifier<DIM>::MemoryFootprintModifier()
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mOutputTimestepMultiple(1),
+      mInitialNumAllocations(0),
+      mInitialNumBytesAllocated(0),
+      mInitialNumDeallocations(0)
+{
+}
+
+template<unsigned DIM>
+MemoryFootprintModifier<DIM>::~MemoryFootprintModifier()
+{
+}
+
+template<unsigned DIM>
+unsigned MemoryFootprintModifier<DIM>::GetOutputTimestepMultiple() const
+{
+    return mOutputTimestepMultiple;
+}
+
+template<unsigned DIM>
+void MemoryFootprintModifier<DIM>::SetOutputTimestepMultiple(unsigned outputTimestepMultiple)
+{
+    assert(outputTimestepMultiple > 0);
+    mOutputTimestepMultiple = outputTimestepMultiple;
+}
+
+template<unsigned DIM>
+void MemoryFootprintModifier<DIM>::AddWriterBufferSource(boost::shared_ptr<AsynchronousOutputModifier<DIM> > pModifier)
+{
+    mWriterBufferSources.push_back(pModifier);
+}
+
+template<unsigned DIM>
+const MammaryMemoryFootprint<DIM>& MemoryFootprintModifier<DIM>::rGetFootprint() const
+{
+    return mFootprint;
+}
+
+template<unsigned DIM>
+void MemoryFootprintModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+    mInitialNumAllocations = MammaryAllocationCounter::GetNumAllocations();
+    mInitialNumBytesAllocated = MammaryAllocationCounter::GetNumBytesAllocated();
+    mInitialNumDeallocations = MammaryAllocationCounter::GetNumDeallocations();
+
+    OutputFileHandler output_file_handler(outputDirectory + "/", false);
+    mpOutputFile = output_file_handler.OpenOutputFile("memory_footprint.csv");
+
+    *mpOutputFile << "time,cells";
+    for (unsigned i=0; i<NUM_MEMORY_SUBSYSTEMS; i++)
+    {
+        *mpOutputFile << "," << MammaryMemoryFootprint<DIM>::GetSubsystemName(static_cast<MammaryMemorySubsystem>(i)) << "_bytes";
+    }
+    *mpOutputFile << ",total_bytes,bytes_per_cell,rss_bytes,peak_rss_bytes";
+    if (MammaryAllocationCounter::IsEnabled())
+    {
+        *mpOutputFile << ",allocations,allocated_bytes,deallocations";
+    }
+    *mpOutputFile << "\n";
+
+    WriteFootprint(rCellPopulation);
+}
+
+template<unsigned DIM>
+void MemoryFootprintModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    MAMMARY_PROFILE_SCOPE("step/modifiers/MemoryFootprintModifier");
+
+    if (SimulationTime::Instance()->GetTimeStepsElapsed() % mOutputTimestepMultiple == 0)
+    {
+        WriteFootprint(rCellPopulation);
+    }
+}
+
+template<unsigned DIM>
+void MemoryFootprintModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    if (mpOutputFile)
+    {
+        // Record the final state, and so the peak resident set size over the whole run
+        if (SimulationTime::Instance()->GetTimeStepsElapsed() % mOutputTimestepMultiple != 0)
+        {
+            WriteFootprint(rCellPopulation);
+        }
+        mpOutputFile->close();
+        mpOutputFile.reset();
+    }
+}
+
+template<unsigned DIM>
+void MemoryFootprintModifier<DIM>::WriteFootprint(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    std::size_t num_writer_buffer_bytes = 0;
+    for (unsigned i=0; i<mWriterBufferSources.size(); i++)
+    {
+        num_writer_buffer_bytes += mWriterBufferSources[i]->GetNumBufferBytes();
+    }
+    mFootprint.Calculate(rCellPopulation, num_writer_buffer_bytes);
+
+    *mpOutputFile << SimulationTime::Instance()->GetTime() << "," << mFootprint.GetNumCells();
+    for (unsigned i=0; i<NUM_MEMORY_SUBSYSTEMS; i++)
+    {
+        *mpOutputFile << "," << mFootprint.GetNumBytes(static_cast<MammaryMemorySubsystem>(i));
+    }
+    *mpOutputFile << "," << mFootprint.GetTotalNumBytes()
+                  << "," << mFootprint.GetNumBytesPerCell()
+                  << "," << MammaryMemoryFootprint<DIM>::GetResidentSetSize()
+                  << "," << MammaryMemoryFootprint<DIM>::GetPeakResidentSetSize();
+    if (MammaryAllocationCounter::IsEnabled())
+    {
+        *mpOutputFile << "," << MammaryAllocationCounter::GetNumAllocations() - mInitialNumAllocations
+                      << "," << MammaryAllocationCounter::GetNumBytesAllocated() - mInitialNumBytesAllocated
+                      << "," << MammaryAllocationCounter::GetNumDeallocations() - mInitialNumDeallocations;
+    }
+    *mpOutputFile << "\n";
+}
+
+template<unsigned DIM>
+void MemoryFootprintModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<OutputTimestepMultiple>" << mOutputTimestepMultiple << "</OutputTimestepMultiple>\n";
+
+    // Call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class MemoryFootprintModifier<1>;
+template class MemoryFootprintModifier<2>;
+template class MemoryFootprintModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(MemoryFootprintModifier)
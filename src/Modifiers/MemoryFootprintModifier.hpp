@@ -0,0 +1,156 @@
+#ifndef MEMORYFOOTPRINTMODIFIER_HPP_
+#define MEMORYFOOTPRINTMODIFIER_HPP_
+
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/shared_ptr.hpp>
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "AsynchronousOutputModifier.hpp"
+#include "MammaryMemoryFootprint.hpp"
+
+/**
+ * A modifier class which writes the memory held by each subsystem of the population (see
+ * MammaryMemoryFootprint) to the file memory_footprint.csv, every mOutputTimestepMultiple
+ * time steps, for sizing jobs and finding where memory goes as the population grows.
+ *
+ * Each line holds the time, the number of cells, the estimated bytes of each subsystem,
+ * their total and the bytes per cell, and the current and peak resident set size of the
+ * process. When the allocation counter is compiled in (MAMMARY_ALLOCATION_COUNTING, see
+ * MammaryAllocationCounter), the numbers of allocations, allocated bytes and deallocations
+ * since SetupSolve() are appended. The allocations made in each profiled phase of the time
+ * step are reported by MammaryProfiler.
+ *
+ * The writer buffers are those of the added AsynchronousOutputModifier objects. These are
+ * not archived, so must be added again after loading a simulation.
+ */
+template<unsigned DIM>
+class MemoryFootprintModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+private:
+
+    /** The number of time steps between outputs. Defaults to 1. */
+    unsigned mOutputTimestepMultiple;
+
+    /** The calculator. */
+    MammaryMemoryFootprint<DIM> mFootprint;
+
+    /** The modifiers whose snapshot buffers are counted as writer buffers. */
+    std::vector<boost::shared_ptr<AsynchronousOutputModifier<DIM> > > mWriterBufferSources;
+
+    /** The number of allocations made by the process at SetupSolve(). */
+    uint64_t mInitialNumAllocations;
+
+    /** The number of bytes allocated by the process at SetupSolve(). */
+    uint64_t mInitialNumBytesAllocated;
+
+    /** The number of deallocations made by the process at SetupSolve(). */
+    uint64_t mInitialNumDeallocations;
+
+    /** The output file. */
+    out_stream mpOutputFile;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mOutputTimestepMultiple;
+    }
+
+    /**
+     * Calculate the footprint and write a line of output.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void WriteFootprint(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    MemoryFootprintModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~MemoryFootprintModifier();
+
+    /**
+     * @return mOutputTimestepMultiple
+     */
+    unsigned GetOutputTimestepMultiple() const;
+
+    /**
+     * Set mOutputTimestepMultiple.
+     *
+     * @param outputTimestepMultiple the number of time steps between outputs
+     */
+    void SetOutputTimestepMultiple(unsigned outputTimestepMultiple);
+
+    /**
+     * Count the snapshot buffers of an asynchronous output modifier as writer buffers.
+     *
+     * @param pModifier the modifier
+     */
+    void AddWriterBufferSource(boost::shared_ptr<AsynchronousOutputModifier<DIM> > pModifier);
+
+    /**
+     * @return the calculator, holding the footprint at the last output
+     */
+    const MammaryMemoryFootprint<DIM>& rGetFootprint() const;
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Writes the footprint every mOutputTimestepMultiple time steps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Opens the output file, writes its header and the footprint of the initial state.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Writes the footprint of the final state and closes the output file.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(MemoryFootprintModifier)
+
+#endif /*MEMORYFOOTPRINTMODIFIER_HPP_*/
@@ -0,0 +1,488 @@
+#include "PerturbationSchedulerModifier.hpp"
+#include "SwitchableForce.hpp"
+#include "LinearSpringForce.hpp"
+#include "GeneralisedLinearSpringForce.hpp"
+#include "DifferentialAdhesionLinearSpringForce.hpp"
+#include "CellCellAdhesionForce.hpp"
+#include "CellParticleAdhesionForce.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "CounterBasedRandomNumberGenerator.hpp"
+#include "MammaryRandomStreams.hpp"
+#include "MammaryOffLatticeSimulation.hpp"
+#include "MammaryProfiler.hpp"
+#include "AbstractSimpleCellCycleModel.hpp"
+#include "StemCellProliferativeType.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <map>
+
+template<unsigned DIM>
+PerturbationSchedulerModifier<DIM>::PerturbationSchedulerModifier()
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mNumEventsAdded(0),
+      mNumEventsApplied(0),
+      mpDivisionScheduler(NULL)
+{
+}
+
+template<unsigned DIM>
+PerturbationSchedulerModifier<DIM>::~PerturbationSchedulerModifier()
+{
+}
+
+template<unsigned DIM>
+unsigned PerturbationSchedulerModifier<DIM>::RegisterForce(boost::shared_ptr<AbstractForce<DIM> > pForce)
+{
+    mForces.push_back(pForce);
+    return mForces.size() - 1;
+}
+
+template<unsigned DIM>
+void PerturbationSchedulerModifier<DIM>::AddEvent(PerturbationEvent event)
+{
+    event.mSequence = mNumEventsAdded;
+    mNumEventsAdded++;
+
+    mEvents.push_back(event);
+    std::push_heap(mEvents.begin(), mEvents.end(), std::greater<PerturbationEvent>());
+}
+
+template<unsigned DIM>
+void PerturbationSchedulerModifier<DIM>::AddIntegrinEvent(double time,
+                                                          IntegrinPerturbation b1Perturbation,
+                                                          IntegrinPerturbation b4Perturbation,
+                                                          const PerturbationTarget& rTarget)
+{
+    PerturbationEvent event;
+    event.mTime = time;
+    event.mEventType = PerturbationEvent::INTEGRIN_EVENT;
+    event.mB1Perturbation = b1Perturbation;
+    event.mB4Perturbation = b4Perturbation;
+    event.mTarget = rTarget;
+    AddEvent(event);
+}
+
+template<unsigned DIM>
+void PerturbationSchedulerModifier<DIM>::AddTypeConversionEvent(double time,
+                                                                MammaryCellType newCellType,
+                                                                const PerturbationTarget& rTarget)
+{
+    if (newCellType == NO_MAMMARY_CELL_TYPE)
+    {
+        EXCEPTION("Cells can only be converted to a mammary cell type");
+    }
+
+    PerturbationEvent event;
+    event.mTime = time;
+    event.mEventType = PerturbationEvent::TYPE_CONVERSION_EVENT;
+    event.mNewCellType = newCellType;
+    event.mTarget = rTarget;
+    AddEvent(event);
+}
+
+template<unsigned DIM>
+void PerturbationSchedulerModifier<DIM>::AddSpringParameterEvent(double time, unsigned forceIndex, SpringParameter springParameter, double value)
+{
+    if (forceIndex >= mForces.size())
+    {
+        EXCEPTION("No force has been registered with index " << forceIndex);
+    }
+
+    PerturbationEvent event;
+    event.mTime = time;
+    event.mEventType = PerturbationEvent::SPRING_PARAMETER_EVENT;
+    event.mForceIndex = forceIndex;
+    event.mSpringParameter = springParameter;
+    event.mValue = value;
+    AddEvent(event);
+}
+
+template<unsigned DIM>
+void PerturbationSchedulerModifier<DIM>::AddForceSwitchEvent(double time, unsigned forceIndex, bool active)
+{
+    if (forceIndex >= mForces.size())
+    {
+        EXCEPTION("No force has been registered with index " << forceIndex);
+    }
+    if (!boost::dynamic_pointer_cast<SwitchableForce<DIM> >(mForces[forceIndex]))
+    {
+        EXCEPTION("Only a SwitchableForce can be switched on or off");
+    }
+
+    PerturbationEvent event;
+    event.mTime = time;
+    event.mEventType = PerturbationEvent::FORCE_SWITCH_EVENT;
+    event.mForceIndex = forceIndex;
+    event.mActive = active;
+    AddEvent(event);
+}
+
+template<unsigned DIM>
+void PerturbationSchedulerModifier<DIM>::SetDivisionScheduler(MammaryOffLatticeSimulation<DIM>* pSimulation)
+{
+    mpDivisionScheduler = pSimulation;
+}
+
+template<unsigned DIM>
+unsigned PerturbationSchedulerModifier<DIM>::GetNumPendingEvents() const
+{
+    return mEvents.size();
+}
+
+template<unsigned DIM>
+unsigned PerturbationSchedulerModifier<DIM>::GetNumEventsApplied() const
+{
+    return mNumEventsApplied;
+}
+
+template<unsigned DIM>
+void PerturbationSchedulerModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+}
+
+template<unsigned DIM>
+void PerturbationSchedulerModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    MAMMARY_PROFILE_SCOPE("step/modifiers/PerturbationSchedulerModifier");
+
+    // Allow for rounding error in the simulation time when comparing with event times
+    double due_time = SimulationTime::Instance()->GetTime() + 0.5*SimulationTime::Instance()->GetTimeStep();
+
+    // Between events, this is the only work done
+    if (mEvents.empty() || mEvents.front().mTime > due_time)
+    {
+        return;
+    }
+
+    // Pop every event that has fallen due, in order of time and then of addition
+    std::vector<PerturbationEvent> cell_events;
+    std::vector<uint64_t> selection_seeds;
+    while (!mEvents.empty() && mEvents.front().mTime <= due_time)
+    {
+        std::pop_heap(mEvents.begin(), mEvents.end(), std::greater<PerturbationEvent>());
+        PerturbationEvent event = mEvents.back();
+        mEvents.pop_back();
+
+        if (event.mEventType == PerturbationEvent::SPRING_PARAMETER_EVENT ||
+            event.mEventType == PerturbationEvent::FORCE_SWITCH_EVENT)
+        {
+            ApplyForceEvent(event);
+        }
+        else
+        {
+            // One draw per event, so that the number of draws does not depend on the cells (reproducible mode draws per cell instead)
+            uint64_t seed = 0;
+            if (event.mTarget.mFraction < 1.0 && !MammaryRandomStreams::Instance()->IsReproducible())
+            {
+                seed = static_cast<uint64_t>(RandomNumberGenerator::Instance()->ranf()*4294967296.0);
+            }
+            cell_events.push_back(event);
+            selection_seeds.push_back(seed);
+        }
+        mNumEventsApplied++;
+    }
+
+    if (!cell_events.empty())
+    {
+        ApplyCellEvents(rCellPopulation, cell_events, selection_seeds);
+    }
+}
+
+template<unsigned DIM>
+void PerturbationSchedulerModifier<DIM>::ApplyForceEvent(const PerturbationEvent& rEvent)
+{
+    boost::shared_ptr<AbstractForce<DIM> > p_force = mForces[rEvent.mForceIndex];
+
+    if (rEvent.mEventType == PerturbationEvent::FORCE_SWITCH_EVENT)
+    {
+        boost::static_pointer_cast<SwitchableForce<DIM> >(p_force)->SetActive(rEvent.mActive);
+        return;
+    }
+
+    // Spring parameter events may be applied to a switchable force, in which case they act on the wrapped force
+    if (boost::shared_ptr<SwitchableForce<DIM> > p_switchable = boost::dynamic_pointer_cast<SwitchableForce<DIM> >(p_force))
+    {
+        p_force = p_switchable->GetForce();
+    }
+
+    bool applied = false;
+    if (rEvent.mSpringParameter == HOMOTYPIC_SPRING_CONSTANT_MULTIPLIER)
+    {
+        if (LinearSpringForce<DIM>* p_linear = dynamic_cast<LinearSpringForce<DIM>*>(p_force.get()))
+        {
+            p_linear->SetHomotypicSpringConstantMultiplier(rEvent.mValue);
+            applied = true;
+        }
+        else if (DifferentialAdhesionLinearSpringForce<DIM>* p_differential = dynamic_cast<DifferentialAdhesionLinearSpringForce<DIM>*>(p_force.get()))
+        {
+            p_differential->SetHomotypicLabelledSpringConstantMultiplier(rEvent.mValue);
+            applied = true;
+        }
+        else if (CellCellAdhesionForce<DIM>* p_cell_cell = dynamic_cast<CellCellAdhesionForce<DIM>*>(p_force.get()))
+        {
+            p_cell_cell->SetHomotypicLabelledSpringConstantMultiplier(rEvent.mValue);
+            applied = true;
+        }
+        else if (CellParticleAdhesionForce<DIM>* p_cell_particle = dynamic_cast<CellParticleAdhesionForce<DIM>*>(p_force.get()))
+        {
+            p_cell_particle->SetHomotypicLabelledSpringConstantMultiplier(rEvent.mValue);
+            applied = true;
+        }
+    }
+    else if (rEvent.mSpringParameter == HETEROTYPIC_SPRING_CONSTANT_MULTIPLIER)
+    {
+        if (LinearSpringForce<DIM>* p_linear = dynamic_cast<LinearSpringForce<DIM>*>(p_force.get()))
+        {
+            p_linear->SetHeterotypicSpringConstantMultiplier(rEvent.mValue);
+            applied = true;
+        }
+        else if (DifferentialAdhesionLinearSpringForce<DIM>* p_differential = dynamic_cast<DifferentialAdhesionLinearSpringForce<DIM>*>(p_force.get()))
+        {
+            p_differential->SetHeterotypicSpringConstantMultiplier(rEvent.mValue);
+            applied = true;
+        }
+        else if (CellCellAdhesionForce<DIM>* p_cell_cell = dynamic_cast<CellCellAdhesionForce<DIM>*>(p_force.get()))
+        {
+            p_cell_cell->SetHeterotypicSpringConstantMultiplier(rEvent.mValue);
+            applied = true;
+        }
+        else if (CellParticleAdhesionForce<DIM>* p_cell_particle = dynamic_cast<CellParticleAdhesionForce<DIM>*>(p_force.get()))
+        {
+            p_cell_particle->SetHeterotypicSpringConstantMultiplier(rEvent.mValue);
+            applied = true;
+        }
+    }
+    else
+    {
+        if (LinearSpringForce<DIM>* p_linear = dynamic_cast<LinearSpringForce<DIM>*>(p_force.get()))
+        {
+            p_linear->SetCellCellSpringStiffness(rEvent.mValue);
+            applied = true;
+        }
+        else if (GeneralisedLinearSpringForce<DIM>* p_generalised = dynamic_cast<GeneralisedLinearSpringForce<DIM>*>(p_force.get()))
+        {
+            p_generalised->SetMeinekeSpringStiffness(rEvent.mValue);
+            applied = true;
+        }
+    }
+
+    if (!applied)
+    {
+        EXCEPTION("The registered force with index " << rEvent.mForceIndex << " does not have the requested spring parameter");
+    }
+}
+
+template<unsigned DIM>
+bool PerturbationSchedulerModifier<DIM>::IsCellTargeted(AbstractCellPopulation<DIM,DIM>& rCellPopulation,
+                                                        CellPtr pCell,
+                                                        MammaryCellType cellType,
+                                                        const PerturbationEvent& rEvent,
+                                                        uint64_t selectionSeed)
+{
+    const PerturbationTarget& rTarget = rEvent.mTarget;
+
+    if (rTarget.mCellTypeMask != 0)
+    {
+        if (cellType == NO_MAMMARY_CELL_TYPE || (rTarget.mCellTypeMask & (1u << cellType)) == 0)
+        {
+            return false;
+        }
+    }
+
+    if (rTarget.mRegionType != PerturbationTarget::ANY_REGION)
+    {
+        c_vector<double, DIM> location = rCellPopulation.GetLocationOfCellCentre(pCell);
+
+        if (rTarget.mRegionType == PerturbationTarget::BOX_REGION)
+        {
+            for (unsigned i=0; i<DIM; i++)
+            {
+                if (location[i] < rTarget.mRegionLower[i] || location[i] > rTarget.mRegionUpper[i])
+                {
+                    return false;
+                }
+            }
+        }
+        else
+        {
+            double distance_squared = 0.0;
+            for (unsigned i=0; i<DIM; i++)
+            {
+                distance_squared += (location[i] - rTarget.mRegionLower[i])*(location[i] - rTarget.mRegionLower[i]);
+            }
+            if (distance_squared > rTarget.mRegionRadius*rTarget.mRegionRadius)
+            {
+                return false;
+            }
+        }
+    }
+
+    if (rTarget.mFraction < 1.0)
+    {
+        // In reproducible mode, the draw is keyed by the cell, the time step and the event alone
+        MammaryRandomStreams* p_streams = MammaryRandomStreams::Instance();
+        double draw = p_streams->IsReproducible()
+                      ? p_streams->ranf(pCell->GetCellId(), PERTURBATION_EVENT, SimulationTime::Instance()->GetTimeStepsElapsed(), rEvent.mSequence)
+                      : CounterBasedRandomNumberGenerator::ranf(selectionSeed, pCell->GetCellId(), 0);
+        return (draw < rTarget.mFraction);
+    }
+    return true;
+}
+
+template<unsigned DIM>
+void PerturbationSchedulerModifier<DIM>::StartNewCellCycle(CellPtr pCell, MammaryCellType cellType)
+{
+    if (cellType == LUMINAL_STEM_CELL || cellType == MYOEPITHELIAL_STEM_CELL)
+    {
+        pCell->SetCellProliferativeType(pCell->rGetCellPropertyCollection().GetCellPropertyRegistry()->Get<StemCellProliferativeType>());
+    }
+    else
+    {
+        pCell->SetCellProliferativeType(pCell->rGetCellPropertyCollection().GetCellPropertyRegistry()->Get<DifferentiatedCellProliferativeType>());
+    }
+
+    /*
+     * The cycle restarts at the conversion, with a duration drawn for the new type (e.g.
+     * a luminal cell's infinite duration is replaced). A cell already marked as ready to
+     * divide is reset as if it had divided, which also clears the mark. Other models
+     * (e.g. SubstrateDependentCellCycleModel) read the cell's properties on every time step.
+     */
+    AbstractCellCycleModel* p_model = pCell->GetCellCycleModel();
+    if (AbstractSimpleCellCycleModel* p_simple_model = dynamic_cast<AbstractSimpleCellCycleModel*>(p_model))
+    {
+        if (p_simple_model->ReadyToDivide())
+        {
+            p_simple_model->ResetForDivision();
+        }
+        else
+        {
+            p_simple_model->SetBirthTime(SimulationTime::Instance()->GetTime());
+            p_simple_model->SetCellCycleDuration();
+        }
+    }
+    else
+    {
+        p_model->SetBirthTime(SimulationTime::Instance()->GetTime());
+    }
+
+    if (mpDivisionScheduler)
+    {
+        mpDivisionScheduler->RescheduleCell(pCell);
+    }
+}
+
+template<unsigned DIM>
+void PerturbationSchedulerModifier<DIM>::ApplyCellEvents(AbstractCellPopulation<DIM,DIM>& rCellPopulation,
+                                                         const std::vector<PerturbationEvent>& rCellEvents,
+                                                         const std::vector<uint64_t>& rSelectionSeeds)
+{
+    // Check region dimensions once for the batch, rather than for every cell
+    for (unsigned event_index=0; event_index<rCellEvents.size(); event_index++)
+    {
+        const PerturbationTarget& r_target = rCellEvents[event_index].mTarget;
+        if (r_target.mRegionType != PerturbationTarget::ANY_REGION &&
+            (r_target.mRegionLower.size() < DIM || (r_target.mRegionType == PerturbationTarget::BOX_REGION && r_target.mRegionUpper.size() < DIM)))
+        {
+            EXCEPTION("The region of a perturbation must have the same dimension as the simulation");
+        }
+    }
+
+    /*
+     * Cells ending up in the same state share a single new property instance, keyed on
+     * (type, B1 expression, B4 expression), so that a batch creates at most a handful of
+     * instances however many cells it affects.
+     */
+    std::map<unsigned, boost::shared_ptr<AbstractMammaryCellProperty> > new_properties;
+
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        boost::shared_ptr<AbstractMammaryCellProperty> p_property = MammaryCellPropertyHelper::GetMammaryCellProperty(*cell_iter);
+        MammaryCellType original_type = MammaryCellPropertyHelper::GetMammaryCellType(p_property);
+
+        MammaryCellType cell_type = original_type;
+        bool b1 = p_property ? p_property->GetB1IntegrinExpression() : false;
+        bool b4 = p_property ? p_property->GetB4IntegrinExpression() : false;
+        bool changed = false;
+
+        for (unsigned event_index=0; event_index<rCellEvents.size(); event_index++)
+        {
+            const PerturbationEvent& r_event = rCellEvents[event_index];
+            if (!IsCellTargeted(rCellPopulation, *cell_iter, cell_type, r_event, rSelectionSeeds[event_index]))
+            {
+                continue;
+            }
+
+            if (r_event.mEventType == PerturbationEvent::TYPE_CONVERSION_EVENT)
+            {
+                cell_type = r_event.mNewCellType;
+                MammaryCellPropertyHelper::GetDefaultIntegrinExpression(cell_type, b1, b4);
+                changed = true;
+            }
+            else if (cell_type != NO_MAMMARY_CELL_TYPE)
+            {
+                if (r_event.mB1Perturbation != INTEGRIN_UNCHANGED)
+                {
+                    b1 = (r_event.mB1Perturbation == INTEGRIN_GAIN_OF_FUNCTION);
+                    changed = true;
+                }
+                if (r_event.mB4Perturbation != INTEGRIN_UNCHANGED)
+                {
+                    b4 = (r_event.mB4Perturbation == INTEGRIN_GAIN_OF_FUNCTION);
+                    changed = true;
+                }
+            }
+        }
+
+        if (!changed)
+        {
+            continue;
+        }
+        if (p_property && cell_type == original_type &&
+            b1 == p_property->GetB1IntegrinExpression() && b4 == p_property->GetB4IntegrinExpression())
+        {
+            continue;
+        }
+
+        unsigned key = 4*cell_type + 2*b1 + b4;
+        std::map<unsigned, boost::shared_ptr<AbstractMammaryCellProperty> >::iterator it = new_properties.find(key);
+        if (it == new_properties.end())
+        {
+            it = new_properties.insert(std::make_pair(key, MammaryCellPropertyHelper::CreateMammaryCellProperty(cell_type, b1, b4))).first;
+        }
+        MammaryCellPropertyHelper::ReplaceMammaryCellProperty(*cell_iter, it->second);
+
+        if (cell_type != original_type)
+        {
+            StartNewCellCycle(*cell_iter, cell_type);
+        }
+    }
+}
+
+template<unsigned DIM>
+void PerturbationSchedulerModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    mpDivisionScheduler = NULL;
+}
+
+template<unsigned DIM>
+void PerturbationSchedulerModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<NumScheduledEvents>" << mEvents.size() + mNumEventsApplied << "</NumScheduledEvents>\n";
+    *rParamsFile << "\t\t\t<NumRegisteredForces>" << mForces.size() << "</NumRegisteredForces>\n";
+
+    // Call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class PerturbationSchedulerModifier<1>;
+template class PerturbationSchedulerModifier<2>;
+template class PerturbationSchedulerModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(PerturbationSchedulerModifier)
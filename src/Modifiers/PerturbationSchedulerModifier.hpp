@@ -0,0 +1,480 @@
+#ifndef PERTURBATIONSCHEDULERMODIFIER_HPP_
+#define PERTURBATIONSCHEDULERMODIFIER_HPP_
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/shared_ptr.hpp>
+#include <boost/serialization/vector.hpp>
+
+#include <stdint.h>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "AbstractForce.hpp"
+#include "MammaryCellPropertyHelper.hpp"
+
+template<unsigned DIM>
+class MammaryOffLatticeSimulation;
+
+/** The change made to the expression of a given integrin by a perturbation. */
+typedef enum IntegrinPerturbation_
+{
+    INTEGRIN_UNCHANGED,
+    INTEGRIN_GAIN_OF_FUNCTION,
+    INTEGRIN_LOSS_OF_FUNCTION
+} IntegrinPerturbation;
+
+/** The spring parameter changed by a stiffness perturbation. */
+typedef enum SpringParameter_
+{
+    HOMOTYPIC_SPRING_CONSTANT_MULTIPLIER,
+    HETEROTYPIC_SPRING_CONSTANT_MULTIPLIER,
+    SPRING_STIFFNESS
+} SpringParameter;
+
+/**
+ * The set of cells affected by a perturbation: those of the given types, lying in
+ * the given region, of which each is selected independently with the given
+ * probability. By default, every cell is targeted.
+ *
+ * The random selection of each cell is keyed by its cell ID (see
+ * PerturbationSchedulerModifier), so does not depend on the order of the cells.
+ */
+struct PerturbationTarget
+{
+    /** The kinds of spatial region. */
+    typedef enum RegionType_
+    {
+        ANY_REGION,
+        BOX_REGION,
+        SPHERE_REGION
+    } RegionType;
+
+    /**
+     * Bit mask of targeted mammary cell types, with bit i set if MammaryCellType i is
+     * targeted. Zero (the default) targets every cell, including those without a
+     * mammary cell property.
+     */
+    unsigned mCellTypeMask;
+
+    /** The kind of spatial region targeted. Defaults to ANY_REGION. */
+    RegionType mRegionType;
+
+    /** The lower corner of a box region, or the centre of a sphere region. */
+    std::vector<double> mRegionLower;
+
+    /** The upper corner of a box region (unused for a sphere region). */
+    std::vector<double> mRegionUpper;
+
+    /** The radius of a sphere region (unused for a box region). */
+    double mRegionRadius;
+
+    /** The probability with which each otherwise-targeted cell is affected. Defaults to 1. */
+    double mFraction;
+
+    /**
+     * Constructor, targeting every cell.
+     */
+    PerturbationTarget()
+        : mCellTypeMask(0),
+          mRegionType(ANY_REGION),
+          mRegionRadius(0.0),
+          mFraction(1.0)
+    {
+    }
+
+    /**
+     * Add a cell type to the targeted types.
+     *
+     * @param cellType the cell type
+     */
+    void AddCellType(MammaryCellType cellType)
+    {
+        mCellTypeMask |= (1u << cellType);
+    }
+
+    /**
+     * Restrict the target to an axis-aligned box.
+     *
+     * @param rLower the lower corner of the box
+     * @param rUpper the upper corner of the box
+     */
+    void SetBoxRegion(const std::vector<double>& rLower, const std::vector<double>& rUpper)
+    {
+        mRegionType = BOX_REGION;
+        mRegionLower = rLower;
+        mRegionUpper = rUpper;
+    }
+
+    /**
+     * Restrict the target to a sphere (a disc in 2D).
+     *
+     * @param rCentre the centre of the sphere
+     * @param radius the radius of the sphere
+     */
+    void SetSphereRegion(const std::vector<double>& rCentre, double radius)
+    {
+        mRegionType = SPHERE_REGION;
+        mRegionLower = rCentre;
+        mRegionRadius = radius;
+    }
+
+    /**
+     * Archive the target.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & mCellTypeMask;
+        archive & mRegionType;
+        archive & mRegionLower;
+        archive & mRegionUpper;
+        archive & mRegionRadius;
+        archive & mFraction;
+    }
+};
+
+/**
+ * A timed perturbation, as scheduled by PerturbationSchedulerModifier.
+ */
+struct PerturbationEvent
+{
+    /** The kinds of perturbation. */
+    typedef enum EventType_
+    {
+        INTEGRIN_EVENT,
+        TYPE_CONVERSION_EVENT,
+        SPRING_PARAMETER_EVENT,
+        FORCE_SWITCH_EVENT
+    } EventType;
+
+    /** The time at which the event is applied. */
+    double mTime;
+
+    /** The order in which the event was added, used to apply simultaneous events in order. */
+    unsigned mSequence;
+
+    /** The kind of perturbation. */
+    EventType mEventType;
+
+    /** The targeted cells (integrin and type conversion events only). */
+    PerturbationTarget mTarget;
+
+    /** The change to B1 integrin expression (integrin events only). */
+    IntegrinPerturbation mB1Perturbation;
+
+    /** The change to B4 integrin expression (integrin events only). */
+    IntegrinPerturbation mB4Perturbation;
+
+    /** The new cell type (type conversion events only). */
+    MammaryCellType mNewCellType;
+
+    /** The index of the registered force (spring parameter and force switch events only). */
+    unsigned mForceIndex;
+
+    /** The spring parameter to change (spring parameter events only). */
+    SpringParameter mSpringParameter;
+
+    /** The new value of the spring parameter (spring parameter events only). */
+    double mValue;
+
+    /** Whether the force is switched on (force switch events only). */
+    bool mActive;
+
+    /**
+     * Constructor.
+     */
+    PerturbationEvent()
+        : mTime(0.0),
+          mSequence(0),
+          mEventType(INTEGRIN_EVENT),
+          mB1Perturbation(INTEGRIN_UNCHANGED),
+          mB4Perturbation(INTEGRIN_UNCHANGED),
+          mNewCellType(NO_MAMMARY_CELL_TYPE),
+          mForceIndex(UNSIGNED_UNSET),
+          mSpringParameter(SPRING_STIFFNESS),
+          mValue(DOUBLE_UNSET),
+          mActive(true)
+    {
+    }
+
+    /**
+     * Heap ordering, so that the earliest (then first added) event is at the front.
+     *
+     * @param rOther another event
+     * @return whether this event is due after rOther
+     */
+    bool operator>(const PerturbationEvent& rOther) const
+    {
+        return (mTime > rOther.mTime) || (mTime == rOther.mTime && mSequence > rOther.mSequence);
+    }
+
+    /**
+     * Archive the event.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & mTime;
+        archive & mSequence;
+        archive & mEventType;
+        archive & mTarget;
+        archive & mB1Perturbation;
+        archive & mB4Perturbation;
+        archive & mNewCellType;
+        archive & mForceIndex;
+        archive & mSpringParameter;
+        archive & mValue;
+        archive & mActive;
+    }
+};
+
+/**
+ * A modifier class which applies a schedule of timed perturbations, generalising
+ * IntegrinExpressionModifier to many events per run.
+ *
+ * Events are held in a min-heap keyed on time. An event may change the integrin
+ * expression of, or convert the type of, a targeted set of cells (see
+ * PerturbationTarget); change a spring parameter of a registered force; or switch
+ * a registered SwitchableForce on or off.
+ *
+ * Between events the modifier only compares the current time with the time of the
+ * earliest event. All cell events that fall due in a time step are applied together
+ * in a single pass over the cells.
+ *
+ * Mammary cell properties are shared between cells, so a perturbed cell is given
+ * a new property instance rather than having its property modified in place
+ * (copy-on-write). Within a batch, all cells ending up in the same state share one
+ * new instance. These instances are not held by the CellPropertyRegistry.
+ *
+ * A converted cell is given the proliferative type of its new type (stem for the
+ * stem cell types, differentiated otherwise) and starts a new cell cycle at the time
+ * of conversion, so that, for example, a luminal cell converted to a luminal stem
+ * cell draws a finite cell-cycle duration and goes on to divide. In a
+ * MammaryOffLatticeSimulation, which sets itself as the division scheduler, the
+ * converted cell is then rescheduled in the division queue.
+ *
+ * Where a target selects a fraction of cells, each event draws one number from the
+ * RandomNumberGenerator when it is applied, and each cell is selected by a hash (see
+ * CounterBasedRandomNumberGenerator) of that number and its cell ID, so that the same
+ * cells are selected whatever the order in which the cells are visited. In the
+ * reproducible mode of MammaryRandomStreams, the RandomNumberGenerator is not used:
+ * each cell draws from its own PERTURBATION_EVENT stream, keyed by the time step and the
+ * event's order of addition.
+ */
+template<unsigned DIM>
+class PerturbationSchedulerModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+private:
+
+    /** The pending events, stored as a min-heap. */
+    std::vector<PerturbationEvent> mEvents;
+
+    /** The number of events added so far, used to order simultaneous events. */
+    unsigned mNumEventsAdded;
+
+    /** Forces registered for spring parameter and force switch events. */
+    std::vector<boost::shared_ptr<AbstractForce<DIM> > > mForces;
+
+    /** The number of events applied so far. */
+    unsigned mNumEventsApplied;
+
+    /**
+     * The simulation whose division queue is told of converted cells, if any. Not
+     * archived, since the simulation sets it again in its SetupSolve().
+     */
+    MammaryOffLatticeSimulation<DIM>* mpDivisionScheduler;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mEvents;
+        archive & mNumEventsAdded;
+        archive & mForces;
+        archive & mNumEventsApplied;
+    }
+
+    /**
+     * Push an event onto the heap.
+     *
+     * @param event the event (its sequence number is set here)
+     */
+    void AddEvent(PerturbationEvent event);
+
+    /**
+     * Apply a spring parameter or force switch event.
+     *
+     * @param rEvent the event
+     */
+    void ApplyForceEvent(const PerturbationEvent& rEvent);
+
+    /**
+     * Apply a batch of integrin and type conversion events in a single pass over the cells.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param rCellEvents the events, in the order in which they are to be applied
+     * @param rSelectionSeeds the seed of the random selection of each event
+     */
+    void ApplyCellEvents(AbstractCellPopulation<DIM,DIM>& rCellPopulation,
+                         const std::vector<PerturbationEvent>& rCellEvents,
+                         const std::vector<uint64_t>& rSelectionSeeds);
+
+    /**
+     * @param rCellPopulation reference to the cell population
+     * @param pCell a cell
+     * @param cellType the cell's mammary type
+     * @param rEvent an event
+     * @param selectionSeed the seed of the random selection, if the event's target selects a
+     *     fraction of cells (unused in the reproducible mode of MammaryRandomStreams)
+     * @return whether the cell is targeted by the event (including the random selection, if any)
+     */
+    bool IsCellTargeted(AbstractCellPopulation<DIM,DIM>& rCellPopulation,
+                        CellPtr pCell,
+                        MammaryCellType cellType,
+                        const PerturbationEvent& rEvent,
+                        uint64_t selectionSeed);
+
+    /**
+     * Give a converted cell the proliferative type of its new type, start a new cell
+     * cycle and reschedule the cell's division.
+     *
+     * @param pCell the cell, which already has the property of its new type
+     * @param cellType the new type
+     */
+    void StartNewCellCycle(CellPtr pCell, MammaryCellType cellType);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    PerturbationSchedulerModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~PerturbationSchedulerModifier();
+
+    /**
+     * Register a force so that it can be the subject of spring parameter or force
+     * switch events.
+     *
+     * @param pForce the force; it must also be passed to the simulation
+     * @return the index of the force, used when adding events
+     */
+    unsigned RegisterForce(boost::shared_ptr<AbstractForce<DIM> > pForce);
+
+    /**
+     * Schedule a change in integrin expression.
+     *
+     * @param time the time at which to apply the event
+     * @param b1Perturbation the change to B1 integrin expression
+     * @param b4Perturbation the change to B4 integrin expression
+     * @param rTarget the targeted cells
+     */
+    void AddIntegrinEvent(double time,
+                          IntegrinPerturbation b1Perturbation,
+                          IntegrinPerturbation b4Perturbation,
+                          const PerturbationTarget& rTarget=PerturbationTarget());
+
+    /**
+     * Schedule a conversion of cell type. Converted cells take the default integrin
+     * expression of their new type.
+     *
+     * @param time the time at which to apply the event
+     * @param newCellType the type to which targeted cells are converted
+     * @param rTarget the targeted cells
+     */
+    void AddTypeConversionEvent(double time,
+                                MammaryCellType newCellType,
+                                const PerturbationTarget& rTarget=PerturbationTarget());
+
+    /**
+     * Schedule a change in a spring parameter of a registered force.
+     *
+     * @param time the time at which to apply the event
+     * @param forceIndex the index returned by RegisterForce()
+     * @param springParameter the parameter to change
+     * @param value the new value of the parameter
+     */
+    void AddSpringParameterEvent(double time, unsigned forceIndex, SpringParameter springParameter, double value);
+
+    /**
+     * Schedule switching a registered SwitchableForce on or off.
+     *
+     * @param time the time at which to apply the event
+     * @param forceIndex the index returned by RegisterForce()
+     * @param active whether the force is switched on
+     */
+    void AddForceSwitchEvent(double time, unsigned forceIndex, bool active);
+
+    /**
+     * Set mpDivisionScheduler. This is called by MammaryOffLatticeSimulation::SetupSolve().
+     *
+     * @param pSimulation the simulation whose division queue is told of converted cells
+     */
+    void SetDivisionScheduler(MammaryOffLatticeSimulation<DIM>* pSimulation);
+
+    /**
+     * @return the number of events not yet applied
+     */
+    unsigned GetNumPendingEvents() const;
+
+    /**
+     * @return mNumEventsApplied
+     */
+    unsigned GetNumEventsApplied() const;
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Applies any events that have fallen due.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method, which forgets the division scheduler, so
+     * that the modifier can be reused with another simulation.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(PerturbationSchedulerModifier)
+
+#endif /*PERTURBATIONSCHEDULERMODIFIER_HPP_*/
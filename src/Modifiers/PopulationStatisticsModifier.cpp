@@ -0,0 +1,114 @@
+#include "PopulationStatisticsModifier.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "MammaryProfiler.hpp"
+
+template<unsigned DIM>
+PopulationStatisticsModifier<DIM>::PopulationStatisticsModifier()
+    : AbstractCellBasedSimulationModifier<DIM>(),
+      mOutputTimestepMultiple(1)
+{
+}
+
+template<unsigned DIM>
+PopulationStatisticsModifier<DIM>::~PopulationStatisticsModifier()
+{
+}
+
+template<unsigned DIM>
+unsigned PopulationStatisticsModifier<DIM>::GetOutputTimestepMultiple() const
+{
+    return mOutputTimestepMultiple;
+}
+
+template<unsigned DIM>
+void PopulationStatisticsModifier<DIM>::SetOutputTimestepMultiple(unsigned outputTimestepMultiple)
+{
+    assert(outputTimestepMultiple > 0);
+    mOutputTimestepMultiple = outputTimestepMultiple;
+}
+
+template<unsigned DIM>
+PopulationStatisticsCalculator<DIM>& PopulationStatisticsModifier<DIM>::rGetCalculator()
+{
+    return mCalculator;
+}
+
+template<unsigned DIM>
+void PopulationStatisticsModifier<DIM>::SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory)
+{
+    OutputFileHandler output_file_handler(outputDirectory + "/", false);
+    mpOutputFile = output_file_handler.OpenOutputFile("populationstatistics.dat");
+
+    WriteStatistics(rCellPopulation);
+}
+
+template<unsigned DIM>
+void PopulationStatisticsModifier<DIM>::UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    MAMMARY_PROFILE_SCOPE("step/modifiers/PopulationStatisticsModifier");
+
+    if (SimulationTime::Instance()->GetTimeStepsElapsed() % mOutputTimestepMultiple == 0)
+    {
+        WriteStatistics(rCellPopulation);
+    }
+}
+
+template<unsigned DIM>
+void PopulationStatisticsModifier<DIM>::UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    if (mpOutputFile)
+    {
+        mpOutputFile->close();
+        mpOutputFile.reset();
+    }
+}
+
+template<unsigned DIM>
+void PopulationStatisticsModifier<DIM>::WriteStatistics(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    mCalculator.Calculate(rCellPopulation);
+
+    *mpOutputFile << SimulationTime::Instance()->GetTime() << "\t" << mCalculator.GetNumCells();
+    for (unsigned type=0; type<=NO_MAMMARY_CELL_TYPE; type++)
+    {
+        *mpOutputFile << "\t" << mCalculator.GetNumCellsOfType(static_cast<MammaryCellType>(type));
+    }
+    for (unsigned d=0; d<DIM; d++)
+    {
+        *mpOutputFile << "\t" << mCalculator.rGetCentroid()[d];
+    }
+    *mpOutputFile << "\t" << mCalculator.GetRadiusOfGyration()
+                  << "\t" << mCalculator.GetMaxRadius()
+                  << "\t" << mCalculator.GetPercentileRadius();
+    for (unsigned lineage=0; lineage<NO_LINEAGE; lineage++)
+    {
+        MammaryLineage this_lineage = static_cast<MammaryLineage>(lineage);
+        *mpOutputFile << "\t" << mCalculator.GetShellInnerRadius(this_lineage)
+                      << "\t" << mCalculator.GetShellOuterRadius(this_lineage)
+                      << "\t" << mCalculator.GetShellThickness(this_lineage);
+    }
+    *mpOutputFile << "\n";
+}
+
+template<unsigned DIM>
+void PopulationStatisticsModifier<DIM>::OutputSimulationModifierParameters(out_stream& rParamsFile)
+{
+    *rParamsFile << "\t\t\t<OutputTimestepMultiple>" << mOutputTimestepMultiple << "</OutputTimestepMultiple>\n";
+    *rParamsFile << "\t\t\t<NumThreads>" << mCalculator.GetNumThreads() << "</NumThreads>\n";
+    *rParamsFile << "\t\t\t<MinCellsPerThread>" << mCalculator.GetMinCellsPerThread() << "</MinCellsPerThread>\n";
+    *rParamsFile << "\t\t\t<RadiusPercentile>" << mCalculator.GetRadiusPercentile() << "</RadiusPercentile>\n";
+    *rParamsFile << "\t\t\t<ShellPercentile>" << mCalculator.GetShellPercentile() << "</ShellPercentile>\n";
+
+    // Call method on direct parent class
+    AbstractCellBasedSimulationModifier<DIM>::OutputSimulationModifierParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class PopulationStatisticsModifier<1>;
+template class PopulationStatisticsModifier<2>;
+template class PopulationStatisticsModifier<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(PopulationStatisticsModifier)
@@ -0,0 +1,131 @@
+#ifndef POPULATIONSTATISTICSMODIFIER_HPP_
+#define POPULATIONSTATISTICSMODIFIER_HPP_
+
+#include <string>
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+#include "AbstractCellBasedSimulationModifier.hpp"
+#include "PopulationStatisticsCalculator.hpp"
+
+/**
+ * A modifier class which writes summary statistics of the growth and layering of an
+ * organoid (see PopulationStatisticsCalculator) to the file populationstatistics.dat.
+ *
+ * The statistics are written every mOutputTimestepMultiple time steps, independently of the
+ * sampling of the cell writers, so that they can be followed much more closely than full
+ * snapshots of the population at little cost. They replace recovering the organoid radius
+ * and cell counts from the location output (RadiusOfOrganoid.m, TimeVsRadius.m, TimeVsNoCells.m).
+ */
+template<unsigned DIM>
+class PopulationStatisticsModifier : public AbstractCellBasedSimulationModifier<DIM,DIM>
+{
+private:
+
+    /** The number of time steps between outputs. Defaults to 1. */
+    unsigned mOutputTimestepMultiple;
+
+    /** The calculator, which holds the number of threads and percentiles used. */
+    PopulationStatisticsCalculator<DIM> mCalculator;
+
+    /** The output file. */
+    out_stream mpOutputFile;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Boost Serialization method for archiving/checkpointing.
+     * Archives the object and its member variables.
+     *
+     * @param archive  The boost archive.
+     * @param version  The current version of this class.
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellBasedSimulationModifier<DIM,DIM> >(*this);
+        archive & mOutputTimestepMultiple;
+    }
+
+    /**
+     * Calculate the statistics and write a line of output.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void WriteStatistics(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    PopulationStatisticsModifier();
+
+    /**
+     * Destructor.
+     */
+    virtual ~PopulationStatisticsModifier();
+
+    /**
+     * @return mOutputTimestepMultiple
+     */
+    unsigned GetOutputTimestepMultiple() const;
+
+    /**
+     * Set mOutputTimestepMultiple.
+     *
+     * @param outputTimestepMultiple the number of time steps between outputs
+     */
+    void SetOutputTimestepMultiple(unsigned outputTimestepMultiple);
+
+    /**
+     * @return the calculator, e.g. to set its number of threads or percentiles
+     */
+    PopulationStatisticsCalculator<DIM>& rGetCalculator();
+
+    /**
+     * Overridden UpdateAtEndOfTimeStep() method.
+     *
+     * Writes the statistics every mOutputTimestepMultiple time steps.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfTimeStep(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden SetupSolve() method.
+     *
+     * Opens the output file and writes the statistics of the initial state. Each line is of the form
+     * [time] [number of cells] [luminal] [myoepithelial] [luminal stem] [myoepithelial stem] [no type]
+     * [centroid (DIM values)] [radius of gyration] [maximum radius] [percentile radius]
+     * [luminal inner radius] [luminal outer radius] [luminal thickness]
+     * [myoepithelial inner radius] [myoepithelial outer radius] [myoepithelial thickness]
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param outputDirectory the output directory, relative to where Chaste output is stored
+     */
+    virtual void SetupSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::string outputDirectory);
+
+    /**
+     * Overridden UpdateAtEndOfSolve() method.
+     *
+     * Closes the output file.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    virtual void UpdateAtEndOfSolve(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+    /**
+     * Overridden OutputSimulationModifierParameters() method.
+     * Output any simulation modifier parameters to file.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationModifierParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(PopulationStatisticsModifier)
+
+#endif /*POPULATIONSTATISTICSMODIFIER_HPP_*/
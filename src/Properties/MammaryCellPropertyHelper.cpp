@@ -0,0 +1,135 @@
+#include "MammaryCellPropertyHelper.hpp"
+#include "LuminalCellProperty.hpp"
+#include "MyoepithelialCellProperty.hpp"
+#include "LuminalStemCellProperty.hpp"
+#include "MyoepithelialStemCellProperty.hpp"
+#include "Exception.hpp"
+
+boost::shared_ptr<AbstractMammaryCellProperty> MammaryCellPropertyHelper::GetMammaryCellProperty(CellPtr pCell)
+{
+    /*
+     * A cell may carry more than one mammary property (e.g. the daughter of a luminal stem
+     * cell keeps the parent's property and gains a luminal one), and the collection is
+     * ordered by pointer, so take the property whose type comes first in MammaryCellType,
+     * as MammaryCellTypeWriter does.
+     */
+    boost::shared_ptr<AbstractMammaryCellProperty> p_best_property;
+    MammaryCellType best_type = NO_MAMMARY_CELL_TYPE;
+    CellPropertyCollection& r_collection = pCell->rGetCellPropertyCollection();
+    for (CellPropertyCollection::Iterator it = r_collection.Begin(); it != r_collection.End(); ++it)
+    {
+        boost::shared_ptr<AbstractMammaryCellProperty> p_property = boost::dynamic_pointer_cast<AbstractMammaryCellProperty>(*it);
+        if (p_property)
+        {
+            MammaryCellType type = GetMammaryCellType(p_property);
+            if (type < best_type)
+            {
+                p_best_property = p_property;
+                best_type = type;
+            }
+        }
+    }
+    return p_best_property;
+}
+
+MammaryCellType MammaryCellPropertyHelper::GetMammaryCellType(boost::shared_ptr<AbstractMammaryCellProperty> pProperty)
+{
+    AbstractMammaryCellProperty* p_property = pProperty.get();
+    if (dynamic_cast<LuminalCellProperty*>(p_property))
+    {
+        return LUMINAL_CELL;
+    }
+    else if (dynamic_cast<MyoepithelialCellProperty*>(p_property))
+    {
+        return MYOEPITHELIAL_CELL;
+    }
+    else if (dynamic_cast<LuminalStemCellProperty*>(p_property))
+    {
+        return LUMINAL_STEM_CELL;
+    }
+    else if (dynamic_cast<MyoepithelialStemCellProperty*>(p_property))
+    {
+        return MYOEPITHELIAL_STEM_CELL;
+    }
+    return NO_MAMMARY_CELL_TYPE;
+}
+
+MammaryCellType MammaryCellPropertyHelper::GetMammaryCellType(CellPtr pCell)
+{
+    return GetMammaryCellType(GetMammaryCellProperty(pCell));
+}
+
+boost::shared_ptr<AbstractMammaryCellProperty> MammaryCellPropertyHelper::CreateMammaryCellProperty(MammaryCellType cellType,
+                                                                                                    bool b1IntegrinExpression,
+                                                                                                    bool b4IntegrinExpression)
+{
+    boost::shared_ptr<AbstractMammaryCellProperty> p_property;
+    switch (cellType)
+    {
+        case LUMINAL_CELL:
+            p_property.reset(new LuminalCellProperty(b1IntegrinExpression, b4IntegrinExpression));
+            break;
+        case MYOEPITHELIAL_CELL:
+            p_property.reset(new MyoepithelialCellProperty(b1IntegrinExpression, b4IntegrinExpression));
+            break;
+        case LUMINAL_STEM_CELL:
+            p_property.reset(new LuminalStemCellProperty(b1IntegrinExpression, b4IntegrinExpression));
+            break;
+        case MYOEPITHELIAL_STEM_CELL:
+            p_property.reset(new MyoepithelialStemCellProperty(b1IntegrinExpression, b4IntegrinExpression));
+            break;
+        default:
+            EXCEPTION("Cannot create a mammary cell property without a mammary cell type");
+    }
+    return p_property;
+}
+
+void MammaryCellPropertyHelper::GetDefaultIntegrinExpression(MammaryCellType cellType,
+                                                             bool& rB1IntegrinExpression,
+                                                             bool& rB4IntegrinExpression)
+{
+    boost::shared_ptr<AbstractMammaryCellProperty> p_default;
+    switch (cellType)
+    {
+        case LUMINAL_CELL:
+            p_default.reset(new LuminalCellProperty());
+            break;
+        case MYOEPITHELIAL_CELL:
+            p_default.reset(new MyoepithelialCellProperty());
+            break;
+        case LUMINAL_STEM_CELL:
+            p_default.reset(new LuminalStemCellProperty());
+            break;
+        case MYOEPITHELIAL_STEM_CELL:
+            p_default.reset(new MyoepithelialStemCellProperty());
+            break;
+        default:
+            EXCEPTION("Cannot get the default integrin expression without a mammary cell type");
+    }
+    rB1IntegrinExpression = p_default->GetB1IntegrinExpression();
+    rB4IntegrinExpression = p_default->GetB4IntegrinExpression();
+}
+
+/**
+ * Remove every property of a given type from a cell.
+ *
+ * @param pCell the cell
+ */
+template<class PROPERTY>
+static void RemoveAllCellProperties(CellPtr pCell)
+{
+    while (pCell->HasCellProperty<PROPERTY>())
+    {
+        pCell->RemoveCellProperty<PROPERTY>();
+    }
+}
+
+void MammaryCellPropertyHelper::ReplaceMammaryCellProperty(CellPtr pCell, boost::shared_ptr<AbstractMammaryCellProperty> pNewProperty)
+{
+    // Remove every mammary property, since a cell may carry more than one
+    RemoveAllCellProperties<LuminalCellProperty>(pCell);
+    RemoveAllCellProperties<MyoepithelialCellProperty>(pCell);
+    RemoveAllCellProperties<LuminalStemCellProperty>(pCell);
+    RemoveAllCellProperties<MyoepithelialStemCellProperty>(pCell);
+    pCell->AddCellProperty(pNewProperty);
+}
@@ -0,0 +1,84 @@
+#ifndef MAMMARYCELLPROPERTYHELPER_HPP_
+#define MAMMARYCELLPROPERTYHELPER_HPP_
+
+#include <boost/shared_ptr.hpp>
+#include "Cell.hpp"
+#include "AbstractMammaryCellProperty.hpp"
+
+/**
+ * The mammary cell types, one for each subclass of AbstractMammaryCellProperty.
+ *
+ * The numerical values match the type codes written by MammaryCellTypeWriter.
+ */
+typedef enum MammaryCellType_
+{
+    LUMINAL_CELL = 0,
+    MYOEPITHELIAL_CELL = 1,
+    LUMINAL_STEM_CELL = 2,
+    MYOEPITHELIAL_STEM_CELL = 3,
+    NO_MAMMARY_CELL_TYPE = 4
+} MammaryCellType;
+
+/**
+ * Helper functions for looking up and replacing the mammary cell property of a cell
+ * in a single pass over its property collection, instead of a chain of
+ * HasCellProperty<>() calls.
+ */
+class MammaryCellPropertyHelper
+{
+public:
+
+    /**
+     * @param pCell a cell
+     * @return the cell's mammary property, or an empty pointer if it has none. If the cell has
+     *     several, the one whose type comes first in MammaryCellType (luminal, myoepithelial,
+     *     luminal stem, myoepithelial stem) is returned, as in MammaryCellTypeWriter.
+     */
+    static boost::shared_ptr<AbstractMammaryCellProperty> GetMammaryCellProperty(CellPtr pCell);
+
+    /**
+     * @param pProperty a mammary cell property (may be empty)
+     * @return the type of the property, or NO_MAMMARY_CELL_TYPE if it is empty
+     */
+    static MammaryCellType GetMammaryCellType(boost::shared_ptr<AbstractMammaryCellProperty> pProperty);
+
+    /**
+     * @param pCell a cell
+     * @return the cell's mammary type, or NO_MAMMARY_CELL_TYPE if it has none
+     */
+    static MammaryCellType GetMammaryCellType(CellPtr pCell);
+
+    /**
+     * Create a new (unshared) mammary cell property of the given type.
+     *
+     * @param cellType the type of property to create
+     * @param b1IntegrinExpression whether B1 integrin is expressed
+     * @param b4IntegrinExpression whether B4 integrin is expressed
+     * @return the new property
+     */
+    static boost::shared_ptr<AbstractMammaryCellProperty> CreateMammaryCellProperty(MammaryCellType cellType,
+                                                                                    bool b1IntegrinExpression,
+                                                                                    bool b4IntegrinExpression);
+
+    /**
+     * Get the default integrin expression of a mammary cell type, as set by the
+     * constructor of the corresponding property.
+     *
+     * @param cellType the cell type
+     * @param rB1IntegrinExpression filled in with the default B1 integrin expression
+     * @param rB4IntegrinExpression filled in with the default B4 integrin expression
+     */
+    static void GetDefaultIntegrinExpression(MammaryCellType cellType,
+                                             bool& rB1IntegrinExpression,
+                                             bool& rB4IntegrinExpression);
+
+    /**
+     * Replace the mammary properties of a cell (if any) with another.
+     *
+     * @param pCell the cell
+     * @param pNewProperty the new property
+     */
+    static void ReplaceMammaryCellProperty(CellPtr pCell, boost::shared_ptr<AbstractMammaryCellProperty> pNewProperty);
+};
+
+#endif /*MAMMARYCELLPROPERTYHELPER_HPP_*/
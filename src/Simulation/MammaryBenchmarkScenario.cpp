@@ -0,0 +1,454 @@
+#include "MammaryBenchmarkScenario.hpp"
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <sstream>
+
+#include "CellBasedEventHandler.hpp"
+#include "CellId.hpp"
+#include "CellPropertyRegistry.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+#include "Exception.hpp"
+#include "NodeBasedCellPopulationWithParticles.hpp"
+#include "ObjectPool.hpp"
+#include "PlaneBoundaryCondition.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "SimulationTime.hpp"
+#include "SmartPointers.hpp"
+#include "StemCellProliferativeType.hpp"
+#include "Timer.hpp"
+#include "WildTypeCellMutationState.hpp"
+
+#include "LuminalCellProperty.hpp"
+#include "MyoepithelialCellProperty.hpp"
+#include "LuminalStemCellProperty.hpp"
+#include "MyoepithelialStemCellProperty.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "MammaryOffLatticeSimulation.hpp"
+
+#include "CellCoverslipAdhesionForce.hpp"
+#include "CellParticleAdhesionForce.hpp"
+#include "DifferentialAdhesionLinearSpringForce.hpp"
+#include "LinearSpringForce.hpp"
+#include "RandomMotionForce.hpp"
+
+double MammaryBenchmarkResult::GetTimePerStep() const
+{
+    return (mNumSteps == 0) ? 0.0 : (mSolveTime - mSetupTime)/mNumSteps;
+}
+
+double MammaryBenchmarkResult::GetTimePerCellStep() const
+{
+    double mean_num_cells = 0.5*(mNumCellsAtStart + mNumCellsAtEnd);
+    return (mean_num_cells == 0.0) ? 0.0 : GetTimePerStep()/mean_num_cells;
+}
+
+template<unsigned DIM>
+MammaryBenchmarkScenario<DIM>::MammaryBenchmarkScenario(MammaryBenchmarkGeometry geometry, unsigned numCells, unsigned forces)
+    : mGeometry(geometry),
+      mNumCells(numCells),
+      mForces(forces),
+      mSpacing(1.0),
+      mParticleRatio(1.0),
+      mStemCellFraction(0.1),
+      mCutOffLength(1.5),
+      mDt(1.0/120.0)
+{
+    if (numCells == 0)
+    {
+        EXCEPTION("A benchmark scenario must have at least one cell");
+    }
+}
+
+template<unsigned DIM>
+std::string MammaryBenchmarkScenario<DIM>::GetGeometryName(MammaryBenchmarkGeometry geometry)
+{
+    switch (geometry)
+    {
+        case ORGANOID_GEOMETRY:
+            return "organoid";
+        case MONOLAYER_GEOMETRY:
+            return "monolayer";
+        case PARTICLE_ORGANOID_GEOMETRY:
+            return "particle_organoid";
+        default:
+            NEVER_REACHED;
+    }
+}
+
+template<unsigned DIM>
+std::string MammaryBenchmarkScenario<DIM>::GetForcesName(unsigned forces)
+{
+    const char* names[5] = {"spring", "adhesion", "particle", "coverslip", "random"};
+    std::string name;
+    for (unsigned bit=0; bit<5; bit++)
+    {
+        if (forces & (1u << bit))
+        {
+            name += (name.empty() ? "" : "+") + std::string(names[bit]);
+        }
+    }
+    return name.empty() ? "none" : name;
+}
+
+template<unsigned DIM>
+std::string MammaryBenchmarkScenario<DIM>::GetName() const
+{
+    std::stringstream name;
+    name << GetGeometryName(mGeometry) << "_" << DIM << "d_" << mNumCells << "_" << GetForcesName(mForces);
+    return name.str();
+}
+
+template<unsigned DIM>
+MammaryBenchmarkGeometry MammaryBenchmarkScenario<DIM>::GetGeometry() const
+{
+    return mGeometry;
+}
+
+template<unsigned DIM>
+unsigned MammaryBenchmarkScenario<DIM>::GetNumCells() const
+{
+    return mNumCells;
+}
+
+template<unsigned DIM>
+unsigned MammaryBenchmarkScenario<DIM>::GetForces() const
+{
+    return mForces;
+}
+
+template<unsigned DIM>
+void MammaryBenchmarkScenario<DIM>::SetSpacing(double spacing)
+{
+    mSpacing = spacing;
+}
+
+template<unsigned DIM>
+void MammaryBenchmarkScenario<DIM>::SetParticleRatio(double particleRatio)
+{
+    mParticleRatio = particleRatio;
+}
+
+template<unsigned DIM>
+void MammaryBenchmarkScenario<DIM>::SetStemCellFraction(double stemCellFraction)
+{
+    mStemCellFraction = stemCellFraction;
+}
+
+template<unsigned DIM>
+void MammaryBenchmarkScenario<DIM>::SetCutOffLength(double cutOffLength)
+{
+    mCutOffLength = cutOffLength;
+}
+
+template<unsigned DIM>
+void MammaryBenchmarkScenario<DIM>::SetDt(double dt)
+{
+    mDt = dt;
+}
+
+template<unsigned DIM>
+void MammaryBenchmarkScenario<DIM>::GenerateNodes(std::vector<Node<DIM>*>& rNodes, std::vector<bool>& rCellIsMyoepithelial) const
+{
+    RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+    unsigned num_particles = (mGeometry == PARTICLE_ORGANOID_GEOMETRY) ? static_cast<unsigned>(mParticleRatio*mNumCells + 0.5) : 0;
+    unsigned num_sites = mNumCells + num_particles;
+
+    // The lattice coordinates of each site, in order
+    std::vector<int> sites(num_sites*DIM, 0);
+    if (mGeometry == MONOLAYER_GEOMETRY)
+    {
+        int side = (DIM == 1) ? num_sites : static_cast<int>(ceil(sqrt(static_cast<double>(num_sites))));
+        for (unsigned site=0; site<num_sites; site++)
+        {
+            sites[site*DIM] = static_cast<int>(site % side) - side/2;
+            if (DIM > 1)
+            {
+                sites[site*DIM + 1] = static_cast<int>(site / side) - side/2;
+            }
+        }
+    }
+    else
+    {
+        // Take the sites of a cube around the origin that lie nearest to it, which form a ball
+        double unit_ball_volume = (DIM == 1) ? 2.0 : ((DIM == 2) ? M_PI : 4.0*M_PI/3.0);
+        int half_width = static_cast<int>(ceil(pow(num_sites/unit_ball_volume, 1.0/DIM))) + 1;
+        int width = 2*half_width + 1;
+        unsigned num_cube_sites = 1;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            num_cube_sites *= width;
+        }
+
+        // Each cube site as (squared distance from the origin, index), so that sorting is deterministic
+        std::vector<std::pair<int, unsigned> > cube_sites(num_cube_sites);
+        for (unsigned index=0; index<num_cube_sites; index++)
+        {
+            int squared_distance = 0;
+            for (unsigned d=0, rest=index; d<DIM; d++, rest/=width)
+            {
+                int x = static_cast<int>(rest % width) - half_width;
+                squared_distance += x*x;
+            }
+            cube_sites[index] = std::make_pair(squared_distance, index);
+        }
+        std::sort(cube_sites.begin(), cube_sites.end());
+
+        for (unsigned site=0; site<num_sites; site++)
+        {
+            for (unsigned d=0, rest=cube_sites[site].second; d<DIM; d++, rest/=width)
+            {
+                sites[site*DIM + d] = static_cast<int>(rest % width) - half_width;
+            }
+        }
+    }
+
+    // The outermost layer of an organoid's cells is myoepithelial; a monolayer's cells are mixed at random
+    rCellIsMyoepithelial.resize(mNumCells);
+    double outer_radius = 0.0;
+    for (unsigned d=0; d<DIM; d++)
+    {
+        outer_radius += sites[(mNumCells-1)*DIM + d]*sites[(mNumCells-1)*DIM + d];
+    }
+    outer_radius = sqrt(outer_radius);
+    for (unsigned cell=0; cell<mNumCells; cell++)
+    {
+        if (mGeometry == MONOLAYER_GEOMETRY)
+        {
+            rCellIsMyoepithelial[cell] = (p_gen->ranf() < 0.5);
+        }
+        else
+        {
+            double radius = 0.0;
+            for (unsigned d=0; d<DIM; d++)
+            {
+                radius += sites[cell*DIM + d]*sites[cell*DIM + d];
+            }
+            rCellIsMyoepithelial[cell] = (sqrt(radius) > outer_radius - 1.0);
+        }
+    }
+
+    // Jitter the sites so that no forces cancel exactly; a monolayer stays flat
+    unsigned num_jittered_dims = (mGeometry == MONOLAYER_GEOMETRY) ? std::min(DIM, 2u) : DIM;
+    rNodes.reserve(num_sites);
+    for (unsigned site=0; site<num_sites; site++)
+    {
+        c_vector<double, DIM> location;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            location[d] = mSpacing*sites[site*DIM + d];
+            if (d < num_jittered_dims)
+            {
+                location[d] += 0.1*mSpacing*(p_gen->ranf() - 0.5);
+            }
+        }
+        rNodes.push_back(new Node<DIM>(site, location, false));
+    }
+}
+
+template<unsigned DIM>
+void MammaryBenchmarkScenario<DIM>::ConstructMesh(NodesOnlyMesh<DIM>& rMesh, std::vector<bool>& rCellIsMyoepithelial) const
+{
+    std::vector<Node<DIM>*> nodes;
+    GenerateNodes(nodes, rCellIsMyoepithelial);
+    rMesh.ConstructNodesWithoutMesh(nodes, mCutOffLength);
+    for (unsigned i=0; i<nodes.size(); i++)
+    {
+        delete nodes[i];
+    }
+}
+
+template<unsigned DIM>
+boost::shared_ptr<NodeBasedCellPopulation<DIM> > MammaryBenchmarkScenario<DIM>::CreateCellPopulation(NodesOnlyMesh<DIM>& rMesh,
+                                                                                                      const std::vector<bool>& rCellIsMyoepithelial) const
+{
+    RandomNumberGenerator* p_gen = RandomNumberGenerator::Instance();
+    CellPropertyRegistry* p_registry = CellPropertyRegistry::Instance();
+    boost::shared_ptr<AbstractCellProperty> p_state(p_registry->Get<WildTypeCellMutationState>());
+    boost::shared_ptr<AbstractCellProperty> p_stem_type(p_registry->Get<StemCellProliferativeType>());
+    boost::shared_ptr<AbstractCellProperty> p_differentiated_type(p_registry->Get<DifferentiatedCellProliferativeType>());
+    boost::shared_ptr<AbstractCellProperty> p_luminal(p_registry->Get<LuminalCellProperty>());
+    boost::shared_ptr<AbstractCellProperty> p_myo(p_registry->Get<MyoepithelialCellProperty>());
+    boost::shared_ptr<AbstractCellProperty> p_luminal_stem(p_registry->Get<LuminalStemCellProperty>());
+    boost::shared_ptr<AbstractCellProperty> p_myo_stem(p_registry->Get<MyoepithelialStemCellProperty>());
+
+    // Cells occupy the first nodes of the mesh, and particles the rest
+    std::vector<CellPtr> cells;
+    std::vector<unsigned> location_indices;
+    cells.reserve(mNumCells);
+    location_indices.reserve(mNumCells);
+    for (unsigned i=0; i<mNumCells; i++)
+    {
+        MammaryCellCycleModel* p_cycle_model = new MammaryCellCycleModel();
+        p_cycle_model->SetDimension(DIM);
+        p_cycle_model->SetBirthTime(-p_cycle_model->GetMinCellCycleDuration()*p_gen->ranf());
+
+        CellPtr p_cell(new Cell(p_state, p_cycle_model));
+        bool is_stem = (p_gen->ranf() < mStemCellFraction);
+        p_cell->SetCellProliferativeType(is_stem ? p_stem_type : p_differentiated_type);
+        if (rCellIsMyoepithelial[i])
+        {
+            p_cell->AddCellProperty(is_stem ? p_myo_stem : p_myo);
+        }
+        else
+        {
+            p_cell->AddCellProperty(is_stem ? p_luminal_stem : p_luminal);
+        }
+
+        cells.push_back(p_cell);
+        location_indices.push_back(i);
+    }
+
+    boost::shared_ptr<NodeBasedCellPopulation<DIM> > p_population;
+    if (mGeometry == PARTICLE_ORGANOID_GEOMETRY)
+    {
+        p_population.reset(new NodeBasedCellPopulationWithParticles<DIM>(rMesh, cells, location_indices));
+    }
+    else
+    {
+        p_population.reset(new NodeBasedCellPopulation<DIM>(rMesh, cells));
+    }
+    return p_population;
+}
+
+template<unsigned DIM>
+void MammaryBenchmarkScenario<DIM>::SetUpSimulation(OffLatticeSimulation<DIM>& rSimulator) const
+{
+    if (mForces & SPRING_FORCE)
+    {
+        MAKE_PTR(LinearSpringForce<DIM>, p_linear_force);
+        p_linear_force->SetCutOffLength(mCutOffLength);
+        p_linear_force->SetCellCellSpringStiffness(15.0);
+        p_linear_force->SetCellECMSpringStiffness(15.0);
+        p_linear_force->SetECMECMSpringStiffness(5.0);
+        p_linear_force->SetHomotypicSpringConstantMultiplier(1.0);
+        p_linear_force->SetHeterotypicSpringConstantMultiplier(0.1);
+        rSimulator.AddForce(p_linear_force);
+    }
+    if (mForces & DIFFERENTIAL_ADHESION_FORCE)
+    {
+        MAKE_PTR(DifferentialAdhesionLinearSpringForce<DIM>, p_differential_adhesion_force);
+        p_differential_adhesion_force->SetCutOffLength(mCutOffLength);
+        p_differential_adhesion_force->SetHeterotypicSpringConstantMultiplier(0.1);
+        rSimulator.AddForce(p_differential_adhesion_force);
+    }
+    if (mForces & PARTICLE_ADHESION_FORCE)
+    {
+        MAKE_PTR(CellParticleAdhesionForce<DIM>, p_particle_force);
+        p_particle_force->SetCutOffLength(mCutOffLength);
+        rSimulator.AddForce(p_particle_force);
+    }
+    if (mForces & COVERSLIP_ADHESION_FORCE)
+    {
+        MAKE_PTR(CellCoverslipAdhesionForce<DIM>, p_coverslip_force);
+        rSimulator.AddForce(p_coverslip_force);
+    }
+    if (mForces & RANDOM_MOTION_FORCE)
+    {
+        MAKE_PTR(RandomMotionForce<DIM>, p_random_force);
+        p_random_force->SetMovementParameter(0.05);
+        rSimulator.AddForce(p_random_force);
+    }
+
+    // A 3D monolayer rests on a coverslip at z=0
+    if (mGeometry == MONOLAYER_GEOMETRY && DIM == 3)
+    {
+        c_vector<double, DIM> point = zero_vector<double>(DIM);
+        c_vector<double, DIM> normal = zero_vector<double>(DIM);
+        normal(DIM-1) = -1.0;
+        MAKE_PTR_ARGS(PlaneBoundaryCondition<DIM>, p_bc, (&rSimulator.rGetCellPopulation(), point, normal));
+        rSimulator.AddCellPopulationBoundaryCondition(p_bc);
+    }
+}
+
+template<unsigned DIM>
+MammaryBenchmarkResult MammaryBenchmarkScenario<DIM>::Run(unsigned numSteps, const std::string& rOutputDirectory, unsigned seed) const
+{
+    // Start each run from the same state, so that runs of a scenario see the same divisions
+    SimulationTime::Destroy();
+    SimulationTime::Instance()->SetStartTime(0.0);
+    RandomNumberGenerator::Instance()->Reseed(seed);
+    CellId::ResetMaxCellId();
+    CellBasedEventHandler::Reset();
+
+    MammaryBenchmarkResult result;
+    result.mNumSteps = numSteps;
+
+    ObjectPool<MammaryCellCycleModel>* p_pool = ObjectPool<MammaryCellCycleModel>::Instance();
+    p_pool->ResetCounters();
+
+    Timer::Reset();
+    NodesOnlyMesh<DIM> mesh;
+    std::vector<bool> cell_is_myoepithelial;
+    ConstructMesh(mesh, cell_is_myoepithelial);
+    boost::shared_ptr<NodeBasedCellPopulation<DIM> > p_population = CreateCellPopulation(mesh, cell_is_myoepithelial);
+    result.mConstructionTime = Timer::GetElapsedTime();
+    result.mNumCellsAtStart = p_population->GetNumRealCells();
+    result.mNumParticles = mesh.GetNumNodes() - result.mNumCellsAtStart;
+
+    {
+        MammaryOffLatticeSimulation<DIM> simulator(*p_population);
+        simulator.SetOutputDirectory(rOutputDirectory);
+        simulator.SetDt(mDt);
+        simulator.SetEndTime(numSteps*mDt);
+        simulator.SetSamplingTimestepMultiple(numSteps + 1);
+        SetUpSimulation(simulator);
+
+        Timer::Reset();
+        simulator.Solve();
+        result.mSolveTime = Timer::GetElapsedTime();
+        result.mNumCellsAtEnd = p_population->GetNumRealCells();
+        result.mNumCycleModelAllocations = p_pool->GetNumObjectAllocations();
+        result.mNumPoolHeapAllocations = p_pool->GetNumHeapAllocations();
+    }
+
+    // The event handler's times are in milliseconds
+    unsigned num_phases = sizeof(CellBasedEventHandler::EventName)/sizeof(CellBasedEventHandler::EventName[0]);
+    for (unsigned phase=0; phase<num_phases; phase++)
+    {
+        result.mPhaseNames.push_back(CellBasedEventHandler::EventName[phase]);
+        result.mPhaseTimes.push_back(0.001*CellBasedEventHandler::GetElapsedTime(phase));
+    }
+    result.mSetupTime = 0.001*CellBasedEventHandler::GetElapsedTime(CellBasedEventHandler::SETUP);
+
+    return result;
+}
+
+template<unsigned DIM>
+void MammaryBenchmarkScenario<DIM>::WriteResultHeader(out_stream& rFile, const MammaryBenchmarkResult& rResult)
+{
+    *rFile << "scenario,geometry,dimension,num_cells,num_particles,forces,num_steps,num_cells_at_end,"
+           << "construction_s,setup_s,solve_s,step_s,cell_step_s,cycle_model_allocations,pool_heap_allocations";
+    for (unsigned phase=0; phase<rResult.mPhaseNames.size(); phase++)
+    {
+        // Phase columns give the mean time per step, named after the phase in lower case without spaces
+        std::string name = rResult.mPhaseNames[phase];
+        for (unsigned i=0; i<name.size(); i++)
+        {
+            name[i] = (name[i] == ' ') ? '_' : tolower(name[i]);
+        }
+        *rFile << "," << name << "_step_s";
+    }
+    *rFile << "\n";
+}
+
+template<unsigned DIM>
+void MammaryBenchmarkScenario<DIM>::WriteResult(out_stream& rFile, const MammaryBenchmarkResult& rResult) const
+{
+    *rFile << GetName() << "," << GetGeometryName(mGeometry) << "," << DIM << "," << rResult.mNumCellsAtStart << ","
+           << rResult.mNumParticles << "," << GetForcesName(mForces) << "," << rResult.mNumSteps << ","
+           << rResult.mNumCellsAtEnd << "," << rResult.mConstructionTime << "," << rResult.mSetupTime << ","
+           << rResult.mSolveTime << "," << rResult.GetTimePerStep() << "," << rResult.GetTimePerCellStep() << ","
+           << rResult.mNumCycleModelAllocations << "," << rResult.mNumPoolHeapAllocations;
+    for (unsigned phase=0; phase<rResult.mPhaseTimes.size(); phase++)
+    {
+        *rFile << "," << rResult.mPhaseTimes[phase]/std::max(rResult.mNumSteps, 1u);
+    }
+    *rFile << "\n";
+    rFile->flush();
+}
+
+// Explicit instantiation
+template class MammaryBenchmarkScenario<1>;
+template class MammaryBenchmarkScenario<2>;
+template class MammaryBenchmarkScenario<3>;
@@ -0,0 +1,273 @@
+#ifndef MAMMARYBENCHMARKSCENARIO_HPP_
+#define MAMMARYBENCHMARKSCENARIO_HPP_
+
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "OffLatticeSimulation.hpp"
+
+/**
+ * The geometry of a benchmark scenario.
+ */
+typedef enum MammaryBenchmarkGeometry_
+{
+    ORGANOID_GEOMETRY = 0,
+    MONOLAYER_GEOMETRY = 1,
+    PARTICLE_ORGANOID_GEOMETRY = 2
+} MammaryBenchmarkGeometry;
+
+/**
+ * The forces that may be combined in a benchmark scenario, as bits of a force combination.
+ */
+typedef enum MammaryBenchmarkForce_
+{
+    SPRING_FORCE = 1,
+    DIFFERENTIAL_ADHESION_FORCE = 2,
+    PARTICLE_ADHESION_FORCE = 4,
+    COVERSLIP_ADHESION_FORCE = 8,
+    RANDOM_MOTION_FORCE = 16
+} MammaryBenchmarkForce;
+
+/**
+ * The timings of one run of a benchmark scenario.
+ */
+struct MammaryBenchmarkResult
+{
+    /** The number of time steps run. */
+    unsigned mNumSteps;
+
+    /** The number of cells at the start of the run. */
+    unsigned mNumCellsAtStart;
+
+    /** The number of cells at the end of the run. */
+    unsigned mNumCellsAtEnd;
+
+    /** The number of particles. */
+    unsigned mNumParticles;
+
+    /** The wall-clock time taken to build the mesh, cells and population, in seconds. */
+    double mConstructionTime;
+
+    /** The wall-clock time taken by Solve(), in seconds. */
+    double mSolveTime;
+
+    /** The wall-clock time taken by the setup of Solve() (including the initial output), in seconds. */
+    double mSetupTime;
+
+    /** The number of cell-cycle models allocated during the run, from ObjectPool<MammaryCellCycleModel>. */
+    unsigned long mNumCycleModelAllocations;
+
+    /** The number of heap allocations made by ObjectPool<MammaryCellCycleModel> during the run. */
+    unsigned long mNumPoolHeapAllocations;
+
+    /** The name of each phase timed by CellBasedEventHandler. */
+    std::vector<std::string> mPhaseNames;
+
+    /** The wall-clock time spent in each phase during Solve(), in seconds. */
+    std::vector<double> mPhaseTimes;
+
+    /**
+     * @return the mean wall-clock time per time step, in seconds, excluding the setup of Solve()
+     */
+    double GetTimePerStep() const;
+
+    /**
+     * @return the mean wall-clock time per time step per cell, in seconds
+     */
+    double GetTimePerCellStep() const;
+};
+
+/**
+ * A parameterised workload for benchmarking: an organoid, a monolayer or an organoid
+ * embedded in particles, of a given number of cells and dimension, run for a fixed
+ * number of time steps with a given combination of forces.
+ *
+ * The cells are placed on a jittered square (or cubic) lattice of spacing mSpacing:
+ * - an organoid is the ball of the lattice sites nearest the origin, with myoepithelial
+ *   cells in the outermost layer and luminal cells inside;
+ * - a monolayer is a square sheet in the first two coordinates (a line in 1D), with
+ *   luminal and myoepithelial cells mixed at random and, in 3D, a coverslip below it;
+ * - a particle-embedded organoid is an organoid surrounded by a shell of
+ *   mParticleRatio particles per cell.
+ * A fraction mStemCellFraction of the cells are stem cells of their lineage, which
+ * divide (with MammaryCellCycleModel); the others are differentiated. The lattice and
+ * cell types are drawn from RandomNumberGenerator, so a scenario is reproducible for a
+ * given seed.
+ *
+ * Run() times the construction and the Solve() of a MammaryOffLatticeSimulation of the
+ * scenario, and the phases of each step as recorded by CellBasedEventHandler, and counts
+ * the allocations of cell-cycle models. Results are only written when the simulation
+ * samples, which it does only at the start.
+ */
+template<unsigned DIM>
+class MammaryBenchmarkScenario
+{
+private:
+
+    /** The geometry of the scenario. */
+    MammaryBenchmarkGeometry mGeometry;
+
+    /** The number of cells. */
+    unsigned mNumCells;
+
+    /** The forces used, as a combination of MammaryBenchmarkForce bits. */
+    unsigned mForces;
+
+    /** The spacing of the lattice on which cells are placed. Defaults to 1. */
+    double mSpacing;
+
+    /** The number of particles per cell in a particle-embedded organoid. Defaults to 1. */
+    double mParticleRatio;
+
+    /** The fraction of cells that are stem cells. Defaults to 0.1. */
+    double mStemCellFraction;
+
+    /** The interaction cut-off length of the mesh and the spring forces. Defaults to 1.5. */
+    double mCutOffLength;
+
+    /** The time step. Defaults to 1/120 hours. */
+    double mDt;
+
+    /**
+     * Place the nodes of the scenario on the lattice.
+     *
+     * @param rNodes filled in with the nodes, cells first, ordered by distance from the origin within an organoid
+     * @param rCellIsMyoepithelial filled in with whether each cell is myoepithelial
+     */
+    void GenerateNodes(std::vector<Node<DIM>*>& rNodes, std::vector<bool>& rCellIsMyoepithelial) const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param geometry the geometry of the scenario
+     * @param numCells the number of cells
+     * @param forces the forces used, as a combination of MammaryBenchmarkForce bits
+     */
+    MammaryBenchmarkScenario(MammaryBenchmarkGeometry geometry, unsigned numCells, unsigned forces);
+
+    /**
+     * @param geometry a geometry
+     * @return the name of the geometry (e.g. "organoid")
+     */
+    static std::string GetGeometryName(MammaryBenchmarkGeometry geometry);
+
+    /**
+     * @param forces a combination of MammaryBenchmarkForce bits
+     * @return the names of the forces joined by '+' (e.g. "spring+random")
+     */
+    static std::string GetForcesName(unsigned forces);
+
+    /**
+     * @return the name of the scenario, built from its geometry, dimension, number of cells and forces
+     */
+    std::string GetName() const;
+
+    /**
+     * @return mGeometry
+     */
+    MammaryBenchmarkGeometry GetGeometry() const;
+
+    /**
+     * @return mNumCells
+     */
+    unsigned GetNumCells() const;
+
+    /**
+     * @return mForces
+     */
+    unsigned GetForces() const;
+
+    /**
+     * Set mSpacing.
+     *
+     * @param spacing the spacing of the lattice on which cells are placed
+     */
+    void SetSpacing(double spacing);
+
+    /**
+     * Set mParticleRatio.
+     *
+     * @param particleRatio the number of particles per cell in a particle-embedded organoid
+     */
+    void SetParticleRatio(double particleRatio);
+
+    /**
+     * Set mStemCellFraction.
+     *
+     * @param stemCellFraction the fraction of cells that are stem cells
+     */
+    void SetStemCellFraction(double stemCellFraction);
+
+    /**
+     * Set mCutOffLength.
+     *
+     * @param cutOffLength the interaction cut-off length
+     */
+    void SetCutOffLength(double cutOffLength);
+
+    /**
+     * Set mDt.
+     *
+     * @param dt the time step
+     */
+    void SetDt(double dt);
+
+    /**
+     * Build the mesh of the scenario.
+     *
+     * @param rMesh the mesh, to be filled in with the cells' and particles' nodes
+     * @param rCellIsMyoepithelial filled in with whether each cell is myoepithelial
+     */
+    void ConstructMesh(NodesOnlyMesh<DIM>& rMesh, std::vector<bool>& rCellIsMyoepithelial) const;
+
+    /**
+     * Create the cells and cell population of the scenario on a mesh built by ConstructMesh().
+     *
+     * @param rMesh the mesh
+     * @param rCellIsMyoepithelial whether each cell is myoepithelial
+     * @return the cell population, which refers to the mesh
+     */
+    boost::shared_ptr<NodeBasedCellPopulation<DIM> > CreateCellPopulation(NodesOnlyMesh<DIM>& rMesh,
+                                                                           const std::vector<bool>& rCellIsMyoepithelial) const;
+
+    /**
+     * Add the scenario's forces (and, for a 3D monolayer, its coverslip) to a simulation.
+     *
+     * @param rSimulator the simulation
+     */
+    void SetUpSimulation(OffLatticeSimulation<DIM>& rSimulator) const;
+
+    /**
+     * Build and run the scenario from a fresh SimulationTime, CellId counter and
+     * RandomNumberGenerator seed, timing each part.
+     *
+     * @param numSteps the number of time steps to run
+     * @param rOutputDirectory the output directory of the simulation
+     * @param seed the seed of RandomNumberGenerator
+     * @return the timings
+     */
+    MammaryBenchmarkResult Run(unsigned numSteps, const std::string& rOutputDirectory, unsigned seed=0) const;
+
+    /**
+     * Write the header of a CSV file of benchmark results.
+     *
+     * @param rFile the file
+     * @param rResult a result, whose phase names head the phase columns
+     */
+    static void WriteResultHeader(out_stream& rFile, const MammaryBenchmarkResult& rResult);
+
+    /**
+     * Write a result as a row of a CSV file.
+     *
+     * @param rFile the file
+     * @param rResult the result of running this scenario
+     */
+    void WriteResult(out_stream& rFile, const MammaryBenchmarkResult& rResult) const;
+};
+
+#endif /*MAMMARYBENCHMARKSCENARIO_HPP_*/
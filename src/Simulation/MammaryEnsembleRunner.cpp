@@ -0,0 +1,322 @@
+#include "MammaryEnsembleRunner.hpp"
+#include <algorithm>
+#include <cassert>
+#include <cerrno>
+#include <chrono>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include "Exception.hpp"
+#include "OutputFileHandler.hpp"
+
+extern char** environ;
+
+/**
+ * Running mean and variance of one column of a merged time series (Welford's method).
+ */
+struct MammaryColumnAccumulator
+{
+    /** The number of values. */
+    unsigned mNumValues;
+
+    /** The mean of the values. */
+    double mMean;
+
+    /** The sum of squared deviations from the mean. */
+    double mSumOfSquares;
+
+    /** Constructor. */
+    MammaryColumnAccumulator()
+        : mNumValues(0),
+          mMean(0.0),
+          mSumOfSquares(0.0)
+    {
+    }
+
+    /**
+     * Add a value.
+     *
+     * @param value the value
+     */
+    void Add(double value)
+    {
+        mNumValues++;
+        double delta = value - mMean;
+        mMean += delta/mNumValues;
+        mSumOfSquares += delta*(value - mMean);
+    }
+
+    /**
+     * @return the sample standard deviation of the values (zero for fewer than two values)
+     */
+    double GetStandardDeviation() const
+    {
+        return (mNumValues < 2) ? 0.0 : sqrt(mSumOfSquares/(mNumValues - 1));
+    }
+};
+
+MammaryEnsembleRunner::MammaryEnsembleRunner(const std::string& rScenarioFileName, const std::string& rOutputDirectory, unsigned numReplicates)
+    : mScenarioFileName(rScenarioFileName),
+      mOutputDirectory(rOutputDirectory),
+      mNumReplicates(numReplicates),
+      mNumProcesses(std::max(1l, sysconf(_SC_NPROCESSORS_ONLN))),
+      mFirstSeed(0),
+      mExecutable("/proc/self/exe")
+{
+    // Name the running executable by its path, so that the replicates' command lines can be read
+    char executable[PATH_MAX];
+    ssize_t length = readlink("/proc/self/exe", executable, sizeof(executable) - 1);
+    if (length > 0)
+    {
+        mExecutable = std::string(executable, length);
+    }
+
+    if (numReplicates == 0)
+    {
+        EXCEPTION("An ensemble must have at least one replicate");
+    }
+    if (rOutputDirectory.empty())
+    {
+        EXCEPTION("An ensemble must have an output directory");
+    }
+
+    // Make the scenario file absolute, since it is opened by the replicates
+    if (mScenarioFileName[0] != '/')
+    {
+        char* p_working_directory = getcwd(NULL, 0);
+        if (p_working_directory)
+        {
+            mScenarioFileName = std::string(p_working_directory) + "/" + mScenarioFileName;
+            free(p_working_directory);
+        }
+    }
+}
+
+unsigned MammaryEnsembleRunner::GetNumProcesses() const
+{
+    return mNumProcesses;
+}
+
+void MammaryEnsembleRunner::SetNumProcesses(unsigned numProcesses)
+{
+    assert(numProcesses > 0);
+    mNumProcesses = numProcesses;
+}
+
+void MammaryEnsembleRunner::SetFirstSeed(unsigned firstSeed)
+{
+    mFirstSeed = firstSeed;
+}
+
+void MammaryEnsembleRunner::SetExecutable(const std::string& rExecutable)
+{
+    mExecutable = rExecutable;
+}
+
+unsigned MammaryEnsembleRunner::GetReplicateSeed(unsigned replicate) const
+{
+    return mFirstSeed + replicate;
+}
+
+std::string MammaryEnsembleRunner::GetReplicateDirectory(unsigned replicate)
+{
+    std::stringstream name;
+    name << "replicate_" << std::setfill('0') << std::setw(3) << replicate;
+    return name.str();
+}
+
+int MammaryEnsembleRunner::SpawnReplicate(unsigned replicate) const
+{
+    std::string replicate_directory = mOutputDirectory + "/" + GetReplicateDirectory(replicate);
+    OutputFileHandler output_file_handler(replicate_directory, true);
+    std::string log_file_name = output_file_handler.GetOutputDirectoryFullPath() + "output.log";
+
+    std::stringstream seed;
+    seed << GetReplicateSeed(replicate);
+    std::vector<std::string> arguments;
+    arguments.push_back(mExecutable);
+    arguments.push_back(mScenarioFileName);
+    arguments.push_back("--seed");
+    arguments.push_back(seed.str());
+    arguments.push_back("--output-directory");
+    arguments.push_back(replicate_directory);
+    std::vector<char*> argv;
+    for (unsigned i=0; i<arguments.size(); i++)
+    {
+        argv.push_back(const_cast<char*>(arguments[i].c_str()));
+    }
+    argv.push_back(NULL);
+
+    // Leave out the variables of this process's MPI job, so that each replicate starts its own
+    std::vector<char*> envp;
+    for (char** p_variable = environ; *p_variable != NULL; p_variable++)
+    {
+        if (strncmp(*p_variable, "OMPI_", 5) != 0 && strncmp(*p_variable, "PMIX_", 5) != 0 && strncmp(*p_variable, "PMI_", 4) != 0)
+        {
+            envp.push_back(*p_variable);
+        }
+    }
+    envp.push_back(NULL);
+
+    posix_spawn_file_actions_t file_actions;
+    posix_spawn_file_actions_init(&file_actions);
+    posix_spawn_file_actions_addopen(&file_actions, STDOUT_FILENO, log_file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    posix_spawn_file_actions_adddup2(&file_actions, STDOUT_FILENO, STDERR_FILENO);
+
+    pid_t pid;
+    int error = posix_spawn(&pid, mExecutable.c_str(), &file_actions, NULL, &argv[0], &envp[0]);
+    posix_spawn_file_actions_destroy(&file_actions);
+    if (error != 0)
+    {
+        EXCEPTION("Could not start replicate " << replicate << " with " << mExecutable << ": " << strerror(error));
+    }
+    return pid;
+}
+
+unsigned MammaryEnsembleRunner::Run()
+{
+    // Start from an empty tree, so that no replicate's output is left from an earlier ensemble
+    OutputFileHandler output_file_handler(mOutputDirectory, true);
+
+    mResults.assign(mNumReplicates, MammaryReplicateResult());
+    std::map<pid_t, unsigned> running_replicates;
+    std::vector<std::chrono::steady_clock::time_point> start_times(mNumReplicates);
+    unsigned next_replicate = 0;
+    unsigned num_failures = 0;
+
+    while (next_replicate < mNumReplicates || !running_replicates.empty())
+    {
+        while (next_replicate < mNumReplicates && running_replicates.size() < mNumProcesses)
+        {
+            mResults[next_replicate].mReplicate = next_replicate;
+            mResults[next_replicate].mSeed = GetReplicateSeed(next_replicate);
+            start_times[next_replicate] = std::chrono::steady_clock::now();
+            running_replicates[SpawnReplicate(next_replicate)] = next_replicate;
+            next_replicate++;
+        }
+
+        int status;
+        pid_t pid = waitpid(-1, &status, 0);
+        if (pid < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (pid < 0)
+        {
+            EXCEPTION("Lost track of the replicates of the ensemble: " << strerror(errno));
+        }
+        std::map<pid_t, unsigned>::iterator it = running_replicates.find(pid);
+        if (it == running_replicates.end())
+        {
+            continue;
+        }
+
+        MammaryReplicateResult& r_result = mResults[it->second];
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start_times[it->second];
+        r_result.mWallTime = elapsed.count();
+        r_result.mExitCode = WIFEXITED(status) ? WEXITSTATUS(status) : 128 + WTERMSIG(status);
+        running_replicates.erase(it);
+
+        std::cout << "Replicate " << r_result.mReplicate << " (seed " << r_result.mSeed << ") ";
+        if (r_result.mExitCode == 0)
+        {
+            std::cout << "finished in " << r_result.mWallTime << " s" << std::endl;
+        }
+        else
+        {
+            std::cout << "failed with exit code " << r_result.mExitCode << "; see "
+                      << mOutputDirectory << "/" << GetReplicateDirectory(r_result.mReplicate) << "/output.log" << std::endl;
+            num_failures++;
+        }
+    }
+
+    out_stream p_file = output_file_handler.OpenOutputFile("ensemble.csv");
+    *p_file << "replicate,seed,exit_code,wall_time_s,directory\n";
+    for (unsigned replicate=0; replicate<mNumReplicates; replicate++)
+    {
+        const MammaryReplicateResult& r_result = mResults[replicate];
+        *p_file << r_result.mReplicate << "," << r_result.mSeed << "," << r_result.mExitCode << ","
+                << r_result.mWallTime << "," << GetReplicateDirectory(replicate) << "\n";
+    }
+    p_file->close();
+
+    return num_failures;
+}
+
+const std::vector<MammaryReplicateResult>& MammaryEnsembleRunner::rGetResults() const
+{
+    return mResults;
+}
+
+unsigned MammaryEnsembleRunner::MergeStatistics(const std::string& rFileName) const
+{
+    // Rows are matched by time, since replicates that lose all their cells may stop writing early
+    std::map<double, std::vector<MammaryColumnAccumulator> > rows;
+    unsigned num_merged = 0;
+    for (unsigned replicate=0; replicate<mResults.size(); replicate++)
+    {
+        if (mResults[replicate].mExitCode != 0)
+        {
+            continue;
+        }
+
+        // MammaryScenarioFactory starts each simulation at time zero
+        std::string file_name = OutputFileHandler::GetChasteTestOutputDirectory() + mOutputDirectory + "/"
+                                + GetReplicateDirectory(replicate) + "/results_from_time_0/" + rFileName;
+        std::ifstream file(file_name.c_str());
+        if (!file.is_open())
+        {
+            continue;
+        }
+
+        std::string line;
+        while (std::getline(file, line))
+        {
+            std::istringstream line_stream(line);
+            double time;
+            if (!(line_stream >> time))
+            {
+                continue;
+            }
+            std::vector<MammaryColumnAccumulator>& r_columns = rows[time];
+            double value;
+            for (unsigned column=0; line_stream >> value; column++)
+            {
+                if (column == r_columns.size())
+                {
+                    r_columns.push_back(MammaryColumnAccumulator());
+                }
+                r_columns[column].Add(value);
+            }
+        }
+        num_merged++;
+    }
+
+    if (num_merged > 0)
+    {
+        OutputFileHandler output_file_handler(mOutputDirectory, false);
+        out_stream p_file = output_file_handler.OpenOutputFile("ensemble_" + rFileName);
+        for (std::map<double, std::vector<MammaryColumnAccumulator> >::const_iterator it = rows.begin(); it != rows.end(); ++it)
+        {
+            *p_file << it->first << "\t" << (it->second.empty() ? 0 : it->second[0].mNumValues);
+            for (unsigned column=0; column<it->second.size(); column++)
+            {
+                *p_file << "\t" << it->second[column].mMean << "\t" << it->second[column].GetStandardDeviation();
+            }
+            *p_file << "\n";
+        }
+        p_file->close();
+    }
+    return num_merged;
+}
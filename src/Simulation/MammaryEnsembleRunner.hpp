@@ -0,0 +1,148 @@
+#ifndef MAMMARYENSEMBLERUNNER_HPP_
+#define MAMMARYENSEMBLERUNNER_HPP_
+
+#include <string>
+#include <vector>
+
+/**
+ * The outcome of one replicate of an ensemble.
+ */
+struct MammaryReplicateResult
+{
+    /** The index of the replicate. */
+    unsigned mReplicate;
+
+    /** The seed of the replicate. */
+    unsigned mSeed;
+
+    /** The exit code of the replicate's process (128 plus the signal number if it was killed). */
+    int mExitCode;
+
+    /** The wall-clock time of the replicate, in seconds. */
+    double mWallTime;
+};
+
+/**
+ * Runs replicates of a scenario (see MammaryScenario) with distinct seeds, each in its own
+ * process of MammarySimulationApp, several at a time.
+ *
+ * SimulationTime, RandomNumberGenerator, CellId and the other singletons of a simulation are
+ * global to a process, so replicates cannot share one; a separate process gives each replicate
+ * its own state and keeps a crash in one replicate from stopping the others.
+ *
+ * Replicate i runs with seed FirstSeed + i and writes to OutputDirectory/replicate_iii (see
+ * GetReplicateDirectory()), with its standard output and error in output.log there. Run()
+ * writes ensemble.csv, listing each replicate's seed, exit code and wall-clock time, and
+ * MergeStatistics() merges a time series written by each replicate, such as the
+ * populationstatistics.dat of PopulationStatisticsModifier.
+ *
+ * The ensemble should be run as a single process (not under mpirun), since it spawns one
+ * process per replicate itself.
+ */
+class MammaryEnsembleRunner
+{
+private:
+
+    /** The scenario file. */
+    std::string mScenarioFileName;
+
+    /** The output directory of the ensemble, relative to CHASTE_TEST_OUTPUT. */
+    std::string mOutputDirectory;
+
+    /** The number of replicates. */
+    unsigned mNumReplicates;
+
+    /** The maximum number of replicates run at once. Defaults to the number of processors. */
+    unsigned mNumProcesses;
+
+    /** The seed of the first replicate. Defaults to 0. */
+    unsigned mFirstSeed;
+
+    /** The simulation executable. Defaults to the running executable. */
+    std::string mExecutable;
+
+    /** The outcome of each replicate, filled by Run(). */
+    std::vector<MammaryReplicateResult> mResults;
+
+    /**
+     * Start a replicate.
+     *
+     * @param replicate the index of the replicate
+     * @return the process ID of the replicate
+     */
+    int SpawnReplicate(unsigned replicate) const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rScenarioFileName the scenario file
+     * @param rOutputDirectory the output directory of the ensemble, relative to CHASTE_TEST_OUTPUT
+     * @param numReplicates the number of replicates
+     */
+    MammaryEnsembleRunner(const std::string& rScenarioFileName, const std::string& rOutputDirectory, unsigned numReplicates);
+
+    /**
+     * @return mNumProcesses
+     */
+    unsigned GetNumProcesses() const;
+
+    /**
+     * Set mNumProcesses.
+     *
+     * @param numProcesses the maximum number of replicates run at once
+     */
+    void SetNumProcesses(unsigned numProcesses);
+
+    /**
+     * Set mFirstSeed.
+     *
+     * @param firstSeed the seed of the first replicate
+     */
+    void SetFirstSeed(unsigned firstSeed);
+
+    /**
+     * Set mExecutable.
+     *
+     * @param rExecutable the path of MammarySimulationApp
+     */
+    void SetExecutable(const std::string& rExecutable);
+
+    /**
+     * @param replicate the index of a replicate
+     * @return the seed of the replicate, which is passed to it as --seed
+     */
+    unsigned GetReplicateSeed(unsigned replicate) const;
+
+    /**
+     * @param replicate the index of a replicate
+     * @return the name of the replicate's directory within the ensemble's output directory
+     */
+    static std::string GetReplicateDirectory(unsigned replicate);
+
+    /**
+     * Run the replicates, at most mNumProcesses at a time, and write ensemble.csv.
+     *
+     * @return the number of replicates that failed
+     */
+    unsigned Run();
+
+    /**
+     * @return the outcome of each replicate, in order of replicate
+     */
+    const std::vector<MammaryReplicateResult>& rGetResults() const;
+
+    /**
+     * Merge a tab-separated time series written by each successful replicate in its results
+     * directory into ensemble_<file> in the ensemble's output directory. Each row of the merged
+     * file gives the time, the number of replicates with a row at that time, and the mean and
+     * standard deviation over those replicates of each other column.
+     *
+     * @param rFileName the name of the file (e.g. populationstatistics.dat)
+     * @return the number of replicates whose files were merged
+     */
+    unsigned MergeStatistics(const std::string& rFileName) const;
+};
+
+#endif /*MAMMARYENSEMBLERUNNER_HPP_*/
@@ -0,0 +1,305 @@
+#include "MammaryOffLatticeSimulation.hpp"
+#include "AbstractDivisionTimeProvider.hpp"
+#include "MammaryProfiler.hpp"
+#include "MammaryRandomStreams.hpp"
+#include "NullSrnModel.hpp"
+#include "PerturbationSchedulerModifier.hpp"
+#include "SimulationTime.hpp"
+
+template<unsigned DIM>
+MammaryOffLatticeSimulation<DIM>::MammaryOffLatticeSimulation(AbstractCellPopulation<DIM>& rCellPopulation,
+                                                              bool deleteCellPopulationInDestructor,
+                                                              bool initialiseCells)
+    : OffLatticeSimulation<DIM>(rCellPopulation, deleteCellPopulationInDestructor, initialiseCells),
+      mDivisionQueueInitialised(false),
+      mParentIdHandle(UNSIGNED_UNSET)
+{
+}
+
+template<unsigned DIM>
+void MammaryOffLatticeSimulation<DIM>::SetupSolve()
+{
+    OffLatticeSimulation<DIM>::SetupSolve();
+
+    // Daughters' parents are recorded so that lineages can be followed (e.g. by MeanSquaredDisplacementModifier)
+    mpCellDataColumns = CellDataColumns::Get(this->mrCellPopulation.GetCellPropertyRegistry());
+    mParentIdHandle = mpCellDataColumns->RegisterColumn("parent_id");
+
+    // Build the division queue from scratch (e.g. on the first Solve() or after loading from an archive)
+    mDivisionQueue = std::priority_queue<ScheduledDivision, std::vector<ScheduledDivision>, std::greater<ScheduledDivision> >();
+    mScheduledDivisionTimes.clear();
+    mPolledCells.clear();
+
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = this->mrCellPopulation.Begin();
+         cell_iter != this->mrCellPopulation.End();
+         ++cell_iter)
+    {
+        ScheduleCell(*cell_iter);
+    }
+    mDivisionQueueInitialised = true;
+
+    // Modifiers that change cells' division times must tell the queue
+    for (typename std::vector<boost::shared_ptr<AbstractCellBasedSimulationModifier<DIM, DIM> > >::iterator iter = this->mSimulationModifiers.begin();
+         iter != this->mSimulationModifiers.end();
+         ++iter)
+    {
+        if (PerturbationSchedulerModifier<DIM>* p_perturbations = dynamic_cast<PerturbationSchedulerModifier<DIM>*>(iter->get()))
+        {
+            p_perturbations->SetDivisionScheduler(this);
+        }
+    }
+}
+
+template<unsigned DIM>
+bool MammaryOffLatticeSimulation<DIM>::HasDivisionTime(CellPtr pCell) const
+{
+    return (dynamic_cast<AbstractDivisionTimeProvider*>(pCell->GetCellCycleModel()) != NULL)
+           && (dynamic_cast<NullSrnModel*>(pCell->GetSrnModel()) != NULL);
+}
+
+template<unsigned DIM>
+void MammaryOffLatticeSimulation<DIM>::ScheduleCell(CellPtr pCell)
+{
+    unsigned cell_id = pCell->GetCellId();
+
+    if (HasDivisionTime(pCell))
+    {
+        double division_time = dynamic_cast<AbstractDivisionTimeProvider*>(pCell->GetCellCycleModel())->GetDivisionTime();
+        if (division_time == DBL_MAX)
+        {
+            // This cell will never divide, so there is nothing to schedule
+            mScheduledDivisionTimes.erase(cell_id);
+        }
+        else
+        {
+            mScheduledDivisionTimes[cell_id] = division_time;
+
+            ScheduledDivision entry;
+            entry.mTime = division_time;
+            entry.mCellId = cell_id;
+            entry.mpCell = pCell;
+            mDivisionQueue.push(entry);
+        }
+    }
+    else
+    {
+        mPolledCells.push_back(boost::weak_ptr<Cell>(pCell));
+    }
+}
+
+template<unsigned DIM>
+void MammaryOffLatticeSimulation<DIM>::RescheduleCell(CellPtr pCell)
+{
+    // Before SetupSolve() the queue is built from scratch, and polled cells see any change when next polled
+    if (mDivisionQueueInitialised && HasDivisionTime(pCell))
+    {
+        ScheduleCell(pCell);
+    }
+}
+
+template<unsigned DIM>
+CellPtr MammaryOffLatticeSimulation<DIM>::DivideCell(CellPtr pCell)
+{
+    // Store parent ID and age for output if required
+    unsigned parent_cell_id = pCell->GetCellId();
+    double cell_age = pCell->GetAge();
+
+    CellPtr p_new_cell = pCell->Divide();
+
+    // If required, output this location to file, as in AbstractCellBasedSimulation::DoCellBirth()
+    if (this->mOutputDivisionLocations)
+    {
+        c_vector<double, DIM> cell_location = this->mrCellPopulation.GetLocationOfCellCentre(pCell);
+
+        *(this->mpDivisionLocationFile) << SimulationTime::Instance()->GetTime() << "\t";
+        for (unsigned i=0; i<DIM; i++)
+        {
+            *(this->mpDivisionLocationFile) << cell_location[i] << "\t";
+        }
+        *(this->mpDivisionLocationFile) << "\t" << cell_age << "\t" << parent_cell_id << "\t" << pCell->GetCellId() << "\t" << p_new_cell->GetCellId() << "\n";
+    }
+
+    this->mrCellPopulation.AddCell(p_new_cell, pCell);
+
+    if (mParentIdHandle != UNSIGNED_UNSET)
+    {
+        mpCellDataColumns->SetValue(mParentIdHandle, p_new_cell->GetCellId(), parent_cell_id);
+    }
+
+    return p_new_cell;
+}
+
+template<unsigned DIM>
+unsigned MammaryOffLatticeSimulation<DIM>::DoCellBirth()
+{
+    MAMMARY_PROFILE_SCOPE("step/population_update/division");
+
+    if (this->mNoBirth)
+    {
+        return 0;
+    }
+
+    if (!mDivisionQueueInitialised)
+    {
+        return OffLatticeSimulation<DIM>::DoCellBirth();
+    }
+
+    unsigned num_births_this_step = 0;
+    double current_time = SimulationTime::Instance()->GetTime();
+
+    // Allow for rounding error between birth time + duration and the age comparison in ReadyToDivide()
+    double tolerance = 0.5*SimulationTime::Instance()->GetTimeStep();
+
+    // Cells which are visited this step and must be (re)scheduled once the queue has been drained
+    std::vector<CellPtr> cells_to_schedule;
+    std::vector<ScheduledDivision> deferred_entries;
+
+    while (!mDivisionQueue.empty() && mDivisionQueue.top().mTime <= current_time + tolerance)
+    {
+        ScheduledDivision entry = mDivisionQueue.top();
+        mDivisionQueue.pop();
+
+        // Discard entries that have been superseded, or whose cell has since been removed
+        std::map<unsigned, double>::iterator time_iter = mScheduledDivisionTimes.find(entry.mCellId);
+        if (time_iter == mScheduledDivisionTimes.end() || time_iter->second != entry.mTime)
+        {
+            continue;
+        }
+        CellPtr p_cell = entry.mpCell.lock();
+        if (!p_cell || p_cell->IsDead())
+        {
+            mScheduledDivisionTimes.erase(time_iter);
+            continue;
+        }
+
+        // Revalidate, in case the cell-cycle model has changed its division time since the entry was pushed
+        double division_time = dynamic_cast<AbstractDivisionTimeProvider*>(p_cell->GetCellCycleModel())->GetDivisionTime();
+        if (division_time != entry.mTime)
+        {
+            cells_to_schedule.push_back(p_cell);
+            continue;
+        }
+
+        if (p_cell->GetAge() > 0.0 && p_cell->ReadyToDivide() && this->mrCellPopulation.IsRoomToDivide(p_cell))
+        {
+            CellPtr p_new_cell = DivideCell(p_cell);
+            num_births_this_step++;
+
+            // Both the parent (whose cycle has been reset) and the daughter now have new division times
+            cells_to_schedule.push_back(p_cell);
+            cells_to_schedule.push_back(p_new_cell);
+        }
+        else
+        {
+            // Not yet ready (e.g. apoptotic, or no room to divide), so try again next time step
+            deferred_entries.push_back(entry);
+        }
+    }
+
+    for (unsigned i=0; i<deferred_entries.size(); i++)
+    {
+        mDivisionQueue.push(deferred_entries[i]);
+    }
+
+    // Poll the remaining cells as in AbstractCellBasedSimulation::DoCellBirth(), pruning dead cells as we go
+    unsigned num_polled_cells = mPolledCells.size();
+    unsigned num_live_polled_cells = 0;
+    for (unsigned i=0; i<num_polled_cells; i++)
+    {
+        CellPtr p_cell = mPolledCells[i].lock();
+        if (!p_cell || p_cell->IsDead())
+        {
+            continue;
+        }
+        mPolledCells[num_live_polled_cells] = mPolledCells[i];
+        num_live_polled_cells++;
+
+        if (p_cell->GetAge() > 0.0 && p_cell->ReadyToDivide() && this->mrCellPopulation.IsRoomToDivide(p_cell))
+        {
+            CellPtr p_new_cell = DivideCell(p_cell);
+            num_births_this_step++;
+
+            // The parent remains in the polled cells; only the daughter needs registering
+            cells_to_schedule.push_back(p_new_cell);
+        }
+    }
+    mPolledCells.resize(num_live_polled_cells);
+
+    for (unsigned i=0; i<cells_to_schedule.size(); i++)
+    {
+        ScheduleCell(cells_to_schedule[i]);
+    }
+
+    return num_births_this_step;
+}
+
+template<unsigned DIM>
+unsigned MammaryOffLatticeSimulation<DIM>::DoCellRemoval()
+{
+    MAMMARY_PROFILE_SCOPE("step/population_update/cell_removal");
+    return OffLatticeSimulation<DIM>::DoCellRemoval();
+}
+
+template<unsigned DIM>
+void MammaryOffLatticeSimulation<DIM>::UpdateCellPopulation()
+{
+#ifdef MAMMARY_PROFILING
+    // Each time step of AbstractCellBasedSimulation::Solve() starts by updating the cell population
+    MammaryProfiler::Instance()->NextStep();
+#endif
+    MAMMARY_PROFILE_SCOPE("step/population_update");
+    OffLatticeSimulation<DIM>::UpdateCellPopulation();
+}
+
+template<unsigned DIM>
+void MammaryOffLatticeSimulation<DIM>::UpdateCellLocationsAndTopology()
+{
+    MAMMARY_PROFILE_SCOPE("step/positions");
+    OffLatticeSimulation<DIM>::UpdateCellLocationsAndTopology();
+}
+
+template<unsigned DIM>
+void MammaryOffLatticeSimulation<DIM>::Solve()
+{
+#ifdef MAMMARY_PROFILING
+    MammaryProfiler::Instance()->Reset();
+#endif
+
+    OffLatticeSimulation<DIM>::Solve();
+
+#ifdef MAMMARY_PROFILING
+    MammaryProfiler::Instance()->WriteReport(this->mSimulationOutputDirectory);
+#endif
+}
+
+template<unsigned DIM>
+unsigned MammaryOffLatticeSimulation<DIM>::GetNumScheduledCells() const
+{
+    return mScheduledDivisionTimes.size();
+}
+
+template<unsigned DIM>
+unsigned MammaryOffLatticeSimulation<DIM>::GetNumPolledCells() const
+{
+    return mPolledCells.size();
+}
+
+template<unsigned DIM>
+void MammaryOffLatticeSimulation<DIM>::OutputSimulationParameters(out_stream& rParamsFile)
+{
+    // Record whether random draws and force sums were reproducible (see MammaryRandomStreams)
+    *rParamsFile << "\t\t<Reproducible>" << MammaryRandomStreams::Instance()->IsReproducible() << "</Reproducible>\n";
+    *rParamsFile << "\t\t<RandomStreamSeed>" << MammaryRandomStreams::Instance()->GetSeed() << "</RandomStreamSeed>\n";
+
+    // Call method on direct parent class
+    OffLatticeSimulation<DIM>::OutputSimulationParameters(rParamsFile);
+}
+
+// Explicit instantiation
+template class MammaryOffLatticeSimulation<1>;
+template class MammaryOffLatticeSimulation<2>;
+template class MammaryOffLatticeSimulation<3>;
+
+// Serialization for Boost >= 1.36
+#include "SerializationExportWrapperForCpp.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(MammaryOffLatticeSimulation)
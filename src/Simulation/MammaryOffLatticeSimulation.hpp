@@ -0,0 +1,252 @@
+#ifndef MAMMARYOFFLATTICESIMULATION_HPP_
+#define MAMMARYOFFLATTICESIMULATION_HPP_
+
+#include <map>
+#include <queue>
+#include <vector>
+#include <boost/weak_ptr.hpp>
+
+#include "OffLatticeSimulation.hpp"
+#include "CellDataColumns.hpp"
+
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+/**
+ * An off-lattice simulation with event-driven division scheduling.
+ *
+ * The default AbstractCellBasedSimulation::DoCellBirth() calls ReadyToDivide() on
+ * every cell on every time step. In our organoids most cells are differentiated and
+ * never divide, and stem cells using MammaryCellCycleModel know their division time
+ * as soon as they are born. Here, cells whose cell-cycle model implements
+ * AbstractDivisionTimeProvider are instead registered once in a priority queue keyed
+ * on their division time, and only cells that are due are visited. Cells that never
+ * divide are not registered at all.
+ *
+ * Cells with any other cell-cycle model (e.g. SubstrateDependentCellCycleModel, whose
+ * timing depends on the cell's state), or with a non-trivial SRN model, are polled on
+ * every time step exactly as before.
+ *
+ * Divisions within a time step happen in order of division time, rather than in the
+ * order of the population's cell list.
+ *
+ * When built with MAMMARY_PROFILING, the phases of each time step are timed by
+ * MammaryProfiler, and Solve() writes its report to the output directory.
+ */
+template<unsigned DIM>
+class MammaryOffLatticeSimulation : public OffLatticeSimulation<DIM>
+{
+private:
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Save or restore the simulation. The division queue is not archived, since it
+     * is rebuilt from the cell population in SetupSolve().
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<OffLatticeSimulation<DIM> >(*this);
+    }
+
+    /** An entry in the division queue. */
+    struct ScheduledDivision
+    {
+        /** The time at which the cell is due to divide. */
+        double mTime;
+
+        /** The cell's ID, used to break ties and to detect stale entries. */
+        unsigned mCellId;
+
+        /** The cell, held weakly so that the queue does not keep dead cells alive. */
+        boost::weak_ptr<Cell> mpCell;
+
+        /**
+         * @param rOther another entry
+         * @return whether this entry is due later than rOther
+         */
+        bool operator>(const ScheduledDivision& rOther) const
+        {
+            return (mTime > rOther.mTime) || (mTime == rOther.mTime && mCellId > rOther.mCellId);
+        }
+    };
+
+    /** Min-heap of scheduled divisions. */
+    std::priority_queue<ScheduledDivision, std::vector<ScheduledDivision>, std::greater<ScheduledDivision> > mDivisionQueue;
+
+    /**
+     * The currently valid division time of each scheduled cell, by cell ID. Queue
+     * entries whose time does not match are stale and are discarded when popped.
+     */
+    std::map<unsigned, double> mScheduledDivisionTimes;
+
+    /** Cells whose division is detected by polling ReadyToDivide() on every time step. */
+    std::vector<boost::weak_ptr<Cell> > mPolledCells;
+
+    /** Whether the division queue has been built from the cell population. */
+    bool mDivisionQueueInitialised;
+
+    /** The cell data columns of the cell population, resolved in SetupSolve(). */
+    boost::shared_ptr<CellDataColumns> mpCellDataColumns;
+
+    /** The handle of the "parent_id" column of mpCellDataColumns, in which each daughter's parent is recorded. */
+    unsigned mParentIdHandle;
+
+    /**
+     * @param pCell a cell
+     * @return whether the cell's division is scheduled by its division time, rather than by polling
+     */
+    bool HasDivisionTime(CellPtr pCell) const;
+
+    /**
+     * Divide a cell which is ready to divide, add the daughter to the population,
+     * record its parent's ID and output the division location if required.
+     *
+     * @param pCell the parent cell
+     * @return the daughter cell
+     */
+    CellPtr DivideCell(CellPtr pCell);
+
+protected:
+
+    /**
+     * Overridden SetupSolve() method, which also builds the division queue and registers the
+     * "parent_id" column of the population's CellDataColumns. Any PerturbationSchedulerModifier
+     * is given this simulation as its division scheduler, so that it reschedules the cells it
+     * converts.
+     */
+    virtual void SetupSolve();
+
+    /**
+     * Overridden DoCellBirth() method.
+     *
+     * Visits only those scheduled cells that are due to divide, together with the
+     * polled cells.
+     *
+     * @return the number of births that occurred.
+     */
+    virtual unsigned DoCellBirth();
+
+    /**
+     * Overridden DoCellRemoval() method, which times the cell killers and the removal of dead cells.
+     *
+     * @return the number of deaths that occurred.
+     */
+    virtual unsigned DoCellRemoval();
+
+    /**
+     * Overridden UpdateCellPopulation() method, which starts each time step of MammaryProfiler
+     * and times the update.
+     */
+    virtual void UpdateCellPopulation();
+
+    /**
+     * Overridden UpdateCellLocationsAndTopology() method, which times the forces, the
+     * integration of the node positions and the boundary conditions.
+     */
+    virtual void UpdateCellLocationsAndTopology();
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rCellPopulation Reference to a cell population object
+     * @param deleteCellPopulationInDestructor Whether to delete the cell population on destruction to
+     *     free up memory (defaults to false)
+     * @param initialiseCells Whether to initialise cells (defaults to true, set to false when loading
+     *     from an archive)
+     */
+    MammaryOffLatticeSimulation(AbstractCellPopulation<DIM>& rCellPopulation,
+                                bool deleteCellPopulationInDestructor=false,
+                                bool initialiseCells=true);
+
+    /**
+     * Register a cell with the division scheduler: push it onto the division queue if
+     * its cell-cycle model provides a division time, otherwise add it to the polled
+     * cells. Any existing entry for the cell is superseded.
+     *
+     * This should be called for any cell added to the population other than by
+     * division once the simulation has been set up, and for any cell whose division
+     * time has been changed externally (e.g. by changing its cell-cycle duration).
+     *
+     * @param pCell the cell
+     */
+    void ScheduleCell(CellPtr pCell);
+
+    /**
+     * Tell the division scheduler that a cell's division time may have changed (e.g.
+     * because its type, and so its cell-cycle duration, has been changed by a modifier).
+     * A scheduled cell is rescheduled; a polled cell needs nothing, since it is polled on
+     * every time step.
+     *
+     * @param pCell the cell
+     */
+    void RescheduleCell(CellPtr pCell);
+
+    /**
+     * @return the number of cells currently in the division queue
+     */
+    unsigned GetNumScheduledCells() const;
+
+    /**
+     * @return the number of cells currently polled on every time step
+     */
+    unsigned GetNumPolledCells() const;
+
+    /**
+     * Run the simulation, as in AbstractCellBasedSimulation::Solve(). When built with
+     * MAMMARY_PROFILING, the times of the phases of each time step are then written to
+     * profile.csv and profile.json in the output directory.
+     */
+    void Solve();
+
+    /**
+     * Overridden OutputSimulationParameters() method.
+     *
+     * @param rParamsFile the file stream to which the parameters are output
+     */
+    void OutputSimulationParameters(out_stream& rParamsFile);
+};
+
+#include "SerializationExportWrapper.hpp"
+EXPORT_TEMPLATE_CLASS_SAME_DIMS(MammaryOffLatticeSimulation)
+
+namespace boost
+{
+    namespace serialization
+    {
+        /**
+         * Serialize information required to construct a MammaryOffLatticeSimulation.
+         */
+        template<class Archive, unsigned DIM>
+        inline void save_construct_data(
+            Archive & ar, const MammaryOffLatticeSimulation<DIM> * t, const unsigned int file_version)
+        {
+            // Save data required to construct instance
+            const AbstractCellPopulation<DIM>* p_cell_population = &(t->rGetCellPopulation());
+            ar & p_cell_population;
+        }
+
+        /**
+         * De-serialize constructor parameters and initialise a MammaryOffLatticeSimulation.
+         */
+        template<class Archive, unsigned DIM>
+        inline void load_construct_data(
+            Archive & ar, MammaryOffLatticeSimulation<DIM> * t, const unsigned int file_version)
+        {
+            // Retrieve data from archive required to construct new instance
+            AbstractCellPopulation<DIM>* p_cell_population;
+            ar >> p_cell_population;
+
+            // Invoke inplace constructor to initialise instance, without re-initialising the cells
+            ::new(t)MammaryOffLatticeSimulation<DIM>(*p_cell_population, true, false);
+        }
+    }
+} // namespace ...
+
+#endif /*MAMMARYOFFLATTICESIMULATION_HPP_*/
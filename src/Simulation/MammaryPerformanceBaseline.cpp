@@ -0,0 +1,209 @@
+#include "MammaryPerformanceBaseline.hpp"
+#include <cctype>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <unistd.h>
+#include <boost/filesystem.hpp>
+
+#include "Exception.hpp"
+
+MammaryPerformanceBaseline::MammaryPerformanceBaseline(const FileFinder& rDirectory)
+{
+    // The directory may lie outside the Chaste output folder, so is created without OutputFileHandler
+    mDirectory = rDirectory.GetAbsolutePath();
+    if (mDirectory.empty() || mDirectory[mDirectory.size() - 1] != '/')
+    {
+        mDirectory += "/";
+    }
+    mDirectory += GetMachineName() + "/";
+    try
+    {
+        boost::filesystem::create_directories(mDirectory);
+    }
+    catch (const boost::filesystem::filesystem_error& e)
+    {
+        EXCEPTION("Could not create the performance baseline directory " + mDirectory + ": " + e.what());
+    }
+
+    std::string file_name = mDirectory + "baseline.csv";
+
+    std::ifstream file(file_name.c_str());
+    if (!file.is_open())
+    {
+        return;
+    }
+
+    std::string line;
+    std::getline(file, line);
+    while (std::getline(file, line))
+    {
+        if (line.empty())
+        {
+            continue;
+        }
+        std::istringstream line_stream(line);
+        std::string scenario;
+        char separator;
+        Entry entry;
+        std::getline(line_stream, scenario, ',');
+        line_stream >> entry.mTimePerStep >> separator >> entry.mNumCycleModelAllocations;
+        if (line_stream.fail())
+        {
+            EXCEPTION("Could not read the line \"" + line + "\" of performance baseline " + file_name);
+        }
+        mEntries[scenario] = entry;
+    }
+}
+
+std::string MammaryPerformanceBaseline::GetMachineName()
+{
+    char host_name[256];
+    if (gethostname(host_name, sizeof(host_name)) != 0)
+    {
+        return "unknown";
+    }
+    host_name[sizeof(host_name) - 1] = '\0';
+
+    // Keep the name safe to use as a directory
+    std::string name(host_name);
+    for (unsigned i=0; i<name.size(); i++)
+    {
+        if (!isalnum(name[i]) && name[i] != '-' && name[i] != '.')
+        {
+            name[i] = '_';
+        }
+    }
+    return name.empty() ? "unknown" : name;
+}
+
+std::string MammaryPerformanceBaseline::GetStatusName(MammaryPerformanceStatus status)
+{
+    switch (status)
+    {
+        case NEW_BASELINE:
+            return "new";
+        case WITHIN_TOLERANCE:
+            return "ok";
+        case FASTER_THAN_BASELINE:
+            return "faster";
+        case SLOWER_THAN_BASELINE:
+            return "slower";
+        case MORE_CYCLE_MODEL_ALLOCATIONS_THAN_BASELINE:
+            return "more_cycle_model_allocations";
+        default:
+            NEVER_REACHED;
+    }
+    return "";
+}
+
+const std::string& MammaryPerformanceBaseline::rGetDirectory() const
+{
+    return mDirectory;
+}
+
+bool MammaryPerformanceBaseline::HasBaseline(const std::string& rScenario) const
+{
+    return mEntries.find(rScenario) != mEntries.end();
+}
+
+double MammaryPerformanceBaseline::GetTimePerStep(const std::string& rScenario) const
+{
+    std::map<std::string, Entry>::const_iterator it = mEntries.find(rScenario);
+    if (it == mEntries.end())
+    {
+        EXCEPTION("There is no performance baseline for " + rScenario);
+    }
+    return it->second.mTimePerStep;
+}
+
+unsigned long MammaryPerformanceBaseline::GetNumCycleModelAllocations(const std::string& rScenario) const
+{
+    std::map<std::string, Entry>::const_iterator it = mEntries.find(rScenario);
+    if (it == mEntries.end())
+    {
+        EXCEPTION("There is no performance baseline for " + rScenario);
+    }
+    return it->second.mNumCycleModelAllocations;
+}
+
+void MammaryPerformanceBaseline::SetBaseline(const std::string& rScenario, double timePerStep, unsigned long numCycleModelAllocations)
+{
+    Entry entry;
+    entry.mTimePerStep = timePerStep;
+    entry.mNumCycleModelAllocations = numCycleModelAllocations;
+    mEntries[rScenario] = entry;
+}
+
+MammaryPerformanceStatus MammaryPerformanceBaseline::Compare(const std::string& rScenario,
+                                                             double timePerStep,
+                                                             unsigned long numCycleModelAllocations,
+                                                             double tolerance)
+{
+    MammaryPerformanceStatus status = NEW_BASELINE;
+    double baseline_time = timePerStep;
+    unsigned long baseline_allocations = numCycleModelAllocations;
+
+    if (HasBaseline(rScenario))
+    {
+        baseline_time = GetTimePerStep(rScenario);
+        baseline_allocations = GetNumCycleModelAllocations(rScenario);
+
+        if (numCycleModelAllocations > baseline_allocations)
+        {
+            status = MORE_CYCLE_MODEL_ALLOCATIONS_THAN_BASELINE;
+        }
+        else if (timePerStep > (1.0 + tolerance)*baseline_time)
+        {
+            status = SLOWER_THAN_BASELINE;
+        }
+        else if (timePerStep < (1.0 - tolerance)*baseline_time)
+        {
+            status = FASTER_THAN_BASELINE;
+        }
+        else
+        {
+            status = WITHIN_TOLERANCE;
+        }
+    }
+    else
+    {
+        SetBaseline(rScenario, timePerStep, numCycleModelAllocations);
+    }
+
+    // Append to the history, writing its header if it is new
+    std::string file_name = mDirectory + "history.csv";
+    bool is_new_file = !std::ifstream(file_name.c_str()).good();
+    std::ofstream history(file_name.c_str(), std::ios::out | std::ios::app);
+    if (is_new_file)
+    {
+        history << "date,scenario,time_per_step_s,baseline_time_per_step_s,ratio,cycle_model_allocations,baseline_cycle_model_allocations,status\n";
+    }
+
+    char date[32];
+    std::time_t now = std::time(NULL);
+    std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+    history << date << "," << rScenario << "," << timePerStep << "," << baseline_time << ","
+            << ((baseline_time > 0.0) ? timePerStep/baseline_time : 1.0) << ","
+            << numCycleModelAllocations << "," << baseline_allocations << "," << GetStatusName(status) << "\n";
+
+    return status;
+}
+
+void MammaryPerformanceBaseline::Save() const
+{
+    std::string file_name = mDirectory + "baseline.csv";
+    std::ofstream file(file_name.c_str());
+    if (!file.is_open())
+    {
+        EXCEPTION("Could not write performance baseline " + file_name);
+    }
+    file << std::setprecision(9);
+    file << "scenario,time_per_step_s,cycle_model_allocations\n";
+    for (std::map<std::string, Entry>::const_iterator it = mEntries.begin(); it != mEntries.end(); ++it)
+    {
+        file << it->first << "," << it->second.mTimePerStep << "," << it->second.mNumCycleModelAllocations << "\n";
+    }
+    file.close();
+}
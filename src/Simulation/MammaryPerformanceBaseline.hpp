@@ -0,0 +1,137 @@
+#ifndef MAMMARYPERFORMANCEBASELINE_HPP_
+#define MAMMARYPERFORMANCEBASELINE_HPP_
+
+#include <map>
+#include <string>
+
+#include "FileFinder.hpp"
+
+/**
+ * The outcome of comparing a measurement with its baseline.
+ */
+typedef enum MammaryPerformanceStatus_
+{
+    NEW_BASELINE = 0,
+    WITHIN_TOLERANCE = 1,
+    FASTER_THAN_BASELINE = 2,
+    SLOWER_THAN_BASELINE = 3,
+    MORE_CYCLE_MODEL_ALLOCATIONS_THAN_BASELINE = 4
+} MammaryPerformanceStatus;
+
+/**
+ * Stored performance baselines of benchmark scenarios on one machine, and the history of
+ * the measurements compared with them.
+ *
+ * Timings are only comparable on the machine that made them, so each machine keeps its
+ * own baselines, in baseline.csv in a directory named after its host name within the
+ * given directory. Each line holds a scenario's time per step and the number of
+ * MammaryCellCycleModel objects it allocated (see
+ * MammaryBenchmarkResult::mNumCycleModelAllocations), which is a count of cell-cycle
+ * model constructions rather than of all heap allocations. Every comparison is appended
+ * to history.csv in the same directory, with the time at which it was made, so that
+ * trends can be followed.
+ *
+ * Baselines are only useful if they last, so the directory should be somewhere durable.
+ * The Chaste output folder (CHASTE_TEST_OUTPUT) is often scratch space, such as a
+ * directory in /tmp, that is cleared between sessions.
+ *
+ * A scenario with no baseline takes its first measurement as its baseline. Baselines are
+ * otherwise only changed by SetBaseline(), so that a gradual slowdown is not absorbed.
+ */
+class MammaryPerformanceBaseline
+{
+private:
+
+    /** A stored baseline. */
+    struct Entry
+    {
+        /** The wall-clock time per step, in seconds. */
+        double mTimePerStep;
+
+        /** The number of cell-cycle models allocated. */
+        unsigned long mNumCycleModelAllocations;
+    };
+
+    /** The full path of the directory of this machine's files, with a trailing slash. */
+    std::string mDirectory;
+
+    /** The baselines, by scenario name. */
+    std::map<std::string, Entry> mEntries;
+
+public:
+
+    /**
+     * Constructor, which creates the directory of this machine's files if need be and
+     * loads its baselines, if any.
+     *
+     * @param rDirectory the directory holding a directory per machine
+     */
+    MammaryPerformanceBaseline(const FileFinder& rDirectory);
+
+    /**
+     * @return the name of this machine, as used for its directory
+     */
+    static std::string GetMachineName();
+
+    /**
+     * @param status a status
+     * @return a short description of the status (e.g. "slower")
+     */
+    static std::string GetStatusName(MammaryPerformanceStatus status);
+
+    /**
+     * @return the full path of the directory of this machine's files, with a trailing slash
+     */
+    const std::string& rGetDirectory() const;
+
+    /**
+     * @param rScenario the name of a scenario
+     * @return whether the scenario has a baseline
+     */
+    bool HasBaseline(const std::string& rScenario) const;
+
+    /**
+     * @param rScenario the name of a scenario with a baseline
+     * @return the baseline time per step, in seconds
+     */
+    double GetTimePerStep(const std::string& rScenario) const;
+
+    /**
+     * @param rScenario the name of a scenario with a baseline
+     * @return the baseline number of cell-cycle models allocated
+     */
+    unsigned long GetNumCycleModelAllocations(const std::string& rScenario) const;
+
+    /**
+     * Set the baseline of a scenario, replacing any existing one.
+     *
+     * @param rScenario the name of the scenario
+     * @param timePerStep the time per step, in seconds
+     * @param numCycleModelAllocations the number of cell-cycle models allocated
+     */
+    void SetBaseline(const std::string& rScenario, double timePerStep, unsigned long numCycleModelAllocations);
+
+    /**
+     * Compare a measurement with the scenario's baseline, taking it as the baseline if
+     * there is none, and append it to the history.
+     *
+     * Cell-cycle model allocation counts do not depend on timing, so any increase is a regression.
+     *
+     * @param rScenario the name of the scenario
+     * @param timePerStep the measured time per step, in seconds
+     * @param numCycleModelAllocations the measured number of cell-cycle models allocated
+     * @param tolerance the relative change in time per step that is not reported (e.g. 0.25)
+     * @return the outcome
+     */
+    MammaryPerformanceStatus Compare(const std::string& rScenario,
+                                     double timePerStep,
+                                     unsigned long numCycleModelAllocations,
+                                     double tolerance);
+
+    /**
+     * Write the baselines to baseline.csv.
+     */
+    void Save() const;
+};
+
+#endif /*MAMMARYPERFORMANCEBASELINE_HPP_*/
@@ -0,0 +1,256 @@
+#include "MammaryScenario.hpp"
+#include <cstdlib>
+#include <sstream>
+#include <boost/property_tree/json_parser.hpp>
+#include <boost/property_tree/ptree.hpp>
+
+#include "Exception.hpp"
+
+MammaryScenarioComponent::MammaryScenarioComponent(const std::string& rType)
+    : mType(rType)
+{
+}
+
+const std::string& MammaryScenarioComponent::rGetType() const
+{
+    return mType;
+}
+
+void MammaryScenarioComponent::SetParameter(const std::string& rName, const std::string& rValue)
+{
+    mParameters[rName] = rValue;
+}
+
+bool MammaryScenarioComponent::HasParameter(const std::string& rName) const
+{
+    if (mParameters.find(rName) == mParameters.end())
+    {
+        return false;
+    }
+    mUsedParameters.insert(rName);
+    return true;
+}
+
+const std::string& MammaryScenarioComponent::rGetValue(const std::string& rName) const
+{
+    std::map<std::string, std::string>::const_iterator it = mParameters.find(rName);
+    if (it == mParameters.end())
+    {
+        EXCEPTION("The parameter " + rName + " of " + (mType.empty() ? std::string("the scenario") : mType) + " must be given");
+    }
+    mUsedParameters.insert(rName);
+    return it->second;
+}
+
+double MammaryScenarioComponent::GetDouble(const std::string& rName, double defaultValue) const
+{
+    if (!HasParameter(rName))
+    {
+        return defaultValue;
+    }
+    const std::string& r_value = rGetValue(rName);
+    char* p_end = NULL;
+    double value = strtod(r_value.c_str(), &p_end);
+    if (r_value.empty() || *p_end != '\0')
+    {
+        EXCEPTION("The parameter " + rName + " must be a number, not \"" + r_value + "\"");
+    }
+    return value;
+}
+
+unsigned MammaryScenarioComponent::GetUnsigned(const std::string& rName, unsigned defaultValue) const
+{
+    if (!HasParameter(rName))
+    {
+        return defaultValue;
+    }
+    const std::string& r_value = rGetValue(rName);
+    char* p_end = NULL;
+    unsigned long value = strtoul(r_value.c_str(), &p_end, 10);
+    if (r_value.empty() || r_value[0] == '-' || *p_end != '\0')
+    {
+        EXCEPTION("The parameter " + rName + " must be a non-negative integer, not \"" + r_value + "\"");
+    }
+    return static_cast<unsigned>(value);
+}
+
+bool MammaryScenarioComponent::GetBool(const std::string& rName, bool defaultValue) const
+{
+    if (!HasParameter(rName))
+    {
+        return defaultValue;
+    }
+    const std::string& r_value = rGetValue(rName);
+    if (r_value == "true" || r_value == "1")
+    {
+        return true;
+    }
+    if (r_value != "false" && r_value != "0")
+    {
+        EXCEPTION("The parameter " + rName + " must be true or false, not \"" + r_value + "\"");
+    }
+    return false;
+}
+
+std::string MammaryScenarioComponent::GetString(const std::string& rName, const std::string& rDefaultValue) const
+{
+    if (!HasParameter(rName))
+    {
+        return rDefaultValue;
+    }
+    return rGetValue(rName);
+}
+
+std::vector<double> MammaryScenarioComponent::GetDoubles(const std::string& rName, unsigned size) const
+{
+    std::istringstream stream(rGetValue(rName));
+    std::vector<double> values;
+    double value;
+    while (stream >> value)
+    {
+        values.push_back(value);
+    }
+    if (!stream.eof() || values.size() != size)
+    {
+        EXCEPTION("The parameter " << rName << " must be a list of " << size << " numbers");
+    }
+    return values;
+}
+
+std::vector<std::string> MammaryScenarioComponent::GetStrings(const std::string& rName) const
+{
+    std::vector<std::string> values;
+    if (HasParameter(rName))
+    {
+        std::istringstream stream(rGetValue(rName));
+        std::string value;
+        while (stream >> value)
+        {
+            values.push_back(value);
+        }
+    }
+    return values;
+}
+
+void MammaryScenarioComponent::CheckAllParametersUsed(const std::string& rContext) const
+{
+    std::string unused;
+    for (std::map<std::string, std::string>::const_iterator it = mParameters.begin(); it != mParameters.end(); ++it)
+    {
+        if (mUsedParameters.find(it->first) == mUsedParameters.end())
+        {
+            unused += (unused.empty() ? "" : ", ") + it->first;
+        }
+    }
+    if (!unused.empty())
+    {
+        EXCEPTION("Unknown parameters of " + rContext + ": " + unused);
+    }
+}
+
+/**
+ * Copy the parameters of a JSON object into a component, flattening arrays into
+ * space-separated lists.
+ *
+ * @param rTree the object
+ * @param rComponent the component
+ * @param rContext describes the object in error messages
+ */
+static void ReadParameters(const boost::property_tree::ptree& rTree, MammaryScenarioComponent& rComponent, const std::string& rContext)
+{
+    for (boost::property_tree::ptree::const_iterator it = rTree.begin(); it != rTree.end(); ++it)
+    {
+        if (it->first == "Type")
+        {
+            continue;
+        }
+        if (it->second.empty())
+        {
+            rComponent.SetParameter(it->first, it->second.data());
+            continue;
+        }
+
+        std::string list;
+        for (boost::property_tree::ptree::const_iterator item = it->second.begin(); item != it->second.end(); ++item)
+        {
+            if (!item->first.empty() || !item->second.empty())
+            {
+                EXCEPTION("The parameter " + it->first + " of " + rContext + " must be a value or a list of values");
+            }
+            list += (list.empty() ? "" : " ") + item->second.data();
+        }
+        rComponent.SetParameter(it->first, list);
+    }
+}
+
+MammaryScenario::MammaryScenario(const std::string& rFileName)
+    : mFileName(rFileName)
+{
+    boost::property_tree::ptree tree;
+    try
+    {
+        boost::property_tree::read_json(rFileName, tree);
+    }
+    catch (const boost::property_tree::json_parser_error& e)
+    {
+        EXCEPTION("Could not read scenario file " + rFileName + ": " + e.what());
+    }
+
+    for (boost::property_tree::ptree::const_iterator it = tree.begin(); it != tree.end(); ++it)
+    {
+        if (it->first == "Simulation")
+        {
+            ReadParameters(it->second, mSimulation, "the simulation");
+        }
+        else if (it->first == "Population")
+        {
+            ReadParameters(it->second, mPopulation, "the population");
+        }
+        else if (it->first == "Forces" || it->first == "Killers" || it->first == "Modifiers" || it->first == "Writers")
+        {
+            std::vector<MammaryScenarioComponent>& r_list = mLists[it->first];
+            for (boost::property_tree::ptree::const_iterator entry = it->second.begin(); entry != it->second.end(); ++entry)
+            {
+                std::string type = entry->second.get<std::string>("Type", "");
+                if (type.empty())
+                {
+                    EXCEPTION("Each entry of " + it->first + " in " + rFileName + " must have a Type");
+                }
+                MammaryScenarioComponent component(type);
+                ReadParameters(entry->second, component, type);
+                r_list.push_back(component);
+            }
+        }
+        else
+        {
+            EXCEPTION("Unknown section " + it->first + " in scenario file " + rFileName);
+        }
+    }
+}
+
+const std::string& MammaryScenario::rGetFileName() const
+{
+    return mFileName;
+}
+
+MammaryScenarioComponent& MammaryScenario::rGetSimulation()
+{
+    return mSimulation;
+}
+
+const MammaryScenarioComponent& MammaryScenario::rGetSimulation() const
+{
+    return mSimulation;
+}
+
+const MammaryScenarioComponent& MammaryScenario::rGetPopulation() const
+{
+    return mPopulation;
+}
+
+const std::vector<MammaryScenarioComponent>& MammaryScenario::rGetList(const std::string& rListName) const
+{
+    static const std::vector<MammaryScenarioComponent> empty_list;
+    std::map<std::string, std::vector<MammaryScenarioComponent> >::const_iterator it = mLists.find(rListName);
+    return (it == mLists.end()) ? empty_list : it->second;
+}
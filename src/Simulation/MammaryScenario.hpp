@@ -0,0 +1,183 @@
+#ifndef MAMMARYSCENARIO_HPP_
+#define MAMMARYSCENARIO_HPP_
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+/**
+ * One entry of a scenario file: its type (e.g. "LinearSpringForce") and its parameters,
+ * named as in the simulation's parameter output (e.g. "CellCellSpringStiffness").
+ *
+ * Values are held as text and converted when read. The parameters that have been read are
+ * recorded, so that CheckAllParametersUsed() can reject misspelt or unsupported parameters
+ * rather than silently ignoring them.
+ */
+class MammaryScenarioComponent
+{
+private:
+
+    /** The type of the component. */
+    std::string mType;
+
+    /** The parameters, by name. Lists are held with their values separated by spaces. */
+    std::map<std::string, std::string> mParameters;
+
+    /** The names of the parameters that have been read. */
+    mutable std::set<std::string> mUsedParameters;
+
+    /**
+     * @param rName the name of a parameter
+     * @return the value of the parameter, which must exist
+     */
+    const std::string& rGetValue(const std::string& rName) const;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rType the type of the component (may be empty, e.g. for the simulation section)
+     */
+    MammaryScenarioComponent(const std::string& rType="");
+
+    /**
+     * @return mType
+     */
+    const std::string& rGetType() const;
+
+    /**
+     * Set a parameter, replacing any existing value.
+     *
+     * @param rName the name of the parameter
+     * @param rValue its value
+     */
+    void SetParameter(const std::string& rName, const std::string& rValue);
+
+    /**
+     * @param rName the name of a parameter
+     * @return whether the parameter is given (which counts as reading it)
+     */
+    bool HasParameter(const std::string& rName) const;
+
+    /**
+     * @param rName the name of a parameter
+     * @param defaultValue the value if the parameter is not given
+     * @return the value of the parameter
+     */
+    double GetDouble(const std::string& rName, double defaultValue) const;
+
+    /**
+     * @param rName the name of a parameter
+     * @param defaultValue the value if the parameter is not given
+     * @return the value of the parameter
+     */
+    unsigned GetUnsigned(const std::string& rName, unsigned defaultValue) const;
+
+    /**
+     * @param rName the name of a parameter
+     * @param defaultValue the value if the parameter is not given
+     * @return the value of the parameter, given as true/false or 1/0
+     */
+    bool GetBool(const std::string& rName, bool defaultValue) const;
+
+    /**
+     * @param rName the name of a parameter
+     * @param rDefaultValue the value if the parameter is not given
+     * @return the value of the parameter
+     */
+    std::string GetString(const std::string& rName, const std::string& rDefaultValue) const;
+
+    /**
+     * @param rName the name of a parameter, which must be given
+     * @param size the number of values required
+     * @return the values of the parameter, given as a list
+     */
+    std::vector<double> GetDoubles(const std::string& rName, unsigned size) const;
+
+    /**
+     * @param rName the name of a parameter
+     * @return the values of the parameter, given as a list (empty if not given)
+     */
+    std::vector<std::string> GetStrings(const std::string& rName) const;
+
+    /**
+     * Throw an exception naming any parameters that have not been read.
+     *
+     * @param rContext describes the component in the message (e.g. "force LinearSpringForce")
+     */
+    void CheckAllParametersUsed(const std::string& rContext) const;
+};
+
+/**
+ * A scenario for MammarySimulationApp, read from a JSON file of the form
+ *
+ * {
+ *   "Simulation": { "Dimension": 3, "Dt": 0.005, "EndTime": 120, "SamplingTimestepMultiple": 200,
+ *                   "OutputDirectory": "Organoid", "Seed": 0 },
+ *   "Population": { "Geometry": "organoid", "NumCells": 500, "StemCellFraction": 0.1 },
+ *   "Forces":    [ { "Type": "LinearSpringForce", "CutOffLength": 1.5 }, { "Type": "RandomMotionForce" } ],
+ *   "Killers":   [ { "Type": "AnoikisCellKiller", "ProbabilityOfDeathInAnHour": 0.1 } ],
+ *   "Modifiers": [ { "Type": "PopulationStatisticsModifier", "OutputTimestepMultiple": 20 } ],
+ *   "Writers":   [ { "Type": "CellLocationWriter" }, { "Type": "MammaryCellTypeWriter" } ]
+ * }
+ *
+ * where each list is optional. The simulation and population sections are read by
+ * MammaryScenarioFactory, and each entry of a list is built by the factory's creator for
+ * its type. Numbers, booleans and strings may be given with or without quotes, and lists
+ * as JSON arrays.
+ */
+class MammaryScenario
+{
+private:
+
+    /** The file from which the scenario was read. */
+    std::string mFileName;
+
+    /** The simulation section. */
+    MammaryScenarioComponent mSimulation;
+
+    /** The population section. */
+    MammaryScenarioComponent mPopulation;
+
+    /** The entries of each list, by list name (e.g. "Forces"). */
+    std::map<std::string, std::vector<MammaryScenarioComponent> > mLists;
+
+public:
+
+    /**
+     * Constructor, which reads the file.
+     *
+     * @param rFileName the scenario file
+     */
+    MammaryScenario(const std::string& rFileName);
+
+    /**
+     * @return mFileName
+     */
+    const std::string& rGetFileName() const;
+
+    /**
+     * @return the simulation section, e.g. to override its parameters
+     */
+    MammaryScenarioComponent& rGetSimulation();
+
+    /**
+     * @return the simulation section
+     */
+    const MammaryScenarioComponent& rGetSimulation() const;
+
+    /**
+     * @return the population section
+     */
+    const MammaryScenarioComponent& rGetPopulation() const;
+
+    /**
+     * @param rListName the name of a list (e.g. "Forces")
+     * @return the entries of the list, in the order given (empty if the list is not given)
+     */
+    const std::vector<MammaryScenarioComponent>& rGetList(const std::string& rListName) const;
+};
+
+#endif /*MAMMARYSCENARIO_HPP_*/
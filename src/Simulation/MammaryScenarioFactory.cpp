@@ -0,0 +1,817 @@
+#include "MammaryScenarioFactory.hpp"
+
+#include "CellId.hpp"
+#include "Exception.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "SimulationTime.hpp"
+#include "SmartPointers.hpp"
+
+#include "MammaryBenchmarkScenario.hpp"
+#include "CounterBasedRandomNumberGenerator.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "MammaryRandomStreams.hpp"
+#include "OrientedDivisionRule.hpp"
+
+#include "CellCellAdhesionForce.hpp"
+#include "CellCoverslipAdhesionForce.hpp"
+#include "CellECMAdhesionForce.hpp"
+#include "CellParticleAdhesionForce.hpp"
+#include "DifferentialAdhesionLinearSpringForce.hpp"
+#include "Force.hpp"
+#include "GeneralisedLinearSpringForce.hpp"
+#include "LinearSpringForce.hpp"
+#include "RandomMotionForce.hpp"
+
+#include "AnoikisCellKiller.hpp"
+#include "AnoikisCellKiller3D.hpp"
+
+#include "AdaptiveOutputModifier.hpp"
+#include "AsynchronousOutputModifier.hpp"
+#include "CellHeightTrackingModifier.hpp"
+#include "CellTrajectoryStoreModifier.hpp"
+#include "IntegrinExpressionModifier.hpp"
+#include "MeanSquaredDisplacementModifier.hpp"
+#include "MemoryFootprintModifier.hpp"
+#include "PopulationStatisticsModifier.hpp"
+
+#include "BinarySnapshotFormat.hpp"
+#include "BoundaryLengthWriter.hpp"
+#include "CellIdWriter.hpp"
+#include "CellLocationWriter.hpp"
+#include "CellPopulationAdjacencyWriter.hpp"
+#include "CellTypeSnapshotFormat.hpp"
+#include "CellVelocityWriter.hpp"
+#include "LocationSnapshotFormat.hpp"
+#include "MammaryCellTypeWriter.hpp"
+#include "MammaryCompositeWriter.hpp"
+#include "MammarySnapshotWriter.hpp"
+#include "VelocitySnapshotFormat.hpp"
+
+/**
+ * @param rComponent an entry of a scenario
+ * @param rName the name of a parameter, which must be given
+ * @return the value of the parameter
+ */
+static double GetRequiredDouble(const MammaryScenarioComponent& rComponent, const std::string& rName)
+{
+    if (!rComponent.HasParameter(rName))
+    {
+        EXCEPTION("The parameter " + rName + " of " + rComponent.rGetType() + " must be given");
+    }
+    return rComponent.GetDouble(rName, 0.0);
+}
+
+/**
+ * @param rComponent an entry of a scenario
+ * @return the compression given by its Compression parameter (none, gzip or zstd)
+ */
+static CompressionType GetCompressionType(const MammaryScenarioComponent& rComponent)
+{
+    std::string name = rComponent.GetString("Compression", "none");
+    if (name == "gzip")
+    {
+        return GZIP_COMPRESSION;
+    }
+    if (name == "zstd")
+    {
+        return ZSTD_COMPRESSION;
+    }
+    if (name != "none")
+    {
+        EXCEPTION("Unknown compression " + name + " of " + rComponent.rGetType() + "; use none, gzip or zstd");
+    }
+    return NO_COMPRESSION;
+}
+
+/**
+ * Set the compression of a writer from the Compression and CompressionLevel parameters of its entry.
+ *
+ * @param rComponent the entry of the writer
+ * @param rWriter the writer
+ */
+template<class WRITER>
+static void SetCompression(const MammaryScenarioComponent& rComponent, WRITER& rWriter)
+{
+    CompressionType type = GetCompressionType(rComponent);
+    rWriter.SetCompression(type, static_cast<int>(rComponent.GetUnsigned("CompressionLevel", 0)));
+}
+
+/**
+ * @param rComponent the entry of a modifier or writer
+ * @return the snapshot formats given by its Formats parameter (location, velocity, cell_type or binary)
+ */
+template<unsigned DIM>
+static std::vector<boost::shared_ptr<AbstractSnapshotFormat<DIM> > > CreateSnapshotFormats(const MammaryScenarioComponent& rComponent)
+{
+    std::vector<boost::shared_ptr<AbstractSnapshotFormat<DIM> > > formats;
+    std::vector<std::string> names = rComponent.GetStrings("Formats");
+    for (unsigned i=0; i<names.size(); i++)
+    {
+        if (names[i] == "location")
+        {
+            formats.push_back(boost::shared_ptr<AbstractSnapshotFormat<DIM> >(new LocationSnapshotFormat<DIM>()));
+        }
+        else if (names[i] == "velocity")
+        {
+            formats.push_back(boost::shared_ptr<AbstractSnapshotFormat<DIM> >(new VelocitySnapshotFormat<DIM>()));
+        }
+        else if (names[i] == "cell_type")
+        {
+            formats.push_back(boost::shared_ptr<AbstractSnapshotFormat<DIM> >(new CellTypeSnapshotFormat<DIM>()));
+        }
+        else if (names[i] == "binary")
+        {
+            formats.push_back(boost::shared_ptr<AbstractSnapshotFormat<DIM> >(new BinarySnapshotFormat<DIM>()));
+        }
+        else
+        {
+            EXCEPTION("Unknown snapshot format " + names[i] + " of " + rComponent.rGetType()
+                      + "; use location, velocity, cell_type or binary");
+        }
+    }
+    return formats;
+}
+
+/**
+ * Set the parameters that a force shares with GeneralisedLinearSpringForce.
+ *
+ * @param rComponent the entry of the force
+ * @param rForce the force
+ */
+template<unsigned DIM>
+static void SetGeneralisedLinearSpringForceParameters(const MammaryScenarioComponent& rComponent,
+                                                      GeneralisedLinearSpringForce<DIM>& rForce)
+{
+    if (rComponent.HasParameter("CutOffLength"))
+    {
+        rForce.SetCutOffLength(rComponent.GetDouble("CutOffLength", 0.0));
+    }
+    if (rComponent.HasParameter("MeinekeSpringStiffness"))
+    {
+        rForce.SetMeinekeSpringStiffness(rComponent.GetDouble("MeinekeSpringStiffness", 0.0));
+    }
+    if (rComponent.HasParameter("MeinekeDivisionRestingSpringLength"))
+    {
+        rForce.SetMeinekeDivisionRestingSpringLength(rComponent.GetDouble("MeinekeDivisionRestingSpringLength", 0.0));
+    }
+    if (rComponent.HasParameter("MeinekeSpringGrowthDuration"))
+    {
+        rForce.SetMeinekeSpringGrowthDuration(rComponent.GetDouble("MeinekeSpringGrowthDuration", 0.0));
+    }
+}
+
+/**
+ * Set the multipliers of a differential adhesion force.
+ *
+ * @param rComponent the entry of the force
+ * @param rForce the force
+ */
+template<class FORCE>
+static void SetAdhesionMultipliers(const MammaryScenarioComponent& rComponent, FORCE& rForce)
+{
+    if (rComponent.HasParameter("HomotypicLabelledSpringConstantMultiplier"))
+    {
+        rForce.SetHomotypicLabelledSpringConstantMultiplier(rComponent.GetDouble("HomotypicLabelledSpringConstantMultiplier", 0.0));
+    }
+    if (rComponent.HasParameter("HeterotypicSpringConstantMultiplier"))
+    {
+        rForce.SetHeterotypicSpringConstantMultiplier(rComponent.GetDouble("HeterotypicSpringConstantMultiplier", 0.0));
+    }
+}
+
+template<unsigned DIM>
+static void CreateGeneralisedLinearSpringForce(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(GeneralisedLinearSpringForce<DIM>, p_force);
+    SetGeneralisedLinearSpringForceParameters(rComponent, *p_force);
+    rComponent.CheckAllParametersUsed("force " + rComponent.rGetType());
+    rSimulator.AddForce(p_force);
+}
+
+template<unsigned DIM>
+static void CreateLinearSpringForce(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(LinearSpringForce<DIM>, p_force);
+    if (rComponent.HasParameter("CutOffLength"))
+    {
+        p_force->SetCutOffLength(rComponent.GetDouble("CutOffLength", 0.0));
+    }
+    if (rComponent.HasParameter("CellCellSpringStiffness"))
+    {
+        p_force->SetCellCellSpringStiffness(rComponent.GetDouble("CellCellSpringStiffness", 0.0));
+    }
+    if (rComponent.HasParameter("CellECMSpringStiffness"))
+    {
+        p_force->SetCellECMSpringStiffness(rComponent.GetDouble("CellECMSpringStiffness", 0.0));
+    }
+    if (rComponent.HasParameter("ECMECMSpringStiffness"))
+    {
+        p_force->SetECMECMSpringStiffness(rComponent.GetDouble("ECMECMSpringStiffness", 0.0));
+    }
+    if (rComponent.HasParameter("MeinekeDivisionRestingSpringLength"))
+    {
+        p_force->SetMeinekeDivisionRestingSpringLength(rComponent.GetDouble("MeinekeDivisionRestingSpringLength", 0.0));
+    }
+    if (rComponent.HasParameter("MeinekeSpringGrowthDuration"))
+    {
+        p_force->SetMeinekeSpringGrowthDuration(rComponent.GetDouble("MeinekeSpringGrowthDuration", 0.0));
+    }
+    if (rComponent.HasParameter("HomotypicSpringConstantMultiplier"))
+    {
+        p_force->SetHomotypicSpringConstantMultiplier(rComponent.GetDouble("HomotypicSpringConstantMultiplier", 0.0));
+    }
+    if (rComponent.HasParameter("HeterotypicSpringConstantMultiplier"))
+    {
+        p_force->SetHeterotypicSpringConstantMultiplier(rComponent.GetDouble("HeterotypicSpringConstantMultiplier", 0.0));
+    }
+    rComponent.CheckAllParametersUsed("force " + rComponent.rGetType());
+    rSimulator.AddForce(p_force);
+}
+
+template<unsigned DIM>
+static void CreateDifferentialAdhesionLinearSpringForce(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(DifferentialAdhesionLinearSpringForce<DIM>, p_force);
+    SetGeneralisedLinearSpringForceParameters(rComponent, *p_force);
+    SetAdhesionMultipliers(rComponent, *p_force);
+    rComponent.CheckAllParametersUsed("force " + rComponent.rGetType());
+    rSimulator.AddForce(p_force);
+}
+
+template<unsigned DIM>
+static void CreateCellCellAdhesionForce(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(CellCellAdhesionForce<DIM>, p_force);
+    SetGeneralisedLinearSpringForceParameters(rComponent, *p_force);
+    SetAdhesionMultipliers(rComponent, *p_force);
+    rComponent.CheckAllParametersUsed("force " + rComponent.rGetType());
+    rSimulator.AddForce(p_force);
+}
+
+template<unsigned DIM>
+static void CreateCellParticleAdhesionForce(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(CellParticleAdhesionForce<DIM>, p_force);
+    SetGeneralisedLinearSpringForceParameters(rComponent, *p_force);
+    SetAdhesionMultipliers(rComponent, *p_force);
+    rComponent.CheckAllParametersUsed("force " + rComponent.rGetType());
+    rSimulator.AddForce(p_force);
+}
+
+template<unsigned DIM>
+static void CreateCellECMAdhesionForce(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(CellECMAdhesionForce<DIM>, p_force);
+    if (rComponent.HasParameter("Stiffness"))
+    {
+        p_force->SetStiffness(rComponent.GetDouble("Stiffness", 0.0));
+    }
+    rComponent.CheckAllParametersUsed("force " + rComponent.rGetType());
+    rSimulator.AddForce(p_force);
+}
+
+template<unsigned DIM>
+static void CreateCellCoverslipAdhesionForce(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(CellCoverslipAdhesionForce<DIM>, p_force);
+    if (rComponent.HasParameter("Stiffness"))
+    {
+        p_force->SetStiffness(rComponent.GetDouble("Stiffness", 0.0));
+    }
+    if (rComponent.HasParameter("EquilibriumLength"))
+    {
+        p_force->SetEquilibriumLength(rComponent.GetDouble("EquilibriumLength", 0.0));
+    }
+    rComponent.CheckAllParametersUsed("force " + rComponent.rGetType());
+    rSimulator.AddForce(p_force);
+}
+
+template<unsigned DIM>
+static void CreateRandomMotionForce(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(RandomMotionForce<DIM>, p_force);
+    if (rComponent.HasParameter("MovementParameter"))
+    {
+        p_force->SetMovementParameter(rComponent.GetDouble("MovementParameter", 0.0));
+    }
+    rComponent.CheckAllParametersUsed("force " + rComponent.rGetType());
+    rSimulator.AddForce(p_force);
+}
+
+template<unsigned DIM>
+static void CreateForce(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(Force<DIM>, p_force);
+    if (rComponent.HasParameter("Stiffness"))
+    {
+        p_force->SetStiffness(rComponent.GetDouble("Stiffness", 0.0));
+    }
+    rComponent.CheckAllParametersUsed("force " + rComponent.rGetType());
+    rSimulator.AddForce(p_force);
+}
+
+template<unsigned DIM>
+static void CreateAnoikisCellKiller(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    double probability = GetRequiredDouble(rComponent, "ProbabilityOfDeathInAnHour");
+    MAKE_PTR_ARGS(AnoikisCellKiller<DIM>, p_killer, (&rSimulator.rGetCellPopulation(), probability));
+    if (rComponent.HasParameter("DetachmentHeight"))
+    {
+        p_killer->SetDetachmentHeight(rComponent.GetDouble("DetachmentHeight", 0.0));
+    }
+
+    /*
+     * Mix the killer's own Seed into the simulation's, which Run() has given to
+     * MammaryRandomStreams, so that each simulation seed gives a different stream of deaths.
+     */
+    uint64_t simulation_seed = MammaryRandomStreams::Instance()->GetSeed();
+    uint64_t killer_seed = rComponent.GetUnsigned("Seed", 0);
+    p_killer->SetSeed((unsigned)(CounterBasedRandomNumberGenerator::Hash(simulation_seed, killer_seed, 0) >> 32));
+    rComponent.CheckAllParametersUsed("killer " + rComponent.rGetType());
+    rSimulator.AddCellKiller(p_killer);
+}
+
+/**
+ * Creator of AnoikisCellKiller3D, which exists only in 3D.
+ *
+ * @param rComponent the entry of the killer
+ * @param rSimulator the simulation
+ */
+static void CreateAnoikisCellKiller3D(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<3>& rSimulator)
+{
+    std::vector<double> centre_values = rComponent.GetDoubles("Centre", 3);
+    c_vector<double, 3> centre;
+    for (unsigned d=0; d<3; d++)
+    {
+        centre[d] = centre_values[d];
+    }
+    double radius = GetRequiredDouble(rComponent, "Radius");
+    MAKE_PTR_ARGS(AnoikisCellKiller3D, p_killer, (&rSimulator.rGetCellPopulation(), centre, radius));
+    if (rComponent.HasParameter("UseDynamicLumen"))
+    {
+        p_killer->SetUseDynamicLumen(rComponent.GetBool("UseDynamicLumen", false));
+    }
+    if (rComponent.HasParameter("LumenUpdateInterval"))
+    {
+        p_killer->SetLumenUpdateInterval(rComponent.GetDouble("LumenUpdateInterval", 0.0));
+    }
+    if (rComponent.HasParameter("LumenPercentile"))
+    {
+        p_killer->SetLumenPercentile(rComponent.GetDouble("LumenPercentile", 0.0));
+    }
+    if (rComponent.HasParameter("LumenRadiusOffset"))
+    {
+        p_killer->SetLumenRadiusOffset(rComponent.GetDouble("LumenRadiusOffset", 0.0));
+    }
+    rComponent.CheckAllParametersUsed("killer " + rComponent.rGetType());
+    rSimulator.AddCellKiller(p_killer);
+}
+
+template<unsigned DIM>
+static void CreatePopulationStatisticsModifier(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(PopulationStatisticsModifier<DIM>, p_modifier);
+    if (rComponent.HasParameter("OutputTimestepMultiple"))
+    {
+        p_modifier->SetOutputTimestepMultiple(rComponent.GetUnsigned("OutputTimestepMultiple", 1));
+    }
+    if (rComponent.HasParameter("NumThreads"))
+    {
+        p_modifier->rGetCalculator().SetNumThreads(rComponent.GetUnsigned("NumThreads", 1));
+    }
+    if (rComponent.HasParameter("MinCellsPerThread"))
+    {
+        p_modifier->rGetCalculator().SetMinCellsPerThread(rComponent.GetUnsigned("MinCellsPerThread", 1));
+    }
+    if (rComponent.HasParameter("RadiusPercentile"))
+    {
+        p_modifier->rGetCalculator().SetRadiusPercentile(rComponent.GetDouble("RadiusPercentile", 0.0));
+    }
+    if (rComponent.HasParameter("ShellPercentile"))
+    {
+        p_modifier->rGetCalculator().SetShellPercentile(rComponent.GetDouble("ShellPercentile", 0.0));
+    }
+    rComponent.CheckAllParametersUsed("modifier " + rComponent.rGetType());
+    rSimulator.AddSimulationModifier(p_modifier);
+}
+
+template<unsigned DIM>
+static void CreateMemoryFootprintModifier(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(MemoryFootprintModifier<DIM>, p_modifier);
+    if (rComponent.HasParameter("OutputTimestepMultiple"))
+    {
+        p_modifier->SetOutputTimestepMultiple(rComponent.GetUnsigned("OutputTimestepMultiple", 1));
+    }
+    rComponent.CheckAllParametersUsed("modifier " + rComponent.rGetType());
+    rSimulator.AddSimulationModifier(p_modifier);
+}
+
+template<unsigned DIM>
+static void CreateCellHeightTrackingModifier(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(CellHeightTrackingModifier<DIM>, p_modifier);
+    rComponent.CheckAllParametersUsed("modifier " + rComponent.rGetType());
+    rSimulator.AddSimulationModifier(p_modifier);
+}
+
+template<unsigned DIM>
+static void CreateIntegrinExpressionModifier(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(IntegrinExpressionModifier<DIM>, p_modifier);
+    if (rComponent.HasParameter("IntegrinExpressionModificationTime"))
+    {
+        p_modifier->SetIntegrinExpressionModificationTime(rComponent.GetDouble("IntegrinExpressionModificationTime", 0.0));
+    }
+    if (rComponent.HasParameter("LuminalCellsAffected"))
+    {
+        p_modifier->SetLuminalCellsAffected(rComponent.GetBool("LuminalCellsAffected", false));
+    }
+    if (rComponent.HasParameter("MyoepithelialCellsAffected"))
+    {
+        p_modifier->SetMyoepithelialCellsAffected(rComponent.GetBool("MyoepithelialCellsAffected", false));
+    }
+    if (rComponent.HasParameter("B1GainOfFunction"))
+    {
+        p_modifier->SetB1GainOfFunction(rComponent.GetBool("B1GainOfFunction", false));
+    }
+    if (rComponent.HasParameter("B1LossOfFunction"))
+    {
+        p_modifier->SetB1LossOfFunction(rComponent.GetBool("B1LossOfFunction", false));
+    }
+    if (rComponent.HasParameter("B4GainOfFunction"))
+    {
+        p_modifier->SetB4GainOfFunction(rComponent.GetBool("B4GainOfFunction", false));
+    }
+    if (rComponent.HasParameter("B4LossOfFunction"))
+    {
+        p_modifier->SetB4LossOfFunction(rComponent.GetBool("B4LossOfFunction", false));
+    }
+    rComponent.CheckAllParametersUsed("modifier " + rComponent.rGetType());
+    rSimulator.AddSimulationModifier(p_modifier);
+}
+
+template<unsigned DIM>
+static void CreateMeanSquaredDisplacementModifier(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(MeanSquaredDisplacementModifier<DIM>, p_modifier);
+    if (rComponent.HasParameter("SamplingTimestepMultiple"))
+    {
+        p_modifier->SetSamplingTimestepMultiple(rComponent.GetUnsigned("SamplingTimestepMultiple", 1));
+    }
+    p_modifier->SetCorrelatorShape(rComponent.GetUnsigned("NumPointsPerLevel", p_modifier->GetNumPointsPerLevel()),
+                                   rComponent.GetUnsigned("AveragingFactor", p_modifier->GetAveragingFactor()),
+                                   rComponent.GetUnsigned("NumLevels", p_modifier->GetNumLevels()));
+    if (rComponent.HasParameter("DaughtersInheritHistory"))
+    {
+        p_modifier->SetDaughtersInheritHistory(rComponent.GetBool("DaughtersInheritHistory", false));
+    }
+    rComponent.CheckAllParametersUsed("modifier " + rComponent.rGetType());
+    rSimulator.AddSimulationModifier(p_modifier);
+}
+
+template<unsigned DIM>
+static void CreateCellTrajectoryStoreModifier(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(CellTrajectoryStoreModifier<DIM>, p_modifier);
+    if (rComponent.HasParameter("SamplingTimestepMultiple"))
+    {
+        p_modifier->SetSamplingTimestepMultiple(rComponent.GetUnsigned("SamplingTimestepMultiple", 1));
+    }
+    if (rComponent.HasParameter("ChunkSize"))
+    {
+        p_modifier->SetChunkSize(rComponent.GetUnsigned("ChunkSize", 1));
+    }
+    rComponent.CheckAllParametersUsed("modifier " + rComponent.rGetType());
+    rSimulator.AddSimulationModifier(p_modifier);
+}
+
+template<unsigned DIM>
+static void CreateAsynchronousOutputModifier(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(AsynchronousOutputModifier<DIM>, p_modifier);
+    if (rComponent.HasParameter("OutputTimestepMultiple"))
+    {
+        p_modifier->SetOutputTimestepMultiple(rComponent.GetUnsigned("OutputTimestepMultiple", 1));
+    }
+    if (rComponent.HasParameter("MaxQueuedSnapshots"))
+    {
+        p_modifier->SetMaxQueuedSnapshots(rComponent.GetUnsigned("MaxQueuedSnapshots", 1));
+    }
+    std::vector<boost::shared_ptr<AbstractSnapshotFormat<DIM> > > formats = CreateSnapshotFormats<DIM>(rComponent);
+    for (unsigned i=0; i<formats.size(); i++)
+    {
+        p_modifier->AddSnapshotFormat(formats[i]);
+    }
+    rComponent.CheckAllParametersUsed("modifier " + rComponent.rGetType());
+    rSimulator.AddSimulationModifier(p_modifier);
+}
+
+template<unsigned DIM>
+static void CreateAdaptiveOutputModifier(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    MAKE_PTR(AdaptiveOutputModifier<DIM>, p_modifier);
+    if (rComponent.HasParameter("CellCountChangeThreshold"))
+    {
+        p_modifier->SetCellCountChangeThreshold(rComponent.GetUnsigned("CellCountChangeThreshold", 0));
+    }
+    if (rComponent.HasParameter("DisplacementThreshold"))
+    {
+        p_modifier->SetDisplacementThreshold(rComponent.GetDouble("DisplacementThreshold", 0.0));
+    }
+    if (rComponent.HasParameter("PhenotypeChangeThreshold"))
+    {
+        p_modifier->SetPhenotypeChangeThreshold(rComponent.GetUnsigned("PhenotypeChangeThreshold", 0));
+    }
+    p_modifier->SetOutputIntervals(rComponent.GetUnsigned("MinOutputInterval", p_modifier->GetMinOutputInterval()),
+                                   rComponent.GetUnsigned("MaxOutputInterval", p_modifier->GetMaxOutputInterval()));
+    rComponent.CheckAllParametersUsed("modifier " + rComponent.rGetType());
+    rSimulator.AddSimulationModifier(p_modifier);
+}
+
+/**
+ * Creator of a cell writer that takes no parameters.
+ *
+ * @param rComponent the entry of the writer
+ * @param rSimulator the simulation
+ */
+template<unsigned DIM, template<unsigned, unsigned> class WRITER>
+static void CreateCellWriter(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    rComponent.CheckAllParametersUsed("writer " + rComponent.rGetType());
+    rSimulator.rGetCellPopulation().template AddCellWriter<WRITER>();
+}
+
+/**
+ * Creator of a cell writer whose output may be compressed.
+ *
+ * @param rComponent the entry of the writer
+ * @param rSimulator the simulation
+ */
+template<unsigned DIM, template<unsigned, unsigned> class WRITER>
+static void CreateCompressedCellWriter(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    boost::shared_ptr<WRITER<DIM, DIM> > p_writer(new WRITER<DIM, DIM>());
+    SetCompression(rComponent, *p_writer);
+    rComponent.CheckAllParametersUsed("writer " + rComponent.rGetType());
+    rSimulator.rGetCellPopulation().AddCellWriter(p_writer);
+}
+
+/**
+ * Creator of a population writer that takes no parameters.
+ *
+ * @param rComponent the entry of the writer
+ * @param rSimulator the simulation
+ */
+template<unsigned DIM, template<unsigned, unsigned> class WRITER>
+static void CreatePopulationWriter(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    rComponent.CheckAllParametersUsed("writer " + rComponent.rGetType());
+    rSimulator.rGetCellPopulation().template AddPopulationWriter<WRITER>();
+}
+
+template<unsigned DIM>
+static void CreateBoundaryLengthWriter(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    boost::shared_ptr<BoundaryLengthWriter<DIM, DIM> > p_writer(new BoundaryLengthWriter<DIM, DIM>());
+    SetCompression(rComponent, *p_writer);
+    rComponent.CheckAllParametersUsed("writer " + rComponent.rGetType());
+    rSimulator.rGetCellPopulation().AddPopulationWriter(p_writer);
+}
+
+template<unsigned DIM>
+static void CreateMammaryCompositeWriter(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    boost::shared_ptr<MammaryCompositeWriter<DIM, DIM> > p_writer(new MammaryCompositeWriter<DIM, DIM>());
+    std::vector<boost::shared_ptr<AbstractSnapshotFormat<DIM> > > formats = CreateSnapshotFormats<DIM>(rComponent);
+    for (unsigned i=0; i<formats.size(); i++)
+    {
+        p_writer->AddSnapshotFormat(formats[i]);
+    }
+    rComponent.CheckAllParametersUsed("writer " + rComponent.rGetType());
+    rSimulator.rGetCellPopulation().AddPopulationWriter(p_writer);
+}
+
+template<unsigned DIM>
+static void CreateMammarySnapshotWriter(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator)
+{
+    boost::shared_ptr<MammarySnapshotWriter<DIM, DIM> > p_writer(new MammarySnapshotWriter<DIM, DIM>());
+    SetCompression(rComponent, *p_writer);
+    if (rComponent.HasParameter("UsePositionDeltas"))
+    {
+        p_writer->SetUsePositionDeltas(rComponent.GetBool("UsePositionDeltas", false));
+    }
+    if (rComponent.HasParameter("KeyFrameInterval"))
+    {
+        p_writer->SetKeyFrameInterval(rComponent.GetUnsigned("KeyFrameInterval", 1));
+    }
+    rComponent.CheckAllParametersUsed("writer " + rComponent.rGetType());
+    rSimulator.rGetCellPopulation().AddPopulationWriter(p_writer);
+}
+
+template<unsigned DIM>
+MammaryScenarioFactory<DIM>::MammaryScenarioFactory()
+{
+    Register("Forces", "GeneralisedLinearSpringForce", CreateGeneralisedLinearSpringForce<DIM>);
+    Register("Forces", "LinearSpringForce", CreateLinearSpringForce<DIM>);
+    Register("Forces", "DifferentialAdhesionLinearSpringForce", CreateDifferentialAdhesionLinearSpringForce<DIM>);
+    Register("Forces", "CellCellAdhesionForce", CreateCellCellAdhesionForce<DIM>);
+    Register("Forces", "CellParticleAdhesionForce", CreateCellParticleAdhesionForce<DIM>);
+    Register("Forces", "CellECMAdhesionForce", CreateCellECMAdhesionForce<DIM>);
+    Register("Forces", "CellCoverslipAdhesionForce", CreateCellCoverslipAdhesionForce<DIM>);
+    Register("Forces", "RandomMotionForce", CreateRandomMotionForce<DIM>);
+    Register("Forces", "Force", CreateForce<DIM>);
+
+    Register("Killers", "AnoikisCellKiller", CreateAnoikisCellKiller<DIM>);
+
+    Register("Modifiers", "PopulationStatisticsModifier", CreatePopulationStatisticsModifier<DIM>);
+    Register("Modifiers", "MemoryFootprintModifier", CreateMemoryFootprintModifier<DIM>);
+    Register("Modifiers", "CellHeightTrackingModifier", CreateCellHeightTrackingModifier<DIM>);
+    Register("Modifiers", "IntegrinExpressionModifier", CreateIntegrinExpressionModifier<DIM>);
+    Register("Modifiers", "MeanSquaredDisplacementModifier", CreateMeanSquaredDisplacementModifier<DIM>);
+    Register("Modifiers", "CellTrajectoryStoreModifier", CreateCellTrajectoryStoreModifier<DIM>);
+    Register("Modifiers", "AsynchronousOutputModifier", CreateAsynchronousOutputModifier<DIM>);
+    Register("Modifiers", "AdaptiveOutputModifier", CreateAdaptiveOutputModifier<DIM>);
+
+    Register("Writers", "CellIdWriter", CreateCellWriter<DIM, CellIdWriter>);
+    Register("Writers", "MammaryCellTypeWriter", CreateCompressedCellWriter<DIM, MammaryCellTypeWriter>);
+    Register("Writers", "CellLocationWriter", CreateCompressedCellWriter<DIM, CellLocationWriter>);
+    Register("Writers", "CellVelocityWriter", CreateCompressedCellWriter<DIM, CellVelocityWriter>);
+    Register("Writers", "CellPopulationAdjacencyWriter", CreatePopulationWriter<DIM, CellPopulationAdjacencyWriter>);
+    Register("Writers", "BoundaryLengthWriter", CreateBoundaryLengthWriter<DIM>);
+    Register("Writers", "MammaryCompositeWriter", CreateMammaryCompositeWriter<DIM>);
+    Register("Writers", "MammarySnapshotWriter", CreateMammarySnapshotWriter<DIM>);
+
+    RegisterDimensionSpecificCreators();
+}
+
+template<unsigned DIM>
+void MammaryScenarioFactory<DIM>::RegisterDimensionSpecificCreators()
+{
+}
+
+template<>
+void MammaryScenarioFactory<3>::RegisterDimensionSpecificCreators()
+{
+    Register("Killers", "AnoikisCellKiller3D", CreateAnoikisCellKiller3D);
+}
+
+template<unsigned DIM>
+void MammaryScenarioFactory<DIM>::Register(const std::string& rListName, const std::string& rType, ComponentCreator creator)
+{
+    if (rListName != "Forces" && rListName != "Killers" && rListName != "Modifiers" && rListName != "Writers")
+    {
+        EXCEPTION("Unknown scenario list " + rListName);
+    }
+    mCreators[rListName][rType] = creator;
+}
+
+template<unsigned DIM>
+bool MammaryScenarioFactory<DIM>::IsRegistered(const std::string& rListName, const std::string& rType) const
+{
+    typename std::map<std::string, std::map<std::string, ComponentCreator> >::const_iterator it = mCreators.find(rListName);
+    return (it != mCreators.end()) && (it->second.find(rType) != it->second.end());
+}
+
+template<unsigned DIM>
+std::vector<std::string> MammaryScenarioFactory<DIM>::GetRegisteredTypes(const std::string& rListName) const
+{
+    std::vector<std::string> types;
+    typename std::map<std::string, std::map<std::string, ComponentCreator> >::const_iterator it = mCreators.find(rListName);
+    if (it != mCreators.end())
+    {
+        for (typename std::map<std::string, ComponentCreator>::const_iterator type = it->second.begin(); type != it->second.end(); ++type)
+        {
+            types.push_back(type->first);
+        }
+    }
+    return types;
+}
+
+template<unsigned DIM>
+void MammaryScenarioFactory<DIM>::AddComponents(const MammaryScenario& rScenario, MammaryOffLatticeSimulation<DIM>& rSimulator) const
+{
+    const char* list_names[4] = {"Forces", "Killers", "Modifiers", "Writers"};
+    for (unsigned list=0; list<4; list++)
+    {
+        const std::vector<MammaryScenarioComponent>& r_components = rScenario.rGetList(list_names[list]);
+        for (unsigned i=0; i<r_components.size(); i++)
+        {
+            const std::string& r_type = r_components[i].rGetType();
+            if (!IsRegistered(list_names[list], r_type))
+            {
+                EXCEPTION("Unknown type " + r_type + " in " + list_names[list] + " of " + rScenario.rGetFileName()
+                          + " for a " << DIM << "D simulation");
+            }
+            mCreators.find(list_names[list])->second.find(r_type)->second(r_components[i], rSimulator);
+        }
+    }
+}
+
+template<unsigned DIM>
+void MammaryScenarioFactory<DIM>::Run(const MammaryScenario& rScenario) const
+{
+    const MammaryScenarioComponent& r_simulation = rScenario.rGetSimulation();
+    const MammaryScenarioComponent& r_population = rScenario.rGetPopulation();
+
+    if (r_simulation.GetUnsigned("Dimension", DIM) != DIM)
+    {
+        EXCEPTION("The scenario " + rScenario.rGetFileName() + " is not for a " << DIM << "D simulation");
+    }
+    if (!r_simulation.HasParameter("EndTime") || !r_simulation.HasParameter("OutputDirectory"))
+    {
+        EXCEPTION("The simulation section of " + rScenario.rGetFileName() + " must give EndTime and OutputDirectory");
+    }
+    double dt = r_simulation.GetDouble("Dt", 1.0/120.0);
+    double end_time = r_simulation.GetDouble("EndTime", 0.0);
+    unsigned sampling_timestep_multiple = r_simulation.GetUnsigned("SamplingTimestepMultiple", 1);
+    std::string output_directory = r_simulation.GetString("OutputDirectory", "");
+    unsigned seed = r_simulation.GetUnsigned("Seed", 0);
+    MammaryRandomStreams* p_streams = MammaryRandomStreams::Instance();
+    p_streams->SetReproducible(r_simulation.GetBool("Reproducible", false));
+    p_streams->SetSeed(seed);
+    r_simulation.CheckAllParametersUsed("the simulation section");
+
+    std::string geometry_name = r_population.GetString("Geometry", "organoid");
+    MammaryBenchmarkGeometry geometry = ORGANOID_GEOMETRY;
+    if (geometry_name == MammaryBenchmarkScenario<DIM>::GetGeometryName(MONOLAYER_GEOMETRY))
+    {
+        geometry = MONOLAYER_GEOMETRY;
+    }
+    else if (geometry_name == MammaryBenchmarkScenario<DIM>::GetGeometryName(PARTICLE_ORGANOID_GEOMETRY))
+    {
+        geometry = PARTICLE_ORGANOID_GEOMETRY;
+    }
+    else if (geometry_name != MammaryBenchmarkScenario<DIM>::GetGeometryName(ORGANOID_GEOMETRY))
+    {
+        EXCEPTION("Unknown geometry " + geometry_name + "; use organoid, monolayer or particle_organoid");
+    }
+
+    // The scenario's forces are added from the Forces list, so none are taken from the benchmark scenario
+    MammaryBenchmarkScenario<DIM> population_scenario(geometry, r_population.GetUnsigned("NumCells", 100), 0);
+    population_scenario.SetSpacing(r_population.GetDouble("Spacing", 1.0));
+    population_scenario.SetParticleRatio(r_population.GetDouble("ParticleRatio", 1.0));
+    population_scenario.SetStemCellFraction(r_population.GetDouble("StemCellFraction", 0.1));
+    population_scenario.SetCutOffLength(r_population.GetDouble("CutOffLength", 1.5));
+    bool has_min_duration = r_population.HasParameter("MinCellCycleDuration");
+    bool has_max_duration = r_population.HasParameter("MaxCellCycleDuration");
+    double min_duration = r_population.GetDouble("MinCellCycleDuration", 0.0);
+    double max_duration = r_population.GetDouble("MaxCellCycleDuration", 0.0);
+    std::string division_rule = r_population.GetString("DivisionRule", "default");
+    if (division_rule != "default" && division_rule != "oriented")
+    {
+        EXCEPTION("Unknown division rule " + division_rule + "; use default or oriented");
+    }
+    r_population.CheckAllParametersUsed("the population section");
+
+    // Start from the same state as a fresh test, so that a scenario and seed always give the same run
+    SimulationTime::Destroy();
+    SimulationTime::Instance()->SetStartTime(0.0);
+    RandomNumberGenerator::Instance()->Reseed(seed);
+    CellId::ResetMaxCellId();
+
+    NodesOnlyMesh<DIM> mesh;
+    std::vector<bool> cell_is_myoepithelial;
+    population_scenario.ConstructMesh(mesh, cell_is_myoepithelial);
+    boost::shared_ptr<NodeBasedCellPopulation<DIM> > p_population = population_scenario.CreateCellPopulation(mesh, cell_is_myoepithelial);
+
+    if (has_min_duration || has_max_duration)
+    {
+        for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = p_population->Begin();
+             cell_iter != p_population->End();
+             ++cell_iter)
+        {
+            MammaryCellCycleModel* p_model = static_cast<MammaryCellCycleModel*>(cell_iter->GetCellCycleModel());
+            if (has_min_duration)
+            {
+                p_model->SetMinCellCycleDuration(min_duration);
+            }
+            if (has_max_duration)
+            {
+                p_model->SetMaxCellCycleDuration(max_duration);
+            }
+            p_model->SetCellCycleDuration();
+        }
+    }
+    if (division_rule == "oriented")
+    {
+        boost::shared_ptr<AbstractCentreBasedDivisionRule<DIM,DIM> > p_division_rule(new OrientedDivisionRule<DIM,DIM>());
+        p_population->SetCentreBasedDivisionRule(p_division_rule);
+    }
+
+    MammaryOffLatticeSimulation<DIM> simulator(*p_population);
+    simulator.SetOutputDirectory(output_directory);
+    simulator.SetDt(dt);
+    simulator.SetEndTime(end_time);
+    simulator.SetSamplingTimestepMultiple(sampling_timestep_multiple);
+    population_scenario.SetUpSimulation(simulator);
+    AddComponents(rScenario, simulator);
+
+    simulator.Solve();
+}
+
+// Explicit instantiation
+template class MammaryScenarioFactory<1>;
+template class MammaryScenarioFactory<2>;
+template class MammaryScenarioFactory<3>;
@@ -0,0 +1,93 @@
+#ifndef MAMMARYSCENARIOFACTORY_HPP_
+#define MAMMARYSCENARIOFACTORY_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+
+#include "MammaryOffLatticeSimulation.hpp"
+#include "MammaryScenario.hpp"
+
+/**
+ * Builds and runs the simulation described by a MammaryScenario.
+ *
+ * The population is built as in MammaryBenchmarkScenario, from the population section:
+ * Geometry (organoid, monolayer or particle_organoid), NumCells, Spacing, ParticleRatio,
+ * StemCellFraction, CutOffLength, MinCellCycleDuration, MaxCellCycleDuration and
+ * DivisionRule (default or oriented). The simulation section gives Dt, EndTime,
+ * SamplingTimestepMultiple, OutputDirectory, Seed and Reproducible (see
+ * MammaryRandomStreams).
+ *
+ * Each entry of the Forces, Killers, Modifiers and Writers lists is built by the creator
+ * registered for its type, which reads the entry's parameters and adds the component to the
+ * simulation. The creators of this project's classes are registered by the constructor, each
+ * under its class name and taking the parameters that the class writes to the simulation's
+ * parameter file (except for the Centre and Radius of AnoikisCellKiller3D, and the
+ * Compression and CompressionLevel of writers); Register() adds others without changing the
+ * app. The Seed of an AnoikisCellKiller is mixed with the simulation's Seed, so replicates
+ * with different seeds kill different cells even when the killer's Seed is given.
+ */
+template<unsigned DIM>
+class MammaryScenarioFactory
+{
+public:
+
+    /** A function that builds a component from its entry in a scenario and adds it to a simulation. */
+    typedef void (*ComponentCreator)(const MammaryScenarioComponent& rComponent, MammaryOffLatticeSimulation<DIM>& rSimulator);
+
+private:
+
+    /** The creator of each type, by list name and type. */
+    std::map<std::string, std::map<std::string, ComponentCreator> > mCreators;
+
+    /** Register the creators of the components that exist only in this dimension. */
+    void RegisterDimensionSpecificCreators();
+
+public:
+
+    /**
+     * Constructor, which registers the creators of this project's components.
+     */
+    MammaryScenarioFactory();
+
+    /**
+     * Register the creator of a type, replacing any creator already registered for it.
+     *
+     * @param rListName the list in which the type may appear (Forces, Killers, Modifiers or Writers)
+     * @param rType the type
+     * @param creator the creator
+     */
+    void Register(const std::string& rListName, const std::string& rType, ComponentCreator creator);
+
+    /**
+     * @param rListName the name of a list
+     * @param rType a type
+     * @return whether a creator is registered for the type in the list
+     */
+    bool IsRegistered(const std::string& rListName, const std::string& rType) const;
+
+    /**
+     * @param rListName the name of a list
+     * @return the types registered in the list, in alphabetical order
+     */
+    std::vector<std::string> GetRegisteredTypes(const std::string& rListName) const;
+
+    /**
+     * Build the entries of the Forces, Killers, Modifiers and Writers lists of a scenario, in
+     * the order given, and add them to a simulation.
+     *
+     * @param rScenario the scenario
+     * @param rSimulator the simulation
+     */
+    void AddComponents(const MammaryScenario& rScenario, MammaryOffLatticeSimulation<DIM>& rSimulator) const;
+
+    /**
+     * Build and run a scenario from a fresh SimulationTime, CellId counter and
+     * RandomNumberGenerator seed.
+     *
+     * @param rScenario the scenario
+     */
+    void Run(const MammaryScenario& rScenario) const;
+};
+
+#endif /*MAMMARYSCENARIOFACTORY_HPP_*/
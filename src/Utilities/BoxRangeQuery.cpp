@@ -0,0 +1,104 @@
+#include "BoxRangeQuery.hpp"
+#include <algorithm>
+
+template<unsigned DIM>
+bool BoxRangeQuery<DIM>::GetBoxesInRegion(NodesOnlyMesh<DIM>& rMesh,
+                                          const c_vector<double, DIM>& rLower,
+                                          const c_vector<double, DIM>& rUpper,
+                                          std::vector<unsigned>& rBoxIndices)
+{
+    rBoxIndices.clear();
+
+    DistributedBoxCollection<DIM>* p_box_collection = rMesh.GetBoxCollection();
+    if (p_box_collection == NULL)
+    {
+        return false;
+    }
+
+    double box_width = rMesh.GetMaximumInteractionDistance();
+    c_vector<double, 2*DIM> domain = p_box_collection->rGetDomainSize();
+
+    /*
+     * Along each axis, clip the region to the domain and list sample coordinates
+     * spaced by at most one box width, so that every box overlapping the region
+     * contains at least one sample point.
+     */
+    std::vector<std::vector<double> > samples(DIM);
+    for (unsigned i=0; i<DIM; i++)
+    {
+        // Keep samples strictly inside the domain, where CalculateContainingBox() is defined
+        double domain_min = domain[2*i];
+        double domain_max = domain[2*i+1] - 1e-9*box_width;
+        double lower = std::max(rLower[i], domain_min);
+        double upper = std::min(rUpper[i], domain_max);
+        if (lower > upper)
+        {
+            // The region does not overlap the domain
+            return true;
+        }
+        for (double x=lower; x<upper; x+=box_width)
+        {
+            samples[i].push_back(x);
+        }
+        samples[i].push_back(upper);
+    }
+
+    // Visit every combination of sample coordinates
+    std::vector<unsigned> counters(DIM, 0);
+    c_vector<double, DIM> point;
+    while (true)
+    {
+        for (unsigned i=0; i<DIM; i++)
+        {
+            point[i] = samples[i][counters[i]];
+        }
+        rBoxIndices.push_back(p_box_collection->CalculateContainingBox(point));
+
+        unsigned dim = 0;
+        while (dim < DIM && ++counters[dim] == samples[dim].size())
+        {
+            counters[dim] = 0;
+            dim++;
+        }
+        if (dim == DIM)
+        {
+            break;
+        }
+    }
+
+    // Neighbouring samples may fall in the same box, and only this process's boxes can be visited
+    std::sort(rBoxIndices.begin(), rBoxIndices.end());
+    rBoxIndices.erase(std::unique(rBoxIndices.begin(), rBoxIndices.end()), rBoxIndices.end());
+    std::vector<unsigned>::iterator new_end = rBoxIndices.begin();
+    for (std::vector<unsigned>::iterator it = rBoxIndices.begin(); it != rBoxIndices.end(); ++it)
+    {
+        if (p_box_collection->IsBoxOwned(*it))
+        {
+            *new_end++ = *it;
+        }
+    }
+    rBoxIndices.erase(new_end, rBoxIndices.end());
+
+    return true;
+}
+
+template<unsigned DIM>
+bool BoxRangeQuery<DIM>::GetBoxesInSphere(NodesOnlyMesh<DIM>& rMesh,
+                                          const c_vector<double, DIM>& rCentre,
+                                          double radius,
+                                          std::vector<unsigned>& rBoxIndices)
+{
+    c_vector<double, DIM> lower = rCentre;
+    c_vector<double, DIM> upper = rCentre;
+    for (unsigned i=0; i<DIM; i++)
+    {
+        lower[i] -= radius;
+        upper[i] += radius;
+    }
+    return GetBoxesInRegion(rMesh, lower, upper, rBoxIndices);
+}
+
+// Explicit instantiation
+template class BoxRangeQuery<1>;
+template class BoxRangeQuery<2>;
+template class BoxRangeQuery<3>;
@@ -0,0 +1,54 @@
+#ifndef BOXRANGEQUERY_HPP_
+#define BOXRANGEQUERY_HPP_
+
+#include <vector>
+#include "UblasVectorInclude.hpp"
+#include "NodesOnlyMesh.hpp"
+
+/**
+ * Range queries against the DistributedBoxCollection of a NodesOnlyMesh.
+ *
+ * The boxes are a regular grid whose width is the mesh's maximum interaction
+ * distance. A query returns every box that intersects an axis-aligned region,
+ * so that callers need only visit the nodes in those boxes rather than every node
+ * in the mesh.
+ *
+ * Note that nodes are only sorted into boxes when the population is updated, so
+ * callers should pad their region by the distance a node may have moved since then
+ * (one box width is ample) and check each node's actual location.
+ */
+template<unsigned DIM>
+class BoxRangeQuery
+{
+public:
+
+    /**
+     * Find the boxes intersecting an axis-aligned region.
+     *
+     * @param rMesh the mesh, whose box collection must have been set up
+     * @param rLower the lower corner of the region
+     * @param rUpper the upper corner of the region
+     * @param rBoxIndices filled in with the global indices of the boxes owned by this process, in increasing order
+     * @return false if the mesh has no box collection (the caller should then visit every node)
+     */
+    static bool GetBoxesInRegion(NodesOnlyMesh<DIM>& rMesh,
+                                 const c_vector<double, DIM>& rLower,
+                                 const c_vector<double, DIM>& rUpper,
+                                 std::vector<unsigned>& rBoxIndices);
+
+    /**
+     * Find the boxes which may contain nodes within a given distance of a point.
+     *
+     * @param rMesh the mesh, whose box collection must have been set up
+     * @param rCentre the point
+     * @param radius the distance
+     * @param rBoxIndices filled in with the global indices of the boxes owned by this process, in increasing order
+     * @return false if the mesh has no box collection (the caller should then visit every node)
+     */
+    static bool GetBoxesInSphere(NodesOnlyMesh<DIM>& rMesh,
+                                 const c_vector<double, DIM>& rCentre,
+                                 double radius,
+                                 std::vector<unsigned>& rBoxIndices);
+};
+
+#endif /*BOXRANGEQUERY_HPP_*/
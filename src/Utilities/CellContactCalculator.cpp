@@ -0,0 +1,143 @@
+#include "CellContactCalculator.hpp"
+#include <algorithm>
+#include <cmath>
+
+template<unsigned DIM>
+CellContactCalculator<DIM>::CellContactCalculator()
+{
+    std::fill(&mContactLengths[0][0], &mContactLengths[0][0] + 9, 0.0);
+    std::fill(&mNumContacts[0][0], &mNumContacts[0][0] + 9, 0u);
+}
+
+template<unsigned DIM>
+MammaryLineage CellContactCalculator<DIM>::GetLineage(MammaryCellType cellType)
+{
+    switch (cellType)
+    {
+        case LUMINAL_CELL:
+        case LUMINAL_STEM_CELL:
+            return LUMINAL_LINEAGE;
+        case MYOEPITHELIAL_CELL:
+        case MYOEPITHELIAL_STEM_CELL:
+            return MYOEPITHELIAL_LINEAGE;
+        default:
+            return NO_LINEAGE;
+    }
+}
+
+template<unsigned DIM>
+double CellContactCalculator<DIM>::GetEdgeLength(double radiusA, double radiusB, double separation)
+{
+    // Use Heron's formula for the area of the triangle with sides a, b and c; the edge is twice its height over c
+    double a = radiusA;
+    double b = radiusB;
+    double c = separation;
+    double s = 0.5*(a + b + c);
+    double A = sqrt(s*(s-a)*(s-b)*(s-c));
+    return 4.0*A/c;
+}
+
+template<unsigned DIM>
+void CellContactCalculator<DIM>::Calculate(NodeBasedCellPopulation<DIM>& rCellPopulation)
+{
+    std::fill(&mContactLengths[0][0], &mContactLengths[0][0] + 9, 0.0);
+    std::fill(&mNumContacts[0][0], &mNumContacts[0][0] + 9, 0u);
+
+    // Cache the lineage of each cell by node index, so that each pair needs only two array lookups
+    mLineages.assign(rCellPopulation.rGetMesh().GetMaximumNodeIndex(), UINT8_MAX);
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        unsigned node_index = rCellPopulation.GetLocationIndexUsingCell(*cell_iter);
+        if (node_index >= mLineages.size())
+        {
+            mLineages.resize(node_index + 1, UINT8_MAX);
+        }
+        mLineages[node_index] = GetLineage(MammaryCellPropertyHelper::GetMammaryCellType(*cell_iter));
+    }
+
+    std::vector<std::pair<Node<DIM>*, Node<DIM>*> >& r_node_pairs = rCellPopulation.rGetNodePairs();
+    for (unsigned i=0; i<r_node_pairs.size(); i++)
+    {
+        Node<DIM>* p_node_a = r_node_pairs[i].first;
+        Node<DIM>* p_node_b = r_node_pairs[i].second;
+        unsigned index_a = p_node_a->GetIndex();
+        unsigned index_b = p_node_b->GetIndex();
+
+        // Skip nodes without cells
+        if (index_a >= mLineages.size() || index_b >= mLineages.size() ||
+            mLineages[index_a] == UINT8_MAX || mLineages[index_b] == UINT8_MAX)
+        {
+            continue;
+        }
+
+        double radius_a = p_node_a->GetRadius();
+        double radius_b = p_node_b->GetRadius();
+        double separation = norm_2(p_node_a->rGetLocation() - p_node_b->rGetLocation());
+        if (separation < radius_a + radius_b)
+        {
+            unsigned lineage_a = std::min(mLineages[index_a], mLineages[index_b]);
+            unsigned lineage_b = std::max(mLineages[index_a], mLineages[index_b]);
+            mContactLengths[lineage_a][lineage_b] += GetEdgeLength(radius_a, radius_b, separation);
+            mNumContacts[lineage_a][lineage_b]++;
+        }
+    }
+}
+
+template<unsigned DIM>
+double CellContactCalculator<DIM>::GetContactLength(MammaryLineage lineageA, MammaryLineage lineageB) const
+{
+    return mContactLengths[std::min(lineageA, lineageB)][std::max(lineageA, lineageB)];
+}
+
+template<unsigned DIM>
+unsigned CellContactCalculator<DIM>::GetNumContacts(MammaryLineage lineageA, MammaryLineage lineageB) const
+{
+    return mNumContacts[std::min(lineageA, lineageB)][std::max(lineageA, lineageB)];
+}
+
+template<unsigned DIM>
+double CellContactCalculator<DIM>::GetHeterotypicContactLength() const
+{
+    return mContactLengths[LUMINAL_LINEAGE][MYOEPITHELIAL_LINEAGE];
+}
+
+template<unsigned DIM>
+double CellContactCalculator<DIM>::GetHomotypicContactLength() const
+{
+    return mContactLengths[LUMINAL_LINEAGE][LUMINAL_LINEAGE] + mContactLengths[MYOEPITHELIAL_LINEAGE][MYOEPITHELIAL_LINEAGE];
+}
+
+template<unsigned DIM>
+double CellContactCalculator<DIM>::GetTotalContactLength() const
+{
+    double total = 0.0;
+    for (unsigned i=0; i<3; i++)
+    {
+        for (unsigned j=i; j<3; j++)
+        {
+            total += mContactLengths[i][j];
+        }
+    }
+    return total;
+}
+
+template<unsigned DIM>
+unsigned CellContactCalculator<DIM>::GetTotalNumContacts() const
+{
+    unsigned total = 0;
+    for (unsigned i=0; i<3; i++)
+    {
+        for (unsigned j=i; j<3; j++)
+        {
+            total += mNumContacts[i][j];
+        }
+    }
+    return total;
+}
+
+// Explicit instantiation
+template class CellContactCalculator<1>;
+template class CellContactCalculator<2>;
+template class CellContactCalculator<3>;
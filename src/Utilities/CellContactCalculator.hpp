@@ -0,0 +1,108 @@
+#ifndef CELLCONTACTCALCULATOR_HPP_
+#define CELLCONTACTCALCULATOR_HPP_
+
+#include <vector>
+#include <stdint.h>
+#include "NodeBasedCellPopulation.hpp"
+#include "MammaryCellPropertyHelper.hpp"
+
+/**
+ * The two mammary lineages, with stem cells counted in the lineage they give rise to.
+ */
+typedef enum MammaryLineage_
+{
+    LUMINAL_LINEAGE = 0,
+    MYOEPITHELIAL_LINEAGE = 1,
+    NO_LINEAGE = 2
+} MammaryLineage;
+
+/**
+ * Calculates the length of contact between neighbouring cells of a NodeBasedCellPopulation,
+ * broken down by the lineages of the two cells. This is a measure of how sorted the
+ * population is, and is cheap enough to be calculated in situ as often as required.
+ *
+ * Each pair of nodes in the population's node pair list whose separation is less than
+ * the sum of their radii is visited once. The length of the edge they share is
+ * approximated, using Heron's formula, as the length of the chord where two circles with
+ * the nodes' radii intersect.
+ *
+ * The node pairs are those found when the population was last updated.
+ */
+template<unsigned DIM>
+class CellContactCalculator
+{
+private:
+
+    /** The lineage of the cell at each node index (UINT8_MAX for nodes without cells). */
+    std::vector<uint8_t> mLineages;
+
+    /** The total contact length between each pair of lineages, stored with the lower lineage first. */
+    double mContactLengths[3][3];
+
+    /** The number of contacts between each pair of lineages, stored with the lower lineage first. */
+    unsigned mNumContacts[3][3];
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    CellContactCalculator();
+
+    /**
+     * @param cellType a mammary cell type
+     * @return the lineage of the cell type
+     */
+    static MammaryLineage GetLineage(MammaryCellType cellType);
+
+    /**
+     * @param radiusA the radius of one node
+     * @param radiusB the radius of the other node
+     * @param separation the distance between the nodes, which must be less than the sum of their radii
+     * @return the (approximate) length of the edge shared by the two cells
+     */
+    static double GetEdgeLength(double radiusA, double radiusB, double separation);
+
+    /**
+     * Calculate the contact lengths for a population.
+     *
+     * @param rCellPopulation the population
+     */
+    void Calculate(NodeBasedCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * @param lineageA a lineage
+     * @param lineageB another lineage (in either order)
+     * @return the total contact length between cells of the two lineages
+     */
+    double GetContactLength(MammaryLineage lineageA, MammaryLineage lineageB) const;
+
+    /**
+     * @param lineageA a lineage
+     * @param lineageB another lineage (in either order)
+     * @return the number of contacts between cells of the two lineages
+     */
+    unsigned GetNumContacts(MammaryLineage lineageA, MammaryLineage lineageB) const;
+
+    /**
+     * @return the total contact length between luminal and myoepithelial cells
+     */
+    double GetHeterotypicContactLength() const;
+
+    /**
+     * @return the total contact length between cells of the same lineage
+     */
+    double GetHomotypicContactLength() const;
+
+    /**
+     * @return the total contact length between all cells
+     */
+    double GetTotalContactLength() const;
+
+    /**
+     * @return the total number of contacts between all cells
+     */
+    unsigned GetTotalNumContacts() const;
+};
+
+#endif /*CELLCONTACTCALCULATOR_HPP_*/
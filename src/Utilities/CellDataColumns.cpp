@@ -0,0 +1,116 @@
+#include "CellDataColumns.hpp"
+#include <algorithm>
+#include <cassert>
+
+#include "Exception.hpp"
+
+CellDataColumns::CellDataColumns()
+    : AbstractCellProperty()
+{
+}
+
+CellDataColumns::~CellDataColumns()
+{
+}
+
+boost::shared_ptr<CellDataColumns> CellDataColumns::Get(CellPropertyRegistry* pRegistry)
+{
+    assert(pRegistry != NULL);
+    return boost::static_pointer_cast<CellDataColumns>(pRegistry->Get<CellDataColumns>());
+}
+
+boost::shared_ptr<CellDataColumns> CellDataColumns::Get(boost::shared_ptr<CellPropertyRegistry> pRegistry)
+{
+    return Get(pRegistry.get());
+}
+
+unsigned CellDataColumns::RegisterColumn(const std::string& rName)
+{
+    std::map<std::string, unsigned>::iterator it = mHandles.find(rName);
+    if (it != mHandles.end())
+    {
+        return it->second;
+    }
+
+    // A new column has an entry for each cell ID that the others have room for
+    unsigned handle = mNames.size();
+    unsigned num_cell_ids = mColumns.empty() ? 0 : mColumns[0].size();
+    mHandles[rName] = handle;
+    mNames.push_back(rName);
+    mColumns.push_back(std::vector<double>(num_cell_ids, DOUBLE_UNSET));
+    return handle;
+}
+
+bool CellDataColumns::HasColumn(const std::string& rName) const
+{
+    return mHandles.find(rName) != mHandles.end();
+}
+
+unsigned CellDataColumns::GetColumnHandle(const std::string& rName) const
+{
+    std::map<std::string, unsigned>::const_iterator it = mHandles.find(rName);
+    if (it == mHandles.end())
+    {
+        EXCEPTION("The cell data column " + rName + " has not been registered.");
+    }
+    return it->second;
+}
+
+const std::string& CellDataColumns::rGetColumnName(unsigned handle) const
+{
+    assert(handle < mNames.size());
+    return mNames[handle];
+}
+
+unsigned CellDataColumns::GetNumColumns() const
+{
+    return mColumns.size();
+}
+
+void CellDataColumns::Reserve(unsigned numCellIds)
+{
+    for (unsigned i=0; i<mColumns.size(); i++)
+    {
+        if (mColumns[i].size() < numCellIds)
+        {
+            // Grow geometrically, so that a steadily growing population does not resize every step
+            unsigned new_size = std::max(numCellIds, (unsigned)(2*mColumns[i].size()));
+            mColumns[i].resize(new_size, DOUBLE_UNSET);
+        }
+    }
+}
+
+double CellDataColumns::GetValue(unsigned handle, unsigned cellId) const
+{
+    assert(handle < mColumns.size());
+    const std::vector<double>& r_column = mColumns[handle];
+    if (cellId >= r_column.size())
+    {
+        return DOUBLE_UNSET;
+    }
+    return r_column[cellId];
+}
+
+std::vector<double>& CellDataColumns::rGetColumn(unsigned handle)
+{
+    assert(handle < mColumns.size());
+    return mColumns[handle];
+}
+
+void CellDataColumns::Clear()
+{
+    for (unsigned i=0; i<mColumns.size(); i++)
+    {
+        std::fill(mColumns[i].begin(), mColumns[i].end(), DOUBLE_UNSET);
+    }
+}
+
+void CellDataColumns::ClearColumn(unsigned handle)
+{
+    assert(handle < mColumns.size());
+    std::fill(mColumns[handle].begin(), mColumns[handle].end(), DOUBLE_UNSET);
+}
+
+#include "SerializationExportWrapperForCpp.hpp"
+// Declare identifier for the serializer
+CHASTE_CLASS_EXPORT(CellDataColumns)
@@ -0,0 +1,181 @@
+#ifndef CELLDATACOLUMNS_HPP_
+#define CELLDATACOLUMNS_HPP_
+
+#include <cassert>
+#include <map>
+#include <string>
+#include <vector>
+#include <boost/shared_ptr.hpp>
+
+#include "AbstractCellProperty.hpp"
+#include "CellPropertyRegistry.hpp"
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/map.hpp>
+#include <boost/serialization/string.hpp>
+#include <boost/serialization/vector.hpp>
+
+/**
+ * Typed, indexed cell data for the cells of one population, used in place of string-keyed
+ * CellData items for quantities that are written and read on every time step.
+ *
+ * Each quantity (e.g. "height") is registered once, at setup, and resolves to an
+ * integer handle. Values are stored in one contiguous column per handle, indexed
+ * by cell ID, so that writing or reading a value is a single vector access rather
+ * than a std::map<std::string,double> lookup. Entries for cells that have not yet
+ * been written hold DOUBLE_UNSET.
+ *
+ * The columns are held by the CellPropertyRegistry of the cell population, alongside the
+ * population's cell properties, so they are created and destroyed with the population (and
+ * archived with it), and two populations never share values. They are never added to a
+ * cell, so their cell count stays zero. Use Get() to find the columns of a population, from
+ * rCellPopulation.GetCellPropertyRegistry(), or of the population of a cell, from
+ * pCell->rGetCellPropertyCollection().GetCellPropertyRegistry(). Handles belong to one
+ * instance, so are resolved from it, e.g. in SetupSolve().
+ */
+class CellDataColumns : public AbstractCellProperty
+{
+private:
+
+    /** Map from column name to handle. */
+    std::map<std::string, unsigned> mHandles;
+
+    /** The registered column names, by handle. */
+    std::vector<std::string> mNames;
+
+    /** The columns, indexed by handle and then by cell ID. */
+    std::vector<std::vector<double> > mColumns;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Archive the member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellProperty>(*this);
+        archive & mHandles;
+        archive & mNames;
+        archive & mColumns;
+    }
+
+public:
+
+    /**
+     * Constructor, with no columns. Called by CellPropertyRegistry::Get().
+     */
+    CellDataColumns();
+
+    /**
+     * Virtual destructor, to make this class polymorphic.
+     */
+    virtual ~CellDataColumns();
+
+    /**
+     * @param pRegistry the cell property registry of a cell population, as held by a cell's
+     *     CellPropertyCollection
+     * @return the columns of the population, which are created on first use
+     */
+    static boost::shared_ptr<CellDataColumns> Get(CellPropertyRegistry* pRegistry);
+
+    /**
+     * @param pRegistry the cell property registry of a cell population, as returned by
+     *     AbstractCellPopulation::GetCellPropertyRegistry()
+     * @return the columns of the population, which are created on first use
+     */
+    static boost::shared_ptr<CellDataColumns> Get(boost::shared_ptr<CellPropertyRegistry> pRegistry);
+
+    /**
+     * Register a column, if not already registered.
+     *
+     * @param rName the name of the column
+     * @return the handle of the column
+     */
+    unsigned RegisterColumn(const std::string& rName);
+
+    /**
+     * @param rName the name of a column
+     * @return whether the column has been registered
+     */
+    bool HasColumn(const std::string& rName) const;
+
+    /**
+     * @param rName the name of a registered column
+     * @return the handle of the column; throws if the column has not been registered
+     */
+    unsigned GetColumnHandle(const std::string& rName) const;
+
+    /**
+     * @param handle the handle of a registered column
+     * @return the name of the column
+     */
+    const std::string& rGetColumnName(unsigned handle) const;
+
+    /**
+     * @return the number of registered columns
+     */
+    unsigned GetNumColumns() const;
+
+    /**
+     * Make sure every column has an entry for each cell ID below numCellIds.
+     *
+     * @param numCellIds one more than the largest cell ID to be stored
+     */
+    void Reserve(unsigned numCellIds);
+
+    /**
+     * Set a value.
+     *
+     * @param handle the handle of a registered column
+     * @param cellId the cell ID
+     * @param value the value to store
+     */
+    inline void SetValue(unsigned handle, unsigned cellId, double value)
+    {
+        assert(handle < mColumns.size());
+        std::vector<double>& r_column = mColumns[handle];
+        if (cellId >= r_column.size())
+        {
+            Reserve(cellId + 1);
+        }
+        r_column[cellId] = value;
+    }
+
+    /**
+     * Get a value.
+     *
+     * @param handle the handle of a registered column
+     * @param cellId the cell ID
+     * @return the stored value, or DOUBLE_UNSET if none has been stored for this cell
+     *     since the column was last cleared
+     */
+    double GetValue(unsigned handle, unsigned cellId) const;
+
+    /**
+     * @param handle the handle of a registered column
+     * @return the column, indexed by cell ID, for bulk access
+     */
+    std::vector<double>& rGetColumn(unsigned handle);
+
+    /**
+     * Reset all stored values to DOUBLE_UNSET, keeping the registered handles.
+     */
+    void Clear();
+
+    /**
+     * Reset the values of one column to DOUBLE_UNSET.
+     *
+     * @param handle the handle of a registered column
+     */
+    void ClearColumn(unsigned handle);
+};
+
+#include "SerializationExportWrapper.hpp"
+// Declare identifier for the serializer
+CHASTE_CLASS_EXPORT(CellDataColumns)
+
+#endif /*CELLDATACOLUMNS_HPP_*/
@@ -0,0 +1,65 @@
+#ifndef COUNTERBASEDRANDOMNUMBERGENERATOR_HPP_
+#define COUNTERBASEDRANDOMNUMBERGENERATOR_HPP_
+
+#include <stdint.h>
+
+/**
+ * A stateless, counter-based random number generator.
+ *
+ * Each draw is a hash of a seed, a stream (e.g. a cell ID) and a counter (e.g. the
+ * number of time steps elapsed), computed with the SplitMix64 finaliser. Unlike the
+ * RandomNumberGenerator singleton, the value drawn for a given cell at a given step
+ * does not depend on how many other draws have been made before it, so results do
+ * not change when the order in which cells are visited changes, or when only some
+ * cells are visited.
+ */
+class CounterBasedRandomNumberGenerator
+{
+private:
+
+    /**
+     * The SplitMix64 finaliser.
+     *
+     * @param x the value to mix
+     * @return the mixed value
+     */
+    static inline uint64_t Mix(uint64_t x)
+    {
+        x += 0x9E3779B97F4A7C15ULL;
+        x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+        return x ^ (x >> 31);
+    }
+
+public:
+
+    /**
+     * @param seed the seed
+     * @param stream the stream, e.g. a cell ID
+     * @param counter the counter, e.g. the number of time steps elapsed
+     * @param substream distinguishes several draws for the same stream and counter
+     * @return 64 random bits
+     */
+    static inline uint64_t Hash(uint64_t seed, uint64_t stream, uint64_t counter, uint64_t substream=0)
+    {
+        uint64_t x = Mix(seed);
+        x = Mix(x ^ stream);
+        x = Mix(x ^ counter);
+        return Mix(x ^ substream);
+    }
+
+    /**
+     * @param seed the seed
+     * @param stream the stream, e.g. a cell ID
+     * @param counter the counter, e.g. the number of time steps elapsed
+     * @param substream distinguishes several draws for the same stream and counter
+     * @return a uniformly distributed random number in [0, 1)
+     */
+    static inline double ranf(uint64_t seed, uint64_t stream, uint64_t counter, uint64_t substream=0)
+    {
+        // Use the top 53 bits, which is the precision of a double
+        return (Hash(seed, stream, counter, substream) >> 11)*(1.0/9007199254740992.0);
+    }
+};
+
+#endif /*COUNTERBASEDRANDOMNUMBERGENERATOR_HPP_*/
@@ -0,0 +1,172 @@
+#include "MammaryAllocationCounter.hpp"
+
+#ifdef MAMMARY_ALLOCATION_COUNTING
+#include <atomic>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+    /** The number of allocations made by the process. */
+    std::atomic<uint64_t> gNumAllocations(0);
+
+    /** The number of bytes allocated by the process. */
+    std::atomic<uint64_t> gNumBytesAllocated(0);
+
+    /** The number of deallocations made by the process. */
+    std::atomic<uint64_t> gNumDeallocations(0);
+
+    /** The number of allocations made by this thread. */
+    thread_local uint64_t tNumAllocations = 0;
+
+    /** The number of bytes allocated by this thread. */
+    thread_local uint64_t tNumBytesAllocated = 0;
+
+    /**
+     * Allocate and count a block of memory.
+     *
+     * @param size the number of bytes
+     * @return the block, or NULL if it could not be allocated
+     */
+    inline void* CountedAllocate(std::size_t size)
+    {
+        gNumAllocations.fetch_add(1, std::memory_order_relaxed);
+        gNumBytesAllocated.fetch_add(size, std::memory_order_relaxed);
+        tNumAllocations++;
+        tNumBytesAllocated += size;
+        return std::malloc(size == 0 ? 1 : size);
+    }
+
+    /**
+     * Free and count a block of memory.
+     *
+     * @param p the block (may be NULL)
+     */
+    inline void CountedFree(void* p)
+    {
+        if (p)
+        {
+            gNumDeallocations.fetch_add(1, std::memory_order_relaxed);
+            std::free(p);
+        }
+    }
+}
+
+void* operator new(std::size_t size)
+{
+    void* p = CountedAllocate(size);
+    if (!p)
+    {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return CountedAllocate(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    CountedFree(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    CountedFree(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    CountedFree(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    CountedFree(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept
+{
+    CountedFree(p);
+}
+
+void operator delete[](void* p, std::size_t) noexcept
+{
+    CountedFree(p);
+}
+
+bool MammaryAllocationCounter::IsEnabled()
+{
+    return true;
+}
+
+uint64_t MammaryAllocationCounter::GetNumAllocations()
+{
+    return gNumAllocations.load(std::memory_order_relaxed);
+}
+
+uint64_t MammaryAllocationCounter::GetNumBytesAllocated()
+{
+    return gNumBytesAllocated.load(std::memory_order_relaxed);
+}
+
+uint64_t MammaryAllocationCounter::GetNumDeallocations()
+{
+    return gNumDeallocations.load(std::memory_order_relaxed);
+}
+
+uint64_t MammaryAllocationCounter::GetNumThreadAllocations()
+{
+    return tNumAllocations;
+}
+
+uint64_t MammaryAllocationCounter::GetNumThreadBytesAllocated()
+{
+    return tNumBytesAllocated;
+}
+
+#else
+
+bool MammaryAllocationCounter::IsEnabled()
+{
+    return false;
+}
+
+uint64_t MammaryAllocationCounter::GetNumAllocations()
+{
+    return 0;
+}
+
+uint64_t MammaryAllocationCounter::GetNumBytesAllocated()
+{
+    return 0;
+}
+
+uint64_t MammaryAllocationCounter::GetNumDeallocations()
+{
+    return 0;
+}
+
+uint64_t MammaryAllocationCounter::GetNumThreadAllocations()
+{
+    return 0;
+}
+
+uint64_t MammaryAllocationCounter::GetNumThreadBytesAllocated()
+{
+    return 0;
+}
+
+#endif // MAMMARY_ALLOCATION_COUNTING
@@ -0,0 +1,51 @@
+#ifndef MAMMARYALLOCATIONCOUNTER_HPP_
+#define MAMMARYALLOCATIONCOUNTER_HPP_
+
+#include <stdint.h>
+
+/**
+ * Counts of the heap allocations made through operator new, kept by a replacement of the
+ * global operator new (in MammaryAllocationCounter.cpp) that is only compiled in when
+ * MAMMARY_ALLOCATION_COUNTING is defined. Otherwise all counts are 0.
+ *
+ * The counts are kept both for the whole process and for the calling thread, so that
+ * MammaryProfiler can attribute the allocations made in each phase of the simulation step
+ * without counting those of other threads (e.g. the writer thread of
+ * AsynchronousOutputModifier). Allocations made by C code with malloc() are not counted.
+ */
+class MammaryAllocationCounter
+{
+public:
+
+    /**
+     * @return whether allocations are being counted, i.e. whether MAMMARY_ALLOCATION_COUNTING was defined
+     */
+    static bool IsEnabled();
+
+    /**
+     * @return the number of allocations made by the process
+     */
+    static uint64_t GetNumAllocations();
+
+    /**
+     * @return the number of bytes allocated by the process (not net of deallocations)
+     */
+    static uint64_t GetNumBytesAllocated();
+
+    /**
+     * @return the number of deallocations made by the process
+     */
+    static uint64_t GetNumDeallocations();
+
+    /**
+     * @return the number of allocations made by the calling thread
+     */
+    static uint64_t GetNumThreadAllocations();
+
+    /**
+     * @return the number of bytes allocated by the calling thread
+     */
+    static uint64_t GetNumThreadBytesAllocated();
+};
+
+#endif /*MAMMARYALLOCATIONCOUNTER_HPP_*/
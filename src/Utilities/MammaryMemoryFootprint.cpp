@@ -0,0 +1,257 @@
+#include "MammaryMemoryFootprint.hpp"
+#include <fstream>
+#include <list>
+#include <map>
+#include <set>
+#include <sys/resource.h>
+#include <unistd.h>
+
+#include "AbstractCentreBasedCellPopulation.hpp"
+#include "CellData.hpp"
+#include "Exception.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "NullSrnModel.hpp"
+#include "CellDataColumns.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "SubstrateDependentCellCycleModel.hpp"
+#include "ObjectPool.hpp"
+
+/** The bookkeeping held by each node of a std::map or std::set (colour and three pointers), in bytes. */
+static const std::size_t TREE_NODE_OVERHEAD = 4*sizeof(void*);
+
+/** The bookkeeping held by each node of a std::list (two pointers), in bytes. */
+static const std::size_t LIST_NODE_OVERHEAD = 2*sizeof(void*);
+
+/** The size of the control block of a boost::shared_ptr created from a raw pointer, in bytes. */
+static const std::size_t SHARED_PTR_CONTROL_BLOCK = 2*sizeof(void*) + 2*sizeof(int);
+
+template<unsigned DIM>
+MammaryMemoryFootprint<DIM>::MammaryMemoryFootprint()
+    : mNumCells(0)
+{
+    for (unsigned i=0; i<NUM_MEMORY_SUBSYSTEMS; i++)
+    {
+        mNumBytes[i] = 0;
+    }
+}
+
+template<unsigned DIM>
+void MammaryMemoryFootprint<DIM>::Calculate(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::size_t numWriterBufferBytes)
+{
+    for (unsigned i=0; i<NUM_MEMORY_SUBSYSTEMS; i++)
+    {
+        mNumBytes[i] = 0;
+    }
+    mNumCells = 0;
+
+    unsigned num_mammary_models = 0;
+    unsigned num_substrate_models = 0;
+    for (typename AbstractCellPopulation<DIM,DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        mNumCells++;
+
+        /*
+         * The cell and its control block, its entry in the population's list of cells,
+         * its entry in the cell-to-location map, and its entry in the set of cells at its
+         * location (assuming one cell per location, as in centre-based populations)
+         */
+        mNumBytes[CELL_MEMORY] += sizeof(Cell) + SHARED_PTR_CONTROL_BLOCK
+                                  + LIST_NODE_OVERHEAD + sizeof(CellPtr)
+                                  + TREE_NODE_OVERHEAD + sizeof(std::pair<Cell*, unsigned>)
+                                  + TREE_NODE_OVERHEAD + sizeof(std::pair<unsigned, std::set<CellPtr> >)
+                                  + TREE_NODE_OVERHEAD + sizeof(CellPtr);
+
+        // The set of property pointers, and the cell's own CellData
+        mNumBytes[PROPERTY_MEMORY] += (*cell_iter)->rGetCellPropertyCollection().GetSize()
+                                      *(TREE_NODE_OVERHEAD + sizeof(boost::shared_ptr<AbstractCellProperty>));
+        if ((*cell_iter)->rGetCellPropertyCollection().HasProperty<CellData>())
+        {
+            mNumBytes[PROPERTY_MEMORY] += sizeof(CellData) + SHARED_PTR_CONTROL_BLOCK
+                                          + (*cell_iter)->GetCellData()->GetNumItems()
+                                            *(TREE_NODE_OVERHEAD + sizeof(std::pair<std::string, double>));
+        }
+
+        // Pooled models are counted by their pool's slabs below
+        AbstractCellCycleModel* p_model = (*cell_iter)->GetCellCycleModel();
+        if (dynamic_cast<MammaryCellCycleModel*>(p_model))
+        {
+            num_mammary_models++;
+        }
+        else if (dynamic_cast<SubstrateDependentCellCycleModel*>(p_model))
+        {
+            num_substrate_models++;
+        }
+        else
+        {
+            mNumBytes[CYCLE_MODEL_MEMORY] += sizeof(AbstractCellCycleModel);
+        }
+        mNumBytes[CYCLE_MODEL_MEMORY] += (dynamic_cast<NullSrnModel*>((*cell_iter)->GetSrnModel()) != NULL)
+                                         ? sizeof(NullSrnModel) : sizeof(AbstractSrnModel);
+    }
+
+    ObjectPool<MammaryCellCycleModel>* p_mammary_pool = ObjectPool<MammaryCellCycleModel>::Instance();
+    mNumBytes[CYCLE_MODEL_MEMORY] += p_mammary_pool->IsPoolingEnabled()
+                                     ? p_mammary_pool->GetNumBytesReserved()
+                                     : num_mammary_models*sizeof(MammaryCellCycleModel);
+    ObjectPool<SubstrateDependentCellCycleModel>* p_substrate_pool = ObjectPool<SubstrateDependentCellCycleModel>::Instance();
+    mNumBytes[CYCLE_MODEL_MEMORY] += p_substrate_pool->IsPoolingEnabled()
+                                     ? p_substrate_pool->GetNumBytesReserved()
+                                     : num_substrate_models*sizeof(SubstrateDependentCellCycleModel);
+
+    // The typed cell data columns are shared by all cells of the population, so are counted once
+    boost::shared_ptr<CellDataColumns> p_columns = CellDataColumns::Get(rCellPopulation.GetCellPropertyRegistry());
+    for (unsigned handle=0; handle<p_columns->GetNumColumns(); handle++)
+    {
+        mNumBytes[PROPERTY_MEMORY] += p_columns->rGetColumn(handle).capacity()*sizeof(double);
+    }
+
+    AddNodes(rCellPopulation);
+
+    mNumBytes[WRITER_BUFFER_MEMORY] = numWriterBufferBytes;
+}
+
+template<unsigned DIM>
+void MammaryMemoryFootprint<DIM>::AddNodes(AbstractCellPopulation<DIM,DIM>& rCellPopulation)
+{
+    AbstractCentreBasedCellPopulation<DIM>* p_centre_based = dynamic_cast<AbstractCentreBasedCellPopulation<DIM>*>(&rCellPopulation);
+    if (p_centre_based == NULL)
+    {
+        return;
+    }
+
+    for (typename AbstractCellPopulation<DIM,DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        Node<DIM>* p_node = p_centre_based->GetNode(rCellPopulation.GetLocationIndexUsingCell(*cell_iter));
+        mNumBytes[NODE_MEMORY] += sizeof(Node<DIM>) + sizeof(Node<DIM>*);
+        if (p_node->HasNodeAttributes())
+        {
+            mNumBytes[NODE_MEMORY] += sizeof(NodeAttributes<DIM>)
+                                      + p_node->rGetNodeAttributes().capacity()*sizeof(double);
+            mNumBytes[NEIGHBOUR_MEMORY] += p_node->rGetNeighbours().capacity()*sizeof(unsigned);
+        }
+    }
+
+    NodeBasedCellPopulation<DIM>* p_node_based = dynamic_cast<NodeBasedCellPopulation<DIM>*>(&rCellPopulation);
+    if (p_node_based == NULL)
+    {
+        return;
+    }
+
+    mNumBytes[NEIGHBOUR_MEMORY] += p_node_based->rGetNodePairs().capacity()*sizeof(std::pair<Node<DIM>*, Node<DIM>*>);
+
+    DistributedBoxCollection<DIM>* p_box_collection = p_node_based->rGetMesh().GetBoxCollection();
+    if (p_box_collection != NULL)
+    {
+        // Box indices are global, and only the boxes owned by this process are stored here
+        for (unsigned box_index=0; box_index<p_box_collection->GetNumBoxes(); box_index++)
+        {
+            if (!p_box_collection->IsBoxOwned(box_index))
+            {
+                continue;
+            }
+            mNumBytes[NEIGHBOUR_MEMORY] += sizeof(Box<DIM>)
+                                           + p_box_collection->rGetBox(box_index).rGetNodesContained().size()
+                                             *(TREE_NODE_OVERHEAD + sizeof(Node<DIM>*))
+                                           + sizeof(std::set<unsigned>)
+                                           + p_box_collection->rGetLocalBoxes(box_index).size()
+                                             *(TREE_NODE_OVERHEAD + sizeof(unsigned));
+        }
+    }
+}
+
+template<unsigned DIM>
+unsigned MammaryMemoryFootprint<DIM>::GetNumCells() const
+{
+    return mNumCells;
+}
+
+template<unsigned DIM>
+std::size_t MammaryMemoryFootprint<DIM>::GetNumBytes(MammaryMemorySubsystem subsystem) const
+{
+    assert(subsystem < NUM_MEMORY_SUBSYSTEMS);
+    return mNumBytes[subsystem];
+}
+
+template<unsigned DIM>
+std::size_t MammaryMemoryFootprint<DIM>::GetTotalNumBytes() const
+{
+    std::size_t num_bytes = 0;
+    for (unsigned i=0; i<NUM_MEMORY_SUBSYSTEMS; i++)
+    {
+        num_bytes += mNumBytes[i];
+    }
+    return num_bytes;
+}
+
+template<unsigned DIM>
+double MammaryMemoryFootprint<DIM>::GetNumBytesPerCell() const
+{
+    if (mNumCells == 0)
+    {
+        return 0.0;
+    }
+    return double(GetTotalNumBytes() - mNumBytes[WRITER_BUFFER_MEMORY])/double(mNumCells);
+}
+
+template<unsigned DIM>
+std::string MammaryMemoryFootprint<DIM>::GetSubsystemName(MammaryMemorySubsystem subsystem)
+{
+    switch (subsystem)
+    {
+        case NODE_MEMORY:
+            return "nodes";
+        case CELL_MEMORY:
+            return "cells";
+        case PROPERTY_MEMORY:
+            return "properties";
+        case CYCLE_MODEL_MEMORY:
+            return "cycle_models";
+        case NEIGHBOUR_MEMORY:
+            return "neighbours";
+        case WRITER_BUFFER_MEMORY:
+            return "writer_buffers";
+        default:
+            NEVER_REACHED;
+    }
+    return "";
+}
+
+template<unsigned DIM>
+std::size_t MammaryMemoryFootprint<DIM>::GetResidentSetSize()
+{
+    // The second field of statm is the number of resident pages
+    std::ifstream statm("/proc/self/statm");
+    std::size_t num_pages = 0;
+    std::size_t num_resident_pages = 0;
+    if (!(statm >> num_pages >> num_resident_pages))
+    {
+        return 0;
+    }
+    return num_resident_pages*static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+}
+
+template<unsigned DIM>
+std::size_t MammaryMemoryFootprint<DIM>::GetPeakResidentSetSize()
+{
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+    {
+        return 0;
+    }
+#ifdef __APPLE__
+    // Reported in bytes on macOS
+    return static_cast<std::size_t>(usage.ru_maxrss);
+#else
+    // Reported in kilobytes on Linux
+    return static_cast<std::size_t>(usage.ru_maxrss)*1024;
+#endif
+}
+
+// Explicit instantiation
+template class MammaryMemoryFootprint<1>;
+template class MammaryMemoryFootprint<2>;
+template class MammaryMemoryFootprint<3>;
@@ -0,0 +1,112 @@
+#ifndef MAMMARYMEMORYFOOTPRINT_HPP_
+#define MAMMARYMEMORYFOOTPRINT_HPP_
+
+#include <cstddef>
+#include <string>
+#include "AbstractCellPopulation.hpp"
+
+/**
+ * The subsystems whose memory is accounted for by MammaryMemoryFootprint.
+ */
+typedef enum MammaryMemorySubsystem_
+{
+    NODE_MEMORY = 0,
+    CELL_MEMORY = 1,
+    PROPERTY_MEMORY = 2,
+    CYCLE_MODEL_MEMORY = 3,
+    NEIGHBOUR_MEMORY = 4,
+    WRITER_BUFFER_MEMORY = 5,
+    NUM_MEMORY_SUBSYSTEMS = 6
+} MammaryMemorySubsystem;
+
+/**
+ * Estimates the memory held by each subsystem of a cell population, together with the
+ * current and peak resident set size of the process.
+ *
+ * The estimates are built from the sizes of the objects and the capacities of the
+ * containers that hold them, with a fixed overhead for each node of a std::map, std::set
+ * or std::list, so they count what the population has asked the allocator for rather
+ * than what the allocator has taken from the system. The subsystems are:
+ *  - nodes: each cell's Node and its NodeAttributes (centre-based populations only);
+ *  - cells: each Cell, its shared_ptr and its entries in the population's containers;
+ *  - properties: each cell's CellPropertyCollection and CellData, and the CellDataColumns;
+ *  - cycle models: each cell's cell-cycle and SRN models, or the pool's slabs for the
+ *    models allocated from an ObjectPool;
+ *  - neighbours: the node pairs, each node's neighbour list and the box collection
+ *    (NodeBasedCellPopulation only);
+ *  - writer buffers: as given to Calculate(), e.g. by AsynchronousOutputModifier.
+ *
+ * Properties shared between cells through the CellPropertyRegistry are not counted.
+ */
+template<unsigned DIM>
+class MammaryMemoryFootprint
+{
+private:
+
+    /** The number of cells at the last call to Calculate(). */
+    unsigned mNumCells;
+
+    /** The number of bytes held by each subsystem at the last call to Calculate(). */
+    std::size_t mNumBytes[NUM_MEMORY_SUBSYSTEMS];
+
+    /**
+     * Add the nodes and neighbour structures of a population.
+     *
+     * @param rCellPopulation reference to the cell population
+     */
+    void AddNodes(AbstractCellPopulation<DIM,DIM>& rCellPopulation);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    MammaryMemoryFootprint();
+
+    /**
+     * Estimate the memory held by each subsystem.
+     *
+     * @param rCellPopulation reference to the cell population
+     * @param numWriterBufferBytes the number of bytes held by writer buffers (defaults to 0)
+     */
+    void Calculate(AbstractCellPopulation<DIM,DIM>& rCellPopulation, std::size_t numWriterBufferBytes=0);
+
+    /**
+     * @return the number of cells at the last call to Calculate()
+     */
+    unsigned GetNumCells() const;
+
+    /**
+     * @param subsystem a subsystem
+     * @return the number of bytes held by the subsystem
+     */
+    std::size_t GetNumBytes(MammaryMemorySubsystem subsystem) const;
+
+    /**
+     * @return the number of bytes held by all subsystems
+     */
+    std::size_t GetTotalNumBytes() const;
+
+    /**
+     * @return the number of bytes held by all subsystems other than the writer buffers, per cell
+     */
+    double GetNumBytesPerCell() const;
+
+    /**
+     * @param subsystem a subsystem
+     * @return the name of the subsystem (e.g. "cycle_models")
+     */
+    static std::string GetSubsystemName(MammaryMemorySubsystem subsystem);
+
+    /**
+     * @return the current resident set size of the process, in bytes, or 0 if it is not known
+     */
+    static std::size_t GetResidentSetSize();
+
+    /**
+     * @return the peak resident set size of the process, in bytes, or 0 if it is not known
+     */
+    static std::size_t GetPeakResidentSetSize();
+};
+
+#endif /*MAMMARYMEMORYFOOTPRINT_HPP_*/
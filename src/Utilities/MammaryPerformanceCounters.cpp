@@ -0,0 +1,167 @@
+#include "MammaryPerformanceCounters.hpp"
+#include <cstring>
+
+#ifdef __linux__
+#include <unistd.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <linux/perf_event.h>
+#endif
+
+MammaryPerformanceCounters::MammaryPerformanceCounters()
+    : mGroupFd(-1),
+      mNumEvents(0)
+{
+    for (unsigned counter=0; counter<NUM_PERFORMANCE_COUNTERS; counter++)
+    {
+        mFds[counter] = -1;
+        mGroupPositions[counter] = -1;
+    }
+
+#ifdef __linux__
+    const uint32_t types[NUM_PERFORMANCE_COUNTERS] = {PERF_TYPE_HARDWARE,
+                                                      PERF_TYPE_HARDWARE,
+                                                      PERF_TYPE_HW_CACHE,
+                                                      PERF_TYPE_HARDWARE,
+                                                      PERF_TYPE_HARDWARE};
+    const uint64_t configs[NUM_PERFORMANCE_COUNTERS] = {PERF_COUNT_HW_CPU_CYCLES,
+                                                        PERF_COUNT_HW_INSTRUCTIONS,
+                                                        PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16),
+                                                        PERF_COUNT_HW_CACHE_MISSES,
+                                                        PERF_COUNT_HW_BRANCH_MISSES};
+
+    for (unsigned counter=0; counter<NUM_PERFORMANCE_COUNTERS; counter++)
+    {
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = types[counter];
+        attr.config = configs[counter];
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        // The leader starts disabled, so that the whole group is enabled at once
+        attr.disabled = (mGroupFd == -1) ? 1 : 0;
+
+        int fd = static_cast<int>(syscall(__NR_perf_event_open, &attr, 0, -1, mGroupFd, 0));
+        if (fd != -1)
+        {
+            if (mGroupFd == -1)
+            {
+                mGroupFd = fd;
+            }
+            mFds[counter] = fd;
+            mGroupPositions[counter] = mNumEvents;
+            mNumEvents++;
+        }
+    }
+
+    if (mGroupFd != -1)
+    {
+        ioctl(mGroupFd, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+        ioctl(mGroupFd, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    }
+#endif
+}
+
+MammaryPerformanceCounters::~MammaryPerformanceCounters()
+{
+#ifdef __linux__
+    // Members are closed before the leader
+    for (int counter=NUM_PERFORMANCE_COUNTERS-1; counter>=0; counter--)
+    {
+        if (mFds[counter] != -1)
+        {
+            close(mFds[counter]);
+        }
+    }
+#endif
+}
+
+bool MammaryPerformanceCounters::IsAvailable(unsigned counter) const
+{
+    return mGroupPositions[counter] != -1;
+}
+
+bool MammaryPerformanceCounters::IsAnyAvailable() const
+{
+    return mNumEvents > 0;
+}
+
+const char* MammaryPerformanceCounters::GetName(unsigned counter)
+{
+    static const char* names[NUM_PERFORMANCE_COUNTERS] = {"cycles",
+                                                           "instructions",
+                                                           "l1d_misses",
+                                                           "llc_misses",
+                                                           "branch_misses"};
+    return names[counter];
+}
+
+void MammaryPerformanceCounters::Read(MammaryPerformanceCounterReading& rReading) const
+{
+    for (unsigned counter=0; counter<NUM_PERFORMANCE_COUNTERS; counter++)
+    {
+        rReading.mCounts[counter] = 0;
+    }
+    rReading.mTimeEnabled = 0;
+    rReading.mTimeRunning = 0;
+    rReading.mIsValid = false;
+
+#ifdef __linux__
+    if (mGroupFd == -1)
+    {
+        return;
+    }
+
+    // The group is read as the number of events, the times enabled and running, then the counts
+    uint64_t buffer[3 + NUM_PERFORMANCE_COUNTERS];
+    ssize_t size = read(mGroupFd, buffer, (3 + mNumEvents)*sizeof(uint64_t));
+    if (size != static_cast<ssize_t>((3 + mNumEvents)*sizeof(uint64_t)))
+    {
+        return;
+    }
+
+    rReading.mTimeEnabled = buffer[1];
+    rReading.mTimeRunning = buffer[2];
+    for (unsigned counter=0; counter<NUM_PERFORMANCE_COUNTERS; counter++)
+    {
+        if (mGroupPositions[counter] != -1)
+        {
+            rReading.mCounts[counter] = buffer[3 + mGroupPositions[counter]];
+        }
+    }
+    rReading.mIsValid = true;
+#endif
+}
+
+bool MammaryPerformanceCounters::GetCountsBetween(const MammaryPerformanceCounterReading& rStart,
+                                                  const MammaryPerformanceCounterReading& rEnd,
+                                                  uint64_t counts[NUM_PERFORMANCE_COUNTERS])
+{
+    if (!rStart.mIsValid || !rEnd.mIsValid || rEnd.mTimeRunning <= rStart.mTimeRunning || rEnd.mTimeEnabled < rStart.mTimeEnabled)
+    {
+        return false;
+    }
+
+    // Raw counts only ever increase, so a decrease means that one of the reads is not to be trusted
+    for (unsigned counter=0; counter<NUM_PERFORMANCE_COUNTERS; counter++)
+    {
+        if (rEnd.mCounts[counter] < rStart.mCounts[counter])
+        {
+            return false;
+        }
+    }
+
+    // Scale up for the part of the interval that the group was multiplexed off the counters
+    uint64_t time_enabled = rEnd.mTimeEnabled - rStart.mTimeEnabled;
+    uint64_t time_running = rEnd.mTimeRunning - rStart.mTimeRunning;
+    double scale = static_cast<double>(time_enabled)/static_cast<double>(time_running);
+    for (unsigned counter=0; counter<NUM_PERFORMANCE_COUNTERS; counter++)
+    {
+        uint64_t count = rEnd.mCounts[counter] - rStart.mCounts[counter];
+        counts[counter] = (time_enabled == time_running) ? count : static_cast<uint64_t>(count*scale);
+    }
+    return true;
+}
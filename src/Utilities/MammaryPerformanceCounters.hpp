@@ -0,0 +1,122 @@
+#ifndef MAMMARYPERFORMANCECOUNTERS_HPP_
+#define MAMMARYPERFORMANCECOUNTERS_HPP_
+
+#include <stdint.h>
+
+/**
+ * The hardware events counted by MammaryPerformanceCounters.
+ */
+typedef enum MammaryPerformanceCounter_
+{
+    CYCLES_COUNTER = 0,
+    INSTRUCTIONS_COUNTER = 1,
+    L1D_MISSES_COUNTER = 2,
+    LLC_MISSES_COUNTER = 3,
+    BRANCH_MISSES_COUNTER = 4,
+    NUM_PERFORMANCE_COUNTERS = 5
+} MammaryPerformanceCounter;
+
+/**
+ * One reading of MammaryPerformanceCounters: the raw count of each event, and the times for
+ * which the group had been enabled and running, from which the counts over an interval
+ * can be scaled for multiplexing (see MammaryPerformanceCounters::GetCountsBetween()).
+ */
+struct MammaryPerformanceCounterReading
+{
+    /** The raw count of each event (0 for those unavailable). */
+    uint64_t mCounts[NUM_PERFORMANCE_COUNTERS];
+
+    /** The time for which the group had been enabled, in nanoseconds. */
+    uint64_t mTimeEnabled;
+
+    /** The time for which the group had been running on the counters, in nanoseconds. */
+    uint64_t mTimeRunning;
+
+    /** Whether the counters were read successfully. */
+    bool mIsValid;
+};
+
+/**
+ * Hardware performance counters of the calling thread, read through the Linux
+ * perf_event_open() interface: CPU cycles, instructions retired, L1 data cache read
+ * misses, last-level cache misses and mispredicted branches. Only user-space events are
+ * counted, so this works at the default perf_event_paranoid level of 2.
+ *
+ * The events are opened as one group, so that they are counted over the same intervals.
+ * Readings hold raw counts, and the counts over an interval are scaled up by the ratio of
+ * the time enabled to the time running over that interval, if the kernel multiplexed the
+ * group with other users of the counters during it. Events that the CPU (or a virtual machine) does not provide are left
+ * unavailable and read as 0; on other platforms, or where perf events are not
+ * permitted, none are available.
+ *
+ * Counts cover the thread that constructed this object only; work in other threads (such
+ * as the writer thread of AsynchronousOutputModifier) is not counted.
+ */
+class MammaryPerformanceCounters
+{
+private:
+
+    /** The file descriptor of each event, or -1 if it is unavailable. */
+    int mFds[NUM_PERFORMANCE_COUNTERS];
+
+    /** The file descriptor of the group leader, or -1 if no event is available. */
+    int mGroupFd;
+
+    /** The position of each event in the values read from the group, or -1 if it is unavailable. */
+    int mGroupPositions[NUM_PERFORMANCE_COUNTERS];
+
+    /** The number of events in the group. */
+    unsigned mNumEvents;
+
+public:
+
+    /**
+     * Constructor, which opens the events and starts counting.
+     */
+    MammaryPerformanceCounters();
+
+    /**
+     * Destructor, which closes the events.
+     */
+    ~MammaryPerformanceCounters();
+
+    /**
+     * @param counter a MammaryPerformanceCounter
+     * @return whether the event is being counted
+     */
+    bool IsAvailable(unsigned counter) const;
+
+    /**
+     * @return whether any event is being counted
+     */
+    bool IsAnyAvailable() const;
+
+    /**
+     * @param counter a MammaryPerformanceCounter
+     * @return the name of the event (e.g. "l1d_misses")
+     */
+    static const char* GetName(unsigned counter);
+
+    /**
+     * Read the raw counts, and the times enabled and running, since construction.
+     *
+     * @param rReading filled in with the reading (with mIsValid false if the read failed)
+     */
+    void Read(MammaryPerformanceCounterReading& rReading) const;
+
+    /**
+     * Get the counts between two readings, scaled up for the time in between that the group
+     * was multiplexed off the counters.
+     *
+     * @param rStart the reading at the start of the interval
+     * @param rEnd the reading at the end of the interval
+     * @param counts filled in with the count of each event over the interval
+     * @return false, leaving counts unset, if either read failed or the group did not run
+     *     at all over the interval, so that the counts cannot be estimated
+     */
+    static bool GetCountsBetween(const MammaryPerformanceCounterReading& rStart,
+                                 const MammaryPerformanceCounterReading& rEnd,
+                                 uint64_t counts[NUM_PERFORMANCE_COUNTERS]);
+};
+
+#endif /*MAMMARYPERFORMANCECOUNTERS_HPP_*/
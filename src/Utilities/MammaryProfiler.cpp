@@ -0,0 +1,346 @@
+#include "MammaryProfiler.hpp"
+#include <algorithm>
+#include <climits>
+#include <cmath>
+#include <iomanip>
+
+#include "OutputFileHandler.hpp"
+
+/** Pointer to the single instance. */
+MammaryProfiler* MammaryProfiler::mpInstance = NULL;
+
+MammaryProfiler::MammaryProfiler()
+    : mStepIsOpen(false),
+      mNumSteps(0),
+      mStepPhase(0),
+      mpCounters(NULL),
+      mStepStartNumAllocations(0),
+      mStepStartNumBytesAllocated(0)
+{
+    mStepPhase = RegisterPhase("step");
+}
+
+MammaryProfiler* MammaryProfiler::Instance()
+{
+    if (mpInstance == NULL)
+    {
+        mpInstance = new MammaryProfiler;
+    }
+    return mpInstance;
+}
+
+unsigned MammaryProfiler::RegisterPhase(const std::string& rName)
+{
+    std::map<std::string, unsigned>::iterator it = mPhaseIndices.find(rName);
+    if (it != mPhaseIndices.end())
+    {
+        return it->second;
+    }
+
+    Phase phase;
+    phase.mName = rName;
+    phase.mStepTime = 0.0;
+    phase.mStepNumCalls = 0;
+    phase.mTotalTime = 0.0;
+    phase.mNumCalls = 0;
+    phase.mNumAllocations = 0;
+    phase.mNumBytesAllocated = 0;
+    for (unsigned counter=0; counter<NUM_PERFORMANCE_COUNTERS; counter++)
+    {
+        phase.mStepCounts[counter] = 0;
+        phase.mTotalCounts[counter] = 0;
+    }
+
+    unsigned index = mPhases.size();
+    mPhases.push_back(phase);
+    mPhaseIndices[rName] = index;
+    return index;
+}
+
+bool MammaryProfiler::EnableCounters()
+{
+    if (mpCounters == NULL)
+    {
+        mpCounters = new MammaryPerformanceCounters;
+        if (!mpCounters->IsAnyAvailable())
+        {
+            delete mpCounters;
+            mpCounters = NULL;
+        }
+    }
+    return mpCounters != NULL;
+}
+
+void MammaryProfiler::AddCounts(unsigned phase,
+                                const MammaryPerformanceCounterReading& rStart,
+                                const MammaryPerformanceCounterReading& rEnd)
+{
+    uint64_t counts[NUM_PERFORMANCE_COUNTERS];
+    if (!MammaryPerformanceCounters::GetCountsBetween(rStart, rEnd, counts))
+    {
+        return;
+    }
+    for (unsigned counter=0; counter<NUM_PERFORMANCE_COUNTERS; counter++)
+    {
+        mPhases[phase].mStepCounts[counter] += counts[counter];
+    }
+}
+
+void MammaryProfiler::CloseStep()
+{
+    if (mStepIsOpen)
+    {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mStepStart;
+        AddTime(mStepPhase, elapsed.count());
+        if (mpCounters)
+        {
+            MammaryPerformanceCounterReading reading;
+            mpCounters->Read(reading);
+            AddCounts(mStepPhase, mStepStartReading, reading);
+        }
+        AddAllocations(mStepPhase,
+                       MammaryAllocationCounter::GetNumThreadAllocations() - mStepStartNumAllocations,
+                       MammaryAllocationCounter::GetNumThreadBytesAllocated() - mStepStartNumBytesAllocated);
+        mNumSteps++;
+    }
+
+    for (unsigned i=0; i<mPhases.size(); i++)
+    {
+        Phase& r_phase = mPhases[i];
+        if (r_phase.mStepNumCalls > 0)
+        {
+            r_phase.mTotalTime += r_phase.mStepTime;
+            r_phase.mNumCalls += r_phase.mStepNumCalls;
+            if (mStepIsOpen)
+            {
+                r_phase.mStepTimes.push_back(r_phase.mStepTime);
+            }
+            r_phase.mStepTime = 0.0;
+            r_phase.mStepNumCalls = 0;
+            for (unsigned counter=0; counter<NUM_PERFORMANCE_COUNTERS; counter++)
+            {
+                r_phase.mTotalCounts[counter] += r_phase.mStepCounts[counter];
+                r_phase.mStepCounts[counter] = 0;
+            }
+        }
+    }
+    mStepIsOpen = false;
+}
+
+void MammaryProfiler::NextStep()
+{
+    CloseStep();
+    mStepIsOpen = true;
+    if (mpCounters)
+    {
+        mpCounters->Read(mStepStartReading);
+    }
+    mStepStartNumAllocations = MammaryAllocationCounter::GetNumThreadAllocations();
+    mStepStartNumBytesAllocated = MammaryAllocationCounter::GetNumThreadBytesAllocated();
+    mStepStart = std::chrono::steady_clock::now();
+}
+
+void MammaryProfiler::EndSteps()
+{
+    CloseStep();
+}
+
+void MammaryProfiler::Reset()
+{
+    for (unsigned i=0; i<mPhases.size(); i++)
+    {
+        mPhases[i].mStepTime = 0.0;
+        mPhases[i].mStepNumCalls = 0;
+        mPhases[i].mTotalTime = 0.0;
+        mPhases[i].mNumCalls = 0;
+        mPhases[i].mNumAllocations = 0;
+        mPhases[i].mNumBytesAllocated = 0;
+        mPhases[i].mStepTimes.clear();
+        for (unsigned counter=0; counter<NUM_PERFORMANCE_COUNTERS; counter++)
+        {
+            mPhases[i].mStepCounts[counter] = 0;
+            mPhases[i].mTotalCounts[counter] = 0;
+        }
+    }
+    mStepIsOpen = false;
+    mNumSteps = 0;
+}
+
+unsigned MammaryProfiler::GetNumSteps() const
+{
+    return mNumSteps;
+}
+
+double MammaryProfiler::GetTotalTime(const std::string& rName) const
+{
+    std::map<std::string, unsigned>::const_iterator it = mPhaseIndices.find(rName);
+    if (it == mPhaseIndices.end())
+    {
+        return 0.0;
+    }
+    return mPhases[it->second].mTotalTime;
+}
+
+uint64_t MammaryProfiler::GetNumTimedScopes() const
+{
+    uint64_t num_scopes = 0;
+    for (unsigned i=0; i<mPhases.size(); i++)
+    {
+        if (i != mStepPhase)
+        {
+            num_scopes += mPhases[i].mNumCalls;
+        }
+    }
+    return num_scopes;
+}
+
+unsigned MammaryProfiler::GetParent(unsigned phase) const
+{
+    std::string name = mPhases[phase].mName;
+    std::string::size_type separator = name.rfind('/');
+    while (separator != std::string::npos)
+    {
+        name.erase(separator);
+        std::map<std::string, unsigned>::const_iterator it = mPhaseIndices.find(name);
+        if (it != mPhaseIndices.end() && mPhases[it->second].mNumCalls > 0)
+        {
+            return it->second;
+        }
+        separator = name.rfind('/');
+    }
+    return UINT_MAX;
+}
+
+void MammaryProfiler::WriteReport(const std::string& rDirectory)
+{
+    CloseStep();
+
+    // Report the phases in order of name, so that each is followed by its children
+    std::vector<unsigned> order;
+    for (std::map<std::string, unsigned>::const_iterator it = mPhaseIndices.begin(); it != mPhaseIndices.end(); ++it)
+    {
+        if (mPhases[it->second].mNumCalls > 0)
+        {
+            order.push_back(it->second);
+        }
+    }
+
+    OutputFileHandler output_file_handler(rDirectory + "/", false);
+    out_stream p_csv_file = output_file_handler.OpenOutputFile("profile.csv");
+    out_stream p_json_file = output_file_handler.OpenOutputFile("profile.json");
+    *p_csv_file << std::setprecision(9);
+    *p_json_file << std::setprecision(9);
+
+    // Hardware event totals follow the times, for those events counted on this machine
+    std::vector<unsigned> counters;
+    for (unsigned counter=0; mpCounters && counter<NUM_PERFORMANCE_COUNTERS; counter++)
+    {
+        if (mpCounters->IsAvailable(counter))
+        {
+            counters.push_back(counter);
+        }
+    }
+
+    *p_csv_file << "phase,calls,steps,total_s,self_s,mean_step_s,min_step_s,max_step_s,p50_step_s,p90_step_s,p99_step_s";
+    if (MammaryAllocationCounter::IsEnabled())
+    {
+        *p_csv_file << ",allocations,allocated_bytes";
+    }
+    for (unsigned j=0; j<counters.size(); j++)
+    {
+        *p_csv_file << "," << MammaryPerformanceCounters::GetName(counters[j]);
+    }
+    *p_csv_file << "\n";
+    *p_json_file << "{\n  \"num_steps\": " << mNumSteps << ",\n  \"phases\": [";
+
+    for (unsigned i=0; i<order.size(); i++)
+    {
+        const Phase& r_phase = mPhases[order[i]];
+
+        /*
+         * The self time excludes the phases nested directly within this one, i.e. those whose nearest
+         * timed ancestor it is. Phases nested within "step" may also have run outside the steps (e.g.
+         * writers during setup), so only their times within steps are excluded from it.
+         */
+        double self_time = r_phase.mTotalTime;
+        for (unsigned j=0; j<order.size(); j++)
+        {
+            if (GetParent(order[j]) == order[i])
+            {
+                const Phase& r_child = mPhases[order[j]];
+                if (order[i] == mStepPhase)
+                {
+                    for (unsigned k=0; k<r_child.mStepTimes.size(); k++)
+                    {
+                        self_time -= r_child.mStepTimes[k];
+                    }
+                }
+                else
+                {
+                    self_time -= r_child.mTotalTime;
+                }
+            }
+        }
+
+        // Statistics over the steps in which the phase ran, with percentiles by nearest rank
+        std::vector<double> step_times = r_phase.mStepTimes;
+        std::sort(step_times.begin(), step_times.end());
+        unsigned num_steps = step_times.size();
+        double statistics[6] = {0.0, 0.0, 0.0, 0.0, 0.0, 0.0};
+        if (num_steps > 0)
+        {
+            double sum = 0.0;
+            for (unsigned j=0; j<num_steps; j++)
+            {
+                sum += step_times[j];
+            }
+            const double percentiles[3] = {0.5, 0.9, 0.99};
+            statistics[0] = sum/num_steps;
+            statistics[1] = step_times.front();
+            statistics[2] = step_times.back();
+            for (unsigned j=0; j<3; j++)
+            {
+                unsigned rank = static_cast<unsigned>(std::ceil(percentiles[j]*num_steps));
+                statistics[3+j] = step_times[std::max(rank, 1u) - 1];
+            }
+        }
+
+        *p_csv_file << r_phase.mName << "," << r_phase.mNumCalls << "," << num_steps << ","
+                    << r_phase.mTotalTime << "," << self_time;
+        for (unsigned j=0; j<6; j++)
+        {
+            *p_csv_file << "," << statistics[j];
+        }
+        if (MammaryAllocationCounter::IsEnabled())
+        {
+            *p_csv_file << "," << r_phase.mNumAllocations << "," << r_phase.mNumBytesAllocated;
+        }
+        for (unsigned j=0; j<counters.size(); j++)
+        {
+            *p_csv_file << "," << r_phase.mTotalCounts[counters[j]];
+        }
+        *p_csv_file << "\n";
+
+        *p_json_file << (i == 0 ? "\n" : ",\n")
+                     << "    {\"phase\": \"" << r_phase.mName << "\", \"calls\": " << r_phase.mNumCalls
+                     << ", \"steps\": " << num_steps << ", \"total_s\": " << r_phase.mTotalTime
+                     << ", \"self_s\": " << self_time << ", \"mean_step_s\": " << statistics[0]
+                     << ", \"min_step_s\": " << statistics[1] << ", \"max_step_s\": " << statistics[2]
+                     << ", \"p50_step_s\": " << statistics[3] << ", \"p90_step_s\": " << statistics[4]
+                     << ", \"p99_step_s\": " << statistics[5];
+        if (MammaryAllocationCounter::IsEnabled())
+        {
+            *p_json_file << ", \"allocations\": " << r_phase.mNumAllocations
+                         << ", \"allocated_bytes\": " << r_phase.mNumBytesAllocated;
+        }
+        for (unsigned j=0; j<counters.size(); j++)
+        {
+            *p_json_file << ", \"" << MammaryPerformanceCounters::GetName(counters[j]) << "\": " << r_phase.mTotalCounts[counters[j]];
+        }
+        *p_json_file << "}";
+    }
+    *p_json_file << "\n  ]\n}\n";
+
+    p_csv_file->close();
+    p_json_file->close();
+}
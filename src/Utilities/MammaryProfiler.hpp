@@ -0,0 +1,337 @@
+#ifndef MAMMARYPROFILER_HPP_
+#define MAMMARYPROFILER_HPP_
+
+#include <map>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <chrono>
+
+#include "MammaryAllocationCounter.hpp"
+#include "MammaryPerformanceCounters.hpp"
+
+/**
+ * Aggregates wall-clock time spent in named phases of the simulation step, recorded by
+ * MammaryScopedTimer (through the MAMMARY_PROFILE_SCOPE macro).
+ *
+ * Phase names are paths: "step/positions/force/LinearSpringForce" is part of
+ * "step/positions" (or of "step", were "step/positions" not timed), and the report gives
+ * each phase's time both in total and excluding the phases nested within it. The times of each phase are summed over each time step, delimited by
+ * calls to NextStep(), and the report gives the minimum, maximum and percentiles of these
+ * step totals over the steps in which the phase ran. Times recorded before the first step
+ * (e.g. during setup) count towards the totals only.
+ *
+ * Recording a time is an array update, and closing a step is a loop over the phases, so
+ * the cost of profiling is that of reading the clock twice per timed scope. Scopes are
+ * placed around whole components (a force, a modifier, a killer, a writer visiting a cell)
+ * rather than inner loops, to keep this well under 1% of the step.
+ *
+ * If EnableCounters() is called, the hardware events of MammaryPerformanceCounters are
+ * also counted in each phase. Reading the counters is a system call, so this costs about
+ * a microsecond per timed scope, and is meant for runs that measure where the misses are
+ * rather than how long the phases take.
+ *
+ * When built with MAMMARY_ALLOCATION_COUNTING, the heap allocations made by the calling
+ * thread in each phase are counted too (see MammaryAllocationCounter).
+ *
+ * MAMMARY_PROFILE_SCOPE caches the index of its phase in a static variable, so the single
+ * instance is never destroyed, and phases stay registered for the life of the process;
+ * Reset() discards the recorded times instead.
+ */
+class MammaryProfiler
+{
+private:
+
+    /** The time recorded in one phase. */
+    struct Phase
+    {
+        /** The name of the phase. */
+        std::string mName;
+
+        /** The time recorded in the current step, in seconds. */
+        double mStepTime;
+
+        /** The number of times recorded in the current step. */
+        unsigned mStepNumCalls;
+
+        /** The total time recorded, in seconds. */
+        double mTotalTime;
+
+        /** The total number of times recorded. */
+        uint64_t mNumCalls;
+
+        /** The time recorded in each step in which the phase ran, in seconds. */
+        std::vector<double> mStepTimes;
+
+        /** The hardware events counted in the current step. */
+        uint64_t mStepCounts[NUM_PERFORMANCE_COUNTERS];
+
+        /** The total hardware events counted. */
+        uint64_t mTotalCounts[NUM_PERFORMANCE_COUNTERS];
+
+        /** The total number of heap allocations made. */
+        uint64_t mNumAllocations;
+
+        /** The total number of bytes allocated. */
+        uint64_t mNumBytesAllocated;
+    };
+
+    /** Pointer to the single instance. */
+    static MammaryProfiler* mpInstance;
+
+    /** The phases, by index. */
+    std::vector<Phase> mPhases;
+
+    /** Map from phase name to index. */
+    std::map<std::string, unsigned> mPhaseIndices;
+
+    /** Whether a step has been started by NextStep() and not yet closed. */
+    bool mStepIsOpen;
+
+    /** The number of steps closed. */
+    unsigned mNumSteps;
+
+    /** The index of the "step" phase, timed from one call to NextStep() to the next. */
+    unsigned mStepPhase;
+
+    /** The time at which the open step started. */
+    std::chrono::steady_clock::time_point mStepStart;
+
+    /** The hardware performance counters, if enabled by EnableCounters(), otherwise NULL. */
+    MammaryPerformanceCounters* mpCounters;
+
+    /** The hardware event counters when the open step started. */
+    MammaryPerformanceCounterReading mStepStartReading;
+
+    /** The number of allocations made by this thread when the open step started. */
+    uint64_t mStepStartNumAllocations;
+
+    /** The number of bytes allocated by this thread when the open step started. */
+    uint64_t mStepStartNumBytesAllocated;
+
+    /**
+     * Protected constructor, as this class is a singleton.
+     */
+    MammaryProfiler();
+
+    /**
+     * Add the times recorded since the last call to the totals and, if a step is open, to the step statistics.
+     */
+    void CloseStep();
+
+    /**
+     * @param phase the index of a phase
+     * @return the index of the phase within which it is nested, i.e. its nearest ancestor in
+     *     the hierarchy of names that has recorded a time, or UINT_MAX if there is none
+     */
+    unsigned GetParent(unsigned phase) const;
+
+public:
+
+    /**
+     * @return a pointer to the single instance, which is created on first use.
+     */
+    static MammaryProfiler* Instance();
+
+    /**
+     * Register a phase, if not already registered.
+     *
+     * @param rName the name of the phase
+     * @return the index of the phase
+     */
+    unsigned RegisterPhase(const std::string& rName);
+
+    /**
+     * Record time spent in a phase.
+     *
+     * @param phase the index of the phase
+     * @param time the time, in seconds
+     */
+    inline void AddTime(unsigned phase, double time)
+    {
+        mPhases[phase].mStepTime += time;
+        mPhases[phase].mStepNumCalls++;
+    }
+
+    /**
+     * Count hardware events in each phase from now on, with MammaryPerformanceCounters.
+     *
+     * @return whether any hardware events can be counted on this machine
+     */
+    bool EnableCounters();
+
+    /**
+     * @return whether hardware events are being counted
+     */
+    inline bool IsCounting() const
+    {
+        return mpCounters != NULL;
+    }
+
+    /**
+     * Read the hardware event counters; only valid if IsCounting().
+     *
+     * @param rReading filled in with the reading
+     */
+    inline void ReadCounters(MammaryPerformanceCounterReading& rReading) const
+    {
+        mpCounters->Read(rReading);
+    }
+
+    /**
+     * Record hardware events counted in a phase. Nothing is recorded if the counts cannot
+     * be estimated (see MammaryPerformanceCounters::GetCountsBetween()).
+     *
+     * @param phase the index of the phase
+     * @param rStart the reading at the start of the phase
+     * @param rEnd the reading at the end of the phase
+     */
+    void AddCounts(unsigned phase,
+                   const MammaryPerformanceCounterReading& rStart,
+                   const MammaryPerformanceCounterReading& rEnd);
+
+    /**
+     * Record heap allocations made in a phase.
+     *
+     * @param phase the index of the phase
+     * @param numAllocations the number of allocations
+     * @param numBytes the number of bytes allocated
+     */
+    inline void AddAllocations(unsigned phase, uint64_t numAllocations, uint64_t numBytes)
+    {
+        mPhases[phase].mNumAllocations += numAllocations;
+        mPhases[phase].mNumBytesAllocated += numBytes;
+    }
+
+    /**
+     * Close the current step, if any, and start the next.
+     */
+    void NextStep();
+
+    /**
+     * Close the current step, if any, without starting another.
+     */
+    void EndSteps();
+
+    /**
+     * Discard all recorded times, keeping the registered phases.
+     */
+    void Reset();
+
+    /**
+     * @return the number of steps closed
+     */
+    unsigned GetNumSteps() const;
+
+    /**
+     * @param rName the name of a phase
+     * @return the total time recorded in the phase, in seconds (0 if it is not registered)
+     */
+    double GetTotalTime(const std::string& rName) const;
+
+    /**
+     * @return the total number of times recorded by MammaryScopedTimer in all phases (that is,
+     *     excluding the "step" phase, which is timed by NextStep()), up to the last closed step
+     */
+    uint64_t GetNumTimedScopes() const;
+
+    /**
+     * Write the report of the recorded times to profile.csv and profile.json in a directory.
+     * The current step, if any, is closed first.
+     *
+     * @param rDirectory the directory, relative to where Chaste output is stored
+     */
+    void WriteReport(const std::string& rDirectory);
+};
+
+/**
+ * Records the wall-clock time from its construction to its destruction in a phase of
+ * the MammaryProfiler.
+ */
+class MammaryScopedTimer
+{
+private:
+
+    /** The index of the phase. */
+    unsigned mPhase;
+
+    /** The time at construction. */
+    std::chrono::steady_clock::time_point mStart;
+
+    /** Whether hardware events are being counted. */
+    bool mIsCounting;
+
+    /** The hardware event counters at construction, if counted. */
+    MammaryPerformanceCounterReading mStartReading;
+
+#ifdef MAMMARY_ALLOCATION_COUNTING
+    /** The number of allocations made by this thread at construction. */
+    uint64_t mStartNumAllocations;
+
+    /** The number of bytes allocated by this thread at construction. */
+    uint64_t mStartNumBytesAllocated;
+#endif
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param phase the index of the phase, from MammaryProfiler::RegisterPhase()
+     */
+    MammaryScopedTimer(unsigned phase)
+        : mPhase(phase),
+          mIsCounting(MammaryProfiler::Instance()->IsCounting())
+    {
+        if (mIsCounting)
+        {
+            MammaryProfiler::Instance()->ReadCounters(mStartReading);
+        }
+#ifdef MAMMARY_ALLOCATION_COUNTING
+        mStartNumAllocations = MammaryAllocationCounter::GetNumThreadAllocations();
+        mStartNumBytesAllocated = MammaryAllocationCounter::GetNumThreadBytesAllocated();
+#endif
+        mStart = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * Destructor, which records the elapsed time.
+     */
+    ~MammaryScopedTimer()
+    {
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - mStart;
+        MammaryProfiler::Instance()->AddTime(mPhase, elapsed.count());
+#ifdef MAMMARY_ALLOCATION_COUNTING
+        MammaryProfiler::Instance()->AddAllocations(mPhase,
+                                                    MammaryAllocationCounter::GetNumThreadAllocations() - mStartNumAllocations,
+                                                    MammaryAllocationCounter::GetNumThreadBytesAllocated() - mStartNumBytesAllocated);
+#endif
+        if (mIsCounting)
+        {
+            MammaryPerformanceCounterReading end_reading;
+            MammaryProfiler::Instance()->ReadCounters(end_reading);
+            MammaryProfiler::Instance()->AddCounts(mPhase, mStartReading, end_reading);
+        }
+    }
+};
+
+/** Helper for MAMMARY_PROFILE_SCOPE, pasting two tokens after expanding them. */
+#define MAMMARY_PROFILE_CONCATENATE_(a, b) a##b
+/** Helper for MAMMARY_PROFILE_SCOPE, pasting two tokens after expanding them. */
+#define MAMMARY_PROFILE_CONCATENATE(a, b) MAMMARY_PROFILE_CONCATENATE_(a, b)
+
+#ifdef MAMMARY_PROFILING
+/**
+ * Time the rest of the enclosing scope in the named phase. The phase is registered on
+ * first use, so the name must be the same on every pass. Compiled out unless
+ * MAMMARY_PROFILING is defined.
+ */
+#define MAMMARY_PROFILE_SCOPE(name) \
+    static const unsigned MAMMARY_PROFILE_CONCATENATE(mammary_profile_phase_, __LINE__) = MammaryProfiler::Instance()->RegisterPhase(name); \
+    MammaryScopedTimer MAMMARY_PROFILE_CONCATENATE(mammary_profile_timer_, __LINE__)(MAMMARY_PROFILE_CONCATENATE(mammary_profile_phase_, __LINE__))
+#else
+/** Time the rest of the enclosing scope in the named phase (compiled out, as MAMMARY_PROFILING is not defined). */
+#define MAMMARY_PROFILE_SCOPE(name)
+#endif
+
+#endif /*MAMMARYPROFILER_HPP_*/
@@ -0,0 +1,57 @@
+#include "MammaryRandomStreams.hpp"
+#include <cmath>
+
+/** Pointer to the single instance. */
+MammaryRandomStreams* MammaryRandomStreams::mpInstance = NULL;
+
+MammaryRandomStreams::MammaryRandomStreams()
+    : mIsReproducible(false),
+      mSeed(0)
+{
+}
+
+MammaryRandomStreams* MammaryRandomStreams::Instance()
+{
+    if (mpInstance == NULL)
+    {
+        mpInstance = new MammaryRandomStreams;
+    }
+    return mpInstance;
+}
+
+void MammaryRandomStreams::Destroy()
+{
+    if (mpInstance)
+    {
+        delete mpInstance;
+        mpInstance = NULL;
+    }
+}
+
+bool MammaryRandomStreams::IsReproducible() const
+{
+    return mIsReproducible;
+}
+
+void MammaryRandomStreams::SetReproducible(bool isReproducible)
+{
+    mIsReproducible = isReproducible;
+}
+
+unsigned MammaryRandomStreams::GetSeed() const
+{
+    return mSeed;
+}
+
+void MammaryRandomStreams::SetSeed(unsigned seed)
+{
+    mSeed = seed;
+}
+
+double MammaryRandomStreams::StandardNormalRandomDeviate(uint64_t stream, MammaryRandomEvent event, uint64_t counter, unsigned index) const
+{
+    // Take 1-u so that the argument of the logarithm is in (0, 1]
+    double u1 = 1.0 - ranf(stream, event, counter, 2*index);
+    double u2 = ranf(stream, event, counter, 2*index + 1);
+    return sqrt(-2.0*log(u1))*cos(2.0*M_PI*u2);
+}
@@ -0,0 +1,129 @@
+#ifndef MAMMARYRANDOMSTREAMS_HPP_
+#define MAMMARYRANDOMSTREAMS_HPP_
+
+#include <stdint.h>
+#include "CounterBasedRandomNumberGenerator.hpp"
+
+/**
+ * The random events of a simulation, each of which draws from its own streams in
+ * reproducible mode.
+ */
+typedef enum MammaryRandomEvent_
+{
+    RANDOM_MOTION_EVENT = 0,
+    ANOIKIS_EVENT = 1,
+    CELL_CYCLE_DURATION_EVENT = 2,
+    DIVISION_ORIENTATION_EVENT = 3,
+    PERTURBATION_EVENT = 4
+} MammaryRandomEvent;
+
+/**
+ * A switch for a bitwise-reproducible mode of simulation, and the keyed random streams
+ * that it uses.
+ *
+ * By default, RandomMotionForce, MammaryCellCycleModel and OrientedDivisionRule draw from
+ * the RandomNumberGenerator singleton in the order in which cells or nodes are visited, as
+ * does PerturbationSchedulerModifier for each event that targets a fraction of cells,
+ * and two-body forces are summed in the order of the population's node pairs, so results
+ * change with the order of the nodes and could not be shared between threads. In
+ * reproducible mode, every draw is instead a hash (see CounterBasedRandomNumberGenerator)
+ * of the seed, the cell ID, the event, the number of time steps elapsed and the index of
+ * the draw, and the two-body forces on each node are summed in the order of the cell IDs
+ * of its neighbours (see MammaryFixedOrderForceSum). Results then depend only on the seed
+ * and the cell IDs, which are assigned in the fixed order of the division queue of
+ * MammaryOffLatticeSimulation, and not on the order of the nodes or the number of threads.
+ *
+ * Nodes without cells (e.g. particles) are keyed by their index, which does not change.
+ *
+ * Since this class is a singleton, the mode and seed apply to the whole process, and
+ * should be set before the cell population is created.
+ */
+class MammaryRandomStreams
+{
+private:
+
+    /** Pointer to the single instance. */
+    static MammaryRandomStreams* mpInstance;
+
+    /** Whether reproducible mode is on. Defaults to false. */
+    bool mIsReproducible;
+
+    /** The seed of the streams. Defaults to 0. */
+    unsigned mSeed;
+
+    /**
+     * Protected constructor, as this class is a singleton.
+     */
+    MammaryRandomStreams();
+
+public:
+
+    /**
+     * @return the single instance of this class, creating it if necessary
+     */
+    static MammaryRandomStreams* Instance();
+
+    /**
+     * Destroy the single instance of this class.
+     */
+    static void Destroy();
+
+    /**
+     * @return mIsReproducible
+     */
+    bool IsReproducible() const;
+
+    /**
+     * Set mIsReproducible.
+     *
+     * @param isReproducible whether to use reproducible mode
+     */
+    void SetReproducible(bool isReproducible);
+
+    /**
+     * @return mSeed
+     */
+    unsigned GetSeed() const;
+
+    /**
+     * Set mSeed.
+     *
+     * @param seed the seed of the streams
+     */
+    void SetSeed(unsigned seed);
+
+    /**
+     * @param nodeIndex the index of a node without a cell
+     * @return the stream of the node, distinct from those of all cells
+     */
+    static inline uint64_t GetNodeStream(unsigned nodeIndex)
+    {
+        return (uint64_t(1) << 32) | nodeIndex;
+    }
+
+    /**
+     * @param stream the stream, usually a cell ID (or see GetNodeStream())
+     * @param event the event
+     * @param counter the counter, usually the number of time steps elapsed
+     * @param index distinguishes several draws for the same stream, event and counter
+     * @return a uniformly distributed random number in [0, 1)
+     */
+    inline double ranf(uint64_t stream, MammaryRandomEvent event, uint64_t counter, unsigned index=0) const
+    {
+        return CounterBasedRandomNumberGenerator::ranf(mSeed, stream, counter, (uint64_t(event) << 32) | index);
+    }
+
+    /**
+     * Draw a standard normal random deviate by the Box-Muller transform, using the draws
+     * 2*index and 2*index+1 of ranf().
+     *
+     * @param stream the stream, usually a cell ID (or see GetNodeStream())
+     * @param event the event
+     * @param counter the counter, usually the number of time steps elapsed
+     * @param index distinguishes several draws for the same stream, event and counter
+     * @return a standard normal random deviate
+     */
+    double StandardNormalRandomDeviate(uint64_t stream, MammaryRandomEvent event, uint64_t counter, unsigned index=0) const;
+};
+
+#endif /*MAMMARYRANDOMSTREAMS_HPP_*/
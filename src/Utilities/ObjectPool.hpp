@@ -0,0 +1,271 @@
+#ifndef OBJECTPOOL_HPP_
+#define OBJECTPOOL_HPP_
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+#include "Exception.hpp"
+
+/**
+ * A slab allocator for objects of a single class, used through class-specific
+ * operator new/delete so that objects which are created and destroyed at a high
+ * rate (e.g. cell-cycle models on every division and anoikis event) are carved
+ * out of large contiguous slabs rather than individual heap allocations.
+ *
+ * Freed slots are kept on an intrusive free list and are recycled before any new
+ * slab is requested, so in a steady birth/death regime the heap is not touched at
+ * all. Slabs are never returned to the heap: the pool is deliberately leaked so that
+ * objects destroyed during static destruction at program exit are still safe.
+ *
+ * Requests whose size differs from sizeof(T), i.e. allocations of a subclass of T
+ * that does not define its own operator new, are forwarded to the global heap.
+ *
+ * The pool also counts allocations so that the benefit can be measured; pooling
+ * can be switched off (while no pooled objects are alive) to compare against
+ * plain heap allocation.
+ */
+template<class T>
+class ObjectPool
+{
+private:
+
+    /** Singly-linked free list node, overlaid on a free slot. */
+    struct FreeSlot
+    {
+        /** The next free slot. */
+        FreeSlot* mpNext;
+    };
+
+    /** The size in bytes of each slot, rounded up to preserve alignment. */
+    std::size_t mSlotSize;
+
+    /** The number of slots carved out of each slab. */
+    unsigned mObjectsPerSlab;
+
+    /** The slabs owned by this pool. */
+    std::vector<char*> mSlabs;
+
+    /** Head of the free list. */
+    FreeSlot* mpFreeList;
+
+    /** Whether allocations are served from the pool (true) or the global heap (false). */
+    bool mPoolingEnabled;
+
+    /** The number of objects of exactly class T currently alive, whether pooled or not. */
+    unsigned mNumLiveObjects;
+
+    /** The number of bytes currently reserved in slabs. */
+    std::size_t mNumBytesReserved;
+
+    /** The largest value taken by mNumLiveObjects. */
+    unsigned mPeakNumLiveObjects;
+
+    /** The total number of objects allocated since the counters were last reset. */
+    unsigned long mNumObjectAllocations;
+
+    /** The number of calls made to the global heap since the counters were last reset. */
+    unsigned long mNumHeapAllocations;
+
+    /**
+     * Constructor is private, since this class is only accessed through Instance().
+     */
+    ObjectPool()
+        : mSlotSize(std::max(sizeof(T), sizeof(FreeSlot))),
+          mObjectsPerSlab(256),
+          mpFreeList(NULL),
+          mPoolingEnabled(true),
+          mNumLiveObjects(0),
+          mNumBytesReserved(0),
+          mPeakNumLiveObjects(0),
+          mNumObjectAllocations(0),
+          mNumHeapAllocations(0)
+    {
+        const std::size_t alignment = sizeof(double) > sizeof(void*) ? sizeof(double) : sizeof(void*);
+        mSlotSize = alignment*((mSlotSize + alignment - 1)/alignment);
+    }
+
+    /**
+     * Request a new slab from the heap and thread its slots onto the free list.
+     */
+    void AllocateSlab()
+    {
+        char* p_slab = static_cast<char*>(::operator new(mSlotSize*mObjectsPerSlab));
+        mSlabs.push_back(p_slab);
+        mNumBytesReserved += mSlotSize*mObjectsPerSlab;
+        mNumHeapAllocations++;
+
+        // Push the slots in reverse so that they are handed out in address order
+        for (unsigned i=mObjectsPerSlab; i>0; i--)
+        {
+            FreeSlot* p_slot = reinterpret_cast<FreeSlot*>(p_slab + (i-1)*mSlotSize);
+            p_slot->mpNext = mpFreeList;
+            mpFreeList = p_slot;
+        }
+    }
+
+public:
+
+    /**
+     * @return the pool for class T, created on first use.
+     */
+    static ObjectPool<T>* Instance()
+    {
+        static ObjectPool<T>* p_pool = new ObjectPool<T>;
+        return p_pool;
+    }
+
+    /**
+     * Allocate storage for one object.
+     *
+     * @param size the number of bytes requested by operator new
+     * @return pointer to uninitialised storage
+     */
+    void* Allocate(std::size_t size)
+    {
+        mNumObjectAllocations++;
+
+        if (size != sizeof(T))
+        {
+            mNumHeapAllocations++;
+            return ::operator new(size);
+        }
+
+        mNumLiveObjects++;
+        mPeakNumLiveObjects = std::max(mPeakNumLiveObjects, mNumLiveObjects);
+
+        if (!mPoolingEnabled)
+        {
+            mNumHeapAllocations++;
+            return ::operator new(size);
+        }
+
+        if (mpFreeList == NULL)
+        {
+            AllocateSlab();
+        }
+        FreeSlot* p_slot = mpFreeList;
+        mpFreeList = p_slot->mpNext;
+        return p_slot;
+    }
+
+    /**
+     * Return the storage for one object to the pool.
+     *
+     * @param pObject pointer previously returned by Allocate()
+     * @param size the number of bytes passed to Allocate()
+     */
+    void Deallocate(void* pObject, std::size_t size)
+    {
+        if (pObject == NULL)
+        {
+            return;
+        }
+        if (size != sizeof(T))
+        {
+            ::operator delete(pObject);
+            return;
+        }
+
+        assert(mNumLiveObjects > 0);
+        mNumLiveObjects--;
+
+        if (!mPoolingEnabled)
+        {
+            ::operator delete(pObject);
+            return;
+        }
+
+        FreeSlot* p_slot = static_cast<FreeSlot*>(pObject);
+        p_slot->mpNext = mpFreeList;
+        mpFreeList = p_slot;
+    }
+
+    /**
+     * Switch pooling on or off. This may only be done while no objects of class T
+     * are alive, since each object must be returned to the allocator it came from.
+     *
+     * @param poolingEnabled whether to serve allocations from the pool
+     */
+    void SetPoolingEnabled(bool poolingEnabled)
+    {
+        if (mNumLiveObjects != 0)
+        {
+            EXCEPTION("Pooling cannot be switched while objects are still alive");
+        }
+        mPoolingEnabled = poolingEnabled;
+    }
+
+    /**
+     * @return mPoolingEnabled
+     */
+    bool IsPoolingEnabled() const
+    {
+        return mPoolingEnabled;
+    }
+
+    /**
+     * Set the number of objects carved out of each new slab.
+     *
+     * @param objectsPerSlab the new value of mObjectsPerSlab
+     */
+    void SetObjectsPerSlab(unsigned objectsPerSlab)
+    {
+        assert(objectsPerSlab > 0);
+        mObjectsPerSlab = objectsPerSlab;
+    }
+
+    /**
+     * @return mNumLiveObjects
+     */
+    unsigned GetNumLiveObjects() const
+    {
+        return mNumLiveObjects;
+    }
+
+    /**
+     * @return mPeakNumLiveObjects
+     */
+    unsigned GetPeakNumLiveObjects() const
+    {
+        return mPeakNumLiveObjects;
+    }
+
+    /**
+     * @return mNumObjectAllocations
+     */
+    unsigned long GetNumObjectAllocations() const
+    {
+        return mNumObjectAllocations;
+    }
+
+    /**
+     * @return mNumHeapAllocations
+     */
+    unsigned long GetNumHeapAllocations() const
+    {
+        return mNumHeapAllocations;
+    }
+
+    /**
+     * @return mNumBytesReserved
+     */
+    std::size_t GetNumBytesReserved() const
+    {
+        return mNumBytesReserved;
+    }
+
+    /**
+     * Reset the allocation counters (but not the live object count).
+     */
+    void ResetCounters()
+    {
+        mNumObjectAllocations = 0;
+        mNumHeapAllocations = 0;
+        mPeakNumLiveObjects = mNumLiveObjects;
+    }
+};
+
+#endif /*OBJECTPOOL_HPP_*/
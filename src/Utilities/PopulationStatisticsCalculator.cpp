@@ -0,0 +1,292 @@
+#include "PopulationStatisticsCalculator.hpp"
+#include <algorithm>
+#include <cmath>
+#include <thread>
+#include "Exception.hpp"
+
+template<unsigned DIM>
+PopulationStatisticsCalculator<DIM>::PopulationStatisticsCalculator()
+    : mNumThreads(1),
+      mMinCellsPerThread(50000),
+      mRadiusPercentile(0.9),
+      mShellPercentile(0.1),
+      mCentroid(zero_vector<double>(DIM)),
+      mRadiusOfGyration(0.0),
+      mMaxRadius(0.0),
+      mPercentileRadius(0.0)
+{
+    std::fill(mNumCellsOfType, mNumCellsOfType + NO_MAMMARY_CELL_TYPE + 1, 0u);
+    std::fill(mShellInnerRadius, mShellInnerRadius + NO_LINEAGE, 0.0);
+    std::fill(mShellOuterRadius, mShellOuterRadius + NO_LINEAGE, 0.0);
+}
+
+template<unsigned DIM>
+unsigned PopulationStatisticsCalculator<DIM>::GetNumThreads() const
+{
+    return mNumThreads;
+}
+
+template<unsigned DIM>
+void PopulationStatisticsCalculator<DIM>::SetNumThreads(unsigned numThreads)
+{
+    if (numThreads == 0)
+    {
+        EXCEPTION("At least one thread is needed to calculate population statistics");
+    }
+    mNumThreads = numThreads;
+}
+
+template<unsigned DIM>
+unsigned PopulationStatisticsCalculator<DIM>::GetMinCellsPerThread() const
+{
+    return mMinCellsPerThread;
+}
+
+template<unsigned DIM>
+void PopulationStatisticsCalculator<DIM>::SetMinCellsPerThread(unsigned minCellsPerThread)
+{
+    if (minCellsPerThread == 0)
+    {
+        EXCEPTION("Each thread must be given at least one cell");
+    }
+    mMinCellsPerThread = minCellsPerThread;
+}
+
+template<unsigned DIM>
+double PopulationStatisticsCalculator<DIM>::GetRadiusPercentile() const
+{
+    return mRadiusPercentile;
+}
+
+template<unsigned DIM>
+void PopulationStatisticsCalculator<DIM>::SetRadiusPercentile(double radiusPercentile)
+{
+    if (radiusPercentile < 0.0 || radiusPercentile > 1.0)
+    {
+        EXCEPTION("The radius percentile must be between 0 and 1");
+    }
+    mRadiusPercentile = radiusPercentile;
+}
+
+template<unsigned DIM>
+double PopulationStatisticsCalculator<DIM>::GetShellPercentile() const
+{
+    return mShellPercentile;
+}
+
+template<unsigned DIM>
+void PopulationStatisticsCalculator<DIM>::SetShellPercentile(double shellPercentile)
+{
+    if (shellPercentile < 0.0 || shellPercentile > 0.5)
+    {
+        EXCEPTION("The shell percentile must be between 0 and 0.5");
+    }
+    mShellPercentile = shellPercentile;
+}
+
+template<unsigned DIM>
+void PopulationStatisticsCalculator<DIM>::Calculate(AbstractCellPopulation<DIM>& rCellPopulation)
+{
+    // Copy the positions and types into contiguous arrays, reusing their storage between calls
+    mPositions.clear();
+    mTypes.clear();
+    std::fill(mNumCellsOfType, mNumCellsOfType + NO_MAMMARY_CELL_TYPE + 1, 0u);
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        c_vector<double, DIM> location = rCellPopulation.GetLocationOfCellCentre(*cell_iter);
+        for (unsigned d=0; d<DIM; d++)
+        {
+            mPositions.push_back(location[d]);
+        }
+        MammaryCellType cell_type = MammaryCellPropertyHelper::GetMammaryCellType(*cell_iter);
+        mTypes.push_back(cell_type);
+        mNumCellsOfType[cell_type]++;
+    }
+
+    unsigned num_cells = mTypes.size();
+    mCentroid = zero_vector<double>(DIM);
+    mRadiusOfGyration = 0.0;
+    mMaxRadius = 0.0;
+    mPercentileRadius = 0.0;
+    std::fill(mShellInnerRadius, mShellInnerRadius + NO_LINEAGE, 0.0);
+    std::fill(mShellOuterRadius, mShellOuterRadius + NO_LINEAGE, 0.0);
+    mRadii.resize(num_cells);
+    if (num_cells == 0)
+    {
+        return;
+    }
+
+    double sum[DIM];
+    Reduce(&PopulationStatisticsCalculator<DIM>::SumPositions, DIM, sum);
+    for (unsigned d=0; d<DIM; d++)
+    {
+        mCentroid[d] = sum[d]/num_cells;
+    }
+
+    // The distances from the centroid are kept for the percentiles
+    double sum_of_squares;
+    Reduce(&PopulationStatisticsCalculator<DIM>::CalculateRadii, 1, &sum_of_squares);
+    mRadiusOfGyration = sqrt(sum_of_squares/num_cells);
+    mMaxRadius = *std::max_element(mRadii.begin(), mRadii.end());
+
+    mSelection = mRadii;
+    mPercentileRadius = SelectPercentile(mRadiusPercentile);
+
+    for (unsigned lineage=0; lineage<NO_LINEAGE; lineage++)
+    {
+        mSelection.clear();
+        for (unsigned i=0; i<num_cells; i++)
+        {
+            if (CellContactCalculator<DIM>::GetLineage(static_cast<MammaryCellType>(mTypes[i])) == lineage)
+            {
+                mSelection.push_back(mRadii[i]);
+            }
+        }
+        mShellInnerRadius[lineage] = SelectPercentile(mShellPercentile);
+        mShellOuterRadius[lineage] = SelectPercentile(1.0 - mShellPercentile);
+    }
+}
+
+template<unsigned DIM>
+void PopulationStatisticsCalculator<DIM>::SumPositions(unsigned begin, unsigned end, double* pSum)
+{
+    std::fill(pSum, pSum + DIM, 0.0);
+    const double* p_position = &mPositions[begin*DIM];
+    for (unsigned i=begin; i<end; i++)
+    {
+        for (unsigned d=0; d<DIM; d++)
+        {
+            pSum[d] += p_position[d];
+        }
+        p_position += DIM;
+    }
+}
+
+template<unsigned DIM>
+void PopulationStatisticsCalculator<DIM>::CalculateRadii(unsigned begin, unsigned end, double* pSum)
+{
+    *pSum = 0.0;
+    const double* p_position = &mPositions[begin*DIM];
+    for (unsigned i=begin; i<end; i++)
+    {
+        double squared_radius = 0.0;
+        for (unsigned d=0; d<DIM; d++)
+        {
+            double offset = p_position[d] - mCentroid[d];
+            squared_radius += offset*offset;
+        }
+        mRadii[i] = sqrt(squared_radius);
+        *pSum += squared_radius;
+        p_position += DIM;
+    }
+}
+
+template<unsigned DIM>
+void PopulationStatisticsCalculator<DIM>::Reduce(void (PopulationStatisticsCalculator<DIM>::*pass)(unsigned, unsigned, double*),
+                                                 unsigned numResults,
+                                                 double* pResult)
+{
+    unsigned num_cells = mTypes.size();
+    // Each pass is only a few operations per cell, so a thread is only worth starting for many cells
+    unsigned num_chunks = std::max(1u, std::min(mNumThreads, num_cells/mMinCellsPerThread));
+    std::vector<double> partial_results(num_chunks*numResults);
+
+    // The calling thread takes the first chunk
+    std::vector<std::thread> threads;
+    for (unsigned chunk=1; chunk<num_chunks; chunk++)
+    {
+        threads.push_back(std::thread(pass, this,
+                                      (chunk*num_cells)/num_chunks,
+                                      ((chunk + 1)*num_cells)/num_chunks,
+                                      &partial_results[chunk*numResults]));
+    }
+    (this->*pass)(0, num_cells/num_chunks, &partial_results[0]);
+    for (unsigned i=0; i<threads.size(); i++)
+    {
+        threads[i].join();
+    }
+
+    std::fill(pResult, pResult + numResults, 0.0);
+    for (unsigned chunk=0; chunk<num_chunks; chunk++)
+    {
+        for (unsigned i=0; i<numResults; i++)
+        {
+            pResult[i] += partial_results[chunk*numResults + i];
+        }
+    }
+}
+
+template<unsigned DIM>
+double PopulationStatisticsCalculator<DIM>::SelectPercentile(double fraction)
+{
+    if (mSelection.empty())
+    {
+        return 0.0;
+    }
+    std::vector<double>::iterator nth = mSelection.begin() + static_cast<unsigned>(fraction*(mSelection.size() - 1));
+    std::nth_element(mSelection.begin(), nth, mSelection.end());
+    return *nth;
+}
+
+template<unsigned DIM>
+unsigned PopulationStatisticsCalculator<DIM>::GetNumCells() const
+{
+    return mTypes.size();
+}
+
+template<unsigned DIM>
+unsigned PopulationStatisticsCalculator<DIM>::GetNumCellsOfType(MammaryCellType cellType) const
+{
+    return mNumCellsOfType[cellType];
+}
+
+template<unsigned DIM>
+const c_vector<double, DIM>& PopulationStatisticsCalculator<DIM>::rGetCentroid() const
+{
+    return mCentroid;
+}
+
+template<unsigned DIM>
+double PopulationStatisticsCalculator<DIM>::GetRadiusOfGyration() const
+{
+    return mRadiusOfGyration;
+}
+
+template<unsigned DIM>
+double PopulationStatisticsCalculator<DIM>::GetMaxRadius() const
+{
+    return mMaxRadius;
+}
+
+template<unsigned DIM>
+double PopulationStatisticsCalculator<DIM>::GetPercentileRadius() const
+{
+    return mPercentileRadius;
+}
+
+template<unsigned DIM>
+double PopulationStatisticsCalculator<DIM>::GetShellInnerRadius(MammaryLineage lineage) const
+{
+    assert(lineage < NO_LINEAGE);
+    return mShellInnerRadius[lineage];
+}
+
+template<unsigned DIM>
+double PopulationStatisticsCalculator<DIM>::GetShellOuterRadius(MammaryLineage lineage) const
+{
+    assert(lineage < NO_LINEAGE);
+    return mShellOuterRadius[lineage];
+}
+
+template<unsigned DIM>
+double PopulationStatisticsCalculator<DIM>::GetShellThickness(MammaryLineage lineage) const
+{
+    return GetShellOuterRadius(lineage) - GetShellInnerRadius(lineage);
+}
+
+// Explicit instantiation
+template class PopulationStatisticsCalculator<1>;
+template class PopulationStatisticsCalculator<2>;
+template class PopulationStatisticsCalculator<3>;
@@ -0,0 +1,223 @@
+#ifndef POPULATIONSTATISTICSCALCULATOR_HPP_
+#define POPULATIONSTATISTICSCALCULATOR_HPP_
+
+#include <vector>
+#include <stdint.h>
+#include "AbstractCellPopulation.hpp"
+#include "CellContactCalculator.hpp"
+
+/**
+ * Calculates summary statistics of the size and layering of an organoid: the number of
+ * cells of each mammary type, the centroid, the radius of gyration, the maximum and a
+ * percentile of the cells' distances from the centroid, and the inner and outer radius
+ * (and so the thickness) of the shell formed by each lineage.
+ *
+ * The cell positions and types are first copied into contiguous arrays, which are then
+ * reduced in two passes (the centroid, then the distances from it), each split between
+ * up to mNumThreads threads. Since the threads are started and joined for each pass, each
+ * is given at least mMinCellsPerThread cells, so that smaller populations are reduced on the
+ * calling thread alone rather than paying for threads that would cost more than the pass.
+ * The partial sums are combined in a fixed order, so for a given number of cells and threads
+ * the results do not depend on scheduling. The percentiles are found by selection rather than sorting.
+ */
+template<unsigned DIM>
+class PopulationStatisticsCalculator
+{
+private:
+
+    /** The largest number of threads used for the reductions. Defaults to 1. */
+    unsigned mNumThreads;
+
+    /** The smallest number of cells given to each thread of a reduction. Defaults to 50000. */
+    unsigned mMinCellsPerThread;
+
+    /** The percentile of the distances from the centroid reported as the organoid radius. Defaults to 0.9. */
+    double mRadiusPercentile;
+
+    /** The percentile of each lineage's distances from the centroid taken as the inner radius of its shell (with 1 minus this as the outer radius). Defaults to 0.1. */
+    double mShellPercentile;
+
+    /** The cell positions (DIM per cell). */
+    std::vector<double> mPositions;
+
+    /** The mammary type of each cell. */
+    std::vector<uint8_t> mTypes;
+
+    /** The distance of each cell from the centroid. */
+    std::vector<double> mRadii;
+
+    /** Workspace for selecting percentiles. */
+    std::vector<double> mSelection;
+
+    /** The number of cells of each mammary type. */
+    unsigned mNumCellsOfType[NO_MAMMARY_CELL_TYPE + 1];
+
+    /** The centroid of the cells. */
+    c_vector<double, DIM> mCentroid;
+
+    /** The radius of gyration about the centroid. */
+    double mRadiusOfGyration;
+
+    /** The largest distance of a cell from the centroid. */
+    double mMaxRadius;
+
+    /** The mRadiusPercentile percentile of the distances from the centroid. */
+    double mPercentileRadius;
+
+    /** The inner radius of the shell formed by each lineage. */
+    double mShellInnerRadius[NO_LINEAGE];
+
+    /** The outer radius of the shell formed by each lineage. */
+    double mShellOuterRadius[NO_LINEAGE];
+
+    /**
+     * Sum the positions of a range of cells.
+     *
+     * @param begin the first cell
+     * @param end one past the last cell
+     * @param pSum filled in with the sum (DIM values)
+     */
+    void SumPositions(unsigned begin, unsigned end, double* pSum);
+
+    /**
+     * Fill in the distances from the centroid of a range of cells, and sum their squares.
+     *
+     * @param begin the first cell
+     * @param end one past the last cell
+     * @param pSum filled in with the sum of squared distances
+     */
+    void CalculateRadii(unsigned begin, unsigned end, double* pSum);
+
+    /**
+     * Split a pass over the cells between threads, one for each mMinCellsPerThread cells up
+     * to mNumThreads, and combine the partial results in order.
+     *
+     * @param pass the pass (SumPositions or CalculateRadii)
+     * @param numResults the number of partial results of the pass
+     * @param pResult filled in with the summed results
+     */
+    void Reduce(void (PopulationStatisticsCalculator<DIM>::*pass)(unsigned, unsigned, double*),
+                unsigned numResults,
+                double* pResult);
+
+    /**
+     * Select a percentile of the values in mSelection, which is reordered.
+     *
+     * @param fraction the percentile, between 0 and 1
+     * @return the value at that percentile (nearest rank below), or 0 if there are no values
+     */
+    double SelectPercentile(double fraction);
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    PopulationStatisticsCalculator();
+
+    /**
+     * @return mNumThreads
+     */
+    unsigned GetNumThreads() const;
+
+    /**
+     * Set mNumThreads.
+     *
+     * @param numThreads the largest number of threads used for the reductions (at least 1)
+     */
+    void SetNumThreads(unsigned numThreads);
+
+    /**
+     * @return mMinCellsPerThread
+     */
+    unsigned GetMinCellsPerThread() const;
+
+    /**
+     * Set mMinCellsPerThread.
+     *
+     * @param minCellsPerThread the smallest number of cells given to each thread of a reduction (at least 1)
+     */
+    void SetMinCellsPerThread(unsigned minCellsPerThread);
+
+    /**
+     * @return mRadiusPercentile
+     */
+    double GetRadiusPercentile() const;
+
+    /**
+     * Set mRadiusPercentile.
+     *
+     * @param radiusPercentile the percentile reported as the organoid radius, between 0 and 1
+     */
+    void SetRadiusPercentile(double radiusPercentile);
+
+    /**
+     * @return mShellPercentile
+     */
+    double GetShellPercentile() const;
+
+    /**
+     * Set mShellPercentile.
+     *
+     * @param shellPercentile the percentile taken as the inner radius of each shell, between 0 and 0.5
+     */
+    void SetShellPercentile(double shellPercentile);
+
+    /**
+     * Calculate the statistics for a population.
+     *
+     * @param rCellPopulation the population
+     */
+    void Calculate(AbstractCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * @return the number of cells
+     */
+    unsigned GetNumCells() const;
+
+    /**
+     * @param cellType a mammary cell type (or NO_MAMMARY_CELL_TYPE)
+     * @return the number of cells of that type
+     */
+    unsigned GetNumCellsOfType(MammaryCellType cellType) const;
+
+    /**
+     * @return the centroid of the cells
+     */
+    const c_vector<double, DIM>& rGetCentroid() const;
+
+    /**
+     * @return the radius of gyration about the centroid
+     */
+    double GetRadiusOfGyration() const;
+
+    /**
+     * @return the largest distance of a cell from the centroid
+     */
+    double GetMaxRadius() const;
+
+    /**
+     * @return the mRadiusPercentile percentile of the distances from the centroid
+     */
+    double GetPercentileRadius() const;
+
+    /**
+     * @param lineage a lineage (not NO_LINEAGE)
+     * @return the inner radius of the shell formed by the lineage
+     */
+    double GetShellInnerRadius(MammaryLineage lineage) const;
+
+    /**
+     * @param lineage a lineage (not NO_LINEAGE)
+     * @return the outer radius of the shell formed by the lineage
+     */
+    double GetShellOuterRadius(MammaryLineage lineage) const;
+
+    /**
+     * @param lineage a lineage (not NO_LINEAGE)
+     * @return the thickness of the shell formed by the lineage
+     */
+    double GetShellThickness(MammaryLineage lineage) const;
+};
+
+#endif /*POPULATIONSTATISTICSCALCULATOR_HPP_*/
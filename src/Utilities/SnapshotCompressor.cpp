@@ -0,0 +1,226 @@
+#include "SnapshotCompressor.hpp"
+#include <cstring>
+#include "Exception.hpp"
+
+#ifdef MAMMARY_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef MAMMARY_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+SnapshotCompressor::SnapshotCompressor(CompressionType type, int level)
+    : mType(type),
+      mLevel(level),
+      mpZstdContext(NULL)
+{
+    if (!IsAvailable(type))
+    {
+        EXCEPTION("This build does not support the requested output compression");
+    }
+
+    switch (type)
+    {
+        case GZIP_COMPRESSION:
+            if (level < 0 || level > 9)
+            {
+                EXCEPTION("Gzip compression levels are between 1 and 9 (or 0 for the default)");
+            }
+            break;
+        case ZSTD_COMPRESSION:
+#ifdef MAMMARY_HAVE_ZSTD
+            if (level < 0 || level > ZSTD_maxCLevel())
+            {
+                EXCEPTION("Zstd compression levels are between 1 and ZSTD_maxCLevel() (or 0 for the default)");
+            }
+            mpZstdContext = ZSTD_createCCtx();
+#endif
+            break;
+        default:
+            break;
+    }
+}
+
+SnapshotCompressor::~SnapshotCompressor()
+{
+#ifdef MAMMARY_HAVE_ZSTD
+    if (mpZstdContext)
+    {
+        ZSTD_freeCCtx(static_cast<ZSTD_CCtx*>(mpZstdContext));
+    }
+#endif
+}
+
+bool SnapshotCompressor::IsAvailable(CompressionType type)
+{
+    switch (type)
+    {
+        case NO_COMPRESSION:
+            return true;
+        case GZIP_COMPRESSION:
+#ifdef MAMMARY_HAVE_ZLIB
+            return true;
+#else
+            return false;
+#endif
+        case ZSTD_COMPRESSION:
+#ifdef MAMMARY_HAVE_ZSTD
+            return true;
+#else
+            return false;
+#endif
+        default:
+            return false;
+    }
+}
+
+std::string SnapshotCompressor::GetFileExtension(CompressionType type)
+{
+    switch (type)
+    {
+        case GZIP_COMPRESSION:
+            return ".gz";
+        case ZSTD_COMPRESSION:
+            return ".zst";
+        default:
+            return "";
+    }
+}
+
+CompressionType SnapshotCompressor::GetType() const
+{
+    return mType;
+}
+
+int SnapshotCompressor::GetLevel() const
+{
+    return mLevel;
+}
+
+uint64_t SnapshotCompressor::WriteFrame(const char* pData, uint64_t size, std::ostream& rStream)
+{
+    uint64_t compressed_size = size;
+    const char* p_frame = pData;
+
+    switch (mType)
+    {
+#ifdef MAMMARY_HAVE_ZLIB
+        case GZIP_COMPRESSION:
+        {
+            z_stream stream;
+            memset(&stream, 0, sizeof(z_stream));
+
+            // A window of 15 bits, plus 16 to write a gzip header and trailer rather than a zlib one
+            if (deflateInit2(&stream, (mLevel == 0) ? Z_DEFAULT_COMPRESSION : mLevel, Z_DEFLATED, 15 + 16, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+            {
+                EXCEPTION("Could not initialise gzip compression");
+            }
+            mCompressedFrame.resize(deflateBound(&stream, size));
+
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(pData));
+            stream.avail_in = size;
+            stream.next_out = reinterpret_cast<Bytef*>(&mCompressedFrame[0]);
+            stream.avail_out = mCompressedFrame.size();
+            int result = deflate(&stream, Z_FINISH);
+            compressed_size = stream.total_out;
+            deflateEnd(&stream);
+
+            if (result != Z_STREAM_END)
+            {
+                EXCEPTION("Gzip compression of an output frame failed");
+            }
+            p_frame = mCompressedFrame.data();
+            break;
+        }
+#endif
+#ifdef MAMMARY_HAVE_ZSTD
+        case ZSTD_COMPRESSION:
+        {
+            mCompressedFrame.resize(ZSTD_compressBound(size));
+            size_t result = ZSTD_compressCCtx(static_cast<ZSTD_CCtx*>(mpZstdContext),
+                                              &mCompressedFrame[0], mCompressedFrame.size(),
+                                              pData, size,
+                                              mLevel); // zstd takes level 0 as its default
+            if (ZSTD_isError(result))
+            {
+                EXCEPTION(std::string("Zstd compression of an output frame failed: ") + ZSTD_getErrorName(result));
+            }
+            compressed_size = result;
+            p_frame = mCompressedFrame.data();
+            break;
+        }
+#endif
+        default:
+            break;
+    }
+
+    rStream.write(p_frame, compressed_size);
+    return compressed_size;
+}
+
+uint64_t SnapshotCompressor::DecompressFrame(CompressionType type, const char* pData, uint64_t size, std::string& rOutput)
+{
+    rOutput.clear();
+
+    switch (type)
+    {
+        case NO_COMPRESSION:
+            rOutput.assign(pData, size);
+            return size;
+#ifdef MAMMARY_HAVE_ZLIB
+        case GZIP_COMPRESSION:
+        {
+            z_stream stream;
+            memset(&stream, 0, sizeof(z_stream));
+            if (inflateInit2(&stream, 15 + 16) != Z_OK)
+            {
+                return 0;
+            }
+            stream.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(pData));
+            stream.avail_in = size;
+
+            // Inflate stops at the end of the first gzip member, i.e. this frame
+            char chunk[65536];
+            int result = Z_OK;
+            while (result == Z_OK)
+            {
+                stream.next_out = reinterpret_cast<Bytef*>(chunk);
+                stream.avail_out = sizeof(chunk);
+                result = inflate(&stream, Z_NO_FLUSH);
+                rOutput.append(chunk, sizeof(chunk) - stream.avail_out);
+            }
+            uint64_t frame_size = stream.total_in;
+            inflateEnd(&stream);
+
+            return (result == Z_STREAM_END) ? frame_size : 0;
+        }
+#endif
+#ifdef MAMMARY_HAVE_ZSTD
+        case ZSTD_COMPRESSION:
+        {
+            size_t frame_size = ZSTD_findFrameCompressedSize(pData, size);
+            if (ZSTD_isError(frame_size))
+            {
+                return 0;
+            }
+
+            // Frames written by WriteFrame() always record their decompressed size
+            unsigned long long content_size = ZSTD_getFrameContentSize(pData, frame_size);
+            if (content_size == ZSTD_CONTENTSIZE_UNKNOWN || content_size == ZSTD_CONTENTSIZE_ERROR)
+            {
+                return 0;
+            }
+            rOutput.resize(content_size);
+            size_t result = ZSTD_decompress(content_size > 0 ? &rOutput[0] : NULL, content_size, pData, frame_size);
+            if (ZSTD_isError(result))
+            {
+                rOutput.clear();
+                return 0;
+            }
+            return frame_size;
+        }
+#endif
+        default:
+            EXCEPTION("This build does not support the requested output compression");
+    }
+}
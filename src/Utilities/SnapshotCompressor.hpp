@@ -0,0 +1,110 @@
+#ifndef SNAPSHOTCOMPRESSOR_HPP_
+#define SNAPSHOTCOMPRESSOR_HPP_
+
+#include <iostream>
+#include <string>
+#include <stdint.h>
+#include <boost/utility.hpp>
+
+/**
+ * The compression applied to output files.
+ */
+typedef enum CompressionType_
+{
+    NO_COMPRESSION = 0,
+    GZIP_COMPRESSION = 1,
+    ZSTD_COMPRESSION = 2
+} CompressionType;
+
+/**
+ * Compresses output one snapshot at a time, each into a self-contained frame.
+ *
+ * Gzip frames are complete gzip members and zstd frames are complete zstd frames, so a
+ * whole file of frames can be decompressed by the standard tools (gunzip, zstd -d). Only
+ * the binary snapshot file of MammarySnapshotWriter indexes its frames, so that one
+ * snapshot can be decompressed alone; the compressed text files of the other writers have
+ * no index and are read from the start (e.g. by MammaryTrajectoryIndex).
+ *
+ * Gzip is available if the project is built with zlib (MAMMARY_HAVE_ZLIB) and zstd if it
+ * is built with libzstd (MAMMARY_HAVE_ZSTD).
+ */
+class SnapshotCompressor : boost::noncopyable
+{
+private:
+
+    /** The type of compression. */
+    CompressionType mType;
+
+    /** The compression level (0 for the library's default). */
+    int mLevel;
+
+    /** Buffer for compressed frames, reused between frames. */
+    std::string mCompressedFrame;
+
+    /** The zstd compression context, if any (held as void* to keep zstd.h out of this header). */
+    void* mpZstdContext;
+
+public:
+
+    /**
+     * Constructor. Throws if the requested compression is not available in this build,
+     * or the level is out of range.
+     *
+     * @param type the type of compression
+     * @param level the compression level: 1-9 for gzip, 1 to ZSTD_maxCLevel() for zstd, or 0 for
+     *     the library's default
+     */
+    SnapshotCompressor(CompressionType type=NO_COMPRESSION, int level=0);
+
+    /**
+     * Destructor.
+     */
+    ~SnapshotCompressor();
+
+    /**
+     * @param type a type of compression
+     * @return whether the type of compression is available in this build
+     */
+    static bool IsAvailable(CompressionType type);
+
+    /**
+     * @param type a type of compression
+     * @return the extension conventionally added to compressed file names ("", ".gz" or ".zst")
+     */
+    static std::string GetFileExtension(CompressionType type);
+
+    /**
+     * @return mType
+     */
+    CompressionType GetType() const;
+
+    /**
+     * @return mLevel
+     */
+    int GetLevel() const;
+
+    /**
+     * Compress data into a single frame and write it to a stream.
+     *
+     * @param pData the data
+     * @param size the number of bytes of data
+     * @param rStream the stream, which should be opened in binary mode
+     * @return the number of bytes written to the stream
+     */
+    uint64_t WriteFrame(const char* pData, uint64_t size, std::ostream& rStream);
+
+    /**
+     * Decompress the frame at the start of a buffer.
+     *
+     * @param type the type of compression
+     * @param pData the buffer
+     * @param size the number of bytes available in the buffer, which may extend beyond the frame
+     * @param rOutput filled in with the decompressed frame
+     * @return the number of bytes of the buffer taken by the frame, or 0 if the buffer
+     *     does not start with a complete frame. Without compression, the whole buffer is
+     *     taken to be the frame.
+     */
+    static uint64_t DecompressFrame(CompressionType type, const char* pData, uint64_t size, std::string& rOutput);
+};
+
+#endif /*SNAPSHOTCOMPRESSOR_HPP_*/
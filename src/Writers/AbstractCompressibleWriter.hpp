@@ -0,0 +1,127 @@
+#ifndef ABSTRACTCOMPRESSIBLEWRITER_HPP_
+#define ABSTRACTCOMPRESSIBLEWRITER_HPP_
+
+#include <string>
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+#include "SimulationTime.hpp"
+#include "CompressedWriterBuffer.hpp"
+
+/**
+ * A text writer that can compress its output, one frame per output time, on top of a
+ * Chaste writer base class BASE (AbstractCellWriter or AbstractCellPopulationWriter).
+ *
+ * Subclasses write through rGetOutStream() rather than mpOutStream. Without compression
+ * this is the output file itself, and the output is unchanged. With compression it is a
+ * buffer holding the current output time's line, which WriteNewline() compresses and
+ * appends to the file (see SnapshotCompressor).
+ */
+template<class BASE>
+class AbstractCompressibleWriter : public BASE
+{
+private:
+
+    /** The name of the output file without compression. */
+    std::string mUncompressedFileName;
+
+    /** The compression of the output, if requested. */
+    CompressedWriterBuffer mCompressedOutput;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object and its member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<BASE>(*this);
+        archive & mCompressedOutput;
+    }
+
+protected:
+
+    /**
+     * @return the stream to which the current output time's line should be written
+     */
+    std::ostream& rGetOutStream()
+    {
+        if (mCompressedOutput.GetCompressionType() == NO_COMPRESSION)
+        {
+            return *this->mpOutStream;
+        }
+        return mCompressedOutput.rGetBuffer();
+    }
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rFileName the name of the output file without compression
+     */
+    AbstractCompressibleWriter(const std::string& rFileName)
+        : BASE(rFileName),
+          mUncompressedFileName(rFileName)
+    {
+    }
+
+    /**
+     * Compress the output file, one frame per output time, and add the corresponding
+     * extension (see SnapshotCompressor::GetFileExtension()) to its name. Must be called
+     * before the output file is opened.
+     *
+     * @param type the type of compression
+     * @param level the compression level (defaults to 0, the library's default)
+     */
+    void SetCompression(CompressionType type, int level=0)
+    {
+        mCompressedOutput.SetCompression(type, level);
+        this->mFileName = mUncompressedFileName + SnapshotCompressor::GetFileExtension(type);
+    }
+
+    /**
+     * @return the type of compression of the output file
+     */
+    CompressionType GetCompressionType() const
+    {
+        return mCompressedOutput.GetCompressionType();
+    }
+
+    /**
+     * Overridden WriteTimeStamp() method, which also starts a compressed frame.
+     */
+    virtual void WriteTimeStamp()
+    {
+        if (mCompressedOutput.GetCompressionType() == NO_COMPRESSION)
+        {
+            BASE::WriteTimeStamp();
+            return;
+        }
+
+        // As BASE::WriteTimeStamp(), but into the frame
+        mCompressedOutput.BeginFrame(*this->mpOutStream);
+        rGetOutStream() << SimulationTime::Instance()->GetTime() << "\t";
+    }
+
+    /**
+     * Overridden WriteNewline() method, which also ends a compressed frame.
+     */
+    virtual void WriteNewline()
+    {
+        if (mCompressedOutput.GetCompressionType() == NO_COMPRESSION)
+        {
+            BASE::WriteNewline();
+            return;
+        }
+
+        // As BASE::WriteNewline(), but into the frame
+        rGetOutStream() << "\n";
+        mCompressedOutput.EndFrame(*this->mpOutStream);
+    }
+};
+
+#endif /*ABSTRACTCOMPRESSIBLEWRITER_HPP_*/
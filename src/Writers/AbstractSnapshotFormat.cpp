@@ -0,0 +1,34 @@
+#include "AbstractSnapshotFormat.hpp"
+
+template<unsigned DIM>
+AbstractSnapshotFormat<DIM>::AbstractSnapshotFormat(const std::string& rFileName)
+    : mFileName(rFileName)
+{
+}
+
+template<unsigned DIM>
+AbstractSnapshotFormat<DIM>::~AbstractSnapshotFormat()
+{
+}
+
+template<unsigned DIM>
+const std::string& AbstractSnapshotFormat<DIM>::rGetFileName() const
+{
+    return mFileName;
+}
+
+template<unsigned DIM>
+bool AbstractSnapshotFormat<DIM>::IsBinary() const
+{
+    return false;
+}
+
+template<unsigned DIM>
+void AbstractSnapshotFormat<DIM>::WriteHeader(std::ostream& rStream)
+{
+}
+
+// Explicit instantiation
+template class AbstractSnapshotFormat<1>;
+template class AbstractSnapshotFormat<2>;
+template class AbstractSnapshotFormat<3>;
@@ -0,0 +1,64 @@
+#ifndef ABSTRACTSNAPSHOTFORMAT_HPP_
+#define ABSTRACTSNAPSHOTFORMAT_HPP_
+
+#include <iostream>
+#include <string>
+
+#include "MammaryPopulationSnapshot.hpp"
+
+/**
+ * An abstract output format for MammaryPopulationSnapshot objects.
+ *
+ * Unlike the cell and population writers, a format only sees the copied snapshot and
+ * never the cell population itself, so it may be run away from the time loop (e.g. on
+ * the writer thread of AsynchronousOutputModifier).
+ */
+template<unsigned DIM>
+class AbstractSnapshotFormat
+{
+private:
+
+    /** The name of the output file. */
+    std::string mFileName;
+
+public:
+
+    /**
+     * Constructor.
+     *
+     * @param rFileName the name of the output file
+     */
+    AbstractSnapshotFormat(const std::string& rFileName);
+
+    /**
+     * Destructor.
+     */
+    virtual ~AbstractSnapshotFormat();
+
+    /**
+     * @return mFileName
+     */
+    const std::string& rGetFileName() const;
+
+    /**
+     * @return whether the output file should be opened in binary mode (defaults to false)
+     */
+    virtual bool IsBinary() const;
+
+    /**
+     * Write anything that comes once at the start of the file. Does nothing by default.
+     *
+     * @param rStream the output stream
+     */
+    virtual void WriteHeader(std::ostream& rStream);
+
+    /**
+     * Write a snapshot.
+     *
+     * @param rSnapshot the snapshot
+     * @param rStream the output stream
+     */
+    virtual void WriteSnapshot(const MammaryPopulationSnapshot<DIM>& rSnapshot, std::ostream& rStream)=0;
+};
+
+#endif /*ABSTRACTSNAPSHOTFORMAT_HPP_*/
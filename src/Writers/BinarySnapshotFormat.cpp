@@ -0,0 +1,30 @@
+#include "BinarySnapshotFormat.hpp"
+
+template<unsigned DIM>
+BinarySnapshotFormat<DIM>::BinarySnapshotFormat()
+    : AbstractSnapshotFormat<DIM>("mammary_snapshots.bin")
+{
+}
+
+template<unsigned DIM>
+bool BinarySnapshotFormat<DIM>::IsBinary() const
+{
+    return true;
+}
+
+template<unsigned DIM>
+void BinarySnapshotFormat<DIM>::WriteHeader(std::ostream& rStream)
+{
+    MammaryPopulationSnapshot<DIM>::WriteFileHeader(rStream);
+}
+
+template<unsigned DIM>
+void BinarySnapshotFormat<DIM>::WriteSnapshot(const MammaryPopulationSnapshot<DIM>& rSnapshot, std::ostream& rStream)
+{
+    rSnapshot.WriteBlock(rStream);
+}
+
+// Explicit instantiation
+template class BinarySnapshotFormat<1>;
+template class BinarySnapshotFormat<2>;
+template class BinarySnapshotFormat<3>;
@@ -0,0 +1,42 @@
+#ifndef BINARYSNAPSHOTFORMAT_HPP_
+#define BINARYSNAPSHOTFORMAT_HPP_
+
+#include "AbstractSnapshotFormat.hpp"
+
+/**
+ * Writes snapshots to mammary_snapshots.bin, in the same binary layout as
+ * MammarySnapshotWriter (but without the index file, whose entries
+ * MammarySnapshotReader recovers by scanning the file).
+ */
+template<unsigned DIM>
+class BinarySnapshotFormat : public AbstractSnapshotFormat<DIM>
+{
+public:
+
+    /**
+     * Default constructor.
+     */
+    BinarySnapshotFormat();
+
+    /**
+     * @return true
+     */
+    virtual bool IsBinary() const;
+
+    /**
+     * Overridden WriteHeader() method, which writes the snapshot file header.
+     *
+     * @param rStream the output stream
+     */
+    virtual void WriteHeader(std::ostream& rStream);
+
+    /**
+     * Overridden WriteSnapshot() method.
+     *
+     * @param rSnapshot the snapshot
+     * @param rStream the output stream
+     */
+    virtual void WriteSnapshot(const MammaryPopulationSnapshot<DIM>& rSnapshot, std::ostream& rStream);
+};
+
+#endif /*BINARYSNAPSHOTFORMAT_HPP_*/
@@ -4,6 +4,7 @@
 #include "AbstractCellPopulationWriter.hpp"
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
+#include "AbstractCompressibleWriter.hpp"
 
 /**
  * A class written using the visitor pattern for writing the length of the
@@ -19,9 +20,10 @@
  * 6(10):e24999. doi:10.1371/journal.pone.0024999
  */
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-class BoundaryLengthWriter : public AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>
+class BoundaryLengthWriter : public AbstractCompressibleWriter<AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM> >
 {
 private:
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
@@ -33,7 +35,7 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & boost::serialization::base_object<AbstractCompressibleWriter<AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM> > >(*this);
     }
 
 public:
@@ -49,7 +51,9 @@ public:
      * Outputs a line of tab-separated values of the form:
      * [fractional_length] [total_length] [fractional_neighbours] [total_neighbours]
      *
-     * Here the indexing of nodes is as given by the NodeIterator.
+     * The contact lengths are calculated by CellContactCalculator, which visits each pair
+     * of neighbouring nodes once; use it directly for the heterotypic, homotypic and total
+     * contact lengths in situ.
      *
      * This line is appended to the output written by AbstractCellBasedWriter, which is a single
      * value [present simulation time], followed by a tab.
@@ -10,7 +10,7 @@
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 CellLocationWriter<ELEMENT_DIM, SPACE_DIM>::CellLocationWriter()
-    : AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>("location.dat")
+    : AbstractCompressibleWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >("location.dat")
 {
     this->mVtkCellDataName = "Cell Location";
 }
@@ -37,30 +37,30 @@ void CellLocationWriter<ELEMENT_DIM, SPACE_DIM>::VisitCell(CellPtr pCell, Abstra
         // Write whether the cell is luminal or myoepithelial 
             if (pCell->HasCellProperty<LuminalCellProperty>())
             {
-                *this->mpOutStream << "Luminal"<< " ";
+                this->rGetOutStream() << "Luminal"<< " ";
             }
             else if (pCell->HasCellProperty<MyoepithelialCellProperty>())
             {
-                *this->mpOutStream << "Myoepithelial"<< " ";
+                this->rGetOutStream() << "Myoepithelial"<< " ";
             }
             else if (pCell->HasCellProperty<LuminalStemCellProperty>())
             {
-                *this->mpOutStream << "LSC"<< " ";
+                this->rGetOutStream() << "LSC"<< " ";
             }
             else
             {
-                *this->mpOutStream << "MSC"<< " ";
+                this->rGetOutStream() << "MSC"<< " ";
             }
         
             // Write the cell's ID to file
             unsigned cell_id = pCell->GetCellId();
-            *this->mpOutStream << cell_id << " ";
+            this->rGetOutStream() << cell_id << " ";
 
             // Write cell location
             c_vector<double, SPACE_DIM> cell_location = pCellPopulation->GetLocationOfCellCentre(pCell);
             for (unsigned i=0; i<SPACE_DIM; i++)
             {
-                *this->mpOutStream << cell_location[i] << " ";
+                this->rGetOutStream() << cell_location[i] << " ";
             }
     }
     else
@@ -1,5 +1,8 @@
 #include "CellPopulationAdjacencyWriter.hpp"
 
+#include <algorithm>
+#include <stdint.h>
+
 #include "AbstractCellPopulation.hpp"
 #include "MeshBasedCellPopulation.hpp"
 #include "CaBasedCellPopulation.hpp"
@@ -9,192 +12,353 @@
 
 #include "CellLabel.hpp"
 
-#include "LuminalCellProperty.hpp"
-#include "MyoepithelialCellProperty.hpp"
-#include "LuminalStemCellProperty.hpp"
-#include "MyoepithelialStemCellProperty.hpp"
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryProfiler.hpp"
+
+/**
+ * @param firstIsLuminal whether the first cell is luminal (or labelled)
+ * @param secondIsLuminal whether the second cell is luminal (or labelled)
+ * @return the type of the link between two neighbouring cells
+ */
+static unsigned GetTypeOfLink(bool firstIsLuminal, bool secondIsLuminal)
+{
+    if (firstIsLuminal != secondIsLuminal)
+    {
+        // Here one cell is luminal but the other is not, so the type of link is 3
+        return 3;
+    }
+    else if (firstIsLuminal)
+    {
+        // Here both cells are luminal, so the type of link is 2
+        return 2;
+    }
+    return 1;
+}
+
+/**
+ * Write an array of unsigned values, either as tab-separated text or as packed 32-bit integers.
+ *
+ * @param rStream the stream
+ * @param rValues the values
+ * @param binary whether to write in binary
+ */
+static void WriteUnsignedArray(std::ostream& rStream, const std::vector<uint32_t>& rValues, bool binary)
+{
+    if (binary)
+    {
+        if (!rValues.empty())
+        {
+            rStream.write(reinterpret_cast<const char*>(&rValues[0]), rValues.size()*sizeof(uint32_t));
+        }
+    }
+    else
+    {
+        for (unsigned i=0; i<rValues.size(); i++)
+        {
+            rStream << rValues[i] << "\t";
+        }
+    }
+}
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::CellPopulationAdjacencyWriter()
-    : AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>("cellpopulationadjacency.dat")
+    : AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>("cellpopulationadjacency.dat"),
+      mOutputFormat(DENSE_ADJACENCY),
+      mUseBinaryOutput(false)
 {
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::VisitAnyPopulation(AbstractCellPopulation<SPACE_DIM, SPACE_DIM>* pCellPopulation)
+void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::SetOutputFormat(AdjacencyOutputFormat outputFormat)
 {
-    // Make sure the cell population is updated
-    ///\todo #2645 - if efficiency is an issue, check if this is really needed
-    pCellPopulation->Update();
-
-    unsigned num_cells = pCellPopulation->GetNumRealCells();
+    if (mUseBinaryOutput && outputFormat == DENSE_ADJACENCY)
+    {
+        EXCEPTION("Binary output is only available for the sparse adjacency layouts");
+    }
+    mOutputFormat = outputFormat;
+}
 
-    // Store a map between cells numbered 1 to n and location indices
-    std::map<unsigned,unsigned> local_cell_id_location_index_map;
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+AdjacencyOutputFormat CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::GetOutputFormat() const
+{
+    return mOutputFormat;
+}
 
-    unsigned local_cell_id = 0;
-    for (typename AbstractCellPopulation<SPACE_DIM, SPACE_DIM>::Iterator cell_iter = pCellPopulation->Begin();
-         cell_iter != pCellPopulation->End();
-         ++cell_iter)
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::SetUseBinaryOutput(bool useBinaryOutput)
+{
+    if (useBinaryOutput && mOutputFormat == DENSE_ADJACENCY)
     {
-        local_cell_id_location_index_map[pCellPopulation->GetLocationIndexUsingCell(*cell_iter)] = local_cell_id;
-        local_cell_id++;
+        EXCEPTION("Binary output is only available for the sparse adjacency layouts");
     }
-    assert(local_cell_id = num_cells+1);
+    mUseBinaryOutput = useBinaryOutput;
+    this->mFileName = mUseBinaryOutput ? "cellpopulationadjacency.bin" : "cellpopulationadjacency.dat";
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::GetUseBinaryOutput() const
+{
+    return mUseBinaryOutput;
+}
 
-    // Iterate over cells and calculate the adjacency matrix (stored as a long vector)
-    std::vector<double> adjacency_matrix(num_cells*num_cells);
-    for (unsigned i=0; i<num_cells*num_cells; i++)
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::OpenOutputFile(OutputFileHandler& rOutputFileHandler)
+{
+    if (mUseBinaryOutput)
     {
-        adjacency_matrix[i] = 0;
+        this->mpOutStream = rOutputFileHandler.OpenOutputFile(this->mFileName, std::ios::out | std::ios::trunc | std::ios::binary);
     }
-
-    for (typename AbstractCellPopulation<SPACE_DIM, SPACE_DIM>::Iterator cell_iter = pCellPopulation->Begin();
-         cell_iter != pCellPopulation->End();
-         ++cell_iter)
+    else
     {
-        // Store whether this cell is luminal or myoepithelial
-        bool cell_is_luminal = cell_iter->template HasCellProperty<LuminalCellProperty>();
-        bool cell_is_myo = cell_iter->template HasCellProperty<MyoepithelialCellProperty>();
-        bool cell_is_luminal_stem = cell_iter->template HasCellProperty<LuminalStemCellProperty>();
-        bool cell_is_myo_stem = cell_iter->template HasCellProperty<MyoepithelialStemCellProperty>();
-
-
-        // Get the location index corresponding to this cell
-        unsigned index = pCellPopulation->GetLocationIndexUsingCell(*cell_iter);
-
-        // Get the set of neighbouring location indices
-        std::set<unsigned> neighbour_indices = pCellPopulation->GetNeighbouringLocationIndices(*cell_iter);
-
-        // If this cell has any neighbours (as defined by mesh/population/interaction distance)...
-        if (!neighbour_indices.empty())
-        {
-            unsigned local_cell_index = local_cell_id_location_index_map[index];
-
-            for (std::set<unsigned>::iterator neighbour_iter = neighbour_indices.begin();
-                 neighbour_iter != neighbour_indices.end();
-                 ++neighbour_iter)
-            {
-                // If both cell_iter and p_neighbour_cell are not labelled, then set type_of_link to 1
-                unsigned type_of_link = 1;
-
-                // Determine whether this neighbour is luminal, myoepithelial or stem
-                CellPtr p_neighbour_cell = pCellPopulation->GetCellUsingLocationIndex(*neighbour_iter);
-                bool neighbour_is_luminal = p_neighbour_cell->template HasCellProperty<LuminalCellProperty>();
-                bool neighbour_is_myo = p_neighbour_cell->template HasCellProperty<MyoepithelialCellProperty>();
-                bool neighbour_is_luminal_stem = p_neighbour_cell->template HasCellProperty<LuminalStemCellProperty>();
-                bool neighbour_is_myo_stem = p_neighbour_cell->template HasCellProperty<MyoepithelialStemCellProperty>();
-
-                if ((cell_is_luminal || cell_is_luminal_stem) != (neighbour_is_luminal || neighbour_is_luminal_stem))
-                {
-                    // Here cell_iter is luminal but p_neighbour_cell is not, or vice versa, so set type_of_link to 3
-                    type_of_link = 3;
-                }
-                else if (cell_is_luminal || cell_is_luminal_stem)
-                {
-                    // Here both cell_iter and p_neighbour_cell are luminal, so set type_of_link to 2
-                    type_of_link = 2;
-                }
-
-                unsigned local_neighbour_index = local_cell_id_location_index_map[*neighbour_iter];
-                adjacency_matrix[local_cell_index + num_cells*local_neighbour_index] = type_of_link;
-                adjacency_matrix[num_cells*local_cell_index + local_neighbour_index] = type_of_link;
-            }
-        }
+        AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>::OpenOutputFile(rOutputFileHandler);
     }
+}
 
-    // Output the number of cells and the elements of the adjacency matrix
-    *this->mpOutStream << num_cells << "\t";
-    for (unsigned i=0; i<num_cells*num_cells; i++)
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::WriteTimeStamp()
+{
+    if (mUseBinaryOutput)
+    {
+        double time = SimulationTime::Instance()->GetTime();
+        this->mpOutStream->write(reinterpret_cast<const char*>(&time), sizeof(double));
+    }
+    else
     {
-        *this->mpOutStream << adjacency_matrix[i] << "\t";
+        AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>::WriteTimeStamp();
     }
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::Visit(MeshBasedCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation)
+void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::WriteNewline()
 {
-    // Make sure the cell population is updated
-    ///\todo #2645 - if efficiency is an issue, check if this is really needed
-    pCellPopulation->Update();
-
-    unsigned num_cells = pCellPopulation->GetNumRealCells();
+    if (!mUseBinaryOutput)
+    {
+        AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>::WriteNewline();
+    }
+}
 
-    // Store a map between cells numbered 1 to n and location indices
-    std::map<unsigned,unsigned> local_cell_id_location_index_map;
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+template<class POPULATION>
+void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::NumberCells(POPULATION* pCellPopulation,
+                                                                        bool useCellLabel,
+                                                                        std::vector<unsigned>& rLocalIndices,
+                                                                        std::vector<bool>& rIsLuminal)
+{
+    // Store a map between location indices and cells numbered 0 to n-1, as a flat array rather than a std::map
+    rLocalIndices.clear();
+    rIsLuminal.clear();
+    rIsLuminal.reserve(pCellPopulation->GetNumRealCells());
 
     unsigned local_cell_id = 0;
-    for (typename AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::Iterator cell_iter = pCellPopulation->Begin();
+    for (typename POPULATION::Iterator cell_iter = pCellPopulation->Begin();
          cell_iter != pCellPopulation->End();
          ++cell_iter)
     {
-        local_cell_id_location_index_map[pCellPopulation->GetLocationIndexUsingCell(*cell_iter)] = local_cell_id;
+        unsigned location_index = pCellPopulation->GetLocationIndexUsingCell(*cell_iter);
+        if (location_index >= rLocalIndices.size())
+        {
+            rLocalIndices.resize(location_index + 1, UNSIGNED_UNSET);
+        }
+        rLocalIndices[location_index] = local_cell_id;
         local_cell_id++;
-    }
-    assert(local_cell_id = num_cells+1);
 
-    // Iterate over cells and calculate the adjacency matrix (stored as a long vector)
-    std::vector<double> adjacency_matrix(num_cells*num_cells);
-    for (unsigned i=0; i<num_cells*num_cells; i++)
-    {
-        adjacency_matrix[i] = 0;
+        if (useCellLabel)
+        {
+            rIsLuminal.push_back(cell_iter->template HasCellProperty<CellLabel>());
+        }
+        else
+        {
+            // Luminal and luminal stem cells are both counted as luminal
+            MammaryCellType cell_type = MammaryCellPropertyHelper::GetMammaryCellType(*cell_iter);
+            rIsLuminal.push_back(cell_type == LUMINAL_CELL || cell_type == LUMINAL_STEM_CELL);
+        }
     }
+}
 
-    for (typename AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>::Iterator cell_iter = pCellPopulation->Begin();
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+template<class POPULATION>
+void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::CollectLinksFromNeighbours(POPULATION* pCellPopulation,
+                                                                                       const std::vector<unsigned>& rLocalIndices,
+                                                                                       const std::vector<bool>& rIsLuminal,
+                                                                                       std::vector<AdjacencyLink>& rLinks)
+{
+    rLinks.clear();
+    for (typename POPULATION::Iterator cell_iter = pCellPopulation->Begin();
          cell_iter != pCellPopulation->End();
          ++cell_iter)
     {
-        // Determine whether this cell is labelled
-        bool cell_is_labelled = cell_iter->template HasCellProperty<CellLabel>();
-
-        // Get the location index corresponding to this cell
-        unsigned index = pCellPopulation->GetLocationIndexUsingCell(*cell_iter);
+        unsigned local_cell_index = rLocalIndices[pCellPopulation->GetLocationIndexUsingCell(*cell_iter)];
 
         // Get the set of neighbouring location indices
         std::set<unsigned> neighbour_indices = pCellPopulation->GetNeighbouringLocationIndices(*cell_iter);
+        for (std::set<unsigned>::iterator neighbour_iter = neighbour_indices.begin();
+             neighbour_iter != neighbour_indices.end();
+             ++neighbour_iter)
+        {
+            unsigned local_neighbour_index = rLocalIndices[*neighbour_iter];
+
+            AdjacencyLink link;
+            link.mFirst = std::min(local_cell_index, local_neighbour_index);
+            link.mSecond = std::max(local_cell_index, local_neighbour_index);
+            link.mType = GetTypeOfLink(rIsLuminal[local_cell_index], rIsLuminal[local_neighbour_index]);
+            rLinks.push_back(link);
+        }
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::WriteLinks(unsigned numCells, std::vector<AdjacencyLink>& rLinks)
+{
+    // Each pair of neighbours is usually found from both ends, so keep one link per pair
+    std::sort(rLinks.begin(), rLinks.end());
+    rLinks.erase(std::unique(rLinks.begin(), rLinks.end()), rLinks.end());
+    unsigned num_links = rLinks.size();
+
+    // Store each link from both ends, in row-major order, for the dense and CSR layouts
+    std::vector<uint32_t> row_offsets;
+    std::vector<uint32_t> columns;
+    std::vector<uint32_t> types;
+    if (mOutputFormat != EDGE_LIST_ADJACENCY)
+    {
+        row_offsets.assign(numCells + 1, 0);
+        for (unsigned i=0; i<num_links; i++)
+        {
+            row_offsets[rLinks[i].mFirst + 1]++;
+            row_offsets[rLinks[i].mSecond + 1]++;
+        }
+        for (unsigned i=0; i<numCells; i++)
+        {
+            row_offsets[i+1] += row_offsets[i];
+        }
 
-        // If this cell has any neighbours (as defined by mesh/population/interaction distance)...
-        if (!neighbour_indices.empty())
+        columns.resize(2*num_links);
+        types.resize(2*num_links);
+        std::vector<uint32_t> next_entry(row_offsets.begin(), row_offsets.end() - 1);
+        for (unsigned i=0; i<num_links; i++)
         {
-            unsigned local_cell_index = local_cell_id_location_index_map[index];
+            unsigned entry = next_entry[rLinks[i].mFirst]++;
+            columns[entry] = rLinks[i].mSecond;
+            types[entry] = rLinks[i].mType;
+
+            entry = next_entry[rLinks[i].mSecond]++;
+            columns[entry] = rLinks[i].mFirst;
+            types[entry] = rLinks[i].mType;
+        }
 
-            for (std::set<unsigned>::iterator neighbour_iter = neighbour_indices.begin();
-                 neighbour_iter != neighbour_indices.end();
-                 ++neighbour_iter)
+        // Since links are sorted by (first, second), only the entries with column < row may be out of order
+        for (unsigned row=0; row<numCells; row++)
+        {
+            std::vector<std::pair<uint32_t, uint32_t> > row_entries;
+            for (unsigned entry=row_offsets[row]; entry<row_offsets[row+1]; entry++)
+            {
+                row_entries.push_back(std::make_pair(columns[entry], types[entry]));
+            }
+            std::sort(row_entries.begin(), row_entries.end());
+            for (unsigned k=0; k<row_entries.size(); k++)
             {
-                // If both cell_iter and p_neighbour_cell are not labelled, then set type_of_link to 1
-                unsigned type_of_link = 1;
+                columns[row_offsets[row] + k] = row_entries[k].first;
+                types[row_offsets[row] + k] = row_entries[k].second;
+            }
+        }
+    }
 
-                // Determine whether this neighbour is labelled
-                CellPtr p_neighbour_cell = pCellPopulation->GetCellUsingLocationIndex(*neighbour_iter);
-                bool neighbour_is_labelled = p_neighbour_cell->template HasCellProperty<CellLabel>();
+    std::ostream& r_stream = *this->mpOutStream;
 
-                if (cell_is_labelled != neighbour_is_labelled)
+    if (mOutputFormat == DENSE_ADJACENCY)
+    {
+        /*
+         * Output the number of cells and the elements of the adjacency matrix. Since the matrix is
+         * symmetric, entry (i,j), at position i + N*j, is entry i of row j, so each row is written in
+         * turn with zeros between its links, without ever storing the full matrix.
+         */
+        r_stream << numCells << "\t";
+        for (unsigned row=0; row<numCells; row++)
+        {
+            unsigned entry = row_offsets[row];
+            for (unsigned column=0; column<numCells; column++)
+            {
+                if (entry < row_offsets[row+1] && columns[entry] == column)
                 {
-                    // Here cell_iter is labelled but p_neighbour_cell is not, or vice versa, so set type_of_link to 3
-                    type_of_link = 3;
+                    r_stream << types[entry] << "\t";
+                    entry++;
                 }
-                else if (cell_is_labelled)
+                else
                 {
-                    // Here both cell_iter and p_neighbour_cell are labelled, so set type_of_link to 2
-                    type_of_link = 2;
+                    r_stream << 0 << "\t";
                 }
-
-                unsigned local_neighbour_index = local_cell_id_location_index_map[*neighbour_iter];
-                adjacency_matrix[local_cell_index + num_cells*local_neighbour_index] = type_of_link;
-                adjacency_matrix[num_cells*local_cell_index + local_neighbour_index] = type_of_link;
             }
         }
+        return;
     }
 
-    // Output the number of cells and the elements of the adjacency matrix
-    *this->mpOutStream << num_cells << "\t";
-    for (unsigned i=0; i<num_cells*num_cells; i++)
+    std::vector<uint32_t> header;
+    if (mUseBinaryOutput)
+    {
+        header.push_back(mOutputFormat);
+    }
+    header.push_back(numCells);
+
+    if (mOutputFormat == EDGE_LIST_ADJACENCY)
+    {
+        header.push_back(num_links);
+        WriteUnsignedArray(r_stream, header, mUseBinaryOutput);
+
+        std::vector<uint32_t> edges(3*num_links);
+        for (unsigned i=0; i<num_links; i++)
+        {
+            edges[3*i] = rLinks[i].mFirst;
+            edges[3*i+1] = rLinks[i].mSecond;
+            edges[3*i+2] = rLinks[i].mType;
+        }
+        WriteUnsignedArray(r_stream, edges, mUseBinaryOutput);
+    }
+    else
     {
-        *this->mpOutStream << adjacency_matrix[i] << "\t";
+        header.push_back(columns.size());
+        WriteUnsignedArray(r_stream, header, mUseBinaryOutput);
+        WriteUnsignedArray(r_stream, row_offsets, mUseBinaryOutput);
+        WriteUnsignedArray(r_stream, columns, mUseBinaryOutput);
+        WriteUnsignedArray(r_stream, types, mUseBinaryOutput);
     }
 }
 
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::VisitAnyPopulation(AbstractCellPopulation<SPACE_DIM, SPACE_DIM>* pCellPopulation)
+{
+    MAMMARY_PROFILE_SCOPE("step/output/CellPopulationAdjacencyWriter");
+
+    // Make sure the cell population is updated
+    ///\todo #2645 - if efficiency is an issue, check if this is really needed
+    pCellPopulation->Update();
+
+    std::vector<unsigned> local_indices;
+    std::vector<bool> is_luminal;
+    NumberCells(pCellPopulation, false, local_indices, is_luminal);
+
+    std::vector<AdjacencyLink> links;
+    CollectLinksFromNeighbours(pCellPopulation, local_indices, is_luminal, links);
+
+    WriteLinks(is_luminal.size(), links);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::Visit(MeshBasedCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation)
+{
+    // Make sure the cell population is updated
+    ///\todo #2645 - if efficiency is an issue, check if this is really needed
+    pCellPopulation->Update();
+
+    // Here cells are distinguished by whether they are labelled (as determined by the CellLabel property)
+    std::vector<unsigned> local_indices;
+    std::vector<bool> is_labelled;
+    NumberCells(pCellPopulation, true, local_indices, is_labelled);
+
+    std::vector<AdjacencyLink> links;
+    CollectLinksFromNeighbours(pCellPopulation, local_indices, is_labelled, links);
+
+    WriteLinks(is_labelled.size(), links);
+}
+
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::Visit(CaBasedCellPopulation<SPACE_DIM>* pCellPopulation)
 {
@@ -203,7 +367,54 @@ void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::Visit(CaBasedCellPop
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void CellPopulationAdjacencyWriter<ELEMENT_DIM, SPACE_DIM>::Visit(NodeBasedCellPopulation<SPACE_DIM>* pCellPopulation)
 {
-    VisitAnyPopulation(pCellPopulation);
+    MAMMARY_PROFILE_SCOPE("step/output/CellPopulationAdjacencyWriter");
+
+    // Make sure the cell population is updated
+    ///\todo #2645 - if efficiency is an issue, check if this is really needed
+    pCellPopulation->Update();
+
+    std::vector<unsigned> local_indices;
+    std::vector<bool> is_luminal;
+    NumberCells(pCellPopulation, false, local_indices, is_luminal);
+
+    /*
+     * Rather than building a set of neighbours for every cell, visit each pair of nearby
+     * nodes once, keeping those closer than the sum of their radii, as in
+     * NodeBasedCellPopulation::GetNeighbouringLocationIndices().
+     */
+    std::vector<AdjacencyLink> links;
+    std::vector<std::pair<Node<SPACE_DIM>*, Node<SPACE_DIM>*> >& r_node_pairs = pCellPopulation->rGetNodePairs();
+    links.reserve(r_node_pairs.size());
+    for (unsigned i=0; i<r_node_pairs.size(); i++)
+    {
+        Node<SPACE_DIM>* p_node_a = r_node_pairs[i].first;
+        Node<SPACE_DIM>* p_node_b = r_node_pairs[i].second;
+        unsigned index_a = p_node_a->GetIndex();
+        unsigned index_b = p_node_b->GetIndex();
+
+        // Skip nodes without cells (e.g. particles)
+        if (index_a >= local_indices.size() || index_b >= local_indices.size() ||
+            local_indices[index_a] == UNSIGNED_UNSET || local_indices[index_b] == UNSIGNED_UNSET)
+        {
+            continue;
+        }
+
+        // Cells exactly touching are not neighbours, as in GetNeighbouringLocationIndices()
+        double distance_between_nodes = norm_2(p_node_a->rGetLocation() - p_node_b->rGetLocation());
+        if (distance_between_nodes < p_node_a->GetRadius() + p_node_b->GetRadius())
+        {
+            unsigned local_a = local_indices[index_a];
+            unsigned local_b = local_indices[index_b];
+
+            AdjacencyLink link;
+            link.mFirst = std::min(local_a, local_b);
+            link.mSecond = std::max(local_a, local_b);
+            link.mType = GetTypeOfLink(is_luminal[local_a], is_luminal[local_b]);
+            links.push_back(link);
+        }
+    }
+
+    WriteLinks(is_luminal.size(), links);
 }
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
@@ -1,20 +1,125 @@
 #ifndef CELLPOPULATIONADJACENCYWRITER_HPP_
 #define CELLPOPULATIONADJACENCYWRITER_HPP_
 
+#include <vector>
 #include "AbstractCellPopulationWriter.hpp"
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 
+/**
+ * The layouts in which CellPopulationAdjacencyWriter can write the adjacency matrix.
+ */
+typedef enum AdjacencyOutputFormat_
+{
+    DENSE_ADJACENCY,
+    EDGE_LIST_ADJACENCY,
+    CSR_ADJACENCY
+} AdjacencyOutputFormat;
+
 /**
  * A class written using the visitor pattern for writing the cell population
  * adjacency (i.e. connectivity) matrix to file.
  *
  * The output file is called cellpopulationadjacency.dat by default.
+ *
+ * By default the full N x N matrix is written (see Visit(NodeBasedCellPopulation*)).
+ * Since this grows quadratically with the number of cells, the matrix may instead be
+ * written in a sparse layout, as either an edge list or in compressed sparse row (CSR)
+ * form. Sparse layouts may also be written in binary, to cellpopulationadjacency.bin.
+ *
+ * Text edge list, one line per time step:
+ * [time] [number of cells] [number of edges] then [i] [j] [type of link] for each edge with i < j.
+ *
+ * Text CSR, one line per time step:
+ * [time] [number of cells] [number of entries] [row offsets (N+1 values)] [column indices] [types of link]
+ * where both (i,j) and (j,i) are stored, and the columns of each row are in increasing order.
+ *
+ * Binary output has one record per time step, with no separators: the time as a double,
+ * then the format, number of cells and number of edges (or entries) as unsigned 32-bit
+ * integers, then the arrays of the corresponding text layout as unsigned 32-bit integers,
+ * all in native byte order.
+ *
+ * In every layout, cells are numbered 0 to N-1 in the order of the population's cell
+ * iterator, and the type of link is as described for the dense matrix.
  */
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 class CellPopulationAdjacencyWriter : public AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>
 {
 private:
+
+    /** The layout in which the adjacency matrix is written. Defaults to DENSE_ADJACENCY. */
+    AdjacencyOutputFormat mOutputFormat;
+
+    /** Whether sparse layouts are written in binary. Defaults to false. */
+    bool mUseBinaryOutput;
+
+    /** A link between two cells, numbered locally. */
+    struct AdjacencyLink
+    {
+        /** The local index of the first cell. */
+        unsigned mFirst;
+
+        /** The local index of the second cell. */
+        unsigned mSecond;
+
+        /** The type of link (1, 2 or 3). */
+        unsigned mType;
+
+        /**
+         * @param rOther another link
+         * @return whether this link comes before rOther in row-major order
+         */
+        bool operator<(const AdjacencyLink& rOther) const
+        {
+            return (mFirst < rOther.mFirst) || (mFirst == rOther.mFirst && mSecond < rOther.mSecond);
+        }
+
+        /**
+         * @param rOther another link
+         * @return whether this link joins the same cells as rOther
+         */
+        bool operator==(const AdjacencyLink& rOther) const
+        {
+            return (mFirst == rOther.mFirst) && (mSecond == rOther.mSecond);
+        }
+    };
+
+    /**
+     * Number the cells of a population locally, and store whether each is luminal (or labelled).
+     *
+     * @param pCellPopulation the population
+     * @param useCellLabel whether to classify cells by CellLabel rather than as luminal (or luminal stem) cells
+     * @param rLocalIndices filled in with the local index of each location index (UNSIGNED_UNSET if there is no cell)
+     * @param rIsLuminal filled in with whether each cell, by local index, is luminal (or labelled)
+     */
+    template<class POPULATION>
+    void NumberCells(POPULATION* pCellPopulation,
+                     bool useCellLabel,
+                     std::vector<unsigned>& rLocalIndices,
+                     std::vector<bool>& rIsLuminal);
+
+    /**
+     * Collect the links between neighbouring cells, as given by GetNeighbouringLocationIndices().
+     *
+     * @param pCellPopulation the population
+     * @param rLocalIndices the local index of each location index
+     * @param rIsLuminal whether each cell, by local index, is luminal (or labelled)
+     * @param rLinks filled in with one link (i < j) for each pair of neighbouring cells
+     */
+    template<class POPULATION>
+    void CollectLinksFromNeighbours(POPULATION* pCellPopulation,
+                                    const std::vector<unsigned>& rLocalIndices,
+                                    const std::vector<bool>& rIsLuminal,
+                                    std::vector<AdjacencyLink>& rLinks);
+
+    /**
+     * Write the links in the chosen layout.
+     *
+     * @param numCells the number of cells
+     * @param rLinks the links, with i < j; sorted and de-duplicated here
+     */
+    void WriteLinks(unsigned numCells, std::vector<AdjacencyLink>& rLinks);
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
@@ -27,6 +132,8 @@ private:
     void serialize(Archive & archive, const unsigned int version)
     {
         archive & boost::serialization::base_object<AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & mOutputFormat;
+        archive & mUseBinaryOutput;
     }
 
 public:
@@ -36,6 +143,48 @@ public:
      */
     CellPopulationAdjacencyWriter();
 
+    /**
+     * Set mOutputFormat.
+     *
+     * @param outputFormat the layout in which the adjacency matrix is written
+     */
+    void SetOutputFormat(AdjacencyOutputFormat outputFormat);
+
+    /**
+     * @return mOutputFormat
+     */
+    AdjacencyOutputFormat GetOutputFormat() const;
+
+    /**
+     * Set mUseBinaryOutput, and the name of the output file accordingly.
+     * Binary output is only available for the sparse layouts.
+     *
+     * @param useBinaryOutput whether to write in binary
+     */
+    void SetUseBinaryOutput(bool useBinaryOutput);
+
+    /**
+     * @return mUseBinaryOutput
+     */
+    bool GetUseBinaryOutput() const;
+
+    /**
+     * Overridden OpenOutputFile() method, which opens the file in binary mode if required.
+     *
+     * @param rOutputFileHandler handler for the directory in which to open this file
+     */
+    virtual void OpenOutputFile(OutputFileHandler& rOutputFileHandler);
+
+    /**
+     * Overridden WriteTimeStamp() method, which writes the time as a double in binary mode.
+     */
+    virtual void WriteTimeStamp();
+
+    /**
+     * Overridden WriteNewline() method, which writes nothing in binary mode.
+     */
+    virtual void WriteNewline();
+
     /**
      * Visit the population and write the data.
      *
@@ -73,6 +222,9 @@ public:
      * By default we have [adjacency i i] = 0, i.e. cells are not considered to be adjacent to
      * themselves.
      *
+     * Neighbours are found from the population's node pairs, keeping pairs closer than the sum
+     * of the two cells' radii, as in NodeBasedCellPopulation::GetNeighbouringLocationIndices().
+     *
      * @param pCellPopulation a pointer to the NodeBasedCellPopulation to visit.
      */
     virtual void Visit(NodeBasedCellPopulation<SPACE_DIM>* pCellPopulation);
@@ -0,0 +1,46 @@
+#include "CellTypeSnapshotFormat.hpp"
+#include "MammaryCellPropertyHelper.hpp"
+
+template<unsigned DIM>
+CellTypeSnapshotFormat<DIM>::CellTypeSnapshotFormat()
+    : AbstractSnapshotFormat<DIM>("results.viztypes")
+{
+}
+
+template<unsigned DIM>
+void CellTypeSnapshotFormat<DIM>::WriteSnapshot(const MammaryPopulationSnapshot<DIM>& rSnapshot, std::ostream& rStream)
+{
+    rStream << rSnapshot.GetTime() << "\t";
+
+    const std::vector<uint8_t>& r_cell_types = rSnapshot.rGetCellTypes();
+    const std::vector<uint8_t>& r_integrin_bits = rSnapshot.rGetIntegrinBits();
+    for (unsigned index=0; index<rSnapshot.GetNumCells(); index++)
+    {
+        // As in MammaryCellTypeWriter, cells with no mammary type are written as luminal, and only luminal and myoepithelial cells have integrin expression
+        unsigned cell_type = r_cell_types[index];
+        unsigned b1_expn = 0;
+        unsigned b4_expn = 0;
+        if (cell_type == LUMINAL_CELL || cell_type == MYOEPITHELIAL_CELL)
+        {
+            b1_expn = r_integrin_bits[index] & 1u;
+            b4_expn = (r_integrin_bits[index] >> 1) & 1u;
+        }
+        else if (cell_type == NO_MAMMARY_CELL_TYPE)
+        {
+            cell_type = 0;
+        }
+
+        rStream << " " << cell_type << " " << b1_expn << " " << b4_expn;
+        rStream << " " << rSnapshot.GetLocationIndex(index);
+        for (unsigned i=0; i<DIM; i++)
+        {
+            rStream << " " << rSnapshot.GetPosition(index, i);
+        }
+    }
+    rStream << "\n";
+}
+
+// Explicit instantiation
+template class CellTypeSnapshotFormat<1>;
+template class CellTypeSnapshotFormat<2>;
+template class CellTypeSnapshotFormat<3>;
@@ -0,0 +1,34 @@
+#ifndef CELLTYPESNAPSHOTFORMAT_HPP_
+#define CELLTYPESNAPSHOTFORMAT_HPP_
+
+#include "AbstractSnapshotFormat.hpp"
+
+/**
+ * Writes snapshots to results.viztypes, in the same text layout as MammaryCellTypeWriter:
+ *
+ * [time] then, for each cell, [cell type] [B1 expn] [B4 expn] [location index] [x-pos] [y-pos] [z-pos]
+ *
+ * where the cell type is 0 (luminal), 1 (myoepithelial), 2 (luminal stem cell) or
+ * 3 (myoepithelial stem cell), and integrin expression is only written for luminal and
+ * myoepithelial cells.
+ */
+template<unsigned DIM>
+class CellTypeSnapshotFormat : public AbstractSnapshotFormat<DIM>
+{
+public:
+
+    /**
+     * Default constructor.
+     */
+    CellTypeSnapshotFormat();
+
+    /**
+     * Overridden WriteSnapshot() method.
+     *
+     * @param rSnapshot the snapshot
+     * @param rStream the output stream
+     */
+    virtual void WriteSnapshot(const MammaryPopulationSnapshot<DIM>& rSnapshot, std::ostream& rStream);
+};
+
+#endif /*CELLTYPESNAPSHOTFORMAT_HPP_*/
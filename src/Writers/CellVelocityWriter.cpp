@@ -6,7 +6,7 @@
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 CellVelocityWriter<ELEMENT_DIM, SPACE_DIM>::CellVelocityWriter()
-    : AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>("velocity.dat")
+    : AbstractCompressibleWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >("velocity.dat")
 {
     this->mVtkCellDataName = "Cell Velocity";
 }
@@ -33,13 +33,13 @@ void CellVelocityWriter<ELEMENT_DIM, SPACE_DIM>::VisitCell(CellPtr pCell, Abstra
         unsigned cell_id = pCell->GetCellId();
        
         // Write the cell's ID to file
-        *this->mpOutStream << cell_id << " ";
+        this->rGetOutStream() << cell_id << " ";
 
         // Write the cell's position to file
         const c_vector<double, SPACE_DIM>& position = p_node->rGetLocation();
         for (unsigned i=0; i<SPACE_DIM; i++)
         {
-            *this->mpOutStream << position[i] << " ";
+            this->rGetOutStream() << position[i] << " ";
         }
 
         // Write the cell's velocity to file
@@ -50,7 +50,7 @@ void CellVelocityWriter<ELEMENT_DIM, SPACE_DIM>::VisitCell(CellPtr pCell, Abstra
         c_vector<double, SPACE_DIM> velocity = time_step * p_node->rGetAppliedForce() / damping_constant;
         for (unsigned i=0; i<SPACE_DIM; i++)
         {
-            *this->mpOutStream << velocity[i] << " ";
+            this->rGetOutStream() << velocity[i] << " ";
         }   
    
     }
@@ -4,14 +4,16 @@
 #include "AbstractCellWriter.hpp"
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
+#include "AbstractCompressibleWriter.hpp"
 
 /**
  * A class for writing cell velocities to file.
  */
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-class CellVelocityWriter : public AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>
+class CellVelocityWriter : public AbstractCompressibleWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >
 {
 private:
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
@@ -23,7 +25,7 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & boost::serialization::base_object<AbstractCompressibleWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> > >(*this);
     }
 
 public:
@@ -0,0 +1,49 @@
+#include "CompressedWriterBuffer.hpp"
+
+CompressedWriterBuffer::CompressedWriterBuffer()
+    : mType(NO_COMPRESSION),
+      mLevel(0)
+{
+}
+
+void CompressedWriterBuffer::SetCompression(CompressionType type, int level)
+{
+    // Create the compressor now, so that an unavailable type or bad level is reported straight away
+    mpCompressor.reset(new SnapshotCompressor(type, level));
+    mType = type;
+    mLevel = level;
+}
+
+CompressionType CompressedWriterBuffer::GetCompressionType() const
+{
+    return mType;
+}
+
+int CompressedWriterBuffer::GetCompressionLevel() const
+{
+    return mLevel;
+}
+
+std::ostream& CompressedWriterBuffer::rGetBuffer()
+{
+    return mBuffer;
+}
+
+void CompressedWriterBuffer::BeginFrame(std::ostream& rFileStream)
+{
+    mBuffer.str("");
+    mBuffer.clear();
+    mBuffer.copyfmt(rFileStream);
+}
+
+void CompressedWriterBuffer::EndFrame(std::ostream& rFileStream)
+{
+    if (!mpCompressor)
+    {
+        mpCompressor.reset(new SnapshotCompressor(mType, mLevel));
+    }
+
+    std::string frame = mBuffer.str();
+    mpCompressor->WriteFrame(frame.data(), frame.size(), rFileStream);
+    rFileStream.flush();
+}
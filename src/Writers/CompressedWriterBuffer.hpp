@@ -0,0 +1,97 @@
+#ifndef COMPRESSEDWRITERBUFFER_HPP_
+#define COMPRESSEDWRITERBUFFER_HPP_
+
+#include <iostream>
+#include <sstream>
+#include <boost/shared_ptr.hpp>
+#include <boost/utility.hpp>
+
+#include "ChasteSerialization.hpp"
+#include "SnapshotCompressor.hpp"
+
+/**
+ * The compression state of a text writer that can compress its output (see
+ * AbstractCompressibleWriter).
+ *
+ * While compressing, the writer writes each output time's line to an in-memory buffer,
+ * from BeginFrame() to EndFrame(), and EndFrame() compresses the buffer as one frame and
+ * appends it to the writer's output file.
+ */
+class CompressedWriterBuffer : boost::noncopyable
+{
+private:
+
+    /** The type of compression. */
+    CompressionType mType;
+
+    /** The compression level (0 for the library's default). */
+    int mLevel;
+
+    /** The compressor, created on first use. */
+    boost::shared_ptr<SnapshotCompressor> mpCompressor;
+
+    /** The line written for the current output time. */
+    std::ostringstream mBuffer;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object and its member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & mType;
+        archive & mLevel;
+        mpCompressor.reset();
+    }
+
+public:
+
+    /**
+     * Default constructor, with no compression.
+     */
+    CompressedWriterBuffer();
+
+    /**
+     * Set the compression. Throws if it is not available in this build.
+     *
+     * @param type the type of compression
+     * @param level the compression level (0 for the library's default)
+     */
+    void SetCompression(CompressionType type, int level);
+
+    /**
+     * @return mType
+     */
+    CompressionType GetCompressionType() const;
+
+    /**
+     * @return mLevel
+     */
+    int GetCompressionLevel() const;
+
+    /**
+     * @return the buffer to which the current output time's line is written
+     */
+    std::ostream& rGetBuffer();
+
+    /**
+     * Start a frame, emptying the buffer and giving it the number format of the output file.
+     *
+     * @param rFileStream the writer's output file
+     */
+    void BeginFrame(std::ostream& rFileStream);
+
+    /**
+     * Compress the buffer as one frame and append it to the writer's output file.
+     *
+     * @param rFileStream the writer's output file
+     */
+    void EndFrame(std::ostream& rFileStream);
+};
+
+#endif /*COMPRESSEDWRITERBUFFER_HPP_*/
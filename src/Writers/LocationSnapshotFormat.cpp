@@ -0,0 +1,47 @@
+#include "LocationSnapshotFormat.hpp"
+#include "MammaryCellPropertyHelper.hpp"
+
+template<unsigned DIM>
+LocationSnapshotFormat<DIM>::LocationSnapshotFormat()
+    : AbstractSnapshotFormat<DIM>("location.dat")
+{
+}
+
+template<unsigned DIM>
+void LocationSnapshotFormat<DIM>::WriteSnapshot(const MammaryPopulationSnapshot<DIM>& rSnapshot, std::ostream& rStream)
+{
+    rStream << rSnapshot.GetTime() << "\t";
+
+    const std::vector<uint32_t>& r_cell_ids = rSnapshot.rGetCellIds();
+    const std::vector<uint8_t>& r_cell_types = rSnapshot.rGetCellTypes();
+    for (unsigned index=0; index<rSnapshot.GetNumCells(); index++)
+    {
+        // As in CellLocationWriter, any cell that is not luminal, myoepithelial or a luminal stem cell is written as "MSC"
+        switch (r_cell_types[index])
+        {
+            case LUMINAL_CELL:
+                rStream << "Luminal" << " ";
+                break;
+            case MYOEPITHELIAL_CELL:
+                rStream << "Myoepithelial" << " ";
+                break;
+            case LUMINAL_STEM_CELL:
+                rStream << "LSC" << " ";
+                break;
+            default:
+                rStream << "MSC" << " ";
+        }
+
+        rStream << r_cell_ids[index] << " ";
+        for (unsigned i=0; i<DIM; i++)
+        {
+            rStream << rSnapshot.GetPosition(index, i) << " ";
+        }
+    }
+    rStream << "\n";
+}
+
+// Explicit instantiation
+template class LocationSnapshotFormat<1>;
+template class LocationSnapshotFormat<2>;
+template class LocationSnapshotFormat<3>;
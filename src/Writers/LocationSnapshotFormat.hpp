@@ -0,0 +1,33 @@
+#ifndef LOCATIONSNAPSHOTFORMAT_HPP_
+#define LOCATIONSNAPSHOTFORMAT_HPP_
+
+#include "AbstractSnapshotFormat.hpp"
+
+/**
+ * Writes snapshots to location.dat, in the same text layout as CellLocationWriter:
+ *
+ * [time] then, for each cell, [cell type] [cell ID] [x-pos] [y-pos] [z-pos]
+ *
+ * where the cell type is one of "Luminal", "Myoepithelial", "LSC" or "MSC", so that
+ * the output can be read with importfile_location.m.
+ */
+template<unsigned DIM>
+class LocationSnapshotFormat : public AbstractSnapshotFormat<DIM>
+{
+public:
+
+    /**
+     * Default constructor.
+     */
+    LocationSnapshotFormat();
+
+    /**
+     * Overridden WriteSnapshot() method.
+     *
+     * @param rSnapshot the snapshot
+     * @param rStream the output stream
+     */
+    virtual void WriteSnapshot(const MammaryPopulationSnapshot<DIM>& rSnapshot, std::ostream& rStream);
+};
+
+#endif /*LOCATIONSNAPSHOTFORMAT_HPP_*/
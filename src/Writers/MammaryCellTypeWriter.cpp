@@ -4,10 +4,11 @@
 #include "MyoepithelialCellProperty.hpp"
 #include "LuminalStemCellProperty.hpp"
 #include "MyoepithelialStemCellProperty.hpp"
+#include "MammaryCellPropertyHelper.hpp"
 
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 MammaryCellTypeWriter<ELEMENT_DIM, SPACE_DIM>::MammaryCellTypeWriter()
-    : AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>("results.viztypes")
+    : AbstractCompressibleWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >("results.viztypes")
 {
     this->mVtkCellDataName = "Mammary Cell Types";
 }
@@ -44,46 +45,32 @@ double MammaryCellTypeWriter<ELEMENT_DIM, SPACE_DIM>::GetCellDataForVtkOutput(Ce
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
 void MammaryCellTypeWriter<ELEMENT_DIM, SPACE_DIM>::VisitCell(CellPtr pCell, AbstractCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation)
 {
-    double cell_type = 0.0;
+    /*
+     * Cells with several mammary properties (e.g. the daughters of luminal stem cells) are
+     * resolved as in MammaryCellPropertyHelper, and so as in CellTypeSnapshotFormat. Cells
+     * with no mammary type are written as luminal, and only luminal and myoepithelial cells
+     * have integrin expression.
+     */
+    boost::shared_ptr<AbstractMammaryCellProperty> p_property = MammaryCellPropertyHelper::GetMammaryCellProperty(pCell);
+    MammaryCellType mammary_cell_type = MammaryCellPropertyHelper::GetMammaryCellType(p_property);
+    double cell_type = (mammary_cell_type == NO_MAMMARY_CELL_TYPE) ? 0.0 : double(mammary_cell_type);
     double b1_expn = 0.0;
     double b4_expn = 0.0;
-    if (pCell->HasCellProperty<LuminalCellProperty>())
-    {
-        CellPropertyCollection collection = pCell->rGetCellPropertyCollection().GetProperties<LuminalCellProperty>();
-        boost::shared_ptr<LuminalCellProperty> p_prop = boost::static_pointer_cast<LuminalCellProperty>(collection.GetProperty());
-        b1_expn = double(p_prop->GetB1IntegrinExpression());
-        b4_expn = double(p_prop->GetB4IntegrinExpression());
-    }
-    else if (pCell->HasCellProperty<MyoepithelialCellProperty>())
-    {
-        cell_type = 1.0;
-        CellPropertyCollection collection = pCell->rGetCellPropertyCollection().GetProperties<MyoepithelialCellProperty>();
-        boost::shared_ptr<MyoepithelialCellProperty> p_prop = boost::static_pointer_cast<MyoepithelialCellProperty>(collection.GetProperty());
-        b1_expn = double(p_prop->GetB1IntegrinExpression());
-        b4_expn = double(p_prop->GetB4IntegrinExpression());
-    }
-    else if (pCell->HasCellProperty<LuminalStemCellProperty>())
-    {
-        cell_type = 2.0;
-        CellPropertyCollection collection = pCell->rGetCellPropertyCollection().GetProperties<LuminalStemCellProperty>();
-        boost::shared_ptr<LuminalStemCellProperty> p_prop = boost::static_pointer_cast<LuminalStemCellProperty>(collection.GetProperty());
-    }
-    else if (pCell->HasCellProperty<MyoepithelialStemCellProperty>())
+    if (mammary_cell_type == LUMINAL_CELL || mammary_cell_type == MYOEPITHELIAL_CELL)
     {
-        cell_type = 3.0;
-        CellPropertyCollection collection = pCell->rGetCellPropertyCollection().GetProperties<MyoepithelialStemCellProperty>();
-        boost::shared_ptr<MyoepithelialStemCellProperty> p_prop = boost::static_pointer_cast<MyoepithelialStemCellProperty>(collection.GetProperty());
+        b1_expn = double(p_property->GetB1IntegrinExpression());
+        b4_expn = double(p_property->GetB4IntegrinExpression());
     }
 
-    *this->mpOutStream << " " << cell_type << " " << b1_expn << " " << b4_expn;
+    this->rGetOutStream() << " " << cell_type << " " << b1_expn << " " << b4_expn;
 
     unsigned location_index = pCellPopulation->GetLocationIndexUsingCell(pCell);
-    *this->mpOutStream << " " << location_index;
+    this->rGetOutStream() << " " << location_index;
 
     c_vector<double, SPACE_DIM> coords = pCellPopulation->GetLocationOfCellCentre(pCell);
     for (unsigned i=0; i<SPACE_DIM; i++)
     {
-        *this->mpOutStream << " " << coords[i];
+        this->rGetOutStream() << " " << coords[i];
     }
 }
 
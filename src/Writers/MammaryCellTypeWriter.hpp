@@ -5,6 +5,7 @@
 #include "ChasteSerialization.hpp"
 #include <boost/serialization/base_object.hpp>
 #include "AbstractCellWriter.hpp"
+#include "AbstractCompressibleWriter.hpp"
 
 /**
  * A class for writing mammary cell types (luminal and myoepithelial) to file.
@@ -14,9 +15,10 @@
  * the VTK cell data "Mammary cell types" by default.
  */
 template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
-class MammaryCellTypeWriter : public AbstractCellWriter<ELEMENT_DIM, SPACE_DIM>
+class MammaryCellTypeWriter : public AbstractCompressibleWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >
 {
 private:
+
     /** Needed for serialization. */
     friend class boost::serialization::access;
     /**
@@ -28,7 +30,7 @@ private:
     template<class Archive>
     void serialize(Archive & archive, const unsigned int version)
     {
-        archive & boost::serialization::base_object<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & boost::serialization::base_object<AbstractCompressibleWriter<AbstractCellWriter<ELEMENT_DIM, SPACE_DIM> > >(*this);
     }
 
 public:
@@ -0,0 +1,113 @@
+#include "MammaryCompositeWriter.hpp"
+
+#include "AbstractCellPopulation.hpp"
+#include "MeshBasedCellPopulation.hpp"
+#include "CaBasedCellPopulation.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "PottsBasedCellPopulation.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "Exception.hpp"
+#include "MammaryProfiler.hpp"
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+MammaryCompositeWriter<ELEMENT_DIM, SPACE_DIM>::MammaryCompositeWriter()
+    : AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>("mammary_output_times.dat")
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammaryCompositeWriter<ELEMENT_DIM, SPACE_DIM>::AddSnapshotFormat(boost::shared_ptr<AbstractSnapshotFormat<SPACE_DIM> > pFormat)
+{
+    mFormats.push_back(pFormat);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned MammaryCompositeWriter<ELEMENT_DIM, SPACE_DIM>::GetNumSnapshotFormats() const
+{
+    return mFormats.size();
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammaryCompositeWriter<ELEMENT_DIM, SPACE_DIM>::OpenOutputFile(OutputFileHandler& rOutputFileHandler)
+{
+    AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>::OpenOutputFile(rOutputFileHandler);
+
+    mFormatStreams.clear();
+    for (unsigned i=0; i<mFormats.size(); i++)
+    {
+        std::ios_base::openmode mode = std::ios::out | std::ios::trunc;
+        if (mFormats[i]->IsBinary())
+        {
+            mode |= std::ios::binary;
+        }
+        mFormatStreams.push_back(rOutputFileHandler.OpenOutputFile(mFormats[i]->rGetFileName(), mode));
+        mFormats[i]->WriteHeader(*mFormatStreams.back());
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammaryCompositeWriter<ELEMENT_DIM, SPACE_DIM>::VisitAnyPopulation(AbstractCellPopulation<SPACE_DIM, SPACE_DIM>* pCellPopulation)
+{
+    MAMMARY_PROFILE_SCOPE("step/output/MammaryCompositeWriter");
+
+    if (mFormatStreams.size() != mFormats.size())
+    {
+        EXCEPTION("The output files of MammaryCompositeWriter must be opened after all snapshot formats are added");
+    }
+
+    mSnapshot.Capture(*pCellPopulation);
+    *this->mpOutStream << mSnapshot.GetNumCells();
+
+    for (unsigned i=0; i<mFormats.size(); i++)
+    {
+        mFormats[i]->WriteSnapshot(mSnapshot, *mFormatStreams[i]);
+        mFormatStreams[i]->flush();
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammaryCompositeWriter<ELEMENT_DIM, SPACE_DIM>::Visit(MeshBasedCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation)
+{
+    AbstractCellPopulation<SPACE_DIM, SPACE_DIM>* p_population = dynamic_cast<AbstractCellPopulation<SPACE_DIM, SPACE_DIM>*>(pCellPopulation);
+    if (!p_population)
+    {
+        EXCEPTION("MammaryCompositeWriter is only implemented for populations whose element and space dimensions are equal");
+    }
+    VisitAnyPopulation(p_population);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammaryCompositeWriter<ELEMENT_DIM, SPACE_DIM>::Visit(CaBasedCellPopulation<SPACE_DIM>* pCellPopulation)
+{
+    VisitAnyPopulation(pCellPopulation);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammaryCompositeWriter<ELEMENT_DIM, SPACE_DIM>::Visit(NodeBasedCellPopulation<SPACE_DIM>* pCellPopulation)
+{
+    VisitAnyPopulation(pCellPopulation);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammaryCompositeWriter<ELEMENT_DIM, SPACE_DIM>::Visit(PottsBasedCellPopulation<SPACE_DIM>* pCellPopulation)
+{
+    VisitAnyPopulation(pCellPopulation);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammaryCompositeWriter<ELEMENT_DIM, SPACE_DIM>::Visit(VertexBasedCellPopulation<SPACE_DIM>* pCellPopulation)
+{
+    VisitAnyPopulation(pCellPopulation);
+}
+
+// Explicit instantiation
+template class MammaryCompositeWriter<1,1>;
+template class MammaryCompositeWriter<1,2>;
+template class MammaryCompositeWriter<2,2>;
+template class MammaryCompositeWriter<1,3>;
+template class MammaryCompositeWriter<2,3>;
+template class MammaryCompositeWriter<3,3>;
+
+#include "SerializationExportWrapperForCpp.hpp"
+// Declare identifier for the serializer
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(MammaryCompositeWriter)
@@ -0,0 +1,133 @@
+#ifndef MAMMARYCOMPOSITEWRITER_HPP_
+#define MAMMARYCOMPOSITEWRITER_HPP_
+
+#include <vector>
+#include <boost/shared_ptr.hpp>
+#include "AbstractCellPopulationWriter.hpp"
+#include "AbstractSnapshotFormat.hpp"
+#include "MammaryPopulationSnapshot.hpp"
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+/**
+ * A class written using the visitor pattern that writes several per-cell outputs from a
+ * single pass over the cells, in place of attaching MammaryCellTypeWriter,
+ * CellLocationWriter and CellVelocityWriter separately (each of which looks up the
+ * location index, position and properties of every cell again).
+ *
+ * At each output time the population is copied once into a MammaryPopulationSnapshot,
+ * which is then written in each of the added snapshot formats (e.g. CellTypeSnapshotFormat,
+ * LocationSnapshotFormat and VelocitySnapshotFormat, which reproduce the output of the
+ * writers above), each to its own file.
+ *
+ * The writer's own output file, mammary_output_times.dat, has one line per output time
+ * of the form [present simulation time] [number of cells].
+ *
+ * The format files are opened by OpenOutputFile() and stay open (flushed after every
+ * output time) until the writer is destroyed or the files are opened again. The added
+ * formats are not archived, so must be added again after loading a simulation.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+class MammaryCompositeWriter : public AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>
+{
+private:
+
+    /** The snapshot, reused between output time steps to avoid reallocating its arrays. */
+    MammaryPopulationSnapshot<SPACE_DIM> mSnapshot;
+
+    /** The formats in which snapshots are written. */
+    std::vector<boost::shared_ptr<AbstractSnapshotFormat<SPACE_DIM> > > mFormats;
+
+    /** The output file of each format. */
+    std::vector<out_stream> mFormatStreams;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object and its member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM> >(*this);
+    }
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    MammaryCompositeWriter();
+
+    /**
+     * Add a format in which snapshots are written. Must be called before the output files are opened.
+     *
+     * @param pFormat the format
+     */
+    void AddSnapshotFormat(boost::shared_ptr<AbstractSnapshotFormat<SPACE_DIM> > pFormat);
+
+    /**
+     * @return the number of formats in which snapshots are written
+     */
+    unsigned GetNumSnapshotFormats() const;
+
+    /**
+     * Overridden OpenOutputFile() method.
+     *
+     * Opens the writer's own output file, and the output file of each format.
+     *
+     * @param rOutputFileHandler handler for the directory in which to open the files
+     */
+    virtual void OpenOutputFile(OutputFileHandler& rOutputFileHandler);
+
+    /**
+     * Visit the population, copy it into the snapshot and write the snapshot in each format.
+     *
+     * @param pCellPopulation a pointer to the population to visit.
+     */
+    void VisitAnyPopulation(AbstractCellPopulation<SPACE_DIM, SPACE_DIM>* pCellPopulation);
+
+    /**
+     * Visit the population and write the data. Only implemented if ELEMENT_DIM equals SPACE_DIM.
+     *
+     * @param pCellPopulation a pointer to the MeshBasedCellPopulation to visit.
+     */
+    virtual void Visit(MeshBasedCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation);
+
+    /**
+     * Visit the population and write the data.
+     *
+     * @param pCellPopulation a pointer to the CaBasedCellPopulation to visit.
+     */
+    virtual void Visit(CaBasedCellPopulation<SPACE_DIM>* pCellPopulation);
+
+    /**
+     * Visit the population and write the data.
+     *
+     * @param pCellPopulation a pointer to the NodeBasedCellPopulation to visit.
+     */
+    virtual void Visit(NodeBasedCellPopulation<SPACE_DIM>* pCellPopulation);
+
+    /**
+     * Visit the population and write the data.
+     *
+     * @param pCellPopulation a pointer to the PottsBasedCellPopulation to visit.
+     */
+    virtual void Visit(PottsBasedCellPopulation<SPACE_DIM>* pCellPopulation);
+
+    /**
+     * Visit the population and write the data.
+     *
+     * @param pCellPopulation a pointer to the VertexBasedCellPopulation to visit.
+     */
+    virtual void Visit(VertexBasedCellPopulation<SPACE_DIM>* pCellPopulation);
+};
+
+#include "SerializationExportWrapper.hpp"
+// Declare identifier for the serializer
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(MammaryCompositeWriter)
+
+#endif /* MAMMARYCOMPOSITEWRITER_HPP_ */
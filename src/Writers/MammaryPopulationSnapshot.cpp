@@ -0,0 +1,379 @@
+#include "MammaryPopulationSnapshot.hpp"
+#include <cstring>
+#include <map>
+#include "NodeBasedCellPopulation.hpp"
+#include "MammaryCellPropertyHelper.hpp"
+#include "SimulationTime.hpp"
+
+/**
+ * Write an array to a binary stream.
+ *
+ * @param rStream the stream
+ * @param rValues the values
+ */
+template<class T>
+static void WriteArray(std::ostream& rStream, const std::vector<T>& rValues)
+{
+    if (!rValues.empty())
+    {
+        rStream.write(reinterpret_cast<const char*>(&rValues[0]), rValues.size()*sizeof(T));
+    }
+}
+
+/**
+ * Read an array from a binary stream.
+ *
+ * @param rStream the stream
+ * @param rValues the values, which must already be of the required size
+ * @return whether the values were read in full
+ */
+template<class T>
+static bool ReadArray(std::istream& rStream, std::vector<T>& rValues)
+{
+    if (!rValues.empty())
+    {
+        rStream.read(reinterpret_cast<char*>(&rValues[0]), rValues.size()*sizeof(T));
+    }
+    return !rStream.fail();
+}
+
+/**
+ * XOR the bit pattern of one double with that of another.
+ *
+ * @param rValue the value to change
+ * @param other the other value
+ */
+static void XorDouble(double& rValue, double other)
+{
+    uint64_t value_bits;
+    uint64_t other_bits;
+    memcpy(&value_bits, &rValue, sizeof(double));
+    memcpy(&other_bits, &other, sizeof(double));
+    value_bits ^= other_bits;
+    memcpy(&rValue, &value_bits, sizeof(double));
+}
+
+template<unsigned DIM>
+const uint32_t MammaryPopulationSnapshot<DIM>::HAS_VELOCITIES;
+
+template<unsigned DIM>
+const uint32_t MammaryPopulationSnapshot<DIM>::HAS_DELTAS;
+
+template<unsigned DIM>
+MammaryPopulationSnapshot<DIM>::MammaryPopulationSnapshot()
+    : mTime(0.0),
+      mHasVelocities(false),
+      mHasDeltas(false)
+{
+}
+
+template<unsigned DIM>
+void MammaryPopulationSnapshot<DIM>::Capture(AbstractCellPopulation<DIM>& rCellPopulation)
+{
+    NodeBasedCellPopulation<DIM>* p_node_population = dynamic_cast<NodeBasedCellPopulation<DIM>*>(&rCellPopulation);
+    double time_step = SimulationTime::Instance()->GetTimeStep();
+
+    mTime = SimulationTime::Instance()->GetTime();
+    Resize(rCellPopulation.GetNumRealCells(), p_node_population != NULL);
+
+    unsigned index = 0;
+    for (typename AbstractCellPopulation<DIM>::Iterator cell_iter = rCellPopulation.Begin();
+         cell_iter != rCellPopulation.End();
+         ++cell_iter)
+    {
+        boost::shared_ptr<AbstractMammaryCellProperty> p_property = MammaryCellPropertyHelper::GetMammaryCellProperty(*cell_iter);
+        unsigned integrin_bits = 0;
+        if (p_property)
+        {
+            integrin_bits = (p_property->GetB1IntegrinExpression() ? 1u : 0u) | (p_property->GetB4IntegrinExpression() ? 2u : 0u);
+        }
+
+        SetCell(index,
+                cell_iter->GetCellId(),
+                MammaryCellPropertyHelper::GetMammaryCellType(p_property),
+                integrin_bits,
+                rCellPopulation.GetLocationOfCellCentre(*cell_iter));
+
+        unsigned location_index = rCellPopulation.GetLocationIndexUsingCell(*cell_iter);
+        SetLocationIndex(index, location_index);
+
+        if (p_node_population)
+        {
+            Node<DIM>* p_node = rCellPopulation.GetNode(location_index);
+            double damping_constant = p_node_population->GetDampingConstant(location_index);
+            c_vector<double, DIM> velocity = time_step * p_node->rGetAppliedForce() / damping_constant;
+            SetVelocity(index, velocity);
+        }
+        index++;
+    }
+}
+
+template<unsigned DIM>
+void MammaryPopulationSnapshot<DIM>::Clear()
+{
+    Resize(0, false);
+}
+
+template<unsigned DIM>
+void MammaryPopulationSnapshot<DIM>::Resize(unsigned numCells, bool hasVelocities)
+{
+    mCellIds.resize(numCells);
+    mCellTypes.resize(numCells);
+    mIntegrinBits.resize(numCells);
+    mLocationIndices.resize(numCells);
+    mPositions.resize(DIM*numCells);
+    mVelocities.resize(hasVelocities ? DIM*numCells : 0);
+    mHasVelocities = hasVelocities;
+    mHasDeltas = false;
+}
+
+template<unsigned DIM>
+void MammaryPopulationSnapshot<DIM>::SetCell(unsigned index,
+                                             unsigned cellId,
+                                             unsigned cellType,
+                                             unsigned integrinBits,
+                                             const c_vector<double, DIM>& rPosition)
+{
+    unsigned num_cells = mCellIds.size();
+    mCellIds[index] = cellId;
+    mCellTypes[index] = cellType;
+    mIntegrinBits[index] = integrinBits;
+    for (unsigned i=0; i<DIM; i++)
+    {
+        mPositions[i*num_cells + index] = rPosition[i];
+    }
+}
+
+template<unsigned DIM>
+void MammaryPopulationSnapshot<DIM>::SetVelocity(unsigned index, const c_vector<double, DIM>& rVelocity)
+{
+    assert(mHasVelocities);
+    unsigned num_cells = mCellIds.size();
+    for (unsigned i=0; i<DIM; i++)
+    {
+        mVelocities[i*num_cells + index] = rVelocity[i];
+    }
+}
+
+template<unsigned DIM>
+void MammaryPopulationSnapshot<DIM>::SetLocationIndex(unsigned index, unsigned locationIndex)
+{
+    mLocationIndices[index] = locationIndex;
+}
+
+template<unsigned DIM>
+double MammaryPopulationSnapshot<DIM>::GetTime() const
+{
+    return mTime;
+}
+
+template<unsigned DIM>
+void MammaryPopulationSnapshot<DIM>::SetTime(double time)
+{
+    mTime = time;
+}
+
+template<unsigned DIM>
+unsigned MammaryPopulationSnapshot<DIM>::GetNumCells() const
+{
+    return mCellIds.size();
+}
+
+template<unsigned DIM>
+bool MammaryPopulationSnapshot<DIM>::HasVelocities() const
+{
+    return mHasVelocities;
+}
+
+template<unsigned DIM>
+bool MammaryPopulationSnapshot<DIM>::HasDeltas() const
+{
+    return mHasDeltas;
+}
+
+template<unsigned DIM>
+std::size_t MammaryPopulationSnapshot<DIM>::GetNumBytesReserved() const
+{
+    return mCellIds.capacity()*sizeof(uint32_t) + mCellTypes.capacity()*sizeof(uint8_t)
+           + mIntegrinBits.capacity()*sizeof(uint8_t) + mLocationIndices.capacity()*sizeof(uint32_t)
+           + mPositions.capacity()*sizeof(double) + mVelocities.capacity()*sizeof(double);
+}
+
+template<unsigned DIM>
+void MammaryPopulationSnapshot<DIM>::XorWith(const MammaryPopulationSnapshot<DIM>& rOther)
+{
+    assert(!rOther.mHasDeltas);
+
+    // Cells are usually visited in the same order at each output time, so try the same index first
+    std::map<uint32_t, unsigned> other_indices;
+    unsigned num_cells = mCellIds.size();
+    unsigned num_other_cells = rOther.mCellIds.size();
+    bool both_have_velocities = mHasVelocities && rOther.mHasVelocities;
+
+    for (unsigned index=0; index<num_cells; index++)
+    {
+        unsigned other_index = num_other_cells;
+        if (index < num_other_cells && rOther.mCellIds[index] == mCellIds[index])
+        {
+            other_index = index;
+        }
+        else
+        {
+            if (other_indices.empty())
+            {
+                for (unsigned j=0; j<num_other_cells; j++)
+                {
+                    other_indices[rOther.mCellIds[j]] = j;
+                }
+            }
+            std::map<uint32_t, unsigned>::const_iterator it = other_indices.find(mCellIds[index]);
+            if (it != other_indices.end())
+            {
+                other_index = it->second;
+            }
+        }
+
+        if (other_index < num_other_cells)
+        {
+            for (unsigned i=0; i<DIM; i++)
+            {
+                XorDouble(mPositions[i*num_cells + index], rOther.mPositions[i*num_other_cells + other_index]);
+                if (both_have_velocities)
+                {
+                    XorDouble(mVelocities[i*num_cells + index], rOther.mVelocities[i*num_other_cells + other_index]);
+                }
+            }
+        }
+    }
+}
+
+template<unsigned DIM>
+void MammaryPopulationSnapshot<DIM>::EncodeDeltas(const MammaryPopulationSnapshot<DIM>& rPrevious)
+{
+    assert(!mHasDeltas);
+    XorWith(rPrevious);
+    mHasDeltas = true;
+}
+
+template<unsigned DIM>
+void MammaryPopulationSnapshot<DIM>::DecodeDeltas(const MammaryPopulationSnapshot<DIM>& rPrevious)
+{
+    assert(mHasDeltas);
+    XorWith(rPrevious);
+    mHasDeltas = false;
+}
+
+template<unsigned DIM>
+const std::vector<uint32_t>& MammaryPopulationSnapshot<DIM>::rGetCellIds() const
+{
+    return mCellIds;
+}
+
+template<unsigned DIM>
+const std::vector<uint8_t>& MammaryPopulationSnapshot<DIM>::rGetCellTypes() const
+{
+    return mCellTypes;
+}
+
+template<unsigned DIM>
+const std::vector<uint8_t>& MammaryPopulationSnapshot<DIM>::rGetIntegrinBits() const
+{
+    return mIntegrinBits;
+}
+
+template<unsigned DIM>
+const std::vector<double>& MammaryPopulationSnapshot<DIM>::rGetPositions() const
+{
+    return mPositions;
+}
+
+template<unsigned DIM>
+const std::vector<double>& MammaryPopulationSnapshot<DIM>::rGetVelocities() const
+{
+    return mVelocities;
+}
+
+template<unsigned DIM>
+double MammaryPopulationSnapshot<DIM>::GetPosition(unsigned index, unsigned component) const
+{
+    return mPositions[component*mCellIds.size() + index];
+}
+
+template<unsigned DIM>
+double MammaryPopulationSnapshot<DIM>::GetVelocity(unsigned index, unsigned component) const
+{
+    return mVelocities[component*mCellIds.size() + index];
+}
+
+template<unsigned DIM>
+unsigned MammaryPopulationSnapshot<DIM>::GetLocationIndex(unsigned index) const
+{
+    return mLocationIndices[index];
+}
+
+template<unsigned DIM>
+uint64_t MammaryPopulationSnapshot<DIM>::GetBlockSize() const
+{
+    uint64_t num_cells = mCellIds.size();
+    return sizeof(double) + 2*sizeof(uint32_t)
+           + num_cells*(sizeof(uint32_t) + 2*sizeof(uint8_t))
+           + (mPositions.size() + mVelocities.size())*sizeof(double);
+}
+
+template<unsigned DIM>
+void MammaryPopulationSnapshot<DIM>::WriteFileHeader(std::ostream& rStream, CompressionType compression)
+{
+    uint32_t version = MAMMARY_SNAPSHOT_FORMAT_VERSION;
+    uint32_t dimension = DIM;
+    uint32_t compression_type = compression;
+    rStream.write(MAMMARY_SNAPSHOT_FILE_MAGIC, 4);
+    rStream.write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
+    rStream.write(reinterpret_cast<const char*>(&dimension), sizeof(uint32_t));
+    rStream.write(reinterpret_cast<const char*>(&compression_type), sizeof(uint32_t));
+}
+
+template<unsigned DIM>
+void MammaryPopulationSnapshot<DIM>::WriteBlock(std::ostream& rStream) const
+{
+    uint32_t num_cells = mCellIds.size();
+    uint32_t flags = (mHasVelocities ? HAS_VELOCITIES : 0u) | (mHasDeltas ? HAS_DELTAS : 0u);
+
+    rStream.write(reinterpret_cast<const char*>(&mTime), sizeof(double));
+    rStream.write(reinterpret_cast<const char*>(&num_cells), sizeof(uint32_t));
+    rStream.write(reinterpret_cast<const char*>(&flags), sizeof(uint32_t));
+
+    WriteArray(rStream, mCellIds);
+    WriteArray(rStream, mCellTypes);
+    WriteArray(rStream, mIntegrinBits);
+    WriteArray(rStream, mPositions);
+    WriteArray(rStream, mVelocities);
+}
+
+template<unsigned DIM>
+bool MammaryPopulationSnapshot<DIM>::ReadBlock(std::istream& rStream)
+{
+    uint32_t num_cells = 0;
+    uint32_t flags = 0;
+
+    rStream.read(reinterpret_cast<char*>(&mTime), sizeof(double));
+    rStream.read(reinterpret_cast<char*>(&num_cells), sizeof(uint32_t));
+    rStream.read(reinterpret_cast<char*>(&flags), sizeof(uint32_t));
+    if (rStream.fail())
+    {
+        return false;
+    }
+
+    Resize(num_cells, (flags & HAS_VELOCITIES) != 0);
+    mHasDeltas = (flags & HAS_DELTAS) != 0;
+
+    return ReadArray(rStream, mCellIds)
+           && ReadArray(rStream, mCellTypes)
+           && ReadArray(rStream, mIntegrinBits)
+           && ReadArray(rStream, mPositions)
+           && ReadArray(rStream, mVelocities);
+}
+
+// Explicit instantiation
+template class MammaryPopulationSnapshot<1>;
+template class MammaryPopulationSnapshot<2>;
+template class MammaryPopulationSnapshot<3>;
@@ -0,0 +1,272 @@
+#ifndef MAMMARYPOPULATIONSNAPSHOT_HPP_
+#define MAMMARYPOPULATIONSNAPSHOT_HPP_
+
+#include <iostream>
+#include <vector>
+#include <stdint.h>
+
+#include "AbstractCellPopulation.hpp"
+#include "SnapshotCompressor.hpp"
+
+/** The four bytes at the start of a snapshot file written by MammarySnapshotWriter. */
+const char MAMMARY_SNAPSHOT_FILE_MAGIC[4] = {'M', 'S', 'N', 'P'};
+
+/** The four bytes at the start of the index of a snapshot file. */
+const char MAMMARY_SNAPSHOT_INDEX_MAGIC[4] = {'M', 'S', 'N', 'I'};
+
+/**
+ * The version of the snapshot file format. Version 2 added the compression type to the
+ * file header, and delta-encoded blocks.
+ */
+const uint32_t MAMMARY_SNAPSHOT_FORMAT_VERSION = 2;
+
+/**
+ * The state of a mammary cell population at one output time, stored column by column
+ * (one packed array per quantity) rather than cell by cell.
+ *
+ * Each snapshot is written as a block of the form
+ *
+ * [time (double)] [number of cells N (uint32)] [flags (uint32)]
+ * [cell IDs (N x uint32)] [cell types (N x uint8)] [integrin bits (N x uint8)]
+ * [positions (DIM x N doubles)] [velocities (DIM x N doubles), if bit 0 of the flags is set]
+ *
+ * with no padding and in native byte order. The cell types take the values of
+ * MammaryCellType; bit 0 of the integrin bits is set if B1 integrin is expressed and
+ * bit 1 if B4 integrin is expressed. Positions and velocities are stored component by
+ * component, i.e. all x-coordinates, then all y-coordinates and so on.
+ *
+ * If bit 1 of the flags is set, the block is delta-encoded: the bit pattern of each
+ * position and velocity component is XORed with that of the same cell (by ID) in the
+ * previous block, so that slowly moving cells leave mostly zero bytes for the compressor.
+ * Cells that are not in the previous block are stored as they are.
+ */
+template<unsigned DIM>
+class MammaryPopulationSnapshot
+{
+private:
+
+    /** The time at which the snapshot was taken. */
+    double mTime;
+
+    /** The ID of each cell. */
+    std::vector<uint32_t> mCellIds;
+
+    /** The MammaryCellType of each cell. */
+    std::vector<uint8_t> mCellTypes;
+
+    /** The integrin bits of each cell. */
+    std::vector<uint8_t> mIntegrinBits;
+
+    /** The location index of each cell in the population (only filled in by Capture(); not written to blocks). */
+    std::vector<uint32_t> mLocationIndices;
+
+    /** The position of each cell, component by component. */
+    std::vector<double> mPositions;
+
+    /** The velocity of each cell, component by component (empty if not available). */
+    std::vector<double> mVelocities;
+
+    /** Whether the snapshot holds velocities. */
+    bool mHasVelocities;
+
+    /** Whether the positions and velocities are delta-encoded. */
+    bool mHasDeltas;
+
+    /**
+     * XOR the bit patterns of the positions and velocities with those of the same cells
+     * in another snapshot. This is its own inverse.
+     *
+     * @param rOther the other snapshot, which must not be delta-encoded
+     */
+    void XorWith(const MammaryPopulationSnapshot<DIM>& rOther);
+
+public:
+
+    /** Bit of the block flags set if the block contains velocities. */
+    static const uint32_t HAS_VELOCITIES = 1u;
+
+    /** Bit of the block flags set if the block is delta-encoded. */
+    static const uint32_t HAS_DELTAS = 2u;
+
+    /**
+     * Default constructor.
+     */
+    MammaryPopulationSnapshot();
+
+    /**
+     * Fill in the snapshot from a cell population at the current time.
+     *
+     * Velocities are only available for a NodeBasedCellPopulation, and are calculated from
+     * the applied force and damping constant of each node as in CellVelocityWriter.
+     *
+     * @param rCellPopulation the cell population
+     */
+    void Capture(AbstractCellPopulation<DIM>& rCellPopulation);
+
+    /**
+     * Empty the snapshot, keeping the memory allocated to it.
+     */
+    void Clear();
+
+    /**
+     * Resize the snapshot, keeping the memory allocated to it.
+     *
+     * @param numCells the number of cells
+     * @param hasVelocities whether the snapshot holds velocities
+     */
+    void Resize(unsigned numCells, bool hasVelocities);
+
+    /**
+     * Set the data of a cell.
+     *
+     * @param index the index of the cell in the snapshot
+     * @param cellId the ID of the cell
+     * @param cellType the MammaryCellType of the cell
+     * @param integrinBits the integrin bits of the cell
+     * @param rPosition the position of the cell
+     */
+    void SetCell(unsigned index,
+                 unsigned cellId,
+                 unsigned cellType,
+                 unsigned integrinBits,
+                 const c_vector<double, DIM>& rPosition);
+
+    /**
+     * Set the velocity of a cell. The snapshot must have been resized to hold velocities.
+     *
+     * @param index the index of the cell in the snapshot
+     * @param rVelocity the velocity of the cell
+     */
+    void SetVelocity(unsigned index, const c_vector<double, DIM>& rVelocity);
+
+    /**
+     * Set the location index of a cell in the population.
+     *
+     * @param index the index of the cell in the snapshot
+     * @param locationIndex the location index of the cell
+     */
+    void SetLocationIndex(unsigned index, unsigned locationIndex);
+
+    /**
+     * @return mTime
+     */
+    double GetTime() const;
+
+    /**
+     * Set mTime.
+     *
+     * @param time the time
+     */
+    void SetTime(double time);
+
+    /**
+     * @return the number of cells in the snapshot
+     */
+    unsigned GetNumCells() const;
+
+    /**
+     * @return whether the snapshot holds velocities
+     */
+    bool HasVelocities() const;
+
+    /**
+     * @return whether the positions and velocities are delta-encoded
+     */
+    bool HasDeltas() const;
+
+    /**
+     * @return the number of bytes reserved by the snapshot's arrays
+     */
+    std::size_t GetNumBytesReserved() const;
+
+    /**
+     * Delta-encode the positions and velocities against a previous snapshot.
+     *
+     * @param rPrevious the previous snapshot, which must not be delta-encoded
+     */
+    void EncodeDeltas(const MammaryPopulationSnapshot<DIM>& rPrevious);
+
+    /**
+     * Undo EncodeDeltas().
+     *
+     * @param rPrevious the snapshot against which this one was encoded, already decoded
+     */
+    void DecodeDeltas(const MammaryPopulationSnapshot<DIM>& rPrevious);
+
+    /**
+     * @return mCellIds
+     */
+    const std::vector<uint32_t>& rGetCellIds() const;
+
+    /**
+     * @return mCellTypes
+     */
+    const std::vector<uint8_t>& rGetCellTypes() const;
+
+    /**
+     * @return mIntegrinBits
+     */
+    const std::vector<uint8_t>& rGetIntegrinBits() const;
+
+    /**
+     * @return mPositions
+     */
+    const std::vector<double>& rGetPositions() const;
+
+    /**
+     * @return mVelocities
+     */
+    const std::vector<double>& rGetVelocities() const;
+
+    /**
+     * @param index the index of a cell in the snapshot
+     * @param component the component
+     * @return the given component of the position of the cell
+     */
+    double GetPosition(unsigned index, unsigned component) const;
+
+    /**
+     * @param index the index of a cell in the snapshot
+     * @param component the component
+     * @return the given component of the velocity of the cell
+     */
+    double GetVelocity(unsigned index, unsigned component) const;
+
+    /**
+     * @param index the index of a cell in the snapshot
+     * @return the location index of the cell in the population
+     */
+    unsigned GetLocationIndex(unsigned index) const;
+
+    /**
+     * @return the number of bytes taken by the snapshot when written with WriteBlock()
+     */
+    uint64_t GetBlockSize() const;
+
+    /**
+     * Write the header of a snapshot file written by MammarySnapshotWriter, of the form
+     * ['MSNP' (4 chars)] [format version (uint32)] [space dimension (uint32)]
+     * [compression of the blocks (uint32, a CompressionType)].
+     *
+     * @param rStream the stream, which should be opened in binary mode
+     * @param compression the compression of the blocks that follow (defaults to none)
+     */
+    static void WriteFileHeader(std::ostream& rStream, CompressionType compression=NO_COMPRESSION);
+
+    /**
+     * Write the snapshot as a block, in the layout given above.
+     *
+     * @param rStream the stream, which should be opened in binary mode
+     */
+    void WriteBlock(std::ostream& rStream) const;
+
+    /**
+     * Read a block written by WriteBlock().
+     *
+     * @param rStream the stream, positioned at the start of a block
+     * @return whether a complete block was read
+     */
+    bool ReadBlock(std::istream& rStream);
+};
+
+#endif /*MAMMARYPOPULATIONSNAPSHOT_HPP_*/
@@ -0,0 +1,328 @@
+#include "MammarySnapshotReader.hpp"
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include "Exception.hpp"
+
+template<unsigned DIM>
+MammarySnapshotReader<DIM>::MammarySnapshotReader(const std::string& rFileName)
+    : mFileSize(0),
+      mCompression(NO_COMPRESSION),
+      mLastSnapshotIndex(UINT_MAX)
+{
+    mFile.open(rFileName.c_str(), std::ios::in | std::ios::binary);
+    if (!mFile.is_open())
+    {
+        EXCEPTION("Could not open snapshot file " + rFileName);
+    }
+
+    mFile.seekg(0, std::ios::end);
+    mFileSize = static_cast<uint64_t>(mFile.tellg());
+    mFile.seekg(0, std::ios::beg);
+
+    char magic[4];
+    uint32_t version = 0;
+    uint32_t dimension = 0;
+    mFile.read(magic, 4);
+    mFile.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
+    mFile.read(reinterpret_cast<char*>(&dimension), sizeof(uint32_t));
+    if (mFile.fail() || memcmp(magic, MAMMARY_SNAPSHOT_FILE_MAGIC, 4) != 0)
+    {
+        EXCEPTION(rFileName + " is not a mammary snapshot file");
+    }
+    if (version == 0 || version > MAMMARY_SNAPSHOT_FORMAT_VERSION)
+    {
+        EXCEPTION("Unsupported snapshot file format version in " + rFileName);
+    }
+    if (dimension != DIM)
+    {
+        EXCEPTION("Snapshot file " + rFileName + " was written by a simulation of a different dimension");
+    }
+    uint64_t header_size = 4 + 2*sizeof(uint32_t);
+
+    // Version 1 files have no compression field
+    if (version >= 2)
+    {
+        uint32_t compression = 0;
+        mFile.read(reinterpret_cast<char*>(&compression), sizeof(uint32_t));
+        mCompression = static_cast<CompressionType>(compression);
+        if (mFile.fail() || !SnapshotCompressor::IsAvailable(mCompression))
+        {
+            EXCEPTION("Snapshot file " + rFileName + " is compressed in a way not supported by this build");
+        }
+        header_size += sizeof(uint32_t);
+    }
+
+    // The index file sits next to the snapshot file, with the extension .idx
+    std::string index_file_name = rFileName;
+    std::string::size_type dot = index_file_name.rfind('.');
+    if (dot != std::string::npos && index_file_name.find('/', dot) == std::string::npos)
+    {
+        index_file_name.erase(dot);
+    }
+    index_file_name += ".idx";
+    ReadIndex(index_file_name);
+
+    if (mCompression != NO_COMPRESSION)
+    {
+        // The size of a frame is only found by decompressing it, so start again from the last indexed one
+        uint64_t offset = header_size;
+        if (!mOffsets.empty())
+        {
+            offset = mOffsets.back();
+            mTimes.pop_back();
+            mOffsets.pop_back();
+            mNumCells.pop_back();
+        }
+        ScanFrames(offset);
+        mFile.clear();
+        return;
+    }
+
+    // Find any snapshots written after the last indexed one
+    uint64_t offset = header_size;
+    if (!mOffsets.empty())
+    {
+        double time;
+        unsigned num_cells;
+        uint64_t block_size;
+        ReadBlockHeader(mOffsets.back(), time, num_cells, block_size);
+        offset = mOffsets.back() + block_size;
+    }
+    while (offset < mFileSize)
+    {
+        double time;
+        unsigned num_cells;
+        uint64_t block_size;
+        if (!ReadBlockHeader(offset, time, num_cells, block_size))
+        {
+            break;
+        }
+        mTimes.push_back(time);
+        mOffsets.push_back(offset);
+        mNumCells.push_back(num_cells);
+        offset += block_size;
+    }
+    mFile.clear();
+}
+
+template<unsigned DIM>
+bool MammarySnapshotReader<DIM>::ReadBlockHeader(uint64_t offset, double& rTime, unsigned& rNumCells, uint64_t& rBlockSize)
+{
+    uint32_t num_cells = 0;
+    uint32_t flags = 0;
+
+    mFile.clear();
+    mFile.seekg(offset, std::ios::beg);
+    mFile.read(reinterpret_cast<char*>(&rTime), sizeof(double));
+    mFile.read(reinterpret_cast<char*>(&num_cells), sizeof(uint32_t));
+    mFile.read(reinterpret_cast<char*>(&flags), sizeof(uint32_t));
+    if (mFile.fail())
+    {
+        return false;
+    }
+
+    unsigned num_vector_columns = (flags & MammaryPopulationSnapshot<DIM>::HAS_VELOCITIES) ? 2 : 1;
+    rNumCells = num_cells;
+    rBlockSize = sizeof(double) + 2*sizeof(uint32_t)
+                 + uint64_t(num_cells)*(sizeof(uint32_t) + 2*sizeof(uint8_t))
+                 + uint64_t(num_cells)*DIM*num_vector_columns*sizeof(double);
+
+    return offset + rBlockSize <= mFileSize;
+}
+
+template<unsigned DIM>
+void MammarySnapshotReader<DIM>::ReadIndex(const std::string& rIndexFileName)
+{
+    std::ifstream index_file(rIndexFileName.c_str(), std::ios::in | std::ios::binary);
+    if (!index_file.is_open())
+    {
+        return;
+    }
+
+    char magic[4];
+    uint32_t version = 0;
+    index_file.read(magic, 4);
+    index_file.read(reinterpret_cast<char*>(&version), sizeof(uint32_t));
+    if (index_file.fail() || memcmp(magic, MAMMARY_SNAPSHOT_INDEX_MAGIC, 4) != 0 || version == 0 || version > MAMMARY_SNAPSHOT_FORMAT_VERSION)
+    {
+        return;
+    }
+
+    while (true)
+    {
+        double time;
+        uint64_t offset;
+        uint32_t num_cells;
+        index_file.read(reinterpret_cast<char*>(&time), sizeof(double));
+        index_file.read(reinterpret_cast<char*>(&offset), sizeof(uint64_t));
+        index_file.read(reinterpret_cast<char*>(&num_cells), sizeof(uint32_t));
+        if (index_file.fail())
+        {
+            break;
+        }
+
+        /*
+         * Compressed frames are contiguous, so a frame is complete if the next one starts
+         * inside the file; the last one is checked by the constructor.
+         */
+        if (mCompression != NO_COMPRESSION)
+        {
+            if (offset >= mFileSize || (!mOffsets.empty() && offset <= mOffsets.back()))
+            {
+                break;
+            }
+            mTimes.push_back(time);
+            mOffsets.push_back(offset);
+            mNumCells.push_back(num_cells);
+            continue;
+        }
+
+        // Stop at the first entry whose block is not (entirely) in the snapshot file
+        double block_time;
+        unsigned block_num_cells;
+        uint64_t block_size;
+        if (!ReadBlockHeader(offset, block_time, block_num_cells, block_size) || block_num_cells != num_cells)
+        {
+            break;
+        }
+
+        mTimes.push_back(time);
+        mOffsets.push_back(offset);
+        mNumCells.push_back(num_cells);
+    }
+}
+
+template<unsigned DIM>
+void MammarySnapshotReader<DIM>::ScanFrames(uint64_t offset)
+{
+    if (offset >= mFileSize)
+    {
+        return;
+    }
+
+    // Frames carry no length, so read the rest of the file and decompress them one after another
+    mFrameBuffer.resize(mFileSize - offset);
+    mFile.clear();
+    mFile.seekg(offset, std::ios::beg);
+    mFile.read(&mFrameBuffer[0], mFrameBuffer.size());
+    if (mFile.fail())
+    {
+        return;
+    }
+
+    uint64_t position = 0;
+    while (position < mFrameBuffer.size())
+    {
+        uint64_t frame_size = SnapshotCompressor::DecompressFrame(mCompression,
+                                                                  mFrameBuffer.data() + position,
+                                                                  mFrameBuffer.size() - position,
+                                                                  mBlockBuffer);
+        if (frame_size == 0 || mBlockBuffer.size() < sizeof(double) + sizeof(uint32_t))
+        {
+            break;
+        }
+
+        double time;
+        uint32_t num_cells;
+        memcpy(&time, mBlockBuffer.data(), sizeof(double));
+        memcpy(&num_cells, mBlockBuffer.data() + sizeof(double), sizeof(uint32_t));
+        mTimes.push_back(time);
+        mOffsets.push_back(offset + position);
+        mNumCells.push_back(num_cells);
+
+        position += frame_size;
+    }
+    mFrameBuffer.clear();
+}
+
+template<unsigned DIM>
+unsigned MammarySnapshotReader<DIM>::GetNumSnapshots() const
+{
+    return mOffsets.size();
+}
+
+template<unsigned DIM>
+const std::vector<double>& MammarySnapshotReader<DIM>::rGetTimes() const
+{
+    return mTimes;
+}
+
+template<unsigned DIM>
+unsigned MammarySnapshotReader<DIM>::GetNumCells(unsigned index) const
+{
+    assert(index < mNumCells.size());
+    return mNumCells[index];
+}
+
+template<unsigned DIM>
+unsigned MammarySnapshotReader<DIM>::FindSnapshot(double time) const
+{
+    std::vector<double>::const_iterator it = std::upper_bound(mTimes.begin(), mTimes.end(), time);
+    return (it == mTimes.begin()) ? 0 : (it - mTimes.begin()) - 1;
+}
+
+template<unsigned DIM>
+void MammarySnapshotReader<DIM>::ReadRawSnapshot(unsigned index, MammaryPopulationSnapshot<DIM>& rSnapshot)
+{
+    mFile.clear();
+    mFile.seekg(mOffsets[index], std::ios::beg);
+
+    if (mCompression == NO_COMPRESSION)
+    {
+        if (!rSnapshot.ReadBlock(mFile))
+        {
+            EXCEPTION("Could not read snapshot from file");
+        }
+        return;
+    }
+
+    uint64_t end = (index + 1 < mOffsets.size()) ? mOffsets[index + 1] : mFileSize;
+    mFrameBuffer.resize(end - mOffsets[index]);
+    mFile.read(&mFrameBuffer[0], mFrameBuffer.size());
+    if (mFile.fail()
+        || SnapshotCompressor::DecompressFrame(mCompression, mFrameBuffer.data(), mFrameBuffer.size(), mBlockBuffer) == 0)
+    {
+        EXCEPTION("Could not read snapshot from file");
+    }
+
+    std::istringstream block_stream(mBlockBuffer);
+    if (!rSnapshot.ReadBlock(block_stream))
+    {
+        EXCEPTION("Could not read snapshot from file");
+    }
+}
+
+template<unsigned DIM>
+void MammarySnapshotReader<DIM>::ReadSnapshot(unsigned index, MammaryPopulationSnapshot<DIM>& rSnapshot)
+{
+    if (index >= mOffsets.size())
+    {
+        EXCEPTION("Snapshot index out of range");
+    }
+
+    ReadRawSnapshot(index, rSnapshot);
+    if (rSnapshot.HasDeltas())
+    {
+        if (index == 0)
+        {
+            EXCEPTION("The first snapshot in the file is delta-encoded");
+        }
+
+        // Reading the previous snapshot leaves it in mLastSnapshot
+        if (mLastSnapshotIndex != index - 1)
+        {
+            MammaryPopulationSnapshot<DIM> previous;
+            ReadSnapshot(index - 1, previous);
+        }
+        rSnapshot.DecodeDeltas(mLastSnapshot);
+    }
+
+    mLastSnapshot = rSnapshot;
+    mLastSnapshotIndex = index;
+}
+
+// Explicit instantiation
+template class MammarySnapshotReader<1>;
+template class MammarySnapshotReader<2>;
+template class MammarySnapshotReader<3>;
@@ -0,0 +1,138 @@
+#ifndef MAMMARYSNAPSHOTREADER_HPP_
+#define MAMMARYSNAPSHOTREADER_HPP_
+
+#include <climits>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include <boost/utility.hpp>
+
+#include "MammaryPopulationSnapshot.hpp"
+
+/**
+ * A reader for the snapshot files written by MammarySnapshotWriter.
+ *
+ * On construction the offsets of all snapshots are taken from the index file
+ * (mammary_snapshots.idx, next to the snapshot file), and any snapshots not in the
+ * index (e.g. those appended by a continued simulation) are found by scanning the
+ * block headers that follow the last indexed one. A snapshot left incomplete at the
+ * end of the file (e.g. by a simulation that was killed) is ignored.
+ *
+ * Individual snapshots are then read on demand by seeking straight to their block.
+ *
+ * If the blocks are compressed, the unindexed ones are found by decompressing the frames
+ * that follow the last indexed one. A delta-encoded snapshot is decoded against the one
+ * before it, which is read (back to the last key frame) if it is not the snapshot read last.
+ */
+template<unsigned DIM>
+class MammarySnapshotReader : boost::noncopyable
+{
+private:
+
+    /** The snapshot file. */
+    std::ifstream mFile;
+
+    /** The size of the snapshot file in bytes. */
+    uint64_t mFileSize;
+
+    /** The time of each snapshot. */
+    std::vector<double> mTimes;
+
+    /** The offset of each snapshot's block in the file. */
+    std::vector<uint64_t> mOffsets;
+
+    /** The number of cells in each snapshot. */
+    std::vector<unsigned> mNumCells;
+
+    /** The compression of the blocks. */
+    CompressionType mCompression;
+
+    /** Buffer for a compressed frame read from the file. */
+    std::string mFrameBuffer;
+
+    /** Buffer for a decompressed block. */
+    std::string mBlockBuffer;
+
+    /** The snapshot read last (decoded), against which the next one may be delta-encoded. */
+    MammaryPopulationSnapshot<DIM> mLastSnapshot;
+
+    /** The index of mLastSnapshot, or UINT_MAX if none has been read. */
+    unsigned mLastSnapshotIndex;
+
+    /**
+     * Read the header of the block at a given offset.
+     *
+     * @param offset the offset of the block
+     * @param rTime filled in with the time of the snapshot
+     * @param rNumCells filled in with the number of cells in the snapshot
+     * @param rBlockSize filled in with the size of the block in bytes
+     * @return whether the whole block lies within the file
+     */
+    bool ReadBlockHeader(uint64_t offset, double& rTime, unsigned& rNumCells, uint64_t& rBlockSize);
+
+    /**
+     * Read the entries of the index file, if it exists, keeping those that point inside the snapshot file.
+     *
+     * @param rIndexFileName the full path of the index file
+     */
+    void ReadIndex(const std::string& rIndexFileName);
+
+    /**
+     * Find the compressed frames from a given offset to the end of the file, stopping at
+     * the first that is incomplete.
+     *
+     * @param offset the offset of the first frame
+     */
+    void ScanFrames(uint64_t offset);
+
+    /**
+     * Read a snapshot without decoding any deltas.
+     *
+     * @param index the index of the snapshot
+     * @param rSnapshot filled in with the snapshot
+     */
+    void ReadRawSnapshot(unsigned index, MammaryPopulationSnapshot<DIM>& rSnapshot);
+
+public:
+
+    /**
+     * Constructor. Throws if the file cannot be opened, is not a snapshot file, or was
+     * written by a simulation of another dimension.
+     *
+     * @param rFileName the full path of the snapshot file (e.g. .../mammary_snapshots.bin)
+     */
+    MammarySnapshotReader(const std::string& rFileName);
+
+    /**
+     * @return the number of snapshots in the file
+     */
+    unsigned GetNumSnapshots() const;
+
+    /**
+     * @return the time of each snapshot
+     */
+    const std::vector<double>& rGetTimes() const;
+
+    /**
+     * @param index the index of a snapshot
+     * @return the number of cells in the snapshot
+     */
+    unsigned GetNumCells(unsigned index) const;
+
+    /**
+     * @param time a time
+     * @return the index of the last snapshot at or before the given time (or 0 if there is none)
+     */
+    unsigned FindSnapshot(double time) const;
+
+    /**
+     * Read a snapshot.
+     *
+     * @param index the index of the snapshot
+     * @param rSnapshot filled in with the snapshot
+     */
+    void ReadSnapshot(unsigned index, MammaryPopulationSnapshot<DIM>& rSnapshot);
+};
+
+#endif /*MAMMARYSNAPSHOTREADER_HPP_*/
@@ -0,0 +1,198 @@
+#include "MammarySnapshotWriter.hpp"
+#include <algorithm>
+
+#include "AbstractCellPopulation.hpp"
+#include "MeshBasedCellPopulation.hpp"
+#include "CaBasedCellPopulation.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "PottsBasedCellPopulation.hpp"
+#include "VertexBasedCellPopulation.hpp"
+#include "Exception.hpp"
+#include "MammaryProfiler.hpp"
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::MammarySnapshotWriter()
+    : AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>("mammary_snapshots.bin"),
+      mCompressionType(NO_COMPRESSION),
+      mCompressionLevel(0),
+      mUsePositionDeltas(false),
+      mKeyFrameInterval(10),
+      mNumBlocksSinceKeyFrame(0)
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::SetCompression(CompressionType type, int level)
+{
+    mpCompressor.reset(new SnapshotCompressor(type, level));
+    mCompressionType = type;
+    mCompressionLevel = level;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+CompressionType MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::GetCompressionType() const
+{
+    return mCompressionType;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::SetUsePositionDeltas(bool usePositionDeltas)
+{
+    mUsePositionDeltas = usePositionDeltas;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+bool MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::GetUsePositionDeltas() const
+{
+    return mUsePositionDeltas;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::SetKeyFrameInterval(unsigned keyFrameInterval)
+{
+    if (keyFrameInterval == 0)
+    {
+        EXCEPTION("The key frame interval must be at least 1");
+    }
+    mKeyFrameInterval = keyFrameInterval;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+unsigned MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::GetKeyFrameInterval() const
+{
+    return mKeyFrameInterval;
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::OpenOutputFile(OutputFileHandler& rOutputFileHandler)
+{
+    this->mpOutStream = rOutputFileHandler.OpenOutputFile(this->mFileName, std::ios::out | std::ios::trunc | std::ios::binary);
+    MammaryPopulationSnapshot<SPACE_DIM>::WriteFileHeader(*this->mpOutStream, mCompressionType);
+    mNumBlocksSinceKeyFrame = 0;
+
+    uint32_t version = MAMMARY_SNAPSHOT_FORMAT_VERSION;
+    mpIndexStream = rOutputFileHandler.OpenOutputFile("mammary_snapshots.idx", std::ios::out | std::ios::trunc | std::ios::binary);
+    mpIndexStream->write(MAMMARY_SNAPSHOT_INDEX_MAGIC, 4);
+    mpIndexStream->write(reinterpret_cast<const char*>(&version), sizeof(uint32_t));
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::WriteTimeStamp()
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::WriteNewline()
+{
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::VisitAnyPopulation(AbstractCellPopulation<SPACE_DIM, SPACE_DIM>* pCellPopulation)
+{
+    MAMMARY_PROFILE_SCOPE("step/output/MammarySnapshotWriter");
+
+    mSnapshot.Capture(*pCellPopulation);
+    double time = mSnapshot.GetTime();
+    uint32_t num_cells = mSnapshot.GetNumCells();
+
+    /*
+     * Start a key frame every mKeyFrameInterval blocks, and whenever there is no previous
+     * snapshot (i.e. at the start of a file, or of the blocks appended by a continued simulation).
+     */
+    bool is_delta = mUsePositionDeltas
+                    && mNumBlocksSinceKeyFrame > 0
+                    && mNumBlocksSinceKeyFrame < mKeyFrameInterval;
+    if (is_delta)
+    {
+        mSnapshot.EncodeDeltas(mPreviousSnapshot);
+    }
+
+    uint64_t bytes_written = 0;
+    if (mCompressionType == NO_COMPRESSION)
+    {
+        mSnapshot.WriteBlock(*this->mpOutStream);
+        bytes_written = mSnapshot.GetBlockSize();
+    }
+    else
+    {
+        if (!mpCompressor)
+        {
+            mpCompressor.reset(new SnapshotCompressor(mCompressionType, mCompressionLevel));
+        }
+        mBlockBuffer.str("");
+        mSnapshot.WriteBlock(mBlockBuffer);
+        std::string block = mBlockBuffer.str();
+        bytes_written = mpCompressor->WriteFrame(block.data(), block.size(), *this->mpOutStream);
+    }
+
+    if (mUsePositionDeltas)
+    {
+        if (is_delta)
+        {
+            mSnapshot.DecodeDeltas(mPreviousSnapshot);
+        }
+        std::swap(mSnapshot, mPreviousSnapshot);
+        mNumBlocksSinceKeyFrame = is_delta ? mNumBlocksSinceKeyFrame + 1 : 1;
+    }
+
+    /*
+     * Take the offset of the block from the end of what has been written, since in append
+     * mode the put position is only moved to the end of the file by the first write.
+     */
+    if (mpIndexStream)
+    {
+        uint64_t offset = static_cast<uint64_t>(this->mpOutStream->tellp()) - bytes_written;
+
+        mpIndexStream->write(reinterpret_cast<const char*>(&time), sizeof(double));
+        mpIndexStream->write(reinterpret_cast<const char*>(&offset), sizeof(uint64_t));
+        mpIndexStream->write(reinterpret_cast<const char*>(&num_cells), sizeof(uint32_t));
+        mpIndexStream->flush();
+    }
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::Visit(MeshBasedCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation)
+{
+    AbstractCellPopulation<SPACE_DIM, SPACE_DIM>* p_population = dynamic_cast<AbstractCellPopulation<SPACE_DIM, SPACE_DIM>*>(pCellPopulation);
+    if (!p_population)
+    {
+        EXCEPTION("MammarySnapshotWriter is only implemented for populations whose element and space dimensions are equal");
+    }
+    VisitAnyPopulation(p_population);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::Visit(CaBasedCellPopulation<SPACE_DIM>* pCellPopulation)
+{
+    VisitAnyPopulation(pCellPopulation);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::Visit(NodeBasedCellPopulation<SPACE_DIM>* pCellPopulation)
+{
+    VisitAnyPopulation(pCellPopulation);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::Visit(PottsBasedCellPopulation<SPACE_DIM>* pCellPopulation)
+{
+    VisitAnyPopulation(pCellPopulation);
+}
+
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+void MammarySnapshotWriter<ELEMENT_DIM, SPACE_DIM>::Visit(VertexBasedCellPopulation<SPACE_DIM>* pCellPopulation)
+{
+    VisitAnyPopulation(pCellPopulation);
+}
+
+// Explicit instantiation
+template class MammarySnapshotWriter<1,1>;
+template class MammarySnapshotWriter<1,2>;
+template class MammarySnapshotWriter<2,2>;
+template class MammarySnapshotWriter<1,3>;
+template class MammarySnapshotWriter<2,3>;
+template class MammarySnapshotWriter<3,3>;
+
+#include "SerializationExportWrapperForCpp.hpp"
+// Declare identifier for the serializer
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(MammarySnapshotWriter)
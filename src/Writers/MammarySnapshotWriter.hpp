@@ -0,0 +1,207 @@
+#ifndef MAMMARYSNAPSHOTWRITER_HPP_
+#define MAMMARYSNAPSHOTWRITER_HPP_
+
+#include <sstream>
+#include <string>
+#include <boost/shared_ptr.hpp>
+#include "AbstractCellPopulationWriter.hpp"
+#include "MammaryPopulationSnapshot.hpp"
+#include "ChasteSerialization.hpp"
+#include <boost/serialization/base_object.hpp>
+
+/**
+ * A class written using the visitor pattern for writing the cell IDs, mammary cell types,
+ * integrin expression, positions and (for node-based populations) velocities of all cells
+ * to a single binary file, in place of the text output of CellLocationWriter,
+ * CellVelocityWriter and MammaryCellTypeWriter.
+ *
+ * The output file is called mammary_snapshots.bin. It starts with a header of the form
+ *
+ * ['MSNP' (4 chars)] [format version (uint32)] [space dimension (uint32)]
+ * [compression of the blocks (uint32)]
+ *
+ * followed by one block per output time step, in the layout described in
+ * MammaryPopulationSnapshot.
+ *
+ * Optionally, each block is compressed as a separate gzip or zstd frame (see
+ * SnapshotCompressor), and the positions and velocities of all but every
+ * mKeyFrameInterval-th block are delta-encoded against the block before, which makes
+ * them far more compressible. A delta-encoded block can only be decoded once the blocks
+ * back to the last key frame have been, which MammarySnapshotReader does.
+ *
+ * An index of the blocks is written alongside it, to mammary_snapshots.idx, of the form
+ *
+ * ['MSNI' (4 chars)] [format version (uint32)]
+ *
+ * followed by one entry per block:
+ *
+ * [time (double)] [offset of the block (or frame) in the file (uint64)] [number of cells (uint32)]
+ *
+ * so that any snapshot can be read without parsing the ones before it. If a simulation
+ * is continued in the same directory, later blocks are appended to the file but not to
+ * the index; MammarySnapshotReader recovers their offsets by scanning the file.
+ */
+template<unsigned ELEMENT_DIM, unsigned SPACE_DIM>
+class MammarySnapshotWriter : public AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM>
+{
+private:
+
+    /** The snapshot, reused between output time steps to avoid reallocating its arrays. */
+    MammaryPopulationSnapshot<SPACE_DIM> mSnapshot;
+
+    /** The index file, if open. */
+    out_stream mpIndexStream;
+
+    /** The compression of the blocks. Defaults to none. */
+    CompressionType mCompressionType;
+
+    /** The compression level (0 for the library's default). */
+    int mCompressionLevel;
+
+    /** Whether to delta-encode blocks between key frames. Defaults to false. */
+    bool mUsePositionDeltas;
+
+    /** The number of blocks from one key frame (a block that is not delta-encoded) to the next. Defaults to 10. */
+    unsigned mKeyFrameInterval;
+
+    /** The compressor, created when the file is first written to. */
+    boost::shared_ptr<SnapshotCompressor> mpCompressor;
+
+    /** The previous snapshot (not delta-encoded), if delta-encoding. */
+    MammaryPopulationSnapshot<SPACE_DIM> mPreviousSnapshot;
+
+    /** The number of blocks written since the last key frame. */
+    unsigned mNumBlocksSinceKeyFrame;
+
+    /** Buffer into which each block is written before it is compressed. */
+    std::ostringstream mBlockBuffer;
+
+    /** Needed for serialization. */
+    friend class boost::serialization::access;
+    /**
+     * Serialize the object and its member variables.
+     *
+     * @param archive the archive
+     * @param version the current version of this class
+     */
+    template<class Archive>
+    void serialize(Archive & archive, const unsigned int version)
+    {
+        archive & boost::serialization::base_object<AbstractCellPopulationWriter<ELEMENT_DIM, SPACE_DIM> >(*this);
+        archive & mCompressionType;
+        archive & mCompressionLevel;
+        archive & mUsePositionDeltas;
+        archive & mKeyFrameInterval;
+    }
+
+public:
+
+    /**
+     * Default constructor.
+     */
+    MammarySnapshotWriter();
+
+    /**
+     * Set the compression of the blocks. Throws if it is not available in this build.
+     *
+     * @param type the type of compression
+     * @param level the compression level (defaults to 0, the library's default)
+     */
+    void SetCompression(CompressionType type, int level=0);
+
+    /**
+     * @return mCompressionType
+     */
+    CompressionType GetCompressionType() const;
+
+    /**
+     * Set mUsePositionDeltas.
+     *
+     * @param usePositionDeltas whether to delta-encode blocks between key frames
+     */
+    void SetUsePositionDeltas(bool usePositionDeltas);
+
+    /**
+     * @return mUsePositionDeltas
+     */
+    bool GetUsePositionDeltas() const;
+
+    /**
+     * Set mKeyFrameInterval.
+     *
+     * @param keyFrameInterval the number of blocks from one key frame to the next (at least 1)
+     */
+    void SetKeyFrameInterval(unsigned keyFrameInterval);
+
+    /**
+     * @return mKeyFrameInterval
+     */
+    unsigned GetKeyFrameInterval() const;
+
+    /**
+     * Overridden OpenOutputFile() method.
+     *
+     * Opens the snapshot file in binary mode and writes its header, and opens the index file.
+     *
+     * @param rOutputFileHandler handler for the directory in which to open this file
+     */
+    virtual void OpenOutputFile(OutputFileHandler& rOutputFileHandler);
+
+    /**
+     * Overridden WriteTimeStamp() method, which writes nothing, since the time is part of each block.
+     */
+    virtual void WriteTimeStamp();
+
+    /**
+     * Overridden WriteNewline() method, which writes nothing.
+     */
+    virtual void WriteNewline();
+
+    /**
+     * Visit the population, and write a snapshot block to the file and an entry to the index.
+     *
+     * @param pCellPopulation a pointer to the population to visit.
+     */
+    void VisitAnyPopulation(AbstractCellPopulation<SPACE_DIM, SPACE_DIM>* pCellPopulation);
+
+    /**
+     * Visit the population and write the data. Only implemented if ELEMENT_DIM equals SPACE_DIM.
+     *
+     * @param pCellPopulation a pointer to the MeshBasedCellPopulation to visit.
+     */
+    virtual void Visit(MeshBasedCellPopulation<ELEMENT_DIM, SPACE_DIM>* pCellPopulation);
+
+    /**
+     * Visit the population and write the data.
+     *
+     * @param pCellPopulation a pointer to the CaBasedCellPopulation to visit.
+     */
+    virtual void Visit(CaBasedCellPopulation<SPACE_DIM>* pCellPopulation);
+
+    /**
+     * Visit the population and write the data.
+     *
+     * @param pCellPopulation a pointer to the NodeBasedCellPopulation to visit.
+     */
+    virtual void Visit(NodeBasedCellPopulation<SPACE_DIM>* pCellPopulation);
+
+    /**
+     * Visit the population and write the data.
+     *
+     * @param pCellPopulation a pointer to the PottsBasedCellPopulation to visit.
+     */
+    virtual void Visit(PottsBasedCellPopulation<SPACE_DIM>* pCellPopulation);
+
+    /**
+     * Visit the population and write the data.
+     *
+     * @param pCellPopulation a pointer to the VertexBasedCellPopulation to visit.
+     */
+    virtual void Visit(VertexBasedCellPopulation<SPACE_DIM>* pCellPopulation);
+};
+
+#include "SerializationExportWrapper.hpp"
+// Declare identifier for the serializer
+EXPORT_TEMPLATE_CLASS_ALL_DIMS(MammarySnapshotWriter)
+
+#endif /* MAMMARYSNAPSHOTWRITER_HPP_ */
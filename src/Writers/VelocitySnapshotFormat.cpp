@@ -0,0 +1,39 @@
+#include "VelocitySnapshotFormat.hpp"
+#include "Exception.hpp"
+
+template<unsigned DIM>
+VelocitySnapshotFormat<DIM>::VelocitySnapshotFormat()
+    : AbstractSnapshotFormat<DIM>("velocity.dat")
+{
+}
+
+template<unsigned DIM>
+void VelocitySnapshotFormat<DIM>::WriteSnapshot(const MammaryPopulationSnapshot<DIM>& rSnapshot, std::ostream& rStream)
+{
+    if (!rSnapshot.HasVelocities())
+    {
+        EXCEPTION("Velocity output is implemented only for a NodeBasedCellPopulation");
+    }
+
+    rStream << rSnapshot.GetTime() << "\t";
+
+    const std::vector<uint32_t>& r_cell_ids = rSnapshot.rGetCellIds();
+    for (unsigned index=0; index<rSnapshot.GetNumCells(); index++)
+    {
+        rStream << r_cell_ids[index] << " ";
+        for (unsigned i=0; i<DIM; i++)
+        {
+            rStream << rSnapshot.GetPosition(index, i) << " ";
+        }
+        for (unsigned i=0; i<DIM; i++)
+        {
+            rStream << rSnapshot.GetVelocity(index, i) << " ";
+        }
+    }
+    rStream << "\n";
+}
+
+// Explicit instantiation
+template class VelocitySnapshotFormat<1>;
+template class VelocitySnapshotFormat<2>;
+template class VelocitySnapshotFormat<3>;
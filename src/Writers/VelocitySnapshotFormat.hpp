@@ -0,0 +1,33 @@
+#ifndef VELOCITYSNAPSHOTFORMAT_HPP_
+#define VELOCITYSNAPSHOTFORMAT_HPP_
+
+#include "AbstractSnapshotFormat.hpp"
+
+/**
+ * Writes snapshots to velocity.dat, in the same text layout as CellVelocityWriter:
+ *
+ * [time] then, for each cell, [cell ID] [x-pos] [y-pos] [z-pos] [x-vel] [y-vel] [z-vel]
+ *
+ * so that the output can be read with importfile_velocity.m. As for CellVelocityWriter,
+ * velocities are only available for a NodeBasedCellPopulation.
+ */
+template<unsigned DIM>
+class VelocitySnapshotFormat : public AbstractSnapshotFormat<DIM>
+{
+public:
+
+    /**
+     * Default constructor.
+     */
+    VelocitySnapshotFormat();
+
+    /**
+     * Overridden WriteSnapshot() method.
+     *
+     * @param rSnapshot the snapshot
+     * @param rStream the output stream
+     */
+    virtual void WriteSnapshot(const MammaryPopulationSnapshot<DIM>& rSnapshot, std::ostream& rStream);
+};
+
+#endif /*VELOCITYSNAPSHOTFORMAT_HPP_*/
@@ -0,0 +1,171 @@
+#ifndef TESTADAPTIVEOUTPUTMODIFIER_HPP_
+#define TESTADAPTIVEOUTPUTMODIFIER_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <string>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "CellLocationWriter.hpp"
+#include "AdaptiveOutputModifier.hpp"
+
+/*
+ * Drives each trigger of AdaptiveOutputModifier in turn on a row of four cells, stepping
+ * the simulation time by hand, and checks the rows of adaptive_output_times.dat and the
+ * snapshots written.
+ */
+class TestAdaptiveOutputModifier : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * @param rFileName the full path of a file
+     * @return the lines of the file
+     */
+    std::vector<std::string> ReadLines(const std::string& rFileName)
+    {
+        std::ifstream file(rFileName.c_str());
+        TS_ASSERT(file.is_open());
+        std::vector<std::string> lines;
+        std::string line;
+        while (std::getline(file, line))
+        {
+            lines.push_back(line);
+        }
+        return lines;
+    }
+
+public:
+
+    void TestEachTrigger()
+    {
+        EXIT_IF_PARALLEL;
+
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(10.0, 10);
+
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<4; i++)
+        {
+            nodes.push_back(new Node<2>(i, false, 2.0*i, 0.0));
+        }
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        std::vector<CellPtr> cells;
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+            p_model->SetDimension(2);
+
+            CellPtr p_cell(new Cell(p_state, p_model));
+            p_cell->SetCellProliferativeType(p_differentiated_type);
+            p_cell->AddCellProperty(MammaryCellPropertyHelper::CreateMammaryCellProperty(LUMINAL_CELL, false, false));
+            p_cell->InitialiseCellCycleModel();
+            cells.push_back(p_cell);
+        }
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+        cell_population.AddCellWriter<CellLocationWriter>();
+
+        AdaptiveOutputModifier<2> modifier;
+        modifier.SetCellCountChangeThreshold(1);
+        modifier.SetDisplacementThreshold(0.5);
+        modifier.SetPhenotypeChangeThreshold(1);
+        modifier.SetOutputIntervals(2, 4);
+
+        // Set up the output as the simulation does, but without writing the initial state
+        std::string output_directory = "TestAdaptiveOutputModifier/results_from_time_0";
+        OutputFileHandler output_file_handler(output_directory, true);
+        cell_population.OpenWritersFiles(output_file_handler);
+        modifier.SetupSolve(cell_population, output_directory);
+
+        // A cell moves at step 1, but nothing is written until the minimum interval has passed
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        cell_population.GetNode(0)->rGetModifiableLocation()[0] = 1.0;
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT_EQUALS(modifier.GetNumSnapshotsWritten(), 0u);
+
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT_EQUALS(modifier.GetNumSnapshotsWritten(), 1u);
+
+        // A luminal cell becomes myoepithelial at step 3, and is written at step 4
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        MammaryCellPropertyHelper::ReplaceMammaryCellProperty(cells[1],
+            MammaryCellPropertyHelper::CreateMammaryCellProperty(MYOEPITHELIAL_CELL, false, false));
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT_EQUALS(modifier.GetNumSnapshotsWritten(), 1u);
+
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT_EQUALS(modifier.GetNumSnapshotsWritten(), 2u);
+
+        // Nothing happens, so the maximum interval writes a snapshot at step 8
+        for (unsigned step=5; step<=8; step++)
+        {
+            SimulationTime::Instance()->IncrementTimeOneStep();
+            modifier.UpdateAtEndOfTimeStep(cell_population);
+        }
+        TS_ASSERT_EQUALS(modifier.GetNumSnapshotsWritten(), 3u);
+
+        // A cell is removed at step 9, and is written at step 10
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        cells[3]->Kill();
+        cell_population.RemoveDeadCells();
+        cell_population.Update();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT_EQUALS(modifier.GetNumSnapshotsWritten(), 3u);
+
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT_EQUALS(modifier.GetNumSnapshotsWritten(), 4u);
+
+        modifier.UpdateAtEndOfSolve(cell_population);
+        cell_population.CloseWritersFiles();
+
+        // [time] [trigger] [births] [removals] [largest displacement] [phenotype changes]
+        std::string results_directory = output_file_handler.GetOutputDirectoryFullPath();
+        std::vector<std::string> rows = ReadLines(results_directory + "adaptive_output_times.dat");
+        TS_ASSERT_EQUALS(rows.size(), 4u);
+        if (rows.size() == 4u)
+        {
+            TS_ASSERT_EQUALS(rows[0], "2\tdisplacement\t0\t0\t1\t0");
+            TS_ASSERT_EQUALS(rows[1], "4\tphenotype\t0\t0\t0\t1");
+            TS_ASSERT_EQUALS(rows[2], "8\tinterval\t0\t0\t0\t0");
+            TS_ASSERT_EQUALS(rows[3], "10\tcount\t0\t1\t0\t0");
+        }
+
+        // The population's output is written at the same times, and only then
+        std::vector<std::string> snapshots = ReadLines(results_directory + "location.dat");
+        TS_ASSERT_EQUALS(snapshots.size(), 4u);
+        if (snapshots.size() == 4u)
+        {
+            TS_ASSERT_EQUALS(snapshots[0].substr(0, 2), "2\t");
+            TS_ASSERT_EQUALS(snapshots[1].substr(0, 2), "4\t");
+            TS_ASSERT_EQUALS(snapshots[2].substr(0, 2), "8\t");
+            TS_ASSERT_EQUALS(snapshots[3].substr(0, 3), "10\t");
+        }
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+};
+
+#endif /*TESTADAPTIVEOUTPUTMODIFIER_HPP_*/
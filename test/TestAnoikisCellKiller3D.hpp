@@ -0,0 +1,181 @@
+#ifndef TESTANOIKISCELLKILLER3D_HPP_
+#define TESTANOIKISCELLKILLER3D_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "CellPropertyRegistry.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "LuminalCellProperty.hpp"
+#include "MyoepithelialCellProperty.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "AnoikisCellKiller3D.hpp"
+
+/*
+ * Tests of the lumen estimated by AnoikisCellKiller3D for organoids of known geometry.
+ */
+class TestAnoikisCellKiller3D : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Add a ball of cells on a cubic lattice, filling a sphere about the origin.
+     *
+     * @param radius the radius of the ball, in lattice spacings
+     * @param spacing the lattice spacing
+     * @param rNodes the nodes, to which the ball is appended
+     */
+    void AddBall(double radius, double spacing, std::vector<Node<3>*>& rNodes)
+    {
+        int extent = (int)radius;
+        for (int x=-extent; x<=extent; x++)
+        {
+            for (int y=-extent; y<=extent; y++)
+            {
+                for (int z=-extent; z<=extent; z++)
+                {
+                    if (x*x + y*y + z*z <= radius*radius)
+                    {
+                        rNodes.push_back(new Node<3>(rNodes.size(), false, spacing*x, spacing*y, spacing*z));
+                    }
+                }
+            }
+        }
+    }
+
+    /**
+     * Add a shell of cells spread evenly over a sphere about the origin.
+     *
+     * @param radius the radius of the sphere
+     * @param numNodes the number of cells in the shell
+     * @param rNodes the nodes, to which the shell is appended
+     */
+    void AddShell(double radius, unsigned numNodes, std::vector<Node<3>*>& rNodes)
+    {
+        for (unsigned i=0; i<numNodes; i++)
+        {
+            double z = 1.0 - (2.0*i + 1.0)/numNodes;
+            double r = sqrt(1.0 - z*z);
+            double phi = i*M_PI*(3.0 - sqrt(5.0));
+            rNodes.push_back(new Node<3>(rNodes.size(), false, radius*r*cos(phi), radius*r*sin(phi), radius*z));
+        }
+    }
+
+    /**
+     * Create a cell for each node, luminal unless its index is at least numLuminalCells.
+     *
+     * @param numNodes the number of nodes
+     * @param numLuminalCells the number of luminal cells, which come first
+     * @param rCells filled in with the cells
+     */
+    void CreateCells(unsigned numNodes, unsigned numLuminalCells, std::vector<CellPtr>& rCells)
+    {
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        boost::shared_ptr<AbstractCellProperty> p_luminal(CellPropertyRegistry::Instance()->Get<LuminalCellProperty>());
+        boost::shared_ptr<AbstractCellProperty> p_myoepithelial(CellPropertyRegistry::Instance()->Get<MyoepithelialCellProperty>());
+
+        for (unsigned i=0; i<numNodes; i++)
+        {
+            MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+            p_model->SetDimension(3);
+
+            CellPtr p_cell(new Cell(p_state, p_model));
+            p_cell->SetCellProliferativeType(p_differentiated_type);
+            p_cell->AddCellProperty(i < numLuminalCells ? p_luminal : p_myoepithelial);
+            p_cell->InitialiseCellCycleModel();
+            rCells.push_back(p_cell);
+        }
+    }
+
+public:
+
+    void TestLumenInsideMyoepithelialShell()
+    {
+        EXIT_IF_PARALLEL;
+
+        // Luminal cells fill the lumen, within a myoepithelial shell of radius 5
+        std::vector<Node<3>*> nodes;
+        AddBall(4.0, 1.0, nodes);
+        unsigned num_luminal_cells = nodes.size();
+        AddShell(5.0, 400, nodes);
+
+        NodesOnlyMesh<3> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+        std::vector<CellPtr> cells;
+        CreateCells(mesh.GetNumNodes(), num_luminal_cells, cells);
+        NodeBasedCellPopulation<3> cell_population(mesh, cells);
+        cell_population.Update();
+
+        c_vector<double,3> centre = zero_vector<double>(3);
+        AnoikisCellKiller3D killer(&cell_population, centre, 0.0);
+        killer.SetUseDynamicLumen(true);
+        killer.CheckAndLabelCellsForApoptosisOrDeath();
+
+        // The lumen is the shell less half a shell cell and one luminal layer
+        TS_ASSERT_DELTA(norm_2(killer.GetCentre()), 0.0, 1e-3);
+        TS_ASSERT_DELTA(killer.GetRadius(), 5.0 - 1.5, 0.01);
+
+        for (AbstractCellPopulation<3>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            double distance = norm_2(cell_population.GetLocationOfCellCentre(*cell_iter));
+            if (distance < 3.4)
+            {
+                TS_ASSERT_EQUALS(cell_iter->IsDead(), true);
+            }
+            else if (distance > 3.6)
+            {
+                TS_ASSERT_EQUALS(cell_iter->IsDead(), false);
+            }
+        }
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
+    void TestLumenInsideSurfaceWithoutMyoepithelialCells()
+    {
+        EXIT_IF_PARALLEL;
+
+        // A ball of luminal cells, overlapping only their six nearest neighbours, so that surface cells have fewer
+        std::vector<Node<3>*> nodes;
+        AddBall(4.0, 0.9, nodes);
+
+        NodesOnlyMesh<3> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+        std::vector<CellPtr> cells;
+        CreateCells(mesh.GetNumNodes(), mesh.GetNumNodes(), cells);
+        NodeBasedCellPopulation<3> cell_population(mesh, cells);
+        cell_population.Update();
+
+        c_vector<double,3> centre = zero_vector<double>(3);
+        AnoikisCellKiller3D killer(&cell_population, centre, 0.0);
+        killer.SetUseDynamicLumen(true);
+        killer.CheckAndLabelCellsForApoptosisOrDeath();
+
+        // The tenth percentile of the surface cells' distances is sqrt(13) lattice spacings
+        TS_ASSERT_DELTA(norm_2(killer.GetCentre()), 0.0, 1e-9);
+        TS_ASSERT_DELTA(killer.GetRadius(), 0.9*sqrt(13.0) - 1.5, 1e-6);
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+};
+
+#endif /*TESTANOIKISCELLKILLER3D_HPP_*/
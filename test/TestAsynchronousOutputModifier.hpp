@@ -0,0 +1,226 @@
+#ifndef TESTASYNCHRONOUSOUTPUTMODIFIER_HPP_
+#define TESTASYNCHRONOUSOUTPUTMODIFIER_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "OutputFileHandler.hpp"
+#include "CellId.hpp"
+#include "SimulationTime.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "Exception.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "MammaryOffLatticeSimulation.hpp"
+#include "LinearSpringForce.hpp"
+#include "CellLocationWriter.hpp"
+#include "LocationSnapshotFormat.hpp"
+#include "AsynchronousOutputModifier.hpp"
+
+/**
+ * A snapshot format that fails on every snapshot, as a full disk would.
+ */
+class FailingSnapshotFormat : public AbstractSnapshotFormat<2>
+{
+public:
+
+    /**
+     * Default constructor.
+     */
+    FailingSnapshotFormat()
+        : AbstractSnapshotFormat<2>("failing.dat")
+    {
+    }
+
+    /**
+     * Overridden WriteSnapshot() method, which always throws.
+     *
+     * @param rSnapshot the snapshot
+     * @param rStream the output stream
+     */
+    void WriteSnapshot(const MammaryPopulationSnapshot<2>& rSnapshot, std::ostream& rStream)
+    {
+        EXCEPTION("No space left on device");
+    }
+};
+
+/*
+ * Checks that AsynchronousOutputModifier, with LocationSnapshotFormat, writes the same
+ * location.dat as CellLocationWriter, even when the time loop has to wait for every
+ * snapshot, and that an error on the writer thread is thrown from Solve().
+ */
+class TestAsynchronousOutputModifier : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Create a compressed row of alternating luminal and myoepithelial cells, which spread
+     * out under spring forces, resetting the simulation time and cell IDs.
+     *
+     * @param rMesh the mesh to construct
+     * @param rNodes filled in with the nodes, to be deleted by the caller
+     * @param rCells filled in with the cells
+     */
+    void CreateRowOfCells(NodesOnlyMesh<2>& rMesh, std::vector<Node<2>*>& rNodes, std::vector<CellPtr>& rCells)
+    {
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+        RandomNumberGenerator::Instance()->Reseed(0);
+        CellId::ResetMaxCellId();
+
+        rNodes.clear();
+        for (unsigned i=0; i<10; i++)
+        {
+            rNodes.push_back(new Node<2>(i, false, 0.6*i, 0.05*(i%2)));
+        }
+        rMesh.ConstructNodesWithoutMesh(rNodes, 1.5);
+
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        rCells.clear();
+        for (unsigned i=0; i<rMesh.GetNumNodes(); i++)
+        {
+            MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+            p_model->SetDimension(2);
+
+            CellPtr p_cell(new Cell(p_state, p_model));
+            p_cell->SetCellProliferativeType(p_differentiated_type);
+            p_cell->AddCellProperty(MammaryCellPropertyHelper::CreateMammaryCellProperty(i%2 == 0 ? LUMINAL_CELL : MYOEPITHELIAL_CELL, false, false));
+            p_cell->InitialiseCellCycleModel();
+            rCells.push_back(p_cell);
+        }
+    }
+
+    /**
+     * @param rOutputDirectory the output directory of a simulation
+     * @return the contents of location.dat in the simulation's results directory
+     */
+    std::string ReadLocations(const std::string& rOutputDirectory)
+    {
+        OutputFileHandler handler(rOutputDirectory, false);
+        std::ifstream file((handler.GetOutputDirectoryFullPath() + "results_from_time_0/location.dat").c_str());
+        TS_ASSERT(file.is_open());
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+public:
+
+    void TestMatchesCellLocationWriter()
+    {
+        EXIT_IF_PARALLEL;
+
+        // Write location.dat with CellLocationWriter, every 6 time steps
+        {
+            NodesOnlyMesh<2> mesh;
+            std::vector<Node<2>*> nodes;
+            std::vector<CellPtr> cells;
+            CreateRowOfCells(mesh, nodes, cells);
+            NodeBasedCellPopulation<2> cell_population(mesh, cells);
+            cell_population.AddCellWriter<CellLocationWriter>();
+
+            MammaryOffLatticeSimulation<2> simulator(cell_population);
+            simulator.SetOutputDirectory("TestAsynchronousOutputModifier/Writer");
+            simulator.SetDt(1.0/120.0);
+            simulator.SetSamplingTimestepMultiple(6);
+            simulator.SetEndTime(0.5);
+
+            MAKE_PTR(LinearSpringForce<2>, p_force);
+            simulator.AddForce(p_force);
+
+            simulator.Solve();
+
+            for (unsigned i=0; i<nodes.size(); i++)
+            {
+                delete nodes[i];
+            }
+        }
+
+        // Write location.dat with LocationSnapshotFormat, waiting for each snapshot to be written before queuing the next
+        {
+            NodesOnlyMesh<2> mesh;
+            std::vector<Node<2>*> nodes;
+            std::vector<CellPtr> cells;
+            CreateRowOfCells(mesh, nodes, cells);
+            NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+            MammaryOffLatticeSimulation<2> simulator(cell_population);
+            simulator.SetOutputDirectory("TestAsynchronousOutputModifier/Format");
+            simulator.SetDt(1.0/120.0);
+            simulator.SetSamplingTimestepMultiple(60);
+            simulator.SetEndTime(0.5);
+
+            MAKE_PTR(LinearSpringForce<2>, p_force);
+            simulator.AddForce(p_force);
+
+            MAKE_PTR(AsynchronousOutputModifier<2>, p_modifier);
+            p_modifier->AddSnapshotFormat(boost::shared_ptr<AbstractSnapshotFormat<2> >(new LocationSnapshotFormat<2>()));
+            p_modifier->SetOutputTimestepMultiple(6);
+            p_modifier->SetMaxQueuedSnapshots(1);
+            simulator.AddSimulationModifier(p_modifier);
+
+            simulator.Solve();
+
+            // The initial state, then one snapshot for each of the 10 sampling steps of 60 time steps
+            TS_ASSERT_EQUALS(p_modifier->GetNumSnapshotsWritten(), 11u);
+
+            for (unsigned i=0; i<nodes.size(); i++)
+            {
+                delete nodes[i];
+            }
+        }
+
+        std::string written_by_writer = ReadLocations("TestAsynchronousOutputModifier/Writer");
+        std::string written_by_format = ReadLocations("TestAsynchronousOutputModifier/Format");
+        TS_ASSERT_LESS_THAN(0u, written_by_writer.size());
+        TS_ASSERT_EQUALS(written_by_format, written_by_writer);
+    }
+
+    void TestWriterErrorIsThrownFromSolve()
+    {
+        EXIT_IF_PARALLEL;
+
+        NodesOnlyMesh<2> mesh;
+        std::vector<Node<2>*> nodes;
+        std::vector<CellPtr> cells;
+        CreateRowOfCells(mesh, nodes, cells);
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        MammaryOffLatticeSimulation<2> simulator(cell_population);
+        simulator.SetOutputDirectory("TestAsynchronousOutputModifier/Failing");
+        simulator.SetSamplingTimestepMultiple(60);
+        simulator.SetEndTime(0.5);
+
+        MAKE_PTR(AsynchronousOutputModifier<2>, p_modifier);
+        p_modifier->AddSnapshotFormat(boost::shared_ptr<AbstractSnapshotFormat<2> >(new FailingSnapshotFormat()));
+        p_modifier->SetMaxQueuedSnapshots(1);
+        simulator.AddSimulationModifier(p_modifier);
+
+        TS_ASSERT_THROWS_CONTAINS(simulator.Solve(), "Asynchronous output failed: No space left on device");
+        TS_ASSERT_EQUALS(p_modifier->GetNumSnapshotsWritten(), 0u);
+
+        // The writer thread has stopped, so every later output step throws rather than waiting for it
+        TS_ASSERT_THROWS_CONTAINS(p_modifier->UpdateAtEndOfTimeStep(cell_population), "Asynchronous output failed");
+        TS_ASSERT_THROWS_CONTAINS(p_modifier->UpdateAtEndOfTimeStep(cell_population), "Asynchronous output failed");
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+};
+
+#endif /*TESTASYNCHRONOUSOUTPUTMODIFIER_HPP_*/
@@ -0,0 +1,161 @@
+#ifndef TESTBOUNDARYLENGTHWRITER_HPP_
+#define TESTBOUNDARYLENGTHWRITER_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "CellContactCalculator.hpp"
+#include "BoundaryLengthWriter.hpp"
+
+/*
+ * Checks CellContactCalculator and BoundaryLengthWriter against the hand-computed contacts
+ * of cells of radius 0.5, in clusters far enough apart not to touch:
+ *
+ *   myoepithelial (-0.8,0), luminal (0,0) and myoepithelial (0.6,0);
+ *   luminal (3,0) and luminal (3.8,0);   myoepithelial (6,0) and myoepithelial (6.6,0);
+ *   luminal (9,0) and untyped (9.8,0);   myoepithelial (12,0) and untyped (12.6,0);
+ *   untyped (15,0) and untyped (15.8,0).
+ *
+ * Two such cells a distance 0.6 apart share an edge of length 0.8, and two a distance 0.8
+ * apart share an edge of length 0.6. The outer cells of the first cluster are 1.4 apart, so
+ * do not touch.
+ */
+class TestBoundaryLengthWriter : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * @param type the mammary cell type of the cell (NO_MAMMARY_CELL_TYPE for none)
+     * @return a cell with MammaryCellCycleModel, which therefore never divides
+     */
+    CellPtr CreateCell(MammaryCellType type)
+    {
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+
+        MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+        p_model->SetDimension(2);
+
+        CellPtr p_cell(new Cell(p_state, p_model));
+        p_cell->SetCellProliferativeType(p_differentiated_type);
+        if (type != NO_MAMMARY_CELL_TYPE)
+        {
+            p_cell->AddCellProperty(MammaryCellPropertyHelper::CreateMammaryCellProperty(type, false, false));
+        }
+        p_cell->InitialiseCellCycleModel();
+        return p_cell;
+    }
+
+public:
+
+    void TestEdgeLengthAndLineages()
+    {
+        TS_ASSERT_DELTA(CellContactCalculator<2>::GetEdgeLength(0.5, 0.5, 0.6), 0.8, 1e-12);
+        TS_ASSERT_DELTA(CellContactCalculator<2>::GetEdgeLength(0.5, 0.5, 0.8), 0.6, 1e-12);
+
+        TS_ASSERT_EQUALS(CellContactCalculator<2>::GetLineage(LUMINAL_CELL), LUMINAL_LINEAGE);
+        TS_ASSERT_EQUALS(CellContactCalculator<2>::GetLineage(LUMINAL_STEM_CELL), LUMINAL_LINEAGE);
+        TS_ASSERT_EQUALS(CellContactCalculator<2>::GetLineage(MYOEPITHELIAL_CELL), MYOEPITHELIAL_LINEAGE);
+        TS_ASSERT_EQUALS(CellContactCalculator<2>::GetLineage(MYOEPITHELIAL_STEM_CELL), MYOEPITHELIAL_LINEAGE);
+        TS_ASSERT_EQUALS(CellContactCalculator<2>::GetLineage(NO_MAMMARY_CELL_TYPE), NO_LINEAGE);
+    }
+
+    void TestContactsOfEachLineagePair()
+    {
+        EXIT_IF_PARALLEL;
+
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        std::vector<Node<2>*> nodes;
+        std::vector<CellPtr> cells;
+        double x_coordinates[] = {-0.8, 0.0, 0.6, 3.0, 3.8, 6.0, 6.6, 9.0, 9.8, 12.0, 12.6, 15.0, 15.8};
+        MammaryCellType types[] = {MYOEPITHELIAL_CELL, LUMINAL_CELL, MYOEPITHELIAL_CELL,
+                                   LUMINAL_CELL, LUMINAL_CELL,
+                                   MYOEPITHELIAL_CELL, MYOEPITHELIAL_CELL,
+                                   LUMINAL_CELL, NO_MAMMARY_CELL_TYPE,
+                                   MYOEPITHELIAL_CELL, NO_MAMMARY_CELL_TYPE,
+                                   NO_MAMMARY_CELL_TYPE, NO_MAMMARY_CELL_TYPE};
+        for (unsigned i=0; i<13; i++)
+        {
+            nodes.push_back(new Node<2>(i, false, x_coordinates[i], 0.0));
+            cells.push_back(CreateCell(types[i]));
+        }
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+        cell_population.Update();
+
+        CellContactCalculator<2> calculator;
+        calculator.Calculate(cell_population);
+
+        TS_ASSERT_DELTA(calculator.GetContactLength(LUMINAL_LINEAGE, MYOEPITHELIAL_LINEAGE), 0.6 + 0.8, 1e-12);
+        TS_ASSERT_DELTA(calculator.GetContactLength(MYOEPITHELIAL_LINEAGE, LUMINAL_LINEAGE), 0.6 + 0.8, 1e-12);
+        TS_ASSERT_DELTA(calculator.GetContactLength(LUMINAL_LINEAGE, LUMINAL_LINEAGE), 0.6, 1e-12);
+        TS_ASSERT_DELTA(calculator.GetContactLength(MYOEPITHELIAL_LINEAGE, MYOEPITHELIAL_LINEAGE), 0.8, 1e-12);
+        TS_ASSERT_DELTA(calculator.GetContactLength(LUMINAL_LINEAGE, NO_LINEAGE), 0.6, 1e-12);
+        TS_ASSERT_DELTA(calculator.GetContactLength(MYOEPITHELIAL_LINEAGE, NO_LINEAGE), 0.8, 1e-12);
+        TS_ASSERT_DELTA(calculator.GetContactLength(NO_LINEAGE, NO_LINEAGE), 0.6, 1e-12);
+
+        TS_ASSERT_EQUALS(calculator.GetNumContacts(LUMINAL_LINEAGE, MYOEPITHELIAL_LINEAGE), 2u);
+        TS_ASSERT_EQUALS(calculator.GetNumContacts(LUMINAL_LINEAGE, LUMINAL_LINEAGE), 1u);
+        TS_ASSERT_EQUALS(calculator.GetNumContacts(MYOEPITHELIAL_LINEAGE, MYOEPITHELIAL_LINEAGE), 1u);
+        TS_ASSERT_EQUALS(calculator.GetNumContacts(NO_LINEAGE, MYOEPITHELIAL_LINEAGE), 1u);
+        TS_ASSERT_EQUALS(calculator.GetNumContacts(NO_LINEAGE, NO_LINEAGE), 1u);
+
+        TS_ASSERT_DELTA(calculator.GetHeterotypicContactLength(), 1.4, 1e-12);
+        TS_ASSERT_DELTA(calculator.GetHomotypicContactLength(), 0.6 + 0.8, 1e-12);
+        TS_ASSERT_DELTA(calculator.GetTotalContactLength(), 1.4 + 0.6 + 0.8 + 0.6 + 0.8 + 0.6, 1e-12);
+        TS_ASSERT_EQUALS(calculator.GetTotalNumContacts(), 7u);
+
+        OutputFileHandler handler("TestBoundaryLengthWriter", true);
+        BoundaryLengthWriter<2,2> writer;
+        writer.OpenOutputFile(handler);
+        writer.WriteTimeStamp();
+        writer.Visit(&cell_population);
+        writer.WriteNewline();
+        writer.CloseFile();
+
+        std::ifstream file((handler.GetOutputDirectoryFullPath() + "heterotypicboundary.dat").c_str());
+        TS_ASSERT(file.is_open());
+        double time;
+        double heterotypic_boundary_length;
+        double total_shared_edges_length;
+        double num_heterotypic_pairs;
+        double total_num_pairs;
+        file >> time >> heterotypic_boundary_length >> total_shared_edges_length >> num_heterotypic_pairs >> total_num_pairs;
+        TS_ASSERT(file.good());
+
+        /*
+         * The luminal-myoepithelial contacts count twice towards the boundary length, and the
+         * contacts with untyped cells once; every pair but the two untyped cells counts twice
+         * towards the number of heterotypic pairs.
+         */
+        TS_ASSERT_DELTA(time, 0.0, 1e-12);
+        TS_ASSERT_DELTA(heterotypic_boundary_length, 2.0*1.4 + 0.6 + 0.8, 1e-5);
+        TS_ASSERT_DELTA(total_shared_edges_length, 4.8, 1e-5);
+        TS_ASSERT_DELTA(num_heterotypic_pairs, 12.0, 1e-12);
+        TS_ASSERT_DELTA(total_num_pairs, 7.0, 1e-12);
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+};
+
+#endif /*TESTBOUNDARYLENGTHWRITER_HPP_*/
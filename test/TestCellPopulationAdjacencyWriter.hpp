@@ -0,0 +1,178 @@
+#ifndef TESTCELLPOPULATIONADJACENCYWRITER_HPP_
+#define TESTCELLPOPULATIONADJACENCYWRITER_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <stdint.h>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "CellPopulationAdjacencyWriter.hpp"
+
+/*
+ * Checks every layout of CellPopulationAdjacencyWriter against the hand-computed adjacency
+ * of five cells of radius 0.5:
+ *
+ *   0 (luminal) at (0,0), 1 (myoepithelial) at (0.75,0), 2 (luminal) at (1.5,0),
+ *   3 (luminal) at (2.5,0) and 4 (luminal) at (2.5,0.75),
+ *
+ * whose links are 0-1 and 1-2 (type 3) and 3-4 (type 2). Cells 2 and 3 are exactly
+ * touching, so are not neighbours, as in NodeBasedCellPopulation::GetNeighbouringLocationIndices().
+ */
+class TestCellPopulationAdjacencyWriter : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Write the adjacency of a population at one time.
+     *
+     * @param rCellPopulation the population
+     * @param format the layout
+     * @param binary whether to write in binary
+     * @param visitAnyPopulation whether to visit through VisitAnyPopulation(), as for a
+     *     population without node pairs, rather than Visit(NodeBasedCellPopulation*)
+     * @param rDirectory the output directory
+     * @return the contents of the output file
+     */
+    std::string WriteAdjacency(NodeBasedCellPopulation<2>& rCellPopulation,
+                               AdjacencyOutputFormat format,
+                               bool binary,
+                               bool visitAnyPopulation,
+                               const std::string& rDirectory)
+    {
+        CellPopulationAdjacencyWriter<2,2> writer;
+        writer.SetOutputFormat(format);
+        writer.SetUseBinaryOutput(binary);
+
+        OutputFileHandler handler(rDirectory, true);
+        writer.OpenOutputFile(handler);
+        writer.WriteTimeStamp();
+        if (visitAnyPopulation)
+        {
+            writer.VisitAnyPopulation(&rCellPopulation);
+        }
+        else
+        {
+            writer.Visit(&rCellPopulation);
+        }
+        writer.WriteNewline();
+        writer.CloseFile();
+
+        std::string file_name = binary ? "cellpopulationadjacency.bin" : "cellpopulationadjacency.dat";
+        std::ifstream file((handler.GetOutputDirectoryFullPath() + file_name).c_str(), std::ios::binary);
+        TS_ASSERT(file.is_open());
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+    /**
+     * @param time the time of the record
+     * @param rValues the unsigned values of the record
+     * @return a binary record, as written by CellPopulationAdjacencyWriter
+     */
+    std::string MakeBinaryRecord(double time, const std::vector<uint32_t>& rValues)
+    {
+        std::string record(reinterpret_cast<const char*>(&time), sizeof(double));
+        record.append(reinterpret_cast<const char*>(&rValues[0]), rValues.size()*sizeof(uint32_t));
+        return record;
+    }
+
+public:
+
+    void TestLayoutsAgree()
+    {
+        EXIT_IF_PARALLEL;
+
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        std::vector<Node<2>*> nodes;
+        nodes.push_back(new Node<2>(0, false, 0.0, 0.0));
+        nodes.push_back(new Node<2>(1, false, 0.75, 0.0));
+        nodes.push_back(new Node<2>(2, false, 1.5, 0.0));
+        nodes.push_back(new Node<2>(3, false, 2.5, 0.0));
+        nodes.push_back(new Node<2>(4, false, 2.5, 0.75));
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        std::vector<CellPtr> cells;
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+            p_model->SetDimension(2);
+
+            CellPtr p_cell(new Cell(p_state, p_model));
+            p_cell->SetCellProliferativeType(p_differentiated_type);
+            p_cell->AddCellProperty(MammaryCellPropertyHelper::CreateMammaryCellProperty(i == 1 ? MYOEPITHELIAL_CELL : LUMINAL_CELL, false, false));
+            p_cell->InitialiseCellCycleModel();
+            cells.push_back(p_cell);
+        }
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        // [time] [number of cells] then the 5x5 matrix, row by row
+        std::string dense = WriteAdjacency(cell_population, DENSE_ADJACENCY, false, false, "TestCellPopulationAdjacencyWriter/Dense");
+        TS_ASSERT_EQUALS(dense, "0\t5\t"
+                                "0\t3\t0\t0\t0\t"
+                                "3\t0\t3\t0\t0\t"
+                                "0\t3\t0\t0\t0\t"
+                                "0\t0\t0\t0\t2\t"
+                                "0\t0\t0\t2\t0\t\n");
+
+        // The node pairs give the same matrix as the neighbours of each cell
+        std::string dense_from_neighbours = WriteAdjacency(cell_population, DENSE_ADJACENCY, false, true, "TestCellPopulationAdjacencyWriter/DenseFromNeighbours");
+        TS_ASSERT_EQUALS(dense_from_neighbours, dense);
+
+        // [time] [number of cells] [number of edges] then [i] [j] [type of link] for each edge
+        std::string edge_list = WriteAdjacency(cell_population, EDGE_LIST_ADJACENCY, false, false, "TestCellPopulationAdjacencyWriter/EdgeList");
+        TS_ASSERT_EQUALS(edge_list, "0\t5\t3\t"
+                                    "0\t1\t3\t"
+                                    "1\t2\t3\t"
+                                    "3\t4\t2\t\n");
+
+        // [time] [number of cells] [number of entries] [row offsets] [column indices] [types of link]
+        std::string csr = WriteAdjacency(cell_population, CSR_ADJACENCY, false, false, "TestCellPopulationAdjacencyWriter/Csr");
+        TS_ASSERT_EQUALS(csr, "0\t5\t6\t"
+                              "0\t1\t3\t4\t5\t6\t"
+                              "1\t0\t2\t1\t4\t3\t"
+                              "3\t3\t3\t3\t2\t2\t\n");
+
+        // The binary records hold the same arrays, after the time and the layout
+        uint32_t edge_list_values[] = {EDGE_LIST_ADJACENCY, 5, 3, 0, 1, 3, 1, 2, 3, 3, 4, 2};
+        std::string binary_edge_list = WriteAdjacency(cell_population, EDGE_LIST_ADJACENCY, true, false, "TestCellPopulationAdjacencyWriter/BinaryEdgeList");
+        TS_ASSERT_EQUALS(binary_edge_list.size(), sizeof(double) + 12*sizeof(uint32_t));
+        TS_ASSERT(binary_edge_list == MakeBinaryRecord(0.0, std::vector<uint32_t>(edge_list_values, edge_list_values + 12)));
+
+        uint32_t csr_values[] = {CSR_ADJACENCY, 5, 6, 0, 1, 3, 4, 5, 6, 1, 0, 2, 1, 4, 3, 3, 3, 3, 3, 2, 2};
+        std::string binary_csr = WriteAdjacency(cell_population, CSR_ADJACENCY, true, false, "TestCellPopulationAdjacencyWriter/BinaryCsr");
+        TS_ASSERT_EQUALS(binary_csr.size(), sizeof(double) + 21*sizeof(uint32_t));
+        TS_ASSERT(binary_csr == MakeBinaryRecord(0.0, std::vector<uint32_t>(csr_values, csr_values + 21)));
+
+        // Binary output is only available for the sparse layouts
+        CellPopulationAdjacencyWriter<2,2> writer;
+        TS_ASSERT_THROWS_THIS(writer.SetUseBinaryOutput(true), "Binary output is only available for the sparse adjacency layouts");
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+};
+
+#endif /*TESTCELLPOPULATIONADJACENCYWRITER_HPP_*/
@@ -0,0 +1,241 @@
+#ifndef TESTCELLTRAJECTORYSTORE_HPP_
+#define TESTCELLTRAJECTORYSTORE_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <cfloat>
+#include <climits>
+#include <map>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "CellDataColumns.hpp"
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "CellTrajectoryStoreModifier.hpp"
+#include "CellTrajectoryStoreReader.hpp"
+
+/*
+ * Writes a cell trajectory store with CellTrajectoryStoreModifier, over a few time steps in
+ * which cells are born and die, and checks that CellTrajectoryStoreReader reads back each
+ * cell's family, birth, death and trajectory.
+ */
+class TestCellTrajectoryStore : public AbstractCellBasedTestSuite
+{
+private:
+
+    /** The parent of each daughter cell, by cell ID, as MammaryOffLatticeSimulation records it. */
+    std::map<unsigned, unsigned> mParentIds;
+
+    /**
+     * @param cellId the ID of a cell
+     * @param step a time step
+     * @return the position of the cell at the time step
+     */
+    c_vector<double, 2> GetPosition(unsigned cellId, unsigned step)
+    {
+        c_vector<double, 2> position;
+        position[0] = 2.0*cellId + 0.25*step;
+        position[1] = 0.1*step*cellId + 1.0/3.0;
+        return position;
+    }
+
+    /**
+     * @return a cell with MammaryCellCycleModel, which therefore never divides
+     */
+    CellPtr CreateCell()
+    {
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+
+        MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+        p_model->SetDimension(2);
+
+        CellPtr p_cell(new Cell(p_state, p_model));
+        p_cell->SetCellProliferativeType(p_differentiated_type);
+        p_cell->AddCellProperty(MammaryCellPropertyHelper::CreateMammaryCellProperty(LUMINAL_CELL, false, false));
+        p_cell->InitialiseCellCycleModel();
+        return p_cell;
+    }
+
+    /**
+     * Pass a population of the given cells, at their positions for the current time step,
+     * to the modifier, as a simulation would at the start of Solve() (time step 0) or at
+     * the end of a time step.
+     *
+     * @param rModifier the modifier
+     * @param rCells the live cells
+     * @param isLastStep whether this is the last time step, after which the store is completed
+     * @param recordParents whether to record mParentIds in the population's "parent_id" column,
+     *     as MammaryOffLatticeSimulation does
+     */
+    void UpdateModifier(CellTrajectoryStoreModifier<2>& rModifier, std::vector<CellPtr>& rCells, bool isLastStep, bool recordParents=true)
+    {
+        unsigned step = SimulationTime::Instance()->GetTimeStepsElapsed();
+
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<rCells.size(); i++)
+        {
+            c_vector<double, 2> position = GetPosition(rCells[i]->GetCellId(), step);
+            nodes.push_back(new Node<2>(i, false, position[0], position[1]));
+        }
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+        NodeBasedCellPopulation<2> cell_population(mesh, rCells);
+
+        if (recordParents)
+        {
+            boost::shared_ptr<CellDataColumns> p_columns = CellDataColumns::Get(cell_population.GetCellPropertyRegistry());
+            unsigned parent_id_handle = p_columns->RegisterColumn("parent_id");
+            for (std::map<unsigned, unsigned>::iterator it = mParentIds.begin(); it != mParentIds.end(); ++it)
+            {
+                p_columns->SetValue(parent_id_handle, it->first, it->second);
+            }
+        }
+
+        if (step == 0)
+        {
+            rModifier.SetupSolve(cell_population, "TestCellTrajectoryStore");
+        }
+        else
+        {
+            rModifier.UpdateAtEndOfTimeStep(cell_population);
+        }
+        if (isLastStep)
+        {
+            rModifier.UpdateAtEndOfSolve(cell_population);
+        }
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
+public:
+
+    void TestNeedsParentIds()
+    {
+        EXIT_IF_PARALLEL;
+
+        // As under OffLatticeSimulation, which does not record parents
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        std::vector<CellPtr> cells(1, CreateCell());
+        CellTrajectoryStoreModifier<2> modifier;
+        TS_ASSERT_THROWS_THIS(UpdateModifier(modifier, cells, false, false),
+            "CellTrajectoryStoreModifier needs the parent_id cell data column, which is written by MammaryOffLatticeSimulation");
+    }
+
+    void TestStoreRoundTrip()
+    {
+        EXIT_IF_PARALLEL;
+
+        mParentIds.clear();
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(4.0, 4);
+        OutputFileHandler output_file_handler("TestCellTrajectoryStore", true);
+
+        // Chunks of two samples, so that longer trajectories are spread over several chunks
+        CellTrajectoryStoreModifier<2> modifier;
+        modifier.SetChunkSize(2);
+
+        /*
+         * Cells a and b are there from the start. At step 2, c is born to a; at step 3, b
+         * dies and d is born to c.
+         */
+        std::vector<CellPtr> cells;
+        cells.push_back(CreateCell());
+        cells.push_back(CreateCell());
+        CellPtr p_cell_a = cells[0];
+        CellPtr p_cell_b = cells[1];
+        UpdateModifier(modifier, cells, false);
+
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        UpdateModifier(modifier, cells, false);
+
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        CellPtr p_cell_c = CreateCell();
+        mParentIds[p_cell_c->GetCellId()] = p_cell_a->GetCellId();
+        cells.push_back(p_cell_c);
+        UpdateModifier(modifier, cells, false);
+
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        CellPtr p_cell_d = CreateCell();
+        mParentIds[p_cell_d->GetCellId()] = p_cell_c->GetCellId();
+        cells.erase(cells.begin() + 1);
+        cells.push_back(p_cell_d);
+        UpdateModifier(modifier, cells, false);
+
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        UpdateModifier(modifier, cells, true);
+
+        CellTrajectoryStoreReader<2> reader(output_file_handler.GetOutputDirectoryFullPath() + "cell_trajectories.bin");
+        TS_ASSERT_EQUALS(reader.GetNumCells(), 4u);
+
+        unsigned id_a = p_cell_a->GetCellId();
+        unsigned id_b = p_cell_b->GetCellId();
+        unsigned id_c = p_cell_c->GetCellId();
+        unsigned id_d = p_cell_d->GetCellId();
+
+        // Family
+        TS_ASSERT_EQUALS(reader.GetParentId(id_a), (unsigned)UINT_MAX);
+        TS_ASSERT_EQUALS(reader.GetParentId(id_b), (unsigned)UINT_MAX);
+        TS_ASSERT_EQUALS(reader.GetParentId(id_c), id_a);
+        TS_ASSERT_EQUALS(reader.GetParentId(id_d), id_c);
+
+        std::vector<unsigned> lineage = reader.GetLineage(id_a);
+        TS_ASSERT_EQUALS(lineage.size(), 3u);
+        TS_ASSERT_EQUALS(lineage[0], id_a);
+        TS_ASSERT_EQUALS(lineage[1], id_c);
+        TS_ASSERT_EQUALS(lineage[2], id_d);
+        TS_ASSERT_EQUALS(reader.GetLineage(id_b).size(), 1u);
+        TS_ASSERT_EQUALS(reader.GetLineage(id_c).size(), 2u);
+
+        std::vector<unsigned> ancestors = reader.GetAncestors(id_d);
+        TS_ASSERT_EQUALS(ancestors.size(), 2u);
+        TS_ASSERT_EQUALS(ancestors[0], id_c);
+        TS_ASSERT_EQUALS(ancestors[1], id_a);
+
+        // Births and deaths
+        TS_ASSERT_DELTA(reader.GetBirthTime(id_c), 2.0, 1e-12);
+        TS_ASSERT_DELTA(reader.GetBirthTime(id_d), 3.0, 1e-12);
+        TS_ASSERT_DELTA(reader.GetBirthPosition(id_d)[0], GetPosition(id_d, 3)[0], 1e-12);
+        TS_ASSERT_DELTA(reader.GetBirthPosition(id_d)[1], GetPosition(id_d, 3)[1], 1e-12);
+        TS_ASSERT_DELTA(reader.GetDeathTime(id_b), 3.0, 1e-12);
+        TS_ASSERT_EQUALS(reader.GetDeathTime(id_a), DBL_MAX);
+
+        // Trajectories, each sampled at every time step from birth to death
+        unsigned ids[4] = {id_a, id_b, id_c, id_d};
+        unsigned first_steps[4] = {0, 0, 2, 3};
+        unsigned num_samples[4] = {5, 3, 3, 2};
+        for (unsigned i=0; i<4; i++)
+        {
+            TS_ASSERT_EQUALS(reader.GetNumSamples(ids[i]), num_samples[i]);
+
+            std::vector<double> times;
+            std::vector<c_vector<double, 2> > positions;
+            reader.ReadTrajectory(ids[i], times, positions);
+            TS_ASSERT_EQUALS(times.size(), num_samples[i]);
+            TS_ASSERT_EQUALS(positions.size(), num_samples[i]);
+            for (unsigned j=0; j<times.size(); j++)
+            {
+                unsigned step = first_steps[i] + j;
+                TS_ASSERT_DELTA(times[j], 1.0*step, 1e-12);
+                TS_ASSERT_DELTA(positions[j][0], GetPosition(ids[i], step)[0], 1e-12);
+                TS_ASSERT_DELTA(positions[j][1], GetPosition(ids[i], step)[1], 1e-12);
+            }
+        }
+    }
+};
+
+#endif /*TESTCELLTRAJECTORYSTORE_HPP_*/
@@ -0,0 +1,130 @@
+#ifndef TESTCELLTYPESNAPSHOTFORMAT_HPP_
+#define TESTCELLTYPESNAPSHOTFORMAT_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "CellPropertyRegistry.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "LuminalCellProperty.hpp"
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "MammaryCellTypeWriter.hpp"
+#include "MammaryCompositeWriter.hpp"
+#include "CellTypeSnapshotFormat.hpp"
+
+/*
+ * Checks that CellTypeSnapshotFormat, written through MammaryCompositeWriter, reproduces
+ * results.viztypes as written by MammaryCellTypeWriter byte for byte.
+ */
+class TestCellTypeSnapshotFormat : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * @param rDirectory the full path of a directory
+     * @return the contents of results.viztypes in the directory
+     */
+    std::string ReadVizTypes(const std::string& rDirectory)
+    {
+        std::ifstream file((rDirectory + "results.viztypes").c_str());
+        TS_ASSERT(file.is_open());
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+public:
+
+    void TestMatchesMammaryCellTypeWriter()
+    {
+        EXIT_IF_PARALLEL;
+
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<12; i++)
+        {
+            nodes.push_back(new Node<2>(i, false, 0.7312*i, 0.1*(i%3) + 1.0/3.0));
+        }
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        /*
+         * Every mammary type with every combination of integrin expression, the daughter of
+         * a luminal stem cell (which also has the luminal property) and a cell with no type.
+         */
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        std::vector<CellPtr> cells;
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+            p_model->SetDimension(2);
+
+            CellPtr p_cell(new Cell(p_state, p_model));
+            p_cell->SetCellProliferativeType(p_differentiated_type);
+            if (i < 8)
+            {
+                p_cell->AddCellProperty(MammaryCellPropertyHelper::CreateMammaryCellProperty((MammaryCellType)(i%4), i%2 == 0, i/4 == 1));
+            }
+            else if (i < 10)
+            {
+                p_cell->AddCellProperty(MammaryCellPropertyHelper::CreateMammaryCellProperty(LUMINAL_STEM_CELL, true, true));
+                p_cell->AddCellProperty(CellPropertyRegistry::Instance()->Get<LuminalCellProperty>());
+            }
+            p_cell->InitialiseCellCycleModel();
+            cells.push_back(p_cell);
+        }
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        // Write results.viztypes with MammaryCellTypeWriter
+        OutputFileHandler writer_handler("TestCellTypeSnapshotFormat/Writer", true);
+        MammaryCellTypeWriter<2,2> writer;
+        writer.OpenOutputFile(writer_handler);
+        writer.WriteTimeStamp();
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            writer.VisitCell(*cell_iter, &cell_population);
+        }
+        writer.WriteNewline();
+        writer.CloseFile();
+
+        // Write results.viztypes with CellTypeSnapshotFormat
+        OutputFileHandler format_handler("TestCellTypeSnapshotFormat/Format", true);
+        MammaryCompositeWriter<2,2> composite_writer;
+        composite_writer.AddSnapshotFormat(boost::shared_ptr<AbstractSnapshotFormat<2> >(new CellTypeSnapshotFormat<2>()));
+        composite_writer.OpenOutputFile(format_handler);
+        composite_writer.WriteTimeStamp();
+        composite_writer.Visit(&cell_population);
+        composite_writer.WriteNewline();
+        composite_writer.CloseFile();
+
+        std::string written_by_writer = ReadVizTypes(writer_handler.GetOutputDirectoryFullPath());
+        std::string written_by_format = ReadVizTypes(format_handler.GetOutputDirectoryFullPath());
+        TS_ASSERT_LESS_THAN(0u, written_by_writer.size());
+        TS_ASSERT_EQUALS(written_by_format, written_by_writer);
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+};
+
+#endif /*TESTCELLTYPESNAPSHOTFORMAT_HPP_*/
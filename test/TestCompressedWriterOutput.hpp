@@ -0,0 +1,218 @@
+#ifndef TESTCOMPRESSEDWRITEROUTPUT_HPP_
+#define TESTCOMPRESSEDWRITEROUTPUT_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "CellLocationWriter.hpp"
+#include "BoundaryLengthWriter.hpp"
+#include "SnapshotCompressor.hpp"
+
+#ifdef MAMMARY_HAVE_ZLIB
+#include <zlib.h>
+#endif
+
+/*
+ * Checks that the gzip-compressed output of CellLocationWriter and BoundaryLengthWriter,
+ * decompressed as a whole by zlib (as gunzip would) or frame by frame by
+ * SnapshotCompressor, is exactly the uncompressed output.
+ */
+class TestCompressedWriterOutput : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * @param rFileName the full path of a file
+     * @return the contents of the file
+     */
+    std::string ReadFile(const std::string& rFileName)
+    {
+        std::ifstream file(rFileName.c_str(), std::ios::binary);
+        TS_ASSERT(file.is_open());
+        std::stringstream contents;
+        contents << file.rdbuf();
+        return contents.str();
+    }
+
+#ifdef MAMMARY_HAVE_ZLIB
+    /**
+     * @param rFileName the full path of a gzip file, of one or more members
+     * @return the decompressed contents of the file
+     */
+    std::string ReadGzipFile(const std::string& rFileName)
+    {
+        gzFile file = gzopen(rFileName.c_str(), "rb");
+        TS_ASSERT(file != NULL);
+        std::string contents;
+        char chunk[4096];
+        int num_bytes_read;
+        while ((num_bytes_read = gzread(file, chunk, sizeof(chunk))) > 0)
+        {
+            contents.append(chunk, num_bytes_read);
+        }
+        TS_ASSERT_EQUALS(num_bytes_read, 0);
+        gzclose(file);
+        return contents;
+    }
+
+    /**
+     * Decompress a file one frame at a time.
+     *
+     * @param rFileName the full path of a gzip file written by a compressed writer
+     * @param rNumFrames filled in with the number of frames in the file
+     * @return the decompressed contents of the file
+     */
+    std::string DecompressFrames(const std::string& rFileName, unsigned& rNumFrames)
+    {
+        std::string compressed = ReadFile(rFileName);
+        std::string contents;
+        std::string frame;
+        rNumFrames = 0;
+        uint64_t offset = 0;
+        while (offset < compressed.size())
+        {
+            uint64_t frame_size = SnapshotCompressor::DecompressFrame(GZIP_COMPRESSION, compressed.data() + offset, compressed.size() - offset, frame);
+            TS_ASSERT_LESS_THAN(0u, frame_size);
+            if (frame_size == 0)
+            {
+                break;
+            }
+            contents += frame;
+            offset += frame_size;
+            rNumFrames++;
+        }
+        return contents;
+    }
+#endif // MAMMARY_HAVE_ZLIB
+
+public:
+
+    void TestGzipRoundTrip()
+    {
+        EXIT_IF_PARALLEL;
+
+#ifdef MAMMARY_HAVE_ZLIB
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(3.0, 3);
+
+        // A row of luminal and myoepithelial cells, close enough to be in contact
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<8; i++)
+        {
+            nodes.push_back(new Node<2>(i, false, 0.8*i, 0.1*(i%3)));
+        }
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        std::vector<CellPtr> cells;
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+            p_model->SetDimension(2);
+
+            CellPtr p_cell(new Cell(p_state, p_model));
+            p_cell->SetCellProliferativeType(p_differentiated_type);
+            p_cell->AddCellProperty(MammaryCellPropertyHelper::CreateMammaryCellProperty(i%3 == 0 ? MYOEPITHELIAL_CELL : LUMINAL_CELL, false, false));
+            p_cell->InitialiseCellCycleModel();
+            cells.push_back(p_cell);
+        }
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        OutputFileHandler plain_handler("TestCompressedWriterOutput/Uncompressed", true);
+        CellLocationWriter<2,2> plain_location_writer;
+        BoundaryLengthWriter<2,2> plain_boundary_writer;
+        plain_location_writer.OpenOutputFile(plain_handler);
+        plain_boundary_writer.OpenOutputFile(plain_handler);
+
+        OutputFileHandler gzip_handler("TestCompressedWriterOutput/Gzip", true);
+        CellLocationWriter<2,2> gzip_location_writer;
+        BoundaryLengthWriter<2,2> gzip_boundary_writer;
+        gzip_location_writer.SetCompression(GZIP_COMPRESSION);
+        gzip_boundary_writer.SetCompression(GZIP_COMPRESSION);
+        TS_ASSERT_EQUALS(gzip_location_writer.GetCompressionType(), GZIP_COMPRESSION);
+        gzip_location_writer.OpenOutputFile(gzip_handler);
+        gzip_boundary_writer.OpenOutputFile(gzip_handler);
+
+        // Write three output times, moving the cells apart between them
+        for (unsigned frame=0; frame<3; frame++)
+        {
+            plain_location_writer.WriteTimeStamp();
+            gzip_location_writer.WriteTimeStamp();
+            for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+                 cell_iter != cell_population.End();
+                 ++cell_iter)
+            {
+                plain_location_writer.VisitCell(*cell_iter, &cell_population);
+                gzip_location_writer.VisitCell(*cell_iter, &cell_population);
+            }
+            plain_location_writer.WriteNewline();
+            gzip_location_writer.WriteNewline();
+
+            plain_boundary_writer.WriteTimeStamp();
+            plain_boundary_writer.Visit(&cell_population);
+            plain_boundary_writer.WriteNewline();
+            gzip_boundary_writer.WriteTimeStamp();
+            gzip_boundary_writer.Visit(&cell_population);
+            gzip_boundary_writer.WriteNewline();
+
+            SimulationTime::Instance()->IncrementTimeOneStep();
+            for (unsigned i=0; i<cell_population.GetNumNodes(); i++)
+            {
+                cell_population.GetNode(i)->rGetModifiableLocation()[0] *= 1.1;
+            }
+        }
+
+        plain_location_writer.CloseFile();
+        plain_boundary_writer.CloseFile();
+        gzip_location_writer.CloseFile();
+        gzip_boundary_writer.CloseFile();
+
+        std::string plain_directory = plain_handler.GetOutputDirectoryFullPath();
+        std::string gzip_directory = gzip_handler.GetOutputDirectoryFullPath();
+        const char* file_names[] = {"location.dat", "heterotypicboundary.dat"};
+        for (unsigned i=0; i<2; i++)
+        {
+            std::string uncompressed = ReadFile(plain_directory + file_names[i]);
+            TS_ASSERT_LESS_THAN(0u, uncompressed.size());
+
+            std::string compressed_file_name = gzip_directory + file_names[i] + ".gz";
+            TS_ASSERT_EQUALS(ReadGzipFile(compressed_file_name), uncompressed);
+
+            // Each output time is a gzip member of its own
+            unsigned num_frames;
+            TS_ASSERT_EQUALS(DecompressFrames(compressed_file_name, num_frames), uncompressed);
+            TS_ASSERT_EQUALS(num_frames, 3u);
+        }
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+#else
+        // Without zlib, asking for gzip compression is an error
+        CellLocationWriter<2,2> writer;
+        TS_ASSERT_THROWS_THIS(writer.SetCompression(GZIP_COMPRESSION),
+                              "This build does not support the requested output compression");
+#endif // MAMMARY_HAVE_ZLIB
+    }
+};
+
+#endif /*TESTCOMPRESSEDWRITEROUTPUT_HPP_*/
@@ -0,0 +1,183 @@
+#ifndef TESTMAMMARYALLOCATIONBENCHMARK_HPP_
+#define TESTMAMMARYALLOCATIONBENCHMARK_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "UblasCustomFunctions.hpp"
+#include "OffLatticeSimulation.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "CellId.hpp"
+#include "Timer.hpp"
+
+#include "LuminalStemCellProperty.hpp"
+#include "MyoepithelialStemCellProperty.hpp"
+
+#include "MammaryCellCycleModel.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "StemCellProliferativeType.hpp"
+
+#include "OrientedDivisionRule.hpp"
+#include "AnoikisCellKiller3D.hpp"
+#include "GeneralisedLinearSpringForce.hpp"
+
+#include "ObjectPool.hpp"
+
+/*
+ * Benchmarks the pooled allocation of cell-cycle models in a growth-heavy organoid,
+ * in which every division clones a cycle model and anoikis continually frees them.
+ * The same simulation is run with pooling switched off and on, and the allocation
+ * counts and run times of each are printed.
+ */
+class TestMammaryAllocationBenchmark : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Run a small 3D organoid of stem cells to the given end time.
+     *
+     * @param poolingEnabled whether cycle models are taken from the ObjectPool
+     * @param endTime the simulation end time
+     * @return the wall-clock run time of the simulation
+     */
+    double RunGrowthSimulation(bool poolingEnabled, double endTime)
+    {
+        // Start each run from the same state so that both runs see the same divisions and deaths
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+        RandomNumberGenerator::Instance()->Reseed(0);
+        CellId::ResetMaxCellId();
+
+        ObjectPool<MammaryCellCycleModel>* p_pool = ObjectPool<MammaryCellCycleModel>::Instance();
+        p_pool->SetPoolingEnabled(poolingEnabled);
+        p_pool->ResetCounters();
+
+        Timer::Reset();
+        {
+            std::vector<Node<3>*> nodes;
+            unsigned index = 0;
+            for (unsigned i=0; i<3; i++)
+            {
+                for (unsigned j=0; j<3; j++)
+                {
+                    for (unsigned k=0; k<3; k++)
+                    {
+                        nodes.push_back(new Node<3>(index, false, 0.75*i, 0.75*j, 0.75*k));
+                        index++;
+                    }
+                }
+            }
+            NodesOnlyMesh<3> mesh;
+            mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+            MAKE_PTR(WildTypeCellMutationState, p_state);
+            MAKE_PTR(StemCellProliferativeType, p_stem_type);
+
+            std::vector<CellPtr> cells;
+            for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+            {
+                MammaryCellCycleModel* p_cycle_model = new MammaryCellCycleModel();
+                p_cycle_model->SetDimension(3);
+                p_cycle_model->SetMinCellCycleDuration(4.0);
+                p_cycle_model->SetMaxCellCycleDuration(6.0);
+                p_cycle_model->SetBirthTime(-6.0*RandomNumberGenerator::Instance()->ranf());
+
+                CellPtr p_cell(new Cell(p_state, p_cycle_model));
+                p_cell->SetCellProliferativeType(p_stem_type);
+                cells.push_back(p_cell);
+            }
+
+            NodeBasedCellPopulation<3> cell_population(mesh, cells);
+
+            boost::shared_ptr<AbstractCellProperty> p_lsc(cell_population.GetCellPropertyRegistry()->Get<LuminalStemCellProperty>());
+            boost::shared_ptr<AbstractCellProperty> p_msc(cell_population.GetCellPropertyRegistry()->Get<MyoepithelialStemCellProperty>());
+            for (AbstractCellPopulation<3>::Iterator cell_iter = cell_population.Begin();
+                 cell_iter != cell_population.End();
+                 ++cell_iter)
+            {
+                if (RandomNumberGenerator::Instance()->ranf() < 0.5)
+                {
+                    cell_iter->AddCellProperty(p_lsc);
+                }
+                else
+                {
+                    cell_iter->AddCellProperty(p_msc);
+                }
+                cell_iter->InitialiseCellCycleModel();
+            }
+
+            boost::shared_ptr<AbstractCentreBasedDivisionRule<3,3> > p_division_rule(new OrientedDivisionRule<3,3>());
+            cell_population.SetCentreBasedDivisionRule(p_division_rule);
+
+            OffLatticeSimulation<3> simulator(cell_population);
+            simulator.SetOutputDirectory(poolingEnabled ? "TestMammaryAllocationBenchmark/Pooled" : "TestMammaryAllocationBenchmark/Heap");
+            simulator.SetSamplingTimestepMultiple(120);
+            simulator.SetEndTime(endTime);
+
+            MAKE_PTR(GeneralisedLinearSpringForce<3>, p_force);
+            p_force->SetCutOffLength(1.5);
+            simulator.AddForce(p_force);
+
+            // Kill cells that end up in the centre of the organoid, so that models are freed as well as created
+            c_vector<double,3> centre = Create_c_vector(0.75, 0.75, 0.75);
+            MAKE_PTR_ARGS(AnoikisCellKiller3D, p_killer, (&cell_population, centre, 0.5));
+            simulator.AddCellKiller(p_killer);
+
+            simulator.Solve();
+
+            std::cout << (poolingEnabled ? "Pooled" : "Heap") << " run: "
+                      << cell_population.GetNumRealCells() << " cells at end, "
+                      << p_pool->GetPeakNumLiveObjects() << " peak live cycle models\n";
+
+            for (unsigned i=0; i<nodes.size(); i++)
+            {
+                delete nodes[i];
+            }
+        }
+        double run_time = Timer::GetElapsedTime();
+
+        // Every cycle model must have been returned once the population is destroyed
+        TS_ASSERT_EQUALS(p_pool->GetNumLiveObjects(), 0u);
+
+        std::cout << "    cycle model allocations: " << p_pool->GetNumObjectAllocations()
+                  << ", heap allocations: " << p_pool->GetNumHeapAllocations()
+                  << ", bytes reserved in slabs: " << p_pool->GetNumBytesReserved()
+                  << ", run time: " << run_time << " s\n";
+
+        return run_time;
+    }
+
+public:
+
+    void TestPooledVersusHeapAllocation()
+    {
+        EXIT_IF_PARALLEL;
+
+        double end_time = 48.0;
+        double heap_time = RunGrowthSimulation(false, end_time);
+        unsigned long heap_allocations = ObjectPool<MammaryCellCycleModel>::Instance()->GetNumHeapAllocations();
+        unsigned long heap_objects = ObjectPool<MammaryCellCycleModel>::Instance()->GetNumObjectAllocations();
+
+        double pooled_time = RunGrowthSimulation(true, end_time);
+        unsigned long pooled_allocations = ObjectPool<MammaryCellCycleModel>::Instance()->GetNumHeapAllocations();
+        unsigned long pooled_objects = ObjectPool<MammaryCellCycleModel>::Instance()->GetNumObjectAllocations();
+
+        // Both runs are seeded identically, so they create the same number of cycle models
+        TS_ASSERT_EQUALS(heap_objects, pooled_objects);
+
+        // With pooling, the heap is only touched once per slab
+        TS_ASSERT_LESS_THAN(pooled_allocations, heap_allocations);
+
+        std::cout << "Heap/pooled run time ratio: " << heap_time/pooled_time << "\n";
+
+        // Leave pooling switched on for any later tests
+        ObjectPool<MammaryCellCycleModel>::Instance()->SetPoolingEnabled(true);
+    }
+};
+
+#endif /*TESTMAMMARYALLOCATIONBENCHMARK_HPP_*/
@@ -0,0 +1,218 @@
+#ifndef TESTMAMMARYBENCHMARKS_HPP_
+#define TESTMAMMARYBENCHMARKS_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+#include "CommandLineArguments.hpp"
+#include "OutputFileHandler.hpp"
+
+#include "MammaryBenchmarkScenario.hpp"
+#include "MammaryProfiler.hpp"
+#include "MammaryRandomStreams.hpp"
+
+/*
+ * Benchmarks the simulation step on organoids, monolayers and particle-embedded organoids
+ * of 10^3 cells and 10^4 cells, in 2D and 3D, each run for a fixed number of time steps (10, or the number given by the
+ * option --steps) with each of the force combinations relevant to it. Larger sizes, by
+ * factors of 10 up to 10^6 cells, take hours and many gigabytes of memory, so are only run
+ * when asked for with the option --max-cells (e.g. --max-cells 1000000).
+ *
+ * The time per step, per cell and per phase of every run is written, one row per run, to
+ * TestMammaryBenchmarks/benchmarks.csv in the Chaste output directory.
+ *
+ * When built with MAMMARY_PROFILING, the phases of each run are also written to profile.csv
+ * and profile.json in its own output directory. With the option --counters, these also
+ * give the cycles, instructions, cache misses and branch mispredictions of each phase,
+ * counted with MammaryPerformanceCounters.
+ *
+ * With the option --reproducible, the runs use the reproducible mode of MammaryRandomStreams,
+ * so that its cost can be measured.
+ *
+ * TestProfilingOverhead measures the cost of MAMMARY_PROFILE_SCOPE. Each build records its
+ * time per step on a 3D organoid of 10^3 cells in profiled_time_per_step.txt or
+ * unprofiled_time_per_step.txt, and reports the ratio of the two once both builds have been
+ * run. A build with MAMMARY_PROFILING also times its own timed scopes, and checks that they
+ * cost under 1% of the run.
+ */
+class TestMammaryBenchmarks : public AbstractCellBasedTestSuite
+{
+private:
+
+    /** The output file of the results. */
+    out_stream mpResultsFile;
+
+    /**
+     * Run every force combination of a geometry for each number of cells.
+     *
+     * @param geometry the geometry
+     * @param rForceCombinations the force combinations to run
+     */
+    template<unsigned DIM>
+    void RunScenarios(MammaryBenchmarkGeometry geometry, const std::vector<unsigned>& rForceCombinations)
+    {
+        unsigned max_num_cells = 10000;
+        unsigned num_steps = 10;
+        CommandLineArguments* p_args = CommandLineArguments::Instance();
+        if (p_args->OptionExists("--max-cells"))
+        {
+            max_num_cells = p_args->GetUnsignedCorrespondingToOption("--max-cells");
+        }
+        if (p_args->OptionExists("--steps"))
+        {
+            num_steps = p_args->GetUnsignedCorrespondingToOption("--steps");
+        }
+        if (p_args->OptionExists("--counters"))
+        {
+#ifndef MAMMARY_PROFILING
+            std::cout << "--counters has no effect unless built with MAMMARY_PROFILING\n" << std::flush;
+#endif
+            if (!MammaryProfiler::Instance()->EnableCounters())
+            {
+                std::cout << "Hardware performance counters are not available (check /proc/sys/kernel/perf_event_paranoid)\n" << std::flush;
+            }
+        }
+
+        MammaryRandomStreams::Instance()->SetReproducible(p_args->OptionExists("--reproducible"));
+
+        for (unsigned num_cells=1000; num_cells<=max_num_cells; num_cells*=10)
+        {
+            for (unsigned i=0; i<rForceCombinations.size(); i++)
+            {
+                MammaryBenchmarkScenario<DIM> scenario(geometry, num_cells, rForceCombinations[i]);
+                MammaryBenchmarkResult result = scenario.Run(num_steps, "TestMammaryBenchmarks/" + scenario.GetName());
+
+                if (!mpResultsFile)
+                {
+                    OutputFileHandler output_file_handler("TestMammaryBenchmarks", false);
+                    mpResultsFile = output_file_handler.OpenOutputFile("benchmarks.csv");
+                    MammaryBenchmarkScenario<DIM>::WriteResultHeader(mpResultsFile, result);
+                }
+                scenario.WriteResult(mpResultsFile, result);
+
+                std::cout << scenario.GetName() << ": " << result.GetTimePerStep() << " s per step, "
+                          << 1e6*result.GetTimePerCellStep() << " us per cell per step\n" << std::flush;
+
+                TS_ASSERT_EQUALS(result.mNumCellsAtStart, num_cells);
+            }
+        }
+    }
+
+public:
+
+    void TestProfilingOverhead()
+    {
+        EXIT_IF_PARALLEL;
+
+        unsigned num_steps = 10;
+        CommandLineArguments* p_args = CommandLineArguments::Instance();
+        if (p_args->OptionExists("--steps"))
+        {
+            num_steps = p_args->GetUnsignedCorrespondingToOption("--steps");
+        }
+
+        MammaryBenchmarkScenario<3> scenario(ORGANOID_GEOMETRY, 1000, SPRING_FORCE | RANDOM_MOTION_FORCE);
+        MammaryBenchmarkResult result = scenario.Run(num_steps, "TestMammaryBenchmarks/ProfilingOverhead");
+        double time_per_step = result.GetTimePerStep();
+
+        // Record this build's time per step, and compare it with the other build's, if run
+#ifdef MAMMARY_PROFILING
+        std::string this_build = "profiled";
+        std::string other_build = "unprofiled";
+#else
+        std::string this_build = "unprofiled";
+        std::string other_build = "profiled";
+#endif
+        OutputFileHandler output_file_handler("TestMammaryBenchmarks", false);
+        out_stream p_time_file = output_file_handler.OpenOutputFile(this_build + "_time_per_step.txt");
+        *p_time_file << std::setprecision(9) << time_per_step << "\n";
+        p_time_file->close();
+
+        std::cout << "Time per step " << this_build << ": " << time_per_step << " s\n";
+        std::ifstream other_file((output_file_handler.GetOutputDirectoryFullPath() + other_build + "_time_per_step.txt").c_str());
+        double other_time_per_step = 0.0;
+        if (other_file >> other_time_per_step && other_time_per_step > 0.0)
+        {
+            double profiled_time = (this_build == "profiled") ? time_per_step : other_time_per_step;
+            double unprofiled_time = (this_build == "profiled") ? other_time_per_step : time_per_step;
+            std::cout << "Time per step with MAMMARY_PROFILING / without: " << profiled_time/unprofiled_time << "\n";
+        }
+        else
+        {
+            std::cout << "Run this test in a build " << (this_build == "profiled" ? "without" : "with")
+                      << " MAMMARY_PROFILING to compare the two\n";
+        }
+
+#ifdef MAMMARY_PROFILING
+        /*
+         * Time the timed scopes themselves, since the difference between two builds is within
+         * the noise of a short run: the cost of an empty timed scope, times the number of
+         * scopes timed in the run, as a fraction of the run.
+         */
+        MammaryProfiler* p_profiler = MammaryProfiler::Instance();
+        uint64_t num_scopes = p_profiler->GetNumTimedScopes();
+        unsigned phase = p_profiler->RegisterPhase("profiling_overhead");
+        const unsigned num_samples = 1000000;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for (unsigned i=0; i<num_samples; i++)
+        {
+            MammaryScopedTimer timer(phase);
+        }
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        p_profiler->Reset();
+
+        double overhead = (elapsed.count()/num_samples)*num_scopes/(time_per_step*num_steps);
+        std::cout << num_scopes << " timed scopes at " << 1e9*elapsed.count()/num_samples
+                  << " ns each: " << 100.0*overhead << "% of the run\n";
+
+        // Counting hardware events or allocations is meant to cost more
+        if (!p_profiler->IsCounting() && !MammaryAllocationCounter::IsEnabled())
+        {
+            TS_ASSERT_LESS_THAN(overhead, 0.01);
+        }
+#endif
+    }
+
+    void TestOrganoids()
+    {
+        EXIT_IF_PARALLEL;
+
+        std::vector<unsigned> forces;
+        forces.push_back(SPRING_FORCE);
+        forces.push_back(SPRING_FORCE | RANDOM_MOTION_FORCE);
+        forces.push_back(DIFFERENTIAL_ADHESION_FORCE | RANDOM_MOTION_FORCE);
+        RunScenarios<2>(ORGANOID_GEOMETRY, forces);
+        RunScenarios<3>(ORGANOID_GEOMETRY, forces);
+    }
+
+    void TestMonolayers()
+    {
+        EXIT_IF_PARALLEL;
+
+        std::vector<unsigned> forces;
+        forces.push_back(SPRING_FORCE | RANDOM_MOTION_FORCE);
+        RunScenarios<2>(MONOLAYER_GEOMETRY, forces);
+
+        forces.push_back(SPRING_FORCE | COVERSLIP_ADHESION_FORCE | RANDOM_MOTION_FORCE);
+        RunScenarios<3>(MONOLAYER_GEOMETRY, forces);
+    }
+
+    void TestParticleEmbeddedOrganoids()
+    {
+        EXIT_IF_PARALLEL;
+
+        std::vector<unsigned> forces;
+        forces.push_back(SPRING_FORCE);
+        forces.push_back(SPRING_FORCE | PARTICLE_ADHESION_FORCE | RANDOM_MOTION_FORCE);
+        RunScenarios<2>(PARTICLE_ORGANOID_GEOMETRY, forces);
+        RunScenarios<3>(PARTICLE_ORGANOID_GEOMETRY, forces);
+    }
+};
+
+#endif /*TESTMAMMARYBENCHMARKS_HPP_*/
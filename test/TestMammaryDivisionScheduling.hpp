@@ -0,0 +1,148 @@
+#ifndef TESTMAMMARYDIVISIONSCHEDULING_HPP_
+#define TESTMAMMARYDIVISIONSCHEDULING_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "CellId.hpp"
+#include "SimulationTime.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "OffLatticeSimulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "StemCellProliferativeType.hpp"
+
+#include "MammaryCellCycleModel.hpp"
+#include "MammaryOffLatticeSimulation.hpp"
+#include "MammaryRandomStreams.hpp"
+
+/*
+ * Checks that the division queue of MammaryOffLatticeSimulation divides the same cells at
+ * the same times as the polling of every cell in OffLatticeSimulation.
+ */
+class TestMammaryDivisionScheduling : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Run a small population of stem cells, each of which divides at most once, and record
+     * when each cell was born or last divided.
+     *
+     * Cell-cycle durations are drawn in the reproducible mode of MammaryRandomStreams, so
+     * that they do not depend on the order in which the cells are visited.
+     *
+     * @param rOutputDirectory the output directory
+     * @param rParentBirthTimes filled in with the birth time of each initial cell, by cell ID
+     * @param rDaughterBirthTimes filled in with the birth times of the daughters, in increasing order
+     */
+    template<class SIMULATION>
+    void RunDivisions(const std::string& rOutputDirectory,
+                      std::map<unsigned, double>& rParentBirthTimes,
+                      std::vector<double>& rDaughterBirthTimes)
+    {
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+        RandomNumberGenerator::Instance()->Reseed(0);
+        CellId::ResetMaxCellId();
+
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<16; i++)
+        {
+            nodes.push_back(new Node<2>(i, false, 1.0*(i%4), 1.0*(i/4)));
+        }
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(StemCellProliferativeType, p_stem_type);
+        std::vector<CellPtr> cells;
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            // Cycles of 12 to 16 hours end between 0.5 and 12 hours, and daughters' cycles after 12.5 hours
+            MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+            p_model->SetDimension(2);
+            p_model->SetBirthTime(-4.0 - 0.5*i);
+
+            CellPtr p_cell(new Cell(p_state, p_model));
+            p_cell->SetCellProliferativeType(p_stem_type);
+            p_cell->InitialiseCellCycleModel();
+            cells.push_back(p_cell);
+        }
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        SIMULATION simulator(cell_population);
+        simulator.SetOutputDirectory(rOutputDirectory);
+        simulator.SetSamplingTimestepMultiple(1200);
+        simulator.SetEndTime(10.0);
+        simulator.Solve();
+
+        rParentBirthTimes.clear();
+        rDaughterBirthTimes.clear();
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            double birth_time = cell_iter->GetCellCycleModel()->GetBirthTime();
+            if (cell_iter->GetCellId() < mesh.GetNumNodes())
+            {
+                rParentBirthTimes[cell_iter->GetCellId()] = birth_time;
+            }
+            else
+            {
+                rDaughterBirthTimes.push_back(birth_time);
+            }
+        }
+        std::sort(rDaughterBirthTimes.begin(), rDaughterBirthTimes.end());
+    }
+
+public:
+
+    void TestDivisionQueueMatchesPolling()
+    {
+        EXIT_IF_PARALLEL;
+
+        MammaryRandomStreams::Instance()->SetReproducible(true);
+
+        std::map<unsigned, double> polled_parent_birth_times;
+        std::vector<double> polled_daughter_birth_times;
+        RunDivisions<OffLatticeSimulation<2> >("TestMammaryDivisionScheduling/Polled",
+                                               polled_parent_birth_times, polled_daughter_birth_times);
+
+        std::map<unsigned, double> queued_parent_birth_times;
+        std::vector<double> queued_daughter_birth_times;
+        RunDivisions<MammaryOffLatticeSimulation<2> >("TestMammaryDivisionScheduling/Queued",
+                                                      queued_parent_birth_times, queued_daughter_birth_times);
+
+        MammaryRandomStreams::Instance()->SetReproducible(false);
+
+        // Some, but not all, of the cells should have divided
+        TS_ASSERT_LESS_THAN(0u, polled_daughter_birth_times.size());
+        TS_ASSERT_LESS_THAN(polled_daughter_birth_times.size(), 16u);
+
+        // The same cells should have divided at the same times
+        TS_ASSERT_EQUALS(queued_parent_birth_times.size(), polled_parent_birth_times.size());
+        for (std::map<unsigned, double>::iterator it = polled_parent_birth_times.begin();
+             it != polled_parent_birth_times.end();
+             ++it)
+        {
+            TS_ASSERT_EQUALS(queued_parent_birth_times.count(it->first), 1u);
+            TS_ASSERT_DELTA(queued_parent_birth_times[it->first], it->second, 1e-9);
+        }
+
+        TS_ASSERT_EQUALS(queued_daughter_birth_times.size(), polled_daughter_birth_times.size());
+        for (unsigned i=0; i<std::min(queued_daughter_birth_times.size(), polled_daughter_birth_times.size()); i++)
+        {
+            TS_ASSERT_DELTA(queued_daughter_birth_times[i], polled_daughter_birth_times[i], 1e-9);
+        }
+    }
+};
+
+#endif /*TESTMAMMARYDIVISIONSCHEDULING_HPP_*/
@@ -0,0 +1,151 @@
+#ifndef TESTMAMMARYENSEMBLESEEDS_HPP_
+#define TESTMAMMARYENSEMBLESEEDS_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "OutputFileHandler.hpp"
+#include "CellId.hpp"
+#include "SimulationTime.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "MammaryOffLatticeSimulation.hpp"
+#include "MammaryRandomStreams.hpp"
+#include "MammaryScenario.hpp"
+#include "MammaryScenarioFactory.hpp"
+#include "MammaryEnsembleRunner.hpp"
+
+/*
+ * Checks that replicates of an ensemble, which differ only in their seeds, draw different
+ * cell deaths from an AnoikisCellKiller built by MammaryScenarioFactory, even when the
+ * killer's own Seed is given in the scenario.
+ */
+class TestMammaryEnsembleSeeds : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Run a replicate's simulation of a row of detached cells for an hour, with the
+     * scenario's killer and no forces, setting up the seeds as MammaryScenarioFactory::Run()
+     * does.
+     *
+     * @param rScenario the scenario
+     * @param seed the seed of the replicate
+     * @param rOutputDirectory the output directory
+     * @param rCellsKilled filled in with whether each cell, in order of creation, started apoptosis
+     */
+    void RunReplicate(const MammaryScenario& rScenario, unsigned seed, const std::string& rOutputDirectory, std::vector<bool>& rCellsKilled)
+    {
+        MammaryRandomStreams::Instance()->SetSeed(seed);
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+        RandomNumberGenerator::Instance()->Reseed(seed);
+        CellId::ResetMaxCellId();
+
+        // Cells above the default detachment height of the killer
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<40; i++)
+        {
+            nodes.push_back(new Node<2>(i, false, 2.0*i, 2.0));
+        }
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        std::vector<CellPtr> cells;
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+            p_model->SetDimension(2);
+
+            CellPtr p_cell(new Cell(p_state, p_model));
+            p_cell->SetCellProliferativeType(p_differentiated_type);
+            p_cell->AddCellProperty(MammaryCellPropertyHelper::CreateMammaryCellProperty(LUMINAL_CELL, false, false));
+            p_cell->InitialiseCellCycleModel();
+            cells.push_back(p_cell);
+        }
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        MammaryOffLatticeSimulation<2> simulator(cell_population);
+        simulator.SetOutputDirectory(rOutputDirectory);
+        simulator.SetSamplingTimestepMultiple(120);
+        simulator.SetEndTime(1.0);
+        MammaryScenarioFactory<2>().AddComponents(rScenario, simulator);
+        simulator.Solve();
+
+        rCellsKilled.clear();
+        for (unsigned i=0; i<cells.size(); i++)
+        {
+            rCellsKilled.push_back(cells[i]->IsDead() || cells[i]->HasApoptosisBegun());
+        }
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
+public:
+
+    void TestReplicatesDrawDifferentDeaths()
+    {
+        EXIT_IF_PARALLEL;
+
+        OutputFileHandler output_file_handler("TestMammaryEnsembleSeeds", true);
+        std::string scenario_file_name = output_file_handler.GetOutputDirectoryFullPath() + "scenario.json";
+        {
+            std::ofstream scenario_file(scenario_file_name.c_str());
+            scenario_file << "{\n"
+                          << "    \"Killers\": [\n"
+                          << "        { \"Type\": \"AnoikisCellKiller\", \"ProbabilityOfDeathInAnHour\": 0.5, \"Seed\": 3 }\n"
+                          << "    ]\n"
+                          << "}\n";
+        }
+        MammaryScenario scenario(scenario_file_name);
+
+        // The seeds that an ensemble passes to its first two replicates
+        MammaryEnsembleRunner runner(scenario_file_name, "TestMammaryEnsembleSeeds/Ensemble", 2);
+        runner.SetFirstSeed(5);
+        TS_ASSERT_EQUALS(runner.GetReplicateSeed(0), 5u);
+        TS_ASSERT_EQUALS(runner.GetReplicateSeed(1), 6u);
+
+        std::vector<bool> killed_in_first;
+        RunReplicate(scenario, runner.GetReplicateSeed(0), "TestMammaryEnsembleSeeds/Replicate0", killed_in_first);
+
+        std::vector<bool> killed_in_second;
+        RunReplicate(scenario, runner.GetReplicateSeed(1), "TestMammaryEnsembleSeeds/Replicate1", killed_in_second);
+
+        std::vector<bool> killed_in_first_again;
+        RunReplicate(scenario, runner.GetReplicateSeed(0), "TestMammaryEnsembleSeeds/Replicate0Again", killed_in_first_again);
+
+        MammaryRandomStreams::Destroy();
+
+        // Some, but not all, of the cells should have been killed in each replicate
+        unsigned num_killed = 0;
+        for (unsigned i=0; i<killed_in_first.size(); i++)
+        {
+            num_killed += killed_in_first[i] ? 1 : 0;
+        }
+        TS_ASSERT_LESS_THAN(0u, num_killed);
+        TS_ASSERT_LESS_THAN(num_killed, killed_in_first.size());
+
+        // The same seed should kill the same cells, and a different seed different ones
+        TS_ASSERT(killed_in_first_again == killed_in_first);
+        TS_ASSERT(killed_in_second != killed_in_first);
+    }
+};
+
+#endif /*TESTMAMMARYENSEMBLESEEDS_HPP_*/
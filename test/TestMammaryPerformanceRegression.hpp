@@ -0,0 +1,133 @@
+#ifndef TESTMAMMARYPERFORMANCEREGRESSION_HPP_
+#define TESTMAMMARYPERFORMANCEREGRESSION_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <algorithm>
+#include <cfloat>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "PetscSetupAndFinalize.hpp"
+#include "CommandLineArguments.hpp"
+#include "FileFinder.hpp"
+
+#include "MammaryBenchmarkScenario.hpp"
+#include "MammaryPerformanceBaseline.hpp"
+
+/*
+ * Guards the speed of the simulation step against regressions, by running reduced
+ * versions of the scenarios of TestMammaryBenchmarks (1000 cells, 20 steps) and comparing
+ * the time per step and the number of MammaryCellCycleModel objects allocated by each with
+ * this machine's baseline (see MammaryPerformanceBaseline). The baselines are kept in
+ * <host name> within the directory given by the option --baseline-dir (an absolute path,
+ * or relative to the current directory). Without it, they are kept in
+ * TestMammaryPerformanceRegression/Baselines in the Chaste output directory, which only
+ * lasts as long as CHASTE_TEST_OUTPUT does (often a scratch directory in /tmp), so
+ * machines that track regressions over time should give --baseline-dir.
+ *
+ * Each scenario is run three times (or the number given by --repeats) and the fastest run
+ * is compared, to reduce the noise from other work on the machine. A scenario fails if it
+ * allocates more cell-cycle models than its baseline or is slower by more than 25% (or the fraction
+ * given by --tolerance); with --warn-only, these are only reported. On the first run on a
+ * machine, the measurements become its baselines; --update-baseline replaces the baselines
+ * with the current measurements (e.g. after an intended change). Every measurement is
+ * appended to history.csv beside the baselines.
+ */
+class TestMammaryPerformanceRegression : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Run a scenario, compare it with its baseline and report the outcome.
+     *
+     * @param geometry the geometry of the scenario
+     * @param forces the forces of the scenario, as a combination of MammaryBenchmarkForce bits
+     * @param rBaseline this machine's baselines
+     */
+    template<unsigned DIM>
+    void CheckScenario(MammaryBenchmarkGeometry geometry, unsigned forces, MammaryPerformanceBaseline& rBaseline)
+    {
+        unsigned num_repeats = 3;
+        double tolerance = 0.25;
+        CommandLineArguments* p_args = CommandLineArguments::Instance();
+        if (p_args->OptionExists("--repeats"))
+        {
+            num_repeats = p_args->GetUnsignedCorrespondingToOption("--repeats");
+        }
+        if (p_args->OptionExists("--tolerance"))
+        {
+            tolerance = p_args->GetDoubleCorrespondingToOption("--tolerance");
+        }
+        bool warn_only = p_args->OptionExists("--warn-only");
+
+        MammaryBenchmarkScenario<DIM> scenario(geometry, 1000, forces);
+        std::string name = scenario.GetName();
+
+        double time_per_step = DBL_MAX;
+        unsigned long num_cycle_model_allocations = 0;
+        for (unsigned repeat=0; repeat<std::max(num_repeats, 1u); repeat++)
+        {
+            MammaryBenchmarkResult result = scenario.Run(20, "TestMammaryPerformanceRegression/" + name);
+            time_per_step = std::min(time_per_step, result.GetTimePerStep());
+            num_cycle_model_allocations = result.mNumCycleModelAllocations;
+        }
+
+        if (p_args->OptionExists("--update-baseline"))
+        {
+            rBaseline.SetBaseline(name, time_per_step, num_cycle_model_allocations);
+        }
+        MammaryPerformanceStatus status = rBaseline.Compare(name, time_per_step, num_cycle_model_allocations, tolerance);
+
+        std::cout << name << ": " << time_per_step << " s per step (baseline " << rBaseline.GetTimePerStep(name)
+                  << "), " << num_cycle_model_allocations << " cell-cycle model allocations (baseline "
+                  << rBaseline.GetNumCycleModelAllocations(name)
+                  << "): " << MammaryPerformanceBaseline::GetStatusName(status) << "\n" << std::flush;
+
+        if (status == SLOWER_THAN_BASELINE || status == MORE_CYCLE_MODEL_ALLOCATIONS_THAN_BASELINE)
+        {
+            std::string message = name + " has regressed (" + MammaryPerformanceBaseline::GetStatusName(status)
+                                  + "); see " + rBaseline.rGetDirectory() + "history.csv";
+            if (warn_only)
+            {
+                std::cout << "Warning: " << message << "\n" << std::flush;
+            }
+            else
+            {
+                TS_FAIL(message);
+            }
+        }
+        else if (status == FASTER_THAN_BASELINE)
+        {
+            std::cout << name << " is faster than its baseline; run with --update-baseline to keep the gain\n" << std::flush;
+        }
+    }
+
+public:
+
+    void TestScenariosAgainstBaselines()
+    {
+        EXIT_IF_PARALLEL;
+
+        FileFinder baseline_directory("TestMammaryPerformanceRegression/Baselines", RelativeTo::ChasteTestOutput);
+        CommandLineArguments* p_args = CommandLineArguments::Instance();
+        if (p_args->OptionExists("--baseline-dir"))
+        {
+            baseline_directory.SetPath(p_args->GetStringCorrespondingToOption("--baseline-dir"), RelativeTo::AbsoluteOrCwd);
+        }
+        MammaryPerformanceBaseline baseline(baseline_directory);
+        std::cout << "Performance baselines are kept in " << baseline.rGetDirectory() << "\n" << std::flush;
+
+        CheckScenario<2>(ORGANOID_GEOMETRY, SPRING_FORCE | RANDOM_MOTION_FORCE, baseline);
+        CheckScenario<3>(ORGANOID_GEOMETRY, DIFFERENTIAL_ADHESION_FORCE | RANDOM_MOTION_FORCE, baseline);
+        CheckScenario<2>(MONOLAYER_GEOMETRY, SPRING_FORCE | RANDOM_MOTION_FORCE, baseline);
+        CheckScenario<3>(MONOLAYER_GEOMETRY, SPRING_FORCE | COVERSLIP_ADHESION_FORCE | RANDOM_MOTION_FORCE, baseline);
+        CheckScenario<2>(PARTICLE_ORGANOID_GEOMETRY, SPRING_FORCE | PARTICLE_ADHESION_FORCE | RANDOM_MOTION_FORCE, baseline);
+        CheckScenario<3>(PARTICLE_ORGANOID_GEOMETRY, SPRING_FORCE | PARTICLE_ADHESION_FORCE | RANDOM_MOTION_FORCE, baseline);
+
+        // Keep any new or updated baselines
+        baseline.Save();
+    }
+};
+
+#endif /*TESTMAMMARYPERFORMANCEREGRESSION_HPP_*/
@@ -0,0 +1,184 @@
+#ifndef TESTMAMMARYREPRODUCIBLEMODE_HPP_
+#define TESTMAMMARYREPRODUCIBLEMODE_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <algorithm>
+#include <map>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "CellId.hpp"
+#include "SimulationTime.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "LuminalCellProperty.hpp"
+#include "CellPropertyRegistry.hpp"
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "MammaryOffLatticeSimulation.hpp"
+#include "MammaryRandomStreams.hpp"
+#include "OrientedDivisionRule.hpp"
+#include "LinearSpringForce.hpp"
+#include "RandomMotionForce.hpp"
+#include "PerturbationSchedulerModifier.hpp"
+
+/*
+ * Checks the acceptance criterion of the reproducible mode of MammaryRandomStreams: a
+ * simulation with random motion, randomly targeted perturbations and divisions gives
+ * bitwise-identical results whatever the order of the nodes in the population.
+ */
+class TestMammaryReproducibleMode : public AbstractCellBasedTestSuite
+{
+private:
+
+    /** The final state of a cell. */
+    struct CellState
+    {
+        /** The cell's position. */
+        c_vector<double, 2> mPosition;
+
+        /** The cell's mammary type. */
+        MammaryCellType mCellType;
+    };
+
+    /**
+     * Run a simulation of a 5x5 sheet of luminal cells, of which a random half are
+     * converted to luminal stem cells after half an hour and go on to divide.
+     *
+     * @param rOutputDirectory the output directory
+     * @param reverseNodeOrder whether the nodes (and so the cells) are held in reverse order
+     * @param rStates filled in with the final state of each cell, by cell ID
+     */
+    void RunSimulation(const std::string& rOutputDirectory, bool reverseNodeOrder, std::map<unsigned, CellState>& rStates)
+    {
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+        RandomNumberGenerator::Instance()->Reseed(0);
+        CellId::ResetMaxCellId();
+
+        // The cells are created in the same order, so have the same IDs, in both runs
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        boost::shared_ptr<AbstractCellProperty> p_luminal(CellPropertyRegistry::Instance()->Get<LuminalCellProperty>());
+        std::vector<CellPtr> cells;
+        std::vector<c_vector<double, 2> > positions;
+        for (unsigned i=0; i<25; i++)
+        {
+            MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+            p_model->SetDimension(2);
+
+            CellPtr p_cell(new Cell(p_state, p_model));
+            p_cell->SetCellProliferativeType(p_differentiated_type);
+            p_cell->AddCellProperty(p_luminal);
+            p_cell->InitialiseCellCycleModel();
+            cells.push_back(p_cell);
+
+            c_vector<double, 2> position;
+            position[0] = 1.0*(i%5);
+            position[1] = 1.0*(i/5);
+            positions.push_back(position);
+        }
+        if (reverseNodeOrder)
+        {
+            std::reverse(cells.begin(), cells.end());
+            std::reverse(positions.begin(), positions.end());
+        }
+
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<positions.size(); i++)
+        {
+            nodes.push_back(new Node<2>(i, false, positions[i][0], positions[i][1]));
+        }
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+        boost::shared_ptr<AbstractCentreBasedDivisionRule<2,2> > p_division_rule(new OrientedDivisionRule<2,2>());
+        cell_population.SetCentreBasedDivisionRule(p_division_rule);
+
+        MammaryOffLatticeSimulation<2> simulator(cell_population);
+        simulator.SetOutputDirectory(rOutputDirectory);
+        simulator.SetSamplingTimestepMultiple(1200);
+        simulator.SetEndTime(15.0);
+
+        MAKE_PTR(LinearSpringForce<2>, p_spring_force);
+        simulator.AddForce(p_spring_force);
+        MAKE_PTR(RandomMotionForce<2>, p_random_force);
+        simulator.AddForce(p_random_force);
+
+        PerturbationTarget half_of_cells;
+        half_of_cells.mFraction = 0.5;
+        MAKE_PTR(PerturbationSchedulerModifier<2>, p_modifier);
+        p_modifier->AddTypeConversionEvent(0.5, LUMINAL_STEM_CELL, half_of_cells);
+        simulator.AddSimulationModifier(p_modifier);
+
+        simulator.Solve();
+
+        rStates.clear();
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            CellState& r_state = rStates[cell_iter->GetCellId()];
+            r_state.mPosition = cell_population.GetLocationOfCellCentre(*cell_iter);
+            r_state.mCellType = MammaryCellPropertyHelper::GetMammaryCellType(*cell_iter);
+        }
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
+public:
+
+    void TestResultsDoNotDependOnNodeOrder()
+    {
+        EXIT_IF_PARALLEL;
+
+        MammaryRandomStreams::Instance()->SetReproducible(true);
+        MammaryRandomStreams::Instance()->SetSeed(7);
+
+        std::map<unsigned, CellState> states_in_order;
+        RunSimulation("TestMammaryReproducibleMode/InOrder", false, states_in_order);
+
+        std::map<unsigned, CellState> states_in_reverse;
+        RunSimulation("TestMammaryReproducibleMode/Reversed", true, states_in_reverse);
+
+        MammaryRandomStreams::Destroy();
+
+        // Some, but not all, of the cells should have been converted, and some should have divided
+        unsigned num_stem_cells = 0;
+        for (std::map<unsigned, CellState>::iterator it = states_in_order.begin(); it != states_in_order.end(); ++it)
+        {
+            if (it->second.mCellType == LUMINAL_STEM_CELL)
+            {
+                num_stem_cells++;
+            }
+        }
+        TS_ASSERT_LESS_THAN(0u, num_stem_cells);
+        TS_ASSERT_LESS_THAN(num_stem_cells, 25u);
+        TS_ASSERT_LESS_THAN(25u, states_in_order.size());
+
+        // The same cells should be in the same states at bitwise-identical positions
+        TS_ASSERT_EQUALS(states_in_reverse.size(), states_in_order.size());
+        for (std::map<unsigned, CellState>::iterator it = states_in_order.begin(); it != states_in_order.end(); ++it)
+        {
+            TS_ASSERT_EQUALS(states_in_reverse.count(it->first), 1u);
+            const CellState& r_reversed = states_in_reverse[it->first];
+            TS_ASSERT_EQUALS(r_reversed.mCellType, it->second.mCellType);
+            TS_ASSERT_EQUALS(r_reversed.mPosition[0], it->second.mPosition[0]);
+            TS_ASSERT_EQUALS(r_reversed.mPosition[1], it->second.mPosition[1]);
+        }
+    }
+};
+
+#endif /*TESTMAMMARYREPRODUCIBLEMODE_HPP_*/
@@ -0,0 +1,208 @@
+#ifndef TESTMAMMARYSNAPSHOTROUNDTRIP_HPP_
+#define TESTMAMMARYSNAPSHOTROUNDTRIP_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "MammaryPopulationSnapshot.hpp"
+#include "MammarySnapshotWriter.hpp"
+#include "MammarySnapshotReader.hpp"
+#include "MammaryTrajectoryIndex.hpp"
+
+/*
+ * Writes snapshots of a moving population with MammarySnapshotWriter, with key frames and
+ * delta-encoded blocks, and checks that they read back exactly through MammarySnapshotReader
+ * and MammaryTrajectoryIndex.
+ */
+class TestMammarySnapshotRoundTrip : public AbstractCellBasedTestSuite
+{
+private:
+
+    /** The number of output time steps written. */
+    static const unsigned NUM_SNAPSHOTS = 7;
+
+    /**
+     * Write NUM_SNAPSHOTS snapshots of a row of cells of each mammary type, moving the
+     * cells between snapshots, and keep a copy of what was written.
+     *
+     * @param rOutputDirectory the output directory
+     * @param rExpectedSnapshots filled in with the snapshots, as captured before writing
+     * @return the full path of the snapshot file
+     */
+    std::string WriteSnapshots(const std::string& rOutputDirectory,
+                               std::vector<MammaryPopulationSnapshot<2> >& rExpectedSnapshots)
+    {
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(NUM_SNAPSHOTS - 1.0, NUM_SNAPSHOTS - 1);
+
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<8; i++)
+        {
+            nodes.push_back(new Node<2>(i, false, 1.0*i, 0.0));
+        }
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        std::vector<CellPtr> cells;
+        for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+        {
+            MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+            p_model->SetDimension(2);
+
+            CellPtr p_cell(new Cell(p_state, p_model));
+            p_cell->SetCellProliferativeType(p_differentiated_type);
+            p_cell->AddCellProperty(MammaryCellPropertyHelper::CreateMammaryCellProperty((MammaryCellType)(i%4), i%2 == 0, i%3 == 0));
+            p_cell->InitialiseCellCycleModel();
+            cells.push_back(p_cell);
+        }
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        OutputFileHandler output_file_handler(rOutputDirectory, true);
+        MammarySnapshotWriter<2,2> writer;
+        writer.SetUsePositionDeltas(true);
+        writer.SetKeyFrameInterval(3);
+        writer.OpenOutputFile(output_file_handler);
+
+        rExpectedSnapshots.clear();
+        for (unsigned step=0; step<NUM_SNAPSHOTS; step++)
+        {
+            if (step > 0)
+            {
+                SimulationTime::Instance()->IncrementTimeOneStep();
+                for (unsigned i=0; i<mesh.GetNumNodes(); i++)
+                {
+                    // Irregular steps, so that the positions do not have a short binary expansion
+                    mesh.GetNode(i)->rGetModifiableLocation()[1] += 0.1*(i + 1)/(step + 2.0);
+                }
+            }
+
+            rExpectedSnapshots.push_back(MammaryPopulationSnapshot<2>());
+            rExpectedSnapshots.back().Capture(cell_population);
+            writer.VisitAnyPopulation(&cell_population);
+        }
+        writer.CloseFile();
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+        return output_file_handler.GetOutputDirectoryFullPath() + "mammary_snapshots.bin";
+    }
+
+    /**
+     * Check that a snapshot read back matches the one written.
+     *
+     * @param rExpected the snapshot written
+     * @param rActual the snapshot read back
+     */
+    void CheckSnapshot(const MammaryPopulationSnapshot<2>& rExpected, const MammaryPopulationSnapshot<2>& rActual)
+    {
+        TS_ASSERT_EQUALS(rActual.GetTime(), rExpected.GetTime());
+        TS_ASSERT_EQUALS(rActual.HasDeltas(), false);
+        TS_ASSERT(rActual.rGetCellIds() == rExpected.rGetCellIds());
+        TS_ASSERT(rActual.rGetCellTypes() == rExpected.rGetCellTypes());
+        TS_ASSERT(rActual.rGetIntegrinBits() == rExpected.rGetIntegrinBits());
+
+        // Delta encoding is lossless, so the positions should be identical
+        TS_ASSERT(rActual.rGetPositions() == rExpected.rGetPositions());
+        TS_ASSERT(rActual.rGetVelocities() == rExpected.rGetVelocities());
+    }
+
+public:
+
+    void TestSnapshotReaderRoundTrip()
+    {
+        EXIT_IF_PARALLEL;
+
+        std::vector<MammaryPopulationSnapshot<2> > expected_snapshots;
+        std::string file_name = WriteSnapshots("TestMammarySnapshotRoundTrip/Reader", expected_snapshots);
+
+        MammarySnapshotReader<2> reader(file_name);
+        TS_ASSERT_EQUALS(reader.GetNumSnapshots(), NUM_SNAPSHOTS);
+
+        // Read forwards, decoding each delta against the snapshot before
+        MammaryPopulationSnapshot<2> snapshot;
+        for (unsigned index=0; index<reader.GetNumSnapshots(); index++)
+        {
+            TS_ASSERT_EQUALS(reader.GetNumCells(index), 8u);
+            reader.ReadSnapshot(index, snapshot);
+            CheckSnapshot(expected_snapshots[index], snapshot);
+        }
+
+        // Read backwards, which goes back to the last key frame for each delta
+        for (unsigned index=reader.GetNumSnapshots(); index-- > 0; )
+        {
+            reader.ReadSnapshot(index, snapshot);
+            CheckSnapshot(expected_snapshots[index], snapshot);
+        }
+
+        TS_ASSERT_EQUALS(reader.FindSnapshot(2.5), 2u);
+    }
+
+    void TestTrajectoryIndexRoundTrip()
+    {
+        EXIT_IF_PARALLEL;
+
+        std::vector<MammaryPopulationSnapshot<2> > expected_snapshots;
+        std::string file_name = WriteSnapshots("TestMammarySnapshotRoundTrip/Index", expected_snapshots);
+
+        MammaryTrajectoryIndex index(file_name);
+        TS_ASSERT_EQUALS(index.GetDimension(), 2u);
+        TS_ASSERT_EQUALS(index.HasVelocities(), true);
+        TS_ASSERT_EQUALS(index.GetNumSnapshots(), NUM_SNAPSHOTS);
+        TS_ASSERT_EQUALS(index.GetNumRows(), 8u*NUM_SNAPSHOTS);
+        TS_ASSERT_EQUALS(index.GetNumCells(), 8u);
+
+        // By snapshot
+        for (unsigned snapshot_index=0; snapshot_index<NUM_SNAPSHOTS; snapshot_index++)
+        {
+            const MammaryPopulationSnapshot<2>& r_expected = expected_snapshots[snapshot_index];
+            MammaryTrajectorySnapshotView view = index.GetSnapshot(snapshot_index);
+            TS_ASSERT_EQUALS(view.GetTime(), r_expected.GetTime());
+            TS_ASSERT_EQUALS(view.GetNumCells(), r_expected.GetNumCells());
+            for (unsigned row=0; row<r_expected.GetNumCells(); row++)
+            {
+                TS_ASSERT_EQUALS(view.GetCellId(row), r_expected.rGetCellIds()[row]);
+                TS_ASSERT_EQUALS(view.GetCellType(row), r_expected.rGetCellTypes()[row]);
+                TS_ASSERT_EQUALS(view.GetPosition(row)[0], r_expected.GetPosition(row, 0));
+                TS_ASSERT_EQUALS(view.GetPosition(row)[1], r_expected.GetPosition(row, 1));
+            }
+        }
+
+        // By cell, with a mapped index rather than one built from the snapshot file
+        MammaryTrajectoryIndex mapped_index(file_name);
+        for (unsigned row=0; row<8; row++)
+        {
+            uint32_t cell_id = expected_snapshots[0].rGetCellIds()[row];
+            MammaryTrajectoryCellView trajectory = mapped_index.GetTrajectory(cell_id);
+            TS_ASSERT_EQUALS(trajectory.GetNumPoints(), NUM_SNAPSHOTS);
+            for (unsigned point=0; point<trajectory.GetNumPoints(); point++)
+            {
+                const MammaryPopulationSnapshot<2>& r_expected = expected_snapshots[point];
+                TS_ASSERT_EQUALS(trajectory.GetSnapshotIndex(point), point);
+                TS_ASSERT_EQUALS(trajectory.GetTime(point), r_expected.GetTime());
+                TS_ASSERT_EQUALS(trajectory.GetCellType(point), r_expected.rGetCellTypes()[row]);
+                TS_ASSERT_EQUALS(trajectory.GetPosition(point)[0], r_expected.GetPosition(row, 0));
+                TS_ASSERT_EQUALS(trajectory.GetPosition(point)[1], r_expected.GetPosition(row, 1));
+            }
+        }
+        TS_ASSERT_EQUALS(mapped_index.GetTrajectory(100).GetNumPoints(), 0u);
+    }
+};
+
+#endif /*TESTMAMMARYSNAPSHOTROUNDTRIP_HPP_*/
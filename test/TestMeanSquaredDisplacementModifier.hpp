@@ -0,0 +1,135 @@
+#ifndef TESTMEANSQUAREDDISPLACEMENTMODIFIER_HPP_
+#define TESTMEANSQUAREDDISPLACEMENTMODIFIER_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "SimulationTime.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "CellDataColumns.hpp"
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "MeanSquaredDisplacementModifier.hpp"
+
+/*
+ * Tests that MeanSquaredDisplacementModifier continues a daughter's history from its own
+ * parent, as recorded in the "parent_id" column of the population's CellDataColumns.
+ */
+class TestMeanSquaredDisplacementModifier : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * @param type the mammary cell type of the cell
+     * @return a cell with MammaryCellCycleModel, which therefore never divides
+     */
+    CellPtr CreateCell(MammaryCellType type)
+    {
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+
+        MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+        p_model->SetDimension(2);
+
+        CellPtr p_cell(new Cell(p_state, p_model));
+        p_cell->SetCellProliferativeType(p_differentiated_type);
+        p_cell->AddCellProperty(MammaryCellPropertyHelper::CreateMammaryCellProperty(type, false, false));
+        p_cell->InitialiseCellCycleModel();
+        return p_cell;
+    }
+
+public:
+
+    void TestDaughterContinuesParentHistory()
+    {
+        EXIT_IF_PARALLEL;
+
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(2.0, 2);
+
+        // A luminal cell that moves one unit per sample, and a myoepithelial cell that stays put
+        std::vector<Node<2>*> nodes;
+        nodes.push_back(new Node<2>(0, false, 0.0, 0.0));
+        nodes.push_back(new Node<2>(1, false, 10.0, 0.0));
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+
+        std::vector<CellPtr> cells;
+        cells.push_back(CreateCell(LUMINAL_CELL));
+        cells.push_back(CreateCell(MYOEPITHELIAL_CELL));
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        MeanSquaredDisplacementModifier<2> modifier;
+        modifier.SetupSolve(cell_population, "TestMeanSquaredDisplacementModifier");
+
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        mesh.GetNode(0)->rGetModifiableLocation()[0] = 1.0;
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+
+        /*
+         * The luminal cell moves on and has a daughter, of a type of its own so that only
+         * the daughter's displacements are counted for that type. The daughter's parent is
+         * given as the luminal cell, so its displacements are from the luminal cell's
+         * positions (0 and 1) rather than from the myoepithelial cell's (10 and 10).
+         */
+        std::vector<Node<2>*> next_nodes;
+        next_nodes.push_back(new Node<2>(0, false, 2.0, 0.0));
+        next_nodes.push_back(new Node<2>(1, false, 10.0, 0.0));
+        next_nodes.push_back(new Node<2>(2, false, 5.0, 0.0));
+        NodesOnlyMesh<2> next_mesh;
+        next_mesh.ConstructNodesWithoutMesh(next_nodes, 1.5);
+
+        std::vector<CellPtr> next_cells(cells);
+        next_cells.push_back(CreateCell(MYOEPITHELIAL_STEM_CELL));
+        NodeBasedCellPopulation<2> next_cell_population(next_mesh, next_cells);
+
+        boost::shared_ptr<CellDataColumns> p_columns = CellDataColumns::Get(next_cell_population.GetCellPropertyRegistry());
+        p_columns->SetValue(p_columns->RegisterColumn("parent_id"), next_cells[2]->GetCellId(), next_cells[0]->GetCellId());
+
+        SimulationTime::Instance()->IncrementTimeOneStep();
+        modifier.UpdateAtEndOfTimeStep(next_cell_population);
+
+        std::vector<double> lags;
+        modifier.GetLags(lags);
+        TS_ASSERT_DELTA(lags[0], 1.0, 1e-12);
+        TS_ASSERT_DELTA(lags[1], 2.0, 1e-12);
+
+        std::vector<double> msds;
+        std::vector<double> counts;
+        modifier.GetMeanSquaredDisplacements(MYOEPITHELIAL_STEM_CELL, msds, counts);
+        TS_ASSERT_DELTA(counts[0], 1.0, 1e-12);
+        TS_ASSERT_DELTA(msds[0], 16.0, 1e-12);
+        TS_ASSERT_DELTA(counts[1], 1.0, 1e-12);
+        TS_ASSERT_DELTA(msds[1], 25.0, 1e-12);
+
+        // The parent's own history is unaffected
+        modifier.GetMeanSquaredDisplacements(LUMINAL_CELL, msds, counts);
+        TS_ASSERT_DELTA(counts[0], 2.0, 1e-12);
+        TS_ASSERT_DELTA(msds[0], 1.0, 1e-12);
+        TS_ASSERT_DELTA(counts[1], 1.0, 1e-12);
+        TS_ASSERT_DELTA(msds[1], 4.0, 1e-12);
+
+        modifier.GetMeanSquaredDisplacements(MYOEPITHELIAL_CELL, msds, counts);
+        TS_ASSERT_DELTA(counts[1], 1.0, 1e-12);
+        TS_ASSERT_DELTA(msds[1], 0.0, 1e-12);
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+        for (unsigned i=0; i<next_nodes.size(); i++)
+        {
+            delete next_nodes[i];
+        }
+    }
+};
+
+#endif /*TESTMEANSQUAREDDISPLACEMENTMODIFIER_HPP_*/
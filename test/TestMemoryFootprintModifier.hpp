@@ -0,0 +1,206 @@
+#ifndef TESTMEMORYFOOTPRINTMODIFIER_HPP_
+#define TESTMEMORYFOOTPRINTMODIFIER_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "OutputFileHandler.hpp"
+#include "SimulationTime.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "NullSrnModel.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "MammaryOffLatticeSimulation.hpp"
+#include "ObjectPool.hpp"
+#include "MammaryMemoryFootprint.hpp"
+#include "MemoryFootprintModifier.hpp"
+
+/*
+ * Checks that the per-cell subsystems of MammaryMemoryFootprint grow in proportion to the
+ * number of cells, and that MemoryFootprintModifier writes a row of memory_footprint.csv
+ * at each output step, with a peak resident set size that never decreases.
+ */
+class TestMemoryFootprintModifier : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Create a sheet of luminal cells, five to a row, one cell diameter apart.
+     *
+     * @param numCells the number of cells
+     * @param rMesh the mesh to construct
+     * @param rCells filled in with the cells
+     */
+    void CreateSheetOfCells(unsigned numCells, NodesOnlyMesh<2>& rMesh, std::vector<CellPtr>& rCells)
+    {
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<numCells; i++)
+        {
+            nodes.push_back(new Node<2>(i, false, 1.0*(i%5), 1.0*(i/5)));
+        }
+        rMesh.ConstructNodesWithoutMesh(nodes, 1.5);
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        rCells.clear();
+        for (unsigned i=0; i<rMesh.GetNumNodes(); i++)
+        {
+            MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+            p_model->SetDimension(2);
+
+            CellPtr p_cell(new Cell(p_state, p_model));
+            p_cell->SetCellProliferativeType(p_differentiated_type);
+            p_cell->AddCellProperty(MammaryCellPropertyHelper::CreateMammaryCellProperty(LUMINAL_CELL, false, false));
+            p_cell->InitialiseCellCycleModel();
+            rCells.push_back(p_cell);
+        }
+    }
+
+    /**
+     * Estimate the memory held by a sheet of cells.
+     *
+     * @param numCells the number of cells
+     * @param rFootprint the footprint to calculate
+     * @return the number of real cells in the population
+     */
+    unsigned CalculateFootprint(unsigned numCells, MammaryMemoryFootprint<2>& rFootprint)
+    {
+        NodesOnlyMesh<2> mesh;
+        std::vector<CellPtr> cells;
+        CreateSheetOfCells(numCells, mesh, cells);
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        rFootprint.Calculate(cell_population);
+        return cell_population.GetNumRealCells();
+    }
+
+    /**
+     * @param rLine a line of comma-separated values
+     * @return the values
+     */
+    std::vector<std::string> SplitCsvLine(const std::string& rLine)
+    {
+        std::vector<std::string> values;
+        std::stringstream line_stream(rLine);
+        std::string value;
+        while (std::getline(line_stream, value, ','))
+        {
+            values.push_back(value);
+        }
+        return values;
+    }
+
+public:
+
+    void TestPerCellSubsystemsScaleWithCells()
+    {
+        EXIT_IF_PARALLEL;
+
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+
+        // Without pooling each cell-cycle model is counted at its own size, rather than as part of a slab
+        ObjectPool<MammaryCellCycleModel>::Instance()->SetPoolingEnabled(false);
+        MammaryMemoryFootprint<2> small_footprint;
+        unsigned num_small_cells = CalculateFootprint(10, small_footprint);
+        MammaryMemoryFootprint<2> large_footprint;
+        unsigned num_large_cells = CalculateFootprint(40, large_footprint);
+        ObjectPool<MammaryCellCycleModel>::Instance()->SetPoolingEnabled(true);
+
+        TS_ASSERT_EQUALS(num_small_cells, 10u);
+        TS_ASSERT_EQUALS(num_large_cells, 40u);
+        TS_ASSERT_EQUALS(small_footprint.GetNumCells(), num_small_cells);
+        TS_ASSERT_EQUALS(large_footprint.GetNumCells(), num_large_cells);
+
+        MammaryMemorySubsystem per_cell_subsystems[] = {NODE_MEMORY, CELL_MEMORY, CYCLE_MODEL_MEMORY};
+        for (unsigned i=0; i<3; i++)
+        {
+            std::size_t num_small_bytes = small_footprint.GetNumBytes(per_cell_subsystems[i]);
+            std::size_t num_large_bytes = large_footprint.GetNumBytes(per_cell_subsystems[i]);
+            TS_ASSERT_LESS_THAN(0u, num_small_bytes);
+            TS_ASSERT_EQUALS(num_small_bytes % num_small_cells, 0u);
+            TS_ASSERT_EQUALS(num_large_bytes, (num_small_bytes/num_small_cells)*num_large_cells);
+        }
+
+        // Each cell has a MammaryCellCycleModel and the default NullSrnModel
+        TS_ASSERT_EQUALS(small_footprint.GetNumBytes(CYCLE_MODEL_MEMORY),
+                         num_small_cells*(sizeof(MammaryCellCycleModel) + sizeof(NullSrnModel)));
+    }
+
+    void TestPeakResidentSetSizeNeverDecreases()
+    {
+        EXIT_IF_PARALLEL;
+
+        NodesOnlyMesh<2> mesh;
+        std::vector<CellPtr> cells;
+        CreateSheetOfCells(20, mesh, cells);
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        MammaryOffLatticeSimulation<2> simulator(cell_population);
+        simulator.SetOutputDirectory("TestMemoryFootprintModifier");
+        simulator.SetDt(0.1);
+        simulator.SetSamplingTimestepMultiple(100);
+        simulator.SetEndTime(1.0);
+
+        MAKE_PTR(MemoryFootprintModifier<2>, p_modifier);
+        simulator.AddSimulationModifier(p_modifier);
+        simulator.Solve();
+
+        OutputFileHandler handler("TestMemoryFootprintModifier", false);
+        std::ifstream file((handler.GetOutputDirectoryFullPath() + "results_from_time_0/memory_footprint.csv").c_str());
+        TS_ASSERT(file.is_open());
+
+        std::string line;
+        std::getline(file, line);
+        std::vector<std::string> header = SplitCsvLine(line);
+        unsigned cells_column = UNSIGNED_UNSET;
+        unsigned peak_rss_column = UNSIGNED_UNSET;
+        for (unsigned i=0; i<header.size(); i++)
+        {
+            if (header[i] == "cells")
+            {
+                cells_column = i;
+            }
+            else if (header[i] == "peak_rss_bytes")
+            {
+                peak_rss_column = i;
+            }
+        }
+        TS_ASSERT_EQUALS(cells_column, 1u);
+        TS_ASSERT_DIFFERS(peak_rss_column, UNSIGNED_UNSET);
+
+        // The initial state, then a row for each of the 10 time steps
+        unsigned num_rows = 0;
+        double last_peak_rss = 0.0;
+        while (std::getline(file, line) && peak_rss_column != UNSIGNED_UNSET)
+        {
+            std::vector<std::string> values = SplitCsvLine(line);
+            TS_ASSERT_EQUALS(values.size(), header.size());
+            TS_ASSERT_EQUALS(atoi(values[cells_column].c_str()), (int)cell_population.GetNumRealCells());
+
+            double peak_rss = atof(values[peak_rss_column].c_str());
+            TS_ASSERT_LESS_THAN(0.0, peak_rss);
+            TS_ASSERT_LESS_THAN_EQUALS(last_peak_rss, peak_rss);
+            last_peak_rss = peak_rss;
+            num_rows++;
+        }
+        TS_ASSERT_EQUALS(num_rows, 11u);
+    }
+};
+
+#endif /*TESTMEMORYFOOTPRINTMODIFIER_HPP_*/
@@ -0,0 +1,210 @@
+#ifndef TESTPERTURBATIONSCHEDULERMODIFIER_HPP_
+#define TESTPERTURBATIONSCHEDULERMODIFIER_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <algorithm>
+#include <set>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "CellId.hpp"
+#include "CellPropertyRegistry.hpp"
+#include "SimulationTime.hpp"
+#include "RandomNumberGenerator.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "StemCellProliferativeType.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "LuminalCellProperty.hpp"
+#include "MyoepithelialCellProperty.hpp"
+#include "LuminalStemCellProperty.hpp"
+#include "MyoepithelialStemCellProperty.hpp"
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "MammaryOffLatticeSimulation.hpp"
+#include "PerturbationSchedulerModifier.hpp"
+
+/*
+ * Tests of the type conversions of PerturbationSchedulerModifier, and of the lookup and
+ * replacement of mammary cell properties that they rely on.
+ */
+class TestPerturbationSchedulerModifier : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * Create luminal cells with MammaryCellCycleModel, which therefore never divide.
+     *
+     * @param numCells the number of cells
+     * @param rCells filled in with the cells, in order of cell ID
+     */
+    void CreateLuminalCells(unsigned numCells, std::vector<CellPtr>& rCells)
+    {
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+        boost::shared_ptr<AbstractCellProperty> p_luminal(CellPropertyRegistry::Instance()->Get<LuminalCellProperty>());
+
+        rCells.clear();
+        for (unsigned i=0; i<numCells; i++)
+        {
+            MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+            p_model->SetDimension(2);
+
+            CellPtr p_cell(new Cell(p_state, p_model));
+            p_cell->SetCellProliferativeType(p_differentiated_type);
+            p_cell->AddCellProperty(p_luminal);
+            p_cell->InitialiseCellCycleModel();
+            rCells.push_back(p_cell);
+        }
+    }
+
+    /**
+     * Create a row of nodes one cell diameter apart.
+     *
+     * @param numNodes the number of nodes
+     * @param rMesh the mesh to construct
+     */
+    void CreateRowOfNodes(unsigned numNodes, NodesOnlyMesh<2>& rMesh)
+    {
+        std::vector<Node<2>*> nodes;
+        for (unsigned i=0; i<numNodes; i++)
+        {
+            nodes.push_back(new Node<2>(i, false, 1.0*i, 0.0));
+        }
+        rMesh.ConstructNodesWithoutMesh(nodes, 1.5);
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+
+    /**
+     * Convert a random half of a population of luminal cells to myoepithelial cells in a
+     * single step, with the cells visited in the given order.
+     *
+     * @param reverseOrder whether the population holds the cells in reverse order of cell ID
+     * @return the IDs of the converted cells
+     */
+    std::set<unsigned> ConvertHalfOfCells(bool reverseOrder)
+    {
+        SimulationTime::Destroy();
+        SimulationTime::Instance()->SetStartTime(0.0);
+        SimulationTime::Instance()->SetEndTimeAndNumberOfTimeSteps(1.0, 1);
+        RandomNumberGenerator::Instance()->Reseed(0);
+        CellId::ResetMaxCellId();
+
+        NodesOnlyMesh<2> mesh;
+        CreateRowOfNodes(100, mesh);
+        std::vector<CellPtr> cells;
+        CreateLuminalCells(mesh.GetNumNodes(), cells);
+        if (reverseOrder)
+        {
+            std::reverse(cells.begin(), cells.end());
+        }
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        PerturbationTarget half_of_cells;
+        half_of_cells.mFraction = 0.5;
+        PerturbationSchedulerModifier<2> modifier;
+        modifier.AddTypeConversionEvent(0.0, MYOEPITHELIAL_CELL, half_of_cells);
+        modifier.UpdateAtEndOfTimeStep(cell_population);
+        TS_ASSERT_EQUALS(modifier.GetNumEventsApplied(), 1u);
+
+        std::set<unsigned> converted_cell_ids;
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            if (MammaryCellPropertyHelper::GetMammaryCellType(*cell_iter) == MYOEPITHELIAL_CELL)
+            {
+                converted_cell_ids.insert(cell_iter->GetCellId());
+            }
+        }
+        return converted_cell_ids;
+    }
+
+public:
+
+    void TestMammaryCellPropertyPriority()
+    {
+        std::vector<CellPtr> cells;
+        CreateLuminalCells(1, cells);
+        CellPtr p_cell = cells[0];
+
+        // The daughter of a luminal stem cell carries both properties, and counts as luminal
+        p_cell->AddCellProperty(CellPropertyRegistry::Instance()->Get<LuminalStemCellProperty>());
+        TS_ASSERT_EQUALS(MammaryCellPropertyHelper::GetMammaryCellType(p_cell), LUMINAL_CELL);
+        p_cell->RemoveCellProperty<LuminalCellProperty>();
+        TS_ASSERT_EQUALS(MammaryCellPropertyHelper::GetMammaryCellType(p_cell), LUMINAL_STEM_CELL);
+
+        // Replacing the mammary property removes every mammary property
+        p_cell->AddCellProperty(CellPropertyRegistry::Instance()->Get<LuminalCellProperty>());
+        MammaryCellPropertyHelper::ReplaceMammaryCellProperty(p_cell,
+            MammaryCellPropertyHelper::CreateMammaryCellProperty(MYOEPITHELIAL_STEM_CELL, true, false));
+        TS_ASSERT_EQUALS(p_cell->HasCellProperty<LuminalCellProperty>(), false);
+        TS_ASSERT_EQUALS(p_cell->HasCellProperty<LuminalStemCellProperty>(), false);
+        TS_ASSERT_EQUALS(p_cell->HasCellProperty<MyoepithelialStemCellProperty>(), true);
+        TS_ASSERT_EQUALS(MammaryCellPropertyHelper::GetMammaryCellType(p_cell), MYOEPITHELIAL_STEM_CELL);
+    }
+
+    void TestConvertedCellsDivide()
+    {
+        EXIT_IF_PARALLEL;
+
+        NodesOnlyMesh<2> mesh;
+        CreateRowOfNodes(4, mesh);
+        std::vector<CellPtr> cells;
+        CreateLuminalCells(mesh.GetNumNodes(), cells);
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        MammaryOffLatticeSimulation<2> simulator(cell_population);
+        simulator.SetOutputDirectory("TestPerturbationSchedulerModifier/ConvertedCellsDivide");
+        simulator.SetSamplingTimestepMultiple(120);
+        simulator.SetEndTime(18.0);
+
+        // Luminal stem cells divide 12 to 16 hours after conversion, and their daughters are luminal
+        MAKE_PTR(PerturbationSchedulerModifier<2>, p_modifier);
+        p_modifier->AddTypeConversionEvent(1.0, LUMINAL_STEM_CELL);
+        simulator.AddSimulationModifier(p_modifier);
+
+        simulator.Solve();
+
+        TS_ASSERT_EQUALS(p_modifier->GetNumEventsApplied(), 1u);
+        TS_ASSERT_EQUALS(cell_population.GetNumRealCells(), 8u);
+        for (AbstractCellPopulation<2>::Iterator cell_iter = cell_population.Begin();
+             cell_iter != cell_population.End();
+             ++cell_iter)
+        {
+            if (cell_iter->GetCellId() < 4)
+            {
+                TS_ASSERT_EQUALS(MammaryCellPropertyHelper::GetMammaryCellType(*cell_iter), LUMINAL_STEM_CELL);
+                TS_ASSERT_EQUALS(cell_iter->GetCellProliferativeType()->IsType<StemCellProliferativeType>(), true);
+            }
+        }
+
+        /*
+         * The converted cells have been rescheduled for their next division. Their daughters are
+         * scheduled too, since MammaryCellCycleModel::InitialiseDaughterCell() does not redraw the
+         * cell-cycle duration, so each daughter keeps the finite duration and birth time of its parent.
+         */
+        TS_ASSERT_EQUALS(simulator.GetNumScheduledCells(), 8u);
+    }
+
+    void TestFractionDoesNotDependOnCellOrder()
+    {
+        std::set<unsigned> converted_in_order = ConvertHalfOfCells(false);
+        std::set<unsigned> converted_in_reverse = ConvertHalfOfCells(true);
+
+        TS_ASSERT_LESS_THAN(30u, converted_in_order.size());
+        TS_ASSERT_LESS_THAN(converted_in_order.size(), 70u);
+        TS_ASSERT(converted_in_order == converted_in_reverse);
+    }
+};
+
+#endif /*TESTPERTURBATIONSCHEDULERMODIFIER_HPP_*/
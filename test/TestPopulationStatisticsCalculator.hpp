@@ -0,0 +1,146 @@
+#ifndef TESTPOPULATIONSTATISTICSCALCULATOR_HPP_
+#define TESTPOPULATIONSTATISTICSCALCULATOR_HPP_
+
+// Include necessary header files
+#include <cxxtest/TestSuite.h>
+#include <cmath>
+#include <vector>
+#include "CheckpointArchiveTypes.hpp"
+#include "AbstractCellBasedTestSuite.hpp"
+
+#include "SmartPointers.hpp"
+#include "PetscSetupAndFinalize.hpp"
+#include "NodesOnlyMesh.hpp"
+#include "NodeBasedCellPopulation.hpp"
+#include "WildTypeCellMutationState.hpp"
+#include "DifferentiatedCellProliferativeType.hpp"
+
+#include "MammaryCellPropertyHelper.hpp"
+#include "MammaryCellCycleModel.hpp"
+#include "PopulationStatisticsCalculator.hpp"
+
+/*
+ * Checks PopulationStatisticsCalculator on two concentric shells about (5,5): a luminal
+ * shell of 10 cells, alternately at radius 1.5 and 2.5, a myoepithelial shell of 20 cells,
+ * alternately at radius 3.5 and 4.5, and an untyped cell at the centre. Each half of each
+ * shell is evenly spaced around the circle, so the centroid is the centre.
+ */
+class TestPopulationStatisticsCalculator : public AbstractCellBasedTestSuite
+{
+private:
+
+    /**
+     * @param type the mammary cell type of the cell (NO_MAMMARY_CELL_TYPE for none)
+     * @return a cell with MammaryCellCycleModel, which therefore never divides
+     */
+    CellPtr CreateCell(MammaryCellType type)
+    {
+        MAKE_PTR(WildTypeCellMutationState, p_state);
+        MAKE_PTR(DifferentiatedCellProliferativeType, p_differentiated_type);
+
+        MammaryCellCycleModel* p_model = new MammaryCellCycleModel();
+        p_model->SetDimension(2);
+
+        CellPtr p_cell(new Cell(p_state, p_model));
+        p_cell->SetCellProliferativeType(p_differentiated_type);
+        if (type != NO_MAMMARY_CELL_TYPE)
+        {
+            p_cell->AddCellProperty(MammaryCellPropertyHelper::CreateMammaryCellProperty(type, false, false));
+        }
+        p_cell->InitialiseCellCycleModel();
+        return p_cell;
+    }
+
+    /**
+     * Check the statistics of the two shells.
+     *
+     * @param rCalculator a calculator with the default percentiles, which has been run on the shells
+     */
+    void CheckStatistics(const PopulationStatisticsCalculator<2>& rCalculator)
+    {
+        TS_ASSERT_EQUALS(rCalculator.GetNumCells(), 31u);
+        TS_ASSERT_EQUALS(rCalculator.GetNumCellsOfType(LUMINAL_CELL), 9u);
+        TS_ASSERT_EQUALS(rCalculator.GetNumCellsOfType(LUMINAL_STEM_CELL), 1u);
+        TS_ASSERT_EQUALS(rCalculator.GetNumCellsOfType(MYOEPITHELIAL_CELL), 18u);
+        TS_ASSERT_EQUALS(rCalculator.GetNumCellsOfType(MYOEPITHELIAL_STEM_CELL), 2u);
+        TS_ASSERT_EQUALS(rCalculator.GetNumCellsOfType(NO_MAMMARY_CELL_TYPE), 1u);
+
+        TS_ASSERT_DELTA(rCalculator.rGetCentroid()[0], 5.0, 1e-12);
+        TS_ASSERT_DELTA(rCalculator.rGetCentroid()[1], 5.0, 1e-12);
+
+        // Five cells at each of 1.5 and 2.5, and ten at each of 3.5 and 4.5
+        double sum_of_squares = 5*1.5*1.5 + 5*2.5*2.5 + 10*3.5*3.5 + 10*4.5*4.5;
+        TS_ASSERT_DELTA(rCalculator.GetRadiusOfGyration(), sqrt(sum_of_squares/31.0), 1e-12);
+        TS_ASSERT_DELTA(rCalculator.GetMaxRadius(), 4.5, 1e-12);
+
+        // The 27th of the 31 sorted distances
+        TS_ASSERT_DELTA(rCalculator.GetPercentileRadius(), 4.5, 1e-12);
+
+        // The 1st and 9th of the 10 luminal distances, and the 2nd and 18th of the 20 myoepithelial ones
+        TS_ASSERT_DELTA(rCalculator.GetShellInnerRadius(LUMINAL_LINEAGE), 1.5, 1e-12);
+        TS_ASSERT_DELTA(rCalculator.GetShellOuterRadius(LUMINAL_LINEAGE), 2.5, 1e-12);
+        TS_ASSERT_DELTA(rCalculator.GetShellThickness(LUMINAL_LINEAGE), 1.0, 1e-12);
+        TS_ASSERT_DELTA(rCalculator.GetShellInnerRadius(MYOEPITHELIAL_LINEAGE), 3.5, 1e-12);
+        TS_ASSERT_DELTA(rCalculator.GetShellOuterRadius(MYOEPITHELIAL_LINEAGE), 4.5, 1e-12);
+        TS_ASSERT_DELTA(rCalculator.GetShellThickness(MYOEPITHELIAL_LINEAGE), 1.0, 1e-12);
+    }
+
+public:
+
+    void TestConcentricShells()
+    {
+        EXIT_IF_PARALLEL;
+
+        std::vector<Node<2>*> nodes;
+        std::vector<CellPtr> cells;
+        nodes.push_back(new Node<2>(0, false, 5.0, 5.0));
+        cells.push_back(CreateCell(NO_MAMMARY_CELL_TYPE));
+        for (unsigned i=0; i<10; i++)
+        {
+            double angle = 2.0*M_PI*i/10.0;
+            double radius = (i%2 == 0) ? 1.5 : 2.5;
+            nodes.push_back(new Node<2>(nodes.size(), false, 5.0 + radius*cos(angle), 5.0 + radius*sin(angle)));
+            cells.push_back(CreateCell(i == 0 ? LUMINAL_STEM_CELL : LUMINAL_CELL));
+        }
+        for (unsigned i=0; i<20; i++)
+        {
+            double angle = 2.0*M_PI*i/20.0;
+            double radius = (i%2 == 0) ? 3.5 : 4.5;
+            nodes.push_back(new Node<2>(nodes.size(), false, 5.0 + radius*cos(angle), 5.0 + radius*sin(angle)));
+            cells.push_back(CreateCell(i < 2 ? MYOEPITHELIAL_STEM_CELL : MYOEPITHELIAL_CELL));
+        }
+        NodesOnlyMesh<2> mesh;
+        mesh.ConstructNodesWithoutMesh(nodes, 1.5);
+        NodeBasedCellPopulation<2> cell_population(mesh, cells);
+
+        PopulationStatisticsCalculator<2> calculator;
+        TS_ASSERT_EQUALS(calculator.GetNumThreads(), 1u);
+        TS_ASSERT_EQUALS(calculator.GetMinCellsPerThread(), 50000u);
+        TS_ASSERT_THROWS_THIS(calculator.SetMinCellsPerThread(0), "Each thread must be given at least one cell");
+
+        calculator.Calculate(cell_population);
+        CheckStatistics(calculator);
+
+        // The same statistics when the passes are split between threads
+        PopulationStatisticsCalculator<2> threaded_calculator;
+        threaded_calculator.SetNumThreads(4);
+        threaded_calculator.SetMinCellsPerThread(5);
+        threaded_calculator.Calculate(cell_population);
+        CheckStatistics(threaded_calculator);
+
+        // The median distance is the 16th of the 31, and the 0th percentile the untyped cell at the centre
+        calculator.SetRadiusPercentile(0.5);
+        calculator.Calculate(cell_population);
+        TS_ASSERT_DELTA(calculator.GetPercentileRadius(), 3.5, 1e-12);
+        calculator.SetRadiusPercentile(0.0);
+        calculator.Calculate(cell_population);
+        TS_ASSERT_DELTA(calculator.GetPercentileRadius(), 0.0, 1e-12);
+
+        for (unsigned i=0; i<nodes.size(); i++)
+        {
+            delete nodes[i];
+        }
+    }
+};
+
+#endif /*TESTPOPULATIONSTATISTICSCALCULATOR_HPP_*/